@@ -0,0 +1,507 @@
+// Latency and throughput benchmark for the audio API, run against SimulatedAudioSession so it
+// measures our own layers rather than whichever player happens to be open.
+//
+// Every API is timed call by call, first from one thread and then from --threads concurrent
+// callers sharing one manager, through four layers:
+//   cpp      audio::AudioTrackManager, the type-erased stack (session registry, command queue,
+//            virtual calls into the session);
+//   virtual  BasicAudioTrackManager over a shared_ptr<IAudioSession>: one session, virtual calls;
+//   static   BasicAudioTrackManager over SimulatedAudioSession held in place: direct calls;
+//   c        the wrapper's V2 C exports, on top of the cpp layer.
+// Only cpp and c queue transport commands, so their play/pause/seek/next also pay a worker
+// round-trip the other two do not. Results go to stdout as a table and, with --output, to a JSON file
+// whose "results" entries are keyed by layer, api and threads so runs from two releases can be
+// joined and compared. With --trace (or AUDIO_TRACE_FILE set) every call is also written as a span
+// to a Chrome trace-event file; the timings then include the tracer's cost.
+//
+// Build it from this file plus the library's portable sources, audio_api_wrapper.cpp and, off
+// Windows, the MPRIS backend (link libsystemd), with AUDIO_ENABLE_SIMULATION defined so the
+// wrapper exports createSimulatedAudioManagerV2; it needs no player and no session bus.
+//
+//     AudioBenchmark [--threads N] [--iterations N] [--warmup N] [--latency-us N] [--jitter-us N]
+//                    [--event-rate N] [--thumbnail-bytes N] [--seed N] [--label TEXT] [--output FILE]
+//                    [--trace FILE]
+
+#include "AudioAPI.h"
+#include "SimulatedAudioSession.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <barrier>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// The V2 C ABI, as declared by audio_api_wrapper.cpp; the layouts must match it exactly.
+extern "C" {
+    struct AudioResult {
+        int32_t status;
+        int32_t kind;
+        union {
+            int64_t i64;
+            double f64;
+            uint64_t size;
+        } value;
+    };
+
+    struct AudioTrackSnapshot {
+        char title[512];
+        char artist[512];
+        char album[512];
+        char albumArtist[512];
+        int32_t trackNumber;
+        int32_t playbackStatus;
+        int64_t durationSeconds;
+        int64_t positionSeconds;
+        uint64_t thumbnailHandle;
+    };
+
+    struct AudioBorrowedText {
+        const char* text;
+        uint64_t length;
+    };
+
+    struct AudioSimulationProfile {
+        int64_t latencyMicros[6];
+        int64_t jitterMicros[6];
+        double eventRate;
+        uint64_t thumbnailBytes;
+        uint64_t seed;
+    };
+
+    AudioResult createSimulatedAudioManagerV2(const AudioSimulationProfile* profile, void** outManager);
+    void destroyAudioManager(void* managerPtr);
+    AudioResult initializeV2(void* managerPtr);
+    AudioResult getDurationV2(void* managerPtr);
+    AudioResult getCurrentPositionV2(void* managerPtr);
+    AudioResult getCurrentPositionPreciseV2(void* managerPtr);
+    AudioResult getTitleV2(void* managerPtr, char* buffer, uint64_t capacity);
+    AudioResult getArtistV2(void* managerPtr, char* buffer, uint64_t capacity);
+    AudioResult getAlbumV2(void* managerPtr, char* buffer, uint64_t capacity);
+    AudioResult borrowTitleV2(void* managerPtr, AudioBorrowedText* outText);
+    AudioResult getTitleUtf16V2(void* managerPtr, char16_t* buffer, uint64_t capacity);
+    AudioResult getSnapshotV2(void* managerPtr, AudioTrackSnapshot* outSnapshot);
+    AudioResult getThumbnailBytesV2(void* managerPtr, uint8_t* buffer, uint64_t capacity);
+    AudioResult playV2(void* managerPtr);
+    AudioResult pauseV2(void* managerPtr);
+    AudioResult nextV2(void* managerPtr);
+    AudioResult seekV2(void* managerPtr, int64_t seconds);
+    AudioResult setVolumeV2(void* managerPtr, double volume);
+    AudioResult getVolumeV2(void* managerPtr);
+}
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int SchemaVersion = 1;
+    constexpr int32_t AudioOk = 0;
+
+    struct Options {
+        unsigned threads{ std::clamp(std::thread::hardware_concurrency(), 2u, 8u) };
+        uint64_t iterations{ 20000 };
+        uint64_t warmup{ 1000 };
+        int64_t latencyMicros{ 0 };
+        int64_t jitterMicros{ 0 };
+        double eventRate{ 0.0 };
+        uint64_t thumbnailBytes{ 64 * 1024 };
+        uint64_t seed{ 1 };
+        std::string label;
+        std::string output;
+        std::string trace;
+    };
+
+    // Per calling thread: scratch buffers the C layer writes into, so no case allocates for them.
+    struct Scratch {
+        std::vector<char> text = std::vector<char>(512);
+        std::vector<char16_t> utf16 = std::vector<char16_t>(512);
+        std::vector<uint8_t> bytes;
+        AudioTrackSnapshot snapshot{};
+        uint64_t counter{ 0 };
+    };
+
+    // One timed call; false counts as an error rather than stopping the run.
+    using Operation = std::function<bool(Scratch&)>;
+
+    struct Case {
+        std::string api;
+        Operation call;
+    };
+
+    struct Result {
+        std::string layer;
+        std::string api;
+        unsigned threads{ 0 };
+        uint64_t operations{ 0 };
+        uint64_t errors{ 0 };
+        double seconds{ 0.0 };
+        double throughput{ 0.0 };
+        int64_t meanNanos{ 0 };
+        int64_t p50Nanos{ 0 };
+        int64_t p99Nanos{ 0 };
+        int64_t p999Nanos{ 0 };
+        int64_t maxNanos{ 0 };
+    };
+
+    // Nearest-rank percentile of a sorted sample.
+    int64_t percentile(const std::vector<int64_t>& sorted, double fraction) {
+        if (sorted.empty())
+            return 0;
+        const auto rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size()) + 0.999999);
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    Result measure(const std::string& layer, const Case& benchmark, unsigned threads, const Options& options) {
+        std::vector<std::vector<int64_t>> samples(threads);
+        std::vector<uint64_t> errors(threads, 0);
+        Clock::time_point started;
+        // Every thread warms up, then all start timing together; the completion step stamps the start.
+        std::barrier ready(static_cast<std::ptrdiff_t>(threads), [&started]() noexcept { started = Clock::now(); });
+
+        auto worker = [&](unsigned index) {
+            Scratch scratch;
+            scratch.bytes.resize(options.thumbnailBytes);
+            scratch.counter = index;
+            auto& latencies = samples[index];
+            latencies.reserve(options.iterations);
+            for (uint64_t i = 0; i < options.warmup; ++i)
+                benchmark.call(scratch);
+            ready.arrive_and_wait();
+            for (uint64_t i = 0; i < options.iterations; ++i) {
+                const auto begin = Clock::now();
+                const bool ok = benchmark.call(scratch);
+                const auto end = Clock::now();
+                latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+                if (!ok)
+                    ++errors[index];
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (unsigned t = 1; t < threads; ++t)
+            pool.emplace_back(worker, t);
+        worker(0);
+        for (auto& thread : pool)
+            thread.join();
+        const auto finished = Clock::now();
+
+        std::vector<int64_t> all;
+        all.reserve(static_cast<size_t>(options.iterations) * threads);
+        for (const auto& latencies : samples)
+            all.insert(all.end(), latencies.begin(), latencies.end());
+        std::sort(all.begin(), all.end());
+
+        Result result;
+        result.layer = layer;
+        result.api = benchmark.api;
+        result.threads = threads;
+        result.operations = all.size();
+        for (auto count : errors)
+            result.errors += count;
+        result.seconds = std::chrono::duration<double>(finished - started).count();
+        result.throughput = result.seconds > 0.0 ? static_cast<double>(result.operations) / result.seconds : 0.0;
+        if (!all.empty()) {
+            long double total = 0;
+            for (auto value : all)
+                total += value;
+            result.meanNanos = static_cast<int64_t>(total / all.size());
+            result.maxNanos = all.back();
+        }
+        result.p50Nanos = percentile(all, 0.50);
+        result.p99Nanos = percentile(all, 0.99);
+        result.p999Nanos = percentile(all, 0.999);
+        return result;
+    }
+
+    // Alternating values keep the setters from being no-ops, and seeks away from the end.
+    double nextVolume(Scratch& scratch) {
+        return (scratch.counter++ & 1) ? 0.25 : 0.75;
+    }
+
+    int64_t nextSeek(Scratch& scratch) {
+        return static_cast<int64_t>(scratch.counter++ % 120);
+    }
+
+    template <typename Manager>
+    std::vector<Case> managerCases(Manager& manager) {
+        std::vector<Case> cases{
+            { "getTitle", [&](Scratch&) { return manager.getTitle().has_value(); } },
+            { "getArtist", [&](Scratch&) { return manager.getArtist().has_value(); } },
+            { "getAlbum", [&](Scratch&) { return manager.getAlbum().has_value(); } },
+            { "getDuration", [&](Scratch&) { return manager.getDuration().has_value(); } },
+            { "getCurrentPosition", [&](Scratch&) { return manager.getCurrentPosition().has_value(); } },
+            { "getCurrentPositionPrecise", [&](Scratch&) { return manager.getCurrentPositionPrecise().has_value(); } },
+            { "getTrackSnapshot", [&](Scratch&) { return manager.getTrackSnapshot().has_value(); } },
+            { "getThumbnail", [&](Scratch&) { return manager.getThumbnail().has_value(); } },
+            { "getVolume", [&](Scratch&) { return manager.getVolume().has_value(); } },
+            { "setVolume", [&](Scratch& s) { return manager.setVolume(nextVolume(s)).has_value(); } },
+            { "play", [&](Scratch&) { return manager.play().has_value(); } },
+            { "pause", [&](Scratch&) { return manager.pause().has_value(); } },
+            { "seek", [&](Scratch& s) { return manager.seek(std::chrono::seconds(nextSeek(s))).has_value(); } },
+            { "next", [&](Scratch&) { return manager.next().has_value(); } },
+        };
+        // Only the full manager interns; the text stays pooled for the whole run.
+        if constexpr (requires { manager.getTitleView(); })
+            cases.insert(cases.begin() + 1, { "getTitleView", [&](Scratch&) { return manager.getTitleView().has_value(); } });
+        return cases;
+    }
+
+    std::vector<Case> abiCases(void* manager) {
+        auto ok = [](const AudioResult& result) { return result.status == AudioOk; };
+        return {
+            { "getTitle", [=](Scratch& s) { return ok(getTitleV2(manager, s.text.data(), s.text.size())); } },
+            { "getTitleUtf16", [=](Scratch& s) { return ok(getTitleUtf16V2(manager, s.utf16.data(), s.utf16.size())); } },
+            { "borrowTitle", [=](Scratch&) { AudioBorrowedText text; return ok(borrowTitleV2(manager, &text)); } },
+            { "getArtist", [=](Scratch& s) { return ok(getArtistV2(manager, s.text.data(), s.text.size())); } },
+            { "getAlbum", [=](Scratch& s) { return ok(getAlbumV2(manager, s.text.data(), s.text.size())); } },
+            { "getDuration", [=](Scratch&) { return ok(getDurationV2(manager)); } },
+            { "getCurrentPosition", [=](Scratch&) { return ok(getCurrentPositionV2(manager)); } },
+            { "getCurrentPositionPrecise", [=](Scratch&) { return ok(getCurrentPositionPreciseV2(manager)); } },
+            { "getTrackSnapshot", [=](Scratch& s) { return ok(getSnapshotV2(manager, &s.snapshot)); } },
+            { "getThumbnail", [=](Scratch& s) { return ok(getThumbnailBytesV2(manager, s.bytes.data(), s.bytes.size())); } },
+            { "getVolume", [=](Scratch&) { return ok(getVolumeV2(manager)); } },
+            { "setVolume", [=](Scratch& s) { return ok(setVolumeV2(manager, nextVolume(s))); } },
+            { "play", [=](Scratch&) { return ok(playV2(manager)); } },
+            { "pause", [=](Scratch&) { return ok(pauseV2(manager)); } },
+            { "seek", [=](Scratch& s) { return ok(seekV2(manager, nextSeek(s))); } },
+            { "next", [=](Scratch&) { return ok(nextV2(manager)); } },
+        };
+    }
+
+    audio::platform::SimulationProfile makeProfile(const Options& options) {
+        audio::platform::SimulationProfile profile;
+        for (auto& latency : profile.latency) {
+            latency.base = std::chrono::microseconds(options.latencyMicros);
+            latency.jitter = std::chrono::microseconds(options.jitterMicros);
+        }
+        profile.eventRate = options.eventRate;
+        profile.thumbnailBytes = static_cast<size_t>(options.thumbnailBytes);
+        profile.seed = options.seed;
+        return profile;
+    }
+
+    AudioSimulationProfile makeAbiProfile(const Options& options) {
+        AudioSimulationProfile profile{};
+        for (size_t i = 0; i < audio::platform::SimulatedOperationCount; ++i) {
+            profile.latencyMicros[i] = options.latencyMicros;
+            profile.jitterMicros[i] = options.jitterMicros;
+        }
+        profile.eventRate = options.eventRate;
+        profile.thumbnailBytes = options.thumbnailBytes;
+        profile.seed = options.seed;
+        return profile;
+    }
+
+    void runLayer(const std::string& layer, const std::vector<Case>& cases, const Options& options, std::vector<Result>& results) {
+        std::vector<unsigned> threadCounts{ 1 };
+        if (options.threads > 1)
+            threadCounts.push_back(options.threads);
+        for (const auto& benchmark : cases) {
+            for (auto threads : threadCounts) {
+                auto result = measure(layer, benchmark, threads, options);
+                std::printf("%-7s %-26s %3u %14.0f %10lld %10lld %10lld %10lld %8llu\n",
+                    result.layer.c_str(), result.api.c_str(), result.threads, result.throughput,
+                    static_cast<long long>(result.p50Nanos), static_cast<long long>(result.p99Nanos),
+                    static_cast<long long>(result.p999Nanos), static_cast<long long>(result.maxNanos),
+                    static_cast<unsigned long long>(result.errors));
+                std::fflush(stdout);
+                results.push_back(std::move(result));
+            }
+        }
+    }
+
+    std::string escape(std::string_view text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+                escaped += code;
+            }
+            else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    std::string timestamp() {
+        const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::tm utc{};
+#ifdef _WIN32
+        gmtime_s(&utc, &now);
+#else
+        gmtime_r(&now, &utc);
+#endif
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        return text;
+    }
+
+    bool writeJson(const std::string& path, const Options& options, const std::vector<Result>& results) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out)
+            return false;
+        out << "{\n";
+        out << "  \"schema\": " << SchemaVersion << ",\n";
+        out << "  \"label\": \"" << escape(options.label) << "\",\n";
+        out << "  \"timestamp\": \"" << timestamp() << "\",\n";
+        out << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "  \"configuration\": {\n";
+        out << "    \"threads\": " << options.threads << ",\n";
+        out << "    \"iterations\": " << options.iterations << ",\n";
+        out << "    \"warmup\": " << options.warmup << ",\n";
+        out << "    \"latencyMicros\": " << options.latencyMicros << ",\n";
+        out << "    \"jitterMicros\": " << options.jitterMicros << ",\n";
+        out << "    \"eventRate\": " << options.eventRate << ",\n";
+        out << "    \"thumbnailBytes\": " << options.thumbnailBytes << ",\n";
+        out << "    \"seed\": " << options.seed << "\n";
+        out << "  },\n";
+        out << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            out << "    { \"layer\": \"" << r.layer << "\", \"api\": \"" << r.api << "\", \"threads\": " << r.threads
+                << ", \"operations\": " << r.operations << ", \"errors\": " << r.errors
+                << ", \"seconds\": " << r.seconds << ", \"throughputPerSecond\": " << static_cast<uint64_t>(r.throughput)
+                << ", \"meanNanos\": " << r.meanNanos << ", \"p50Nanos\": " << r.p50Nanos
+                << ", \"p99Nanos\": " << r.p99Nanos << ", \"p999Nanos\": " << r.p999Nanos
+                << ", \"maxNanos\": " << r.maxNanos << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n";
+        out << "}\n";
+        return static_cast<bool>(out);
+    }
+
+    template<typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = true;
+            if (name == "--threads")
+                parsed = parseNumber(value, options.threads) && options.threads > 0;
+            else if (name == "--iterations")
+                parsed = parseNumber(value, options.iterations) && options.iterations > 0;
+            else if (name == "--warmup")
+                parsed = parseNumber(value, options.warmup);
+            else if (name == "--latency-us")
+                parsed = parseNumber(value, options.latencyMicros) && options.latencyMicros >= 0;
+            else if (name == "--jitter-us")
+                parsed = parseNumber(value, options.jitterMicros) && options.jitterMicros >= 0;
+            else if (name == "--event-rate")
+                parsed = parseNumber(value, options.eventRate) && options.eventRate >= 0.0;
+            else if (name == "--thumbnail-bytes")
+                parsed = parseNumber(value, options.thumbnailBytes);
+            else if (name == "--seed")
+                parsed = parseNumber(value, options.seed);
+            else if (name == "--label")
+                options.label = value;
+            else if (name == "--output")
+                options.output = value;
+            else if (name == "--trace")
+                options.trace = value;
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    if (!options.trace.empty()) {
+        if (auto started = audio::Tracer::start(options.trace); !started) {
+            std::fprintf(stderr, "Could not start the trace: %s\n", started.error().message().c_str());
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    std::printf("%-7s %-26s %3s %14s %10s %10s %10s %10s %8s\n",
+        "layer", "api", "thr", "ops/s", "p50 ns", "p99 ns", "p999 ns", "max ns", "errors");
+
+    {
+        audio::AudioTrackManager manager(std::make_shared<audio::platform::SimulatedAudioSession>(makeProfile(options)));
+        if (auto initialized = manager.initialize(); !initialized) {
+            std::fprintf(stderr, "C++ layer failed to initialize: %s\n", initialized.error().message().c_str());
+            return 1;
+        }
+        runLayer("cpp", managerCases(manager), options, results);
+    }
+
+    {
+        audio::BasicAudioTrackManager<std::shared_ptr<audio::IAudioSession>> manager(
+            std::make_shared<audio::platform::SimulatedAudioSession>(makeProfile(options)));
+        if (auto initialized = manager.initialize(); !initialized) {
+            std::fprintf(stderr, "Virtual layer failed to initialize: %s\n", initialized.error().message().c_str());
+            return 1;
+        }
+        runLayer("virtual", managerCases(manager), options, results);
+    }
+
+    {
+        audio::BasicAudioTrackManager<audio::platform::SimulatedAudioSession> manager(makeProfile(options));
+        if (auto initialized = manager.initialize(); !initialized) {
+            std::fprintf(stderr, "Static layer failed to initialize: %s\n", initialized.error().message().c_str());
+            return 1;
+        }
+        runLayer("static", managerCases(manager), options, results);
+    }
+
+    {
+        const auto profile = makeAbiProfile(options);
+        void* manager = nullptr;
+        if (createSimulatedAudioManagerV2(&profile, &manager).status != AudioOk || initializeV2(manager).status != AudioOk) {
+            std::fprintf(stderr, "C ABI layer failed to initialize\n");
+            destroyAudioManager(manager);
+            return 1;
+        }
+        runLayer("c", abiCases(manager), options, results);
+        destroyAudioManager(manager);
+    }
+
+    const auto trace = audio::Tracer::stats();
+    audio::Tracer::stop();
+    if (trace.recorded > 0)
+        std::printf("trace: %llu spans, %llu dropped\n",
+            static_cast<unsigned long long>(trace.recorded), static_cast<unsigned long long>(trace.dropped));
+
+    if (!options.output.empty() && !writeJson(options.output, options, results)) {
+        std::fprintf(stderr, "Could not write %s\n", options.output.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,242 @@
+// Behaviour checks of audio::CommandQueue over audio::platform::ScriptedAudioSession.
+//
+// The worker is held inside a first volume change (its listener waits on a gate) while the
+// rest is queued behind it, so what folds is fixed rather than left to timing. Seeks must fold
+// into the waiting seek but never across a next track, volume changes must fold into the
+// waiting one across play and pause, and every caller must complete, in execution order, with
+// the result of the value actually applied. Then --threads threads queue --commands seeks and
+// volume changes each behind a held worker: every caller must succeed, the newest value must win,
+// and submitted must equal executed plus coalesced. The first mismatch is printed and the run
+// fails.
+//
+// Build it from this file, CommandQueue.cpp and the sources listed in SessionCacheBenchmark.cpp.
+//
+//     CommandQueueBenchmark [--threads N] [--commands N]
+
+#include "CommandQueue.h"
+#include "ScriptedAudioSession.h"
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using namespace std::chrono_literals;
+    using audio::AsyncResult;
+    using audio::CommandQueue;
+    using audio::platform::ScriptedAudioSession;
+
+    struct Options {
+        uint64_t threads{ 8 };
+        uint64_t commands{ 500 };
+    };
+
+    bool failed = false;
+
+    bool expect(bool condition, const char* test, const char* what) {
+        if (!condition && !failed) {
+            std::fprintf(stderr, "%s: %s\n", test, what);
+            failed = true;
+        }
+        return condition;
+    }
+
+    // Holds the worker inside the volume change to HeldVolume until released. Volumes that are
+    // applied are exact in a float, which is what the endpoint keeps.
+    constexpr double HeldVolume = 0.125;
+
+    struct Gate {
+        std::mutex mutex;
+        std::condition_variable changed;
+        bool entered{ false };
+        bool released{ false };
+
+        void enter() {
+            std::unique_lock lock(mutex);
+            entered = true;
+            changed.notify_all();
+            changed.wait(lock, [this] { return released; });
+        }
+
+        bool waitEntered() {
+            std::unique_lock lock(mutex);
+            return changed.wait_for(lock, 5s, [this] { return entered; });
+        }
+
+        void release() {
+            {
+                std::scoped_lock lock(mutex);
+                released = true;
+            }
+            changed.notify_all();
+        }
+    };
+
+    struct Fixture {
+        std::shared_ptr<ScriptedAudioSession> session{ std::make_shared<ScriptedAudioSession>() };
+        Gate gate;
+        std::mutex mutex;
+        std::vector<double> volumes;
+
+        Fixture() {
+            (void)session->initialize();
+            audio::PlaybackState paused;
+            paused.status = audio::PlaybackStatus::Paused;
+            session->setPlaybackInfo(paused);
+            session->subscribeVolumeChanged([this](double volume, bool) {
+                {
+                    std::scoped_lock lock(mutex);
+                    volumes.push_back(volume);
+                }
+                if (volume == HeldVolume)
+                    gate.enter();
+            });
+        }
+    };
+
+    void ordered(const Options&) {
+        Fixture fixture;
+        CommandQueue queue(fixture.session);
+        std::mutex mutex;
+        std::condition_variable done;
+        std::vector<std::string> completed;
+        std::vector<AsyncResult<void>> results;
+        // Completions are logged by continuations, which run on the worker after get() wakes.
+        const auto track = [&](AsyncResult<void> result, std::string label) {
+            result.then([&, label](const std::expected<void, audio::AudioError>& outcome) {
+                {
+                    std::scoped_lock lock(mutex);
+                    completed.push_back(outcome ? label : label + " failed");
+                }
+                done.notify_all();
+            });
+            results.push_back(std::move(result));
+        };
+
+        track(queue.setVolume(HeldVolume), "held");
+        expect(fixture.gate.waitEntered(), "ordered", "the worker never reached the held command");
+        track(queue.submit(CommandQueue::Kind::Play), "play");
+        track(queue.setVolume(0.2), "volume 0.2");
+        track(queue.submit(CommandQueue::Kind::Pause), "pause");
+        track(queue.seek(std::chrono::seconds(10)), "seek 10");
+        track(queue.setVolume(0.3), "volume 0.3");
+        track(queue.seek(std::chrono::seconds(20)), "seek 20");
+        track(queue.submit(CommandQueue::Kind::Next), "next");
+        track(queue.seek(std::chrono::seconds(30)), "seek 30");
+        track(queue.setVolume(0.75), "volume 0.75");
+        fixture.gate.release();
+
+        const std::vector<std::string> expected{ "held", "play", "volume 0.2", "volume 0.3", "volume 0.75", "pause", "seek 10", "seek 20", "next", "seek 30" };
+        std::unique_lock lock(mutex);
+        expect(done.wait_for(lock, 5s, [&] { return completed.size() == results.size(); }), "ordered", "a caller never completed");
+        expect(completed == expected, "ordered", "commands did not fold or complete in order");
+        {
+            std::scoped_lock volumes(fixture.mutex);
+            expect(fixture.volumes == std::vector<double>{ HeldVolume, 0.75 }, "ordered", "a folded volume reached the session");
+        }
+        expect(fixture.session->getCurrentPosition().value_or(std::chrono::seconds(-1)) == std::chrono::seconds(30), "ordered", "the last seek did not win");
+        const auto stats = queue.stats();
+        expect(stats.submitted == 10 && stats.executed == 7 && stats.coalesced == 3, "ordered", "wrong counters");
+    }
+
+    void manyCallers(const Options& options) {
+        Fixture fixture;
+        CommandQueue queue(fixture.session);
+        auto held = queue.setVolume(HeldVolume);
+        expect(fixture.gate.waitEntered(), "many callers", "the worker never reached the held command");
+
+        std::vector<std::vector<AsyncResult<void>>> results(options.threads);
+        std::vector<std::thread> threads;
+        for (uint64_t t = 0; t < options.threads; ++t) {
+            threads.emplace_back([&, t] {
+                for (uint64_t i = 0; i < options.commands; ++i) {
+                    results[t].push_back(queue.seek(std::chrono::seconds(static_cast<int64_t>(t * options.commands + i))));
+                    results[t].push_back(queue.setVolume(static_cast<double>(i % 100) / 200.0));
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        // Queued last, so these are the values the folded commands must end with.
+        auto lastSeek = queue.seek(std::chrono::seconds(12345));
+        auto lastVolume = queue.setVolume(0.75);
+        fixture.gate.release();
+
+        bool allDone = bool(held.get()) && bool(lastSeek.get()) && bool(lastVolume.get());
+        for (auto& mine : results) {
+            for (auto& result : mine)
+                allDone &= bool(result.get());
+        }
+        expect(allDone, "many callers", "a caller did not complete successfully");
+        expect(fixture.session->getCurrentPosition().value_or(std::chrono::seconds(-1)) == std::chrono::seconds(12345), "many callers", "the newest seek did not win");
+        expect(fixture.session->getVolume().value_or(-1.0) == 0.75, "many callers", "the newest volume did not win");
+        const auto stats = queue.stats();
+        expect(stats.submitted == stats.executed + stats.coalesced, "many callers", "submitted does not match executed plus coalesced");
+        expect(stats.executed == 3, "many callers", "commands queued behind the held one were not folded");
+        std::printf("%llu commands from %llu threads ran as %llu, max wait %lld us\n", static_cast<unsigned long long>(stats.submitted),
+            static_cast<unsigned long long>(options.threads), static_cast<unsigned long long>(stats.executed), static_cast<long long>(stats.maxWait.count()));
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = false;
+            if (name == "--threads")
+                parsed = parseNumber(value, options.threads) && options.threads > 0;
+            else if (name == "--commands")
+                parsed = parseNumber(value, options.commands);
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    const struct {
+        const char* name;
+        void (*run)(const Options&);
+    } cases[] = {
+        { "ordered", ordered },
+        { "many callers", manyCallers },
+    };
+    for (const auto& test : cases) {
+        test.run(options);
+        if (failed) {
+            std::printf("FAILED: %s\n", test.name);
+            return 1;
+        }
+        std::printf("ok: %s\n", test.name);
+    }
+    return 0;
+}
@@ -0,0 +1,245 @@
+// Behaviour checks and throughput of audio::EventQueue, the lock-free session event ring.
+//
+// On one thread, events must come out in push order with sequences 1, 2, 3..., the capacity
+// must round up to a power of two, and a full ring must drop its oldest events, count each
+// overflow and leave a sequence gap exactly as wide as what it dropped; wait() must time out on
+// an empty ring and wake for a push. Then --producers threads push --events events each into
+// a --capacity ring while --consumers threads poll it: every consumer must see sequences only
+// increase, no sequence may be seen twice or fall outside what was pushed, and what was
+// delivered plus what was dropped must add up to what was pushed. With a single consumer, the
+// gaps it sees must add up to the dropped count. The first mismatch is printed and the run
+// fails.
+//
+// Build it from this file and EventQueue.cpp.
+//
+//     EventQueueBenchmark [--producers N] [--consumers N] [--events N] [--capacity N]
+
+#include "EventQueue.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using namespace std::chrono_literals;
+    using Clock = std::chrono::steady_clock;
+    using audio::EventQueue;
+    using audio::SessionEvent;
+
+    struct Options {
+        uint64_t producers{ 4 };
+        uint64_t consumers{ 2 };
+        uint64_t events{ 100000 };
+        uint64_t capacity{ 64 };
+    };
+
+    bool failed = false;
+
+    bool expect(bool condition, const char* test, const char* what) {
+        if (!condition && !failed) {
+            std::fprintf(stderr, "%s: %s\n", test, what);
+            failed = true;
+        }
+        return condition;
+    }
+
+    SessionEvent::Kind kindOf(uint64_t i) {
+        return static_cast<SessionEvent::Kind>(i % 3 + 1);
+    }
+
+    void inOrder(const Options&) {
+        EventQueue queue(5);
+        expect(queue.stats().capacity == 8, "in order", "capacity was not rounded up to a power of two");
+        expect(EventQueue(0).stats().capacity == 2, "in order", "a zero capacity was not raised to two");
+        for (uint64_t i = 0; i < 6; ++i)
+            queue.push(kindOf(i));
+        std::array<SessionEvent, 4> buffer{};
+        size_t seen = 0;
+        bool wrong = false;
+        while (const auto count = queue.poll(buffer)) {
+            for (size_t i = 0; i < count; ++i, ++seen)
+                wrong |= buffer[i].sequence != seen + 1 || buffer[i].kind != kindOf(seen) || buffer[i].timestampMicros == 0;
+        }
+        expect(seen == 6 && !wrong, "in order", "events did not come out as pushed");
+        const auto stats = queue.stats();
+        expect(stats.pushed == 6 && stats.delivered == 6 && stats.overflows == 0 && stats.dropped == 0, "in order", "wrong counters");
+    }
+
+    void overflow(const Options&) {
+        EventQueue queue(8);
+        for (uint64_t i = 0; i < 20; ++i)
+            queue.push(kindOf(i));
+        std::array<SessionEvent, 16> buffer{};
+        const auto count = queue.poll(buffer);
+        expect(count == 8, "overflow", "a full ring did not keep exactly its capacity");
+        bool newest = count == 8;
+        for (size_t i = 0; i < count; ++i)
+            newest &= buffer[i].sequence == 13 + i;
+        expect(newest, "overflow", "the oldest events were not the ones dropped");
+        const auto stats = queue.stats();
+        expect(stats.overflows == 12 && stats.dropped == 12, "overflow", "overflows were not counted once each");
+        expect(stats.pushed == 20 && stats.delivered == 8, "overflow", "wrong counters");
+    }
+
+    void waiting(const Options&) {
+        EventQueue queue;
+        const auto started = Clock::now();
+        expect(!queue.wait(20ms), "wait", "an empty ring reported events");
+        expect(Clock::now() - started >= 20ms, "wait", "wait returned before its timeout");
+        std::thread producer([&] {
+            std::this_thread::sleep_for(20ms);
+            queue.push(SessionEvent::Kind::TrackChanged);
+        });
+        expect(queue.wait(5s), "wait", "a push did not wake the waiter");
+        producer.join();
+        std::array<SessionEvent, 1> buffer{};
+        expect(queue.poll(buffer) == 1 && buffer[0].kind == SessionEvent::Kind::TrackChanged, "wait", "the event the waiter woke for is missing");
+    }
+
+    void stress(const Options& options, uint64_t consumers, const char* test) {
+        EventQueue queue(options.capacity);
+        std::atomic<uint64_t> producing{ options.producers };
+        std::vector<std::vector<uint64_t>> seen(consumers);
+        std::atomic<bool> backwards{ false };
+
+        const auto started = Clock::now();
+        std::vector<std::thread> threads;
+        for (uint64_t c = 0; c < consumers; ++c) {
+            threads.emplace_back([&, c] {
+                std::array<SessionEvent, 32> buffer{};
+                uint64_t last = 0;
+                for (;;) {
+                    // Read before polling: once every producer is done, an empty poll is final.
+                    const bool done = producing.load() == 0;
+                    const auto count = queue.poll(buffer);
+                    for (size_t i = 0; i < count; ++i) {
+                        if (buffer[i].sequence <= last)
+                            backwards.store(true);
+                        last = buffer[i].sequence;
+                        seen[c].push_back(last);
+                    }
+                    if (count != 0)
+                        continue;
+                    if (done)
+                        return;
+                    queue.wait(1ms);
+                }
+            });
+        }
+        for (uint64_t p = 0; p < options.producers; ++p) {
+            threads.emplace_back([&] {
+                for (uint64_t i = 0; i < options.events; ++i)
+                    queue.push(kindOf(i));
+                producing.fetch_sub(1);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        const auto seconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+        const auto stats = queue.stats();
+        const auto total = options.producers * options.events;
+        std::vector<uint64_t> all;
+        for (const auto& mine : seen)
+            all.insert(all.end(), mine.begin(), mine.end());
+        std::sort(all.begin(), all.end());
+
+        expect(!backwards.load(), test, "a consumer saw a sequence go backwards");
+        expect(std::adjacent_find(all.begin(), all.end()) == all.end(), test, "an event was delivered twice");
+        expect(all.empty() || (all.front() >= 1 && all.back() <= total), test, "a sequence outside what was pushed");
+        expect(stats.pushed == total, test, "pushes were not all counted");
+        expect(stats.delivered == all.size(), test, "delivered does not match what consumers saw");
+        expect(stats.delivered + stats.dropped == total, test, "delivered plus dropped does not match pushed");
+        if (consumers == 1) {
+            uint64_t gaps = 0;
+            uint64_t last = 0;
+            for (const auto sequence : seen.front()) {
+                gaps += sequence - last - 1;
+                last = sequence;
+            }
+            gaps += total - last;
+            expect(gaps == stats.dropped, test, "the sequence gaps do not match the dropped count");
+        }
+        std::printf("%llu producers, %llu consumers, capacity %zu: %llu events in %.2f s (%.1f M/s), %llu overflows, %llu dropped\n",
+            static_cast<unsigned long long>(options.producers), static_cast<unsigned long long>(consumers), stats.capacity,
+            static_cast<unsigned long long>(total), seconds, static_cast<double>(total) / seconds / 1e6,
+            static_cast<unsigned long long>(stats.overflows), static_cast<unsigned long long>(stats.dropped));
+    }
+
+    void manyConsumers(const Options& options) {
+        stress(options, options.consumers, "many consumers");
+    }
+
+    void oneConsumer(const Options& options) {
+        stress(options, 1, "one consumer");
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = false;
+            if (name == "--producers")
+                parsed = parseNumber(value, options.producers) && options.producers > 0;
+            else if (name == "--consumers")
+                parsed = parseNumber(value, options.consumers) && options.consumers > 0;
+            else if (name == "--events")
+                parsed = parseNumber(value, options.events);
+            else if (name == "--capacity")
+                parsed = parseNumber(value, options.capacity);
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    const struct {
+        const char* name;
+        void (*run)(const Options&);
+    } cases[] = {
+        { "in order", inOrder },
+        { "overflow", overflow },
+        { "wait", waiting },
+        { "many consumers", manyConsumers },
+        { "one consumer", oneConsumer },
+    };
+    for (const auto& test : cases) {
+        test.run(options);
+        if (failed) {
+            std::printf("FAILED: %s\n", test.name);
+            return 1;
+        }
+        std::printf("ok: %s\n", test.name);
+    }
+    return 0;
+}
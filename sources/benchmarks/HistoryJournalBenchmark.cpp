@@ -0,0 +1,294 @@
+// Recovery checks and throughput of audio::HistoryJournal and audio::HistoryReader.
+//
+// Each recovery case writes a journal, damages it the way a crash or a stray file would, and
+// reopens it: a partial last record, a corrupted checksum in the middle, a zero-filled tail,
+// a file that is not a journal at all, and a reader that was opened before recovery cut the
+// tail. The records that survive, the recovered and truncated counts and the file size must
+// be exactly what the damage calls for; the first mismatch is printed and the run fails.
+//
+// Then --threads threads append --records records each, through one journal, and a reader
+// checks that every record arrived once and each thread's records kept their order, and times
+// a play-count scan over all of them.
+//
+// Build it from this file, HistoryJournal.cpp and AudioError.cpp.
+//
+//     HistoryJournalBenchmark [--dir PATH] [--threads N] [--records N]
+
+#include "HistoryJournal.h"
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint64_t HeaderSize = 16;
+    constexpr uint64_t RecordSize = sizeof(audio::HistoryRecord);
+
+    struct Options {
+        std::filesystem::path dir{ std::filesystem::temp_directory_path() / "history-journal-benchmark" };
+        uint64_t threads{ 4 };
+        uint64_t records{ 250000 };
+    };
+
+    bool failed = false;
+
+    bool expect(bool condition, const char* test, const char* what) {
+        if (!condition && !failed) {
+            std::fprintf(stderr, "%s: %s\n", test, what);
+            failed = true;
+        }
+        return condition;
+    }
+
+    audio::HistoryRecord record(uint64_t n) {
+        audio::HistoryRecord value;
+        value.startedMicros = static_cast<int64_t>(1'700'000'000'000'000 + n * 1000);
+        value.trackId = n * 0x9E3779B97F4A7C15ull;
+        value.playedMillis = static_cast<uint32_t>(n % 400000);
+        value.durationSeconds = static_cast<uint32_t>(n % 600);
+        value.outcome = n % 3 == 0 ? audio::PlayOutcome::Skipped : audio::PlayOutcome::Completed;
+        return value;
+    }
+
+    bool same(const audio::HistoryRecord& a, const audio::HistoryRecord& b) {
+        return a.startedMicros == b.startedMicros && a.trackId == b.trackId && a.playedMillis == b.playedMillis
+            && a.durationSeconds == b.durationSeconds && a.outcome == b.outcome;
+    }
+
+    // A fresh journal at path holding records 0 .. count-1.
+    bool writeJournal(const std::filesystem::path& path, uint64_t count, const char* test) {
+        std::filesystem::remove(path);
+        auto journal = audio::HistoryJournal::open(path);
+        if (!expect(journal.has_value(), test, "could not create the journal"))
+            return false;
+        for (uint64_t n = 0; n < count; ++n)
+            (*journal)->append(record(n));
+        const bool flushed = expect((*journal)->flush().has_value(), test, "flush failed");
+        (*journal)->close();
+        return flushed && expect(std::filesystem::file_size(path) == HeaderSize + count * RecordSize, test, "unexpected size after writing");
+    }
+
+    void appendBytes(const std::filesystem::path& path, const std::string& bytes) {
+        std::ofstream(path, std::ios::binary | std::ios::app).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    void overwriteByte(const std::filesystem::path& path, uint64_t offset) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(static_cast<std::streamoff>(offset));
+        char byte = 0;
+        file.read(&byte, 1);
+        byte = static_cast<char>(byte ^ 0x5A);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(&byte, 1);
+    }
+
+    // Reopens the journal and checks that records 0 .. survivors-1 are left, truncatedBytes cut.
+    void expectRecovery(const std::filesystem::path& path, uint64_t survivors, uint64_t truncatedBytes, const char* test) {
+        {
+            auto journal = audio::HistoryJournal::open(path);
+            if (!expect(journal.has_value(), test, "reopening failed"))
+                return;
+            const auto stats = (*journal)->stats();
+            expect(stats.recovered == survivors, test, "wrong number of recovered records");
+            expect(stats.truncatedBytes == truncatedBytes, test, "wrong number of truncated bytes");
+        }
+        expect(std::filesystem::file_size(path) == HeaderSize + survivors * RecordSize, test, "file not cut back to its valid records");
+        auto reader = audio::HistoryReader::open(path);
+        if (!expect(reader.has_value(), test, "reader could not open the recovered journal"))
+            return;
+        const auto records = reader->records();
+        if (!expect(records.size() == survivors, test, "reader sees the wrong number of records"))
+            return;
+        for (uint64_t n = 0; n < survivors; ++n) {
+            if (!expect(same(records[n], record(n)), test, "a surviving record changed"))
+                return;
+        }
+    }
+
+    void partialRecord(const Options& options) {
+        const auto path = options.dir / "partial.journal";
+        if (!writeJournal(path, 100, "partial record"))
+            return;
+        auto torn = record(100);
+        torn.checksum = torn.computeChecksum();
+        appendBytes(path, std::string(reinterpret_cast<const char*>(&torn), 13));
+        expectRecovery(path, 100, 13, "partial record");
+    }
+
+    void corruptedChecksum(const Options& options) {
+        const auto path = options.dir / "checksum.journal";
+        if (!writeJournal(path, 100, "corrupted checksum"))
+            return;
+        // Everything after the first bad record belongs to the same torn commit.
+        overwriteByte(path, HeaderSize + 60 * RecordSize + 9);
+        expectRecovery(path, 60, 40 * RecordSize, "corrupted checksum");
+    }
+
+    void zeroTail(const Options& options) {
+        const auto path = options.dir / "zeros.journal";
+        if (!writeJournal(path, 100, "zero-filled tail"))
+            return;
+        // What a file system that extended the file but lost the data leaves behind.
+        appendBytes(path, std::string(3 * 4096, '\0'));
+        expectRecovery(path, 100, 3 * 4096, "zero-filled tail");
+    }
+
+    void foreignHeader(const Options& options) {
+        const auto path = options.dir / "foreign.journal";
+        std::filesystem::remove(path);
+        const std::string text = "These are not the records you are looking for.\n";
+        appendBytes(path, text);
+        auto journal = audio::HistoryJournal::open(path);
+        expect(!journal && journal.error().category() == audio::ErrorCategory::InvalidArgument, "foreign header", "a foreign file was accepted");
+        expect(!audio::HistoryReader::open(path).has_value(), "foreign header", "the reader accepted a foreign file");
+        expect(std::filesystem::file_size(path) == text.size(), "foreign header", "a foreign file was modified");
+    }
+
+    // A reader maps no further than the committed length, so recovery may cut the tail while
+    // it is open; touching a page past the new end would raise SIGBUS.
+    void readerDuringRecovery(const Options& options) {
+        const auto path = options.dir / "reader.journal";
+        if (!writeJournal(path, 100, "reader during recovery"))
+            return;
+        appendBytes(path, std::string(5 * 4096, '\x7F'));
+        auto reader = audio::HistoryReader::open(path);
+        if (!expect(reader.has_value(), "reader during recovery", "reader could not open the damaged journal"))
+            return;
+        expect(reader->records().size() == 100, "reader during recovery", "reader mapped past the committed records");
+        expectRecovery(path, 100, 5 * 4096, "reader during recovery");
+        uint64_t sum = 0;
+        for (const auto& value : reader->records())
+            sum += value.trackId;
+        expect(sum != 0 && reader->playCount(record(7).trackId).plays == 1, "reader during recovery", "reader lost its records");
+    }
+
+    void concurrentAppend(const Options& options) {
+        const auto path = options.dir / "threads.journal";
+        std::filesystem::remove(path);
+        const auto total = options.threads * options.records;
+        auto started = Clock::now();
+        {
+            auto journal = audio::HistoryJournal::open(path);
+            if (!expect(journal.has_value(), "multi-threaded append", "could not create the journal"))
+                return;
+            std::vector<std::thread> threads;
+            for (uint64_t t = 0; t < options.threads; ++t) {
+                threads.emplace_back([&, t] {
+                    for (uint64_t i = 0; i < options.records; ++i) {
+                        auto value = record(i);
+                        value.trackId = t << 32 | i;
+                        (*journal)->append(value);
+                    }
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+            expect((*journal)->flush().has_value(), "multi-threaded append", "flush failed");
+            const auto stats = (*journal)->stats();
+            expect(stats.committed == total, "multi-threaded append", "not every record was committed");
+            const auto seconds = std::chrono::duration<double>(Clock::now() - started).count();
+            std::printf("appended %llu records from %llu threads in %.3f s: %.0f records/s, %llu commits\n",
+                static_cast<unsigned long long>(total), static_cast<unsigned long long>(options.threads), seconds,
+                static_cast<double>(total) / seconds, static_cast<unsigned long long>(stats.commits));
+        }
+
+        auto reader = audio::HistoryReader::open(path);
+        if (!expect(reader.has_value(), "multi-threaded append", "reader could not open the journal"))
+            return;
+        const auto records = reader->records();
+        if (!expect(records.size() == total, "multi-threaded append", "reader sees the wrong number of records"))
+            return;
+        std::vector<uint64_t> next(options.threads, 0);
+        for (const auto& value : records) {
+            const auto thread = value.trackId >> 32;
+            const auto index = value.trackId & 0xFFFFFFFFu;
+            if (!expect(thread < options.threads && index == next[thread], "multi-threaded append", "a record is missing, repeated or out of order"))
+                return;
+            ++next[thread];
+        }
+
+        started = Clock::now();
+        const auto count = reader->playCount(options.records / 2);
+        const auto seconds = std::chrono::duration<double>(Clock::now() - started).count();
+        expect(count.plays == 1, "multi-threaded append", "play count scan found the wrong number of plays");
+        std::printf("scanned %llu records for a play count in %.3f ms: %.0f M records/s\n",
+            static_cast<unsigned long long>(records.size()), seconds * 1e3, static_cast<double>(records.size()) / seconds / 1e6);
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = true;
+            if (name == "--dir")
+                options.dir = std::filesystem::path(value);
+            else if (name == "--threads")
+                parsed = parseNumber(value, options.threads) && options.threads > 0 && options.threads < (1ull << 32);
+            else if (name == "--records")
+                parsed = parseNumber(value, options.records) && options.records < (1ull << 32);
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+    std::error_code error;
+    std::filesystem::create_directories(options.dir, error);
+    if (error) {
+        std::fprintf(stderr, "Cannot create %s\n", options.dir.string().c_str());
+        return 2;
+    }
+
+    const struct {
+        const char* name;
+        void (*run)(const Options&);
+    } cases[] = {
+        { "partial record", partialRecord },
+        { "corrupted checksum", corruptedChecksum },
+        { "zero-filled tail", zeroTail },
+        { "foreign header", foreignHeader },
+        { "reader during recovery", readerDuringRecovery },
+        { "multi-threaded append", concurrentAppend },
+    };
+    for (const auto& test : cases) {
+        test.run(options);
+        if (failed) {
+            std::printf("FAILED: %s\n", test.name);
+            return 1;
+        }
+        std::printf("ok: %s\n", test.name);
+    }
+    std::filesystem::remove_all(options.dir, error);
+    return 0;
+}
@@ -0,0 +1,459 @@
+// Mirror checks and signal latency of audio::platform::MprisAudioSession on a private bus.
+//
+// Starts its own dbus-daemon, so it needs no desktop session and touches no real player, and
+// registers a minimal org.mpris.MediaPlayer2 player on it. A session opened through
+// MprisConnection::open(address) must take the player's state from its GetAll, then follow
+// PropertiesChanged for status, metadata and volume and Seeked for the position, without
+// another bus call. The player keeps changing its title while sessions initialize, --rounds
+// times, and every session must end on the last title the player sent, whichever side of the
+// GetAll reply the signals fell on. Finally the player leaves the bus and the session must
+// report NoSession. The first mismatch is printed and the run fails; the time from a signal
+// leaving the player to the mirror showing it is printed for --signals changes.
+//
+// Build it from this file and the Mpris*, SessionStateCache, TrackChangeWatcher, PlaybackEvents,
+// PlaybackClock, VolumeController, ThumbnailCache, StringPool, Utf16, OperationStats, TickClock,
+// Tracer and AudioError sources, and link libsystemd.
+//
+//     MprisBenchmark [--dbus-daemon PATH] [--rounds N] [--signals N]
+
+#include "MprisAudioSession.h"
+#include "MprisConnection.h"
+#include <systemd/sd-bus.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using namespace std::chrono_literals;
+
+    constexpr const char* PlayerName = "org.mpris.MediaPlayer2.benchmark";
+    constexpr const char* PlayerPath = "/org/mpris/MediaPlayer2";
+    constexpr const char* PlayerInterface = "org.mpris.MediaPlayer2.Player";
+    constexpr const char* PropertiesInterface = "org.freedesktop.DBus.Properties";
+    constexpr auto Patience = 2s;
+
+    struct Options {
+        std::string daemon{ "dbus-daemon" };
+        uint64_t rounds{ 200 };
+        uint64_t signals{ 2000 };
+    };
+
+    bool failed = false;
+
+    bool expect(bool condition, const char* test, const char* what) {
+        if (!condition && !failed) {
+            std::fprintf(stderr, "%s: %s\n", test, what);
+            failed = true;
+        }
+        return condition;
+    }
+
+    // Polls until done() holds or Patience runs out.
+    bool eventually(const std::function<bool()>& done) {
+        const auto deadline = Clock::now() + Patience;
+        while (!done()) {
+            if (Clock::now() > deadline)
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // A session bus of its own, stopped when this goes away.
+    class PrivateBus {
+    public:
+        ~PrivateBus() {
+            if (m_pid > 0) {
+                ::kill(m_pid, SIGTERM);
+                ::waitpid(m_pid, nullptr, 0);
+            }
+        }
+
+        bool start(const std::string& daemon) {
+            int fds[2];
+            if (::pipe(fds) != 0)
+                return false;
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+            posix_spawn_file_actions_addclose(&actions, fds[0]);
+            std::string program = daemon;
+            std::string session = "--session";
+            std::string nofork = "--nofork";
+            std::string print = "--print-address";
+            char* argv[] = { program.data(), session.data(), nofork.data(), print.data(), nullptr };
+            const int spawned = posix_spawnp(&m_pid, program.c_str(), &actions, nullptr, argv, environ);
+            posix_spawn_file_actions_destroy(&actions);
+            ::close(fds[1]);
+            if (spawned != 0) {
+                m_pid = 0;
+                ::close(fds[0]);
+                return false;
+            }
+            char buffer[512];
+            ssize_t length = 0;
+            while (length < static_cast<ssize_t>(sizeof(buffer)) - 1) {
+                const auto read = ::read(fds[0], buffer + length, sizeof(buffer) - 1 - length);
+                if (read <= 0)
+                    break;
+                length += read;
+                if (buffer[length - 1] == '\n')
+                    break;
+            }
+            ::close(fds[0]);
+            m_address.assign(buffer, static_cast<size_t>(std::max<ssize_t>(length, 0)));
+            while (!m_address.empty() && (m_address.back() == '\n' || m_address.back() == '\r'))
+                m_address.pop_back();
+            return !m_address.empty();
+        }
+
+        [[nodiscard]] const std::string& address() const noexcept { return m_address; }
+
+    private:
+        pid_t m_pid{ 0 };
+        std::string m_address;
+    };
+
+    // The least of an MPRIS player: GetAll, and PropertiesChanged and Seeked on demand. Every bus
+    // access and the state it reports hold one mutex; a thread processes incoming calls.
+    class Player {
+    public:
+        ~Player() {
+            m_stopping.store(true, std::memory_order_release);
+            if (m_worker.joinable())
+                m_worker.join();
+            sd_bus_flush_close_unref(m_bus);
+        }
+
+        bool start(const std::string& address) {
+            if (sd_bus_new(&m_bus) < 0 || sd_bus_set_address(m_bus, address.c_str()) < 0
+                || sd_bus_set_bus_client(m_bus, 1) < 0 || sd_bus_start(m_bus) < 0)
+                return false;
+            if (sd_bus_add_object(m_bus, nullptr, PlayerPath, &Player::handle, this) < 0
+                || sd_bus_request_name(m_bus, PlayerName, 0) < 0)
+                return false;
+            m_worker = std::thread([this] {
+                while (!m_stopping.load(std::memory_order_acquire)) {
+                    {
+                        std::scoped_lock lock(m_mutex);
+                        while (sd_bus_process(m_bus, nullptr) > 0) {
+                        }
+                    }
+                    sd_bus_wait(m_bus, 1000);
+                }
+            });
+            return true;
+        }
+
+        void setTitle(std::string title) {
+            std::scoped_lock lock(m_mutex);
+            m_title = std::move(title);
+            ++m_track;
+            emitChanged("Metadata");
+        }
+
+        void setStatus(std::string status) {
+            std::scoped_lock lock(m_mutex);
+            m_status = std::move(status);
+            emitChanged("PlaybackStatus");
+        }
+
+        void setVolume(double volume) {
+            std::scoped_lock lock(m_mutex);
+            m_volume = volume;
+            emitChanged("Volume");
+        }
+
+        void seek(std::chrono::microseconds position) {
+            std::scoped_lock lock(m_mutex);
+            sd_bus_emit_signal(m_bus, PlayerPath, PlayerInterface, "Seeked", "x", static_cast<int64_t>(position.count()));
+        }
+
+        void vanish() {
+            std::scoped_lock lock(m_mutex);
+            sd_bus_release_name(m_bus, PlayerName);
+        }
+
+        [[nodiscard]] std::string title() {
+            std::scoped_lock lock(m_mutex);
+            return m_title;
+        }
+
+    private:
+        sd_bus* m_bus{ nullptr };
+        std::mutex m_mutex;
+        std::thread m_worker;
+        std::atomic<bool> m_stopping{ false };
+        std::string m_title{ "Title 0" };
+        std::string m_status{ "Paused" };
+        double m_volume{ 0.5 };
+        uint64_t m_track{ 0 };
+
+        int appendMetadata(sd_bus_message* message) {
+            const auto trackId = "/benchmark/track/" + std::to_string(m_track);
+            return sd_bus_message_append(message, "a{sv}", 4,
+                "mpris:trackid", "o", trackId.c_str(),
+                "mpris:length", "x", static_cast<int64_t>(240'000'000),
+                "xesam:title", "s", m_title.c_str(),
+                "xesam:artist", "as", 1, "Benchmark");
+        }
+
+        int appendProperty(sd_bus_message* message, std::string_view name) {
+            int r = sd_bus_message_open_container(message, 'e', "sv");
+            if (r >= 0)
+                r = sd_bus_message_append(message, "s", std::string(name).c_str());
+            if (r < 0)
+                return r;
+            if (name == "Metadata") {
+                if ((r = sd_bus_message_open_container(message, 'v', "a{sv}")) >= 0 && (r = appendMetadata(message)) >= 0)
+                    r = sd_bus_message_close_container(message);
+            }
+            else if (name == "PlaybackStatus")
+                r = sd_bus_message_append(message, "v", "s", m_status.c_str());
+            else if (name == "Volume")
+                r = sd_bus_message_append(message, "v", "d", m_volume);
+            else if (name == "Rate")
+                r = sd_bus_message_append(message, "v", "d", 1.0);
+            else if (name == "Position")
+                r = sd_bus_message_append(message, "v", "x", static_cast<int64_t>(0));
+            else
+                r = sd_bus_message_append(message, "v", "b", 1);
+            return r < 0 ? r : sd_bus_message_close_container(message);
+        }
+
+        // Called with m_mutex held.
+        void emitChanged(std::string_view name) {
+            sd_bus_message* message = nullptr;
+            int r = sd_bus_message_new_signal(m_bus, &message, PlayerPath, PropertiesInterface, "PropertiesChanged");
+            if (r >= 0)
+                r = sd_bus_message_append(message, "s", PlayerInterface);
+            if (r >= 0 && (r = sd_bus_message_open_container(message, 'a', "{sv}")) >= 0 && (r = appendProperty(message, name)) >= 0)
+                r = sd_bus_message_close_container(message);
+            if (r >= 0)
+                r = sd_bus_message_append(message, "as", 0);
+            if (r >= 0)
+                sd_bus_send(m_bus, message, nullptr);
+            sd_bus_message_unref(message);
+        }
+
+        // Runs on the worker with m_mutex held.
+        static int handle(sd_bus_message* message, void* userdata, sd_bus_error*) {
+            auto* self = static_cast<Player*>(userdata);
+            if (!sd_bus_message_is_method_call(message, PropertiesInterface, "GetAll"))
+                return 0;
+            sd_bus_message* reply = nullptr;
+            int r = sd_bus_message_new_method_return(message, &reply);
+            if (r >= 0)
+                r = sd_bus_message_open_container(reply, 'a', "{sv}");
+            for (const char* name : { "PlaybackStatus", "Rate", "Volume", "Position", "Metadata", "CanGoNext", "CanGoPrevious",
+                     "CanPlay", "CanPause", "CanSeek", "CanControl" }) {
+                if (r >= 0)
+                    r = self->appendProperty(reply, name);
+            }
+            if (r >= 0)
+                r = sd_bus_message_close_container(reply);
+            if (r >= 0)
+                r = sd_bus_send(self->m_bus, reply, nullptr);
+            sd_bus_message_unref(reply);
+            return r < 0 ? r : 1;
+        }
+    };
+
+    std::shared_ptr<audio::platform::MprisAudioSession> openSession(const std::shared_ptr<audio::platform::MprisConnection>& connection,
+        const std::shared_ptr<audio::ThumbnailCache>& thumbnails) {
+        return std::make_shared<audio::platform::MprisAudioSession>(connection, PlayerName, thumbnails);
+    }
+
+    std::string titleOf(audio::platform::MprisAudioSession& session) {
+        auto title = session.getTitle();
+        return title ? *title : std::string();
+    }
+
+    void followsSignals(Player& player, audio::platform::MprisAudioSession& session) {
+        const char* test = "mirror follows signals";
+        if (!expect(session.initialize().has_value(), test, "initialize failed"))
+            return;
+        expect(titleOf(session) == player.title(), test, "the GetAll title was not taken");
+        auto snapshot = session.getTrackSnapshot();
+        expect(snapshot && snapshot->status == audio::PlaybackStatus::Paused && snapshot->duration == 240s, test,
+            "the GetAll status or length was not taken");
+        auto volume = session.getVolume();
+        expect(volume && *volume == 0.5, test, "the GetAll volume was not taken");
+
+        player.setStatus("Playing");
+        expect(eventually([&] {
+            auto current = session.getTrackSnapshot();
+            return current && current->status == audio::PlaybackStatus::Playing;
+        }), test, "PlaybackStatus did not reach the mirror");
+        player.setStatus("Paused");
+        expect(eventually([&] {
+            auto current = session.getTrackSnapshot();
+            return current && current->status == audio::PlaybackStatus::Paused;
+        }), test, "PlaybackStatus did not reach the mirror");
+
+        player.setTitle("Changed");
+        expect(eventually([&] { return titleOf(session) == "Changed"; }), test, "Metadata did not reach the mirror");
+
+        player.setVolume(0.25);
+        expect(eventually([&] {
+            auto current = session.getVolume();
+            return current && *current == 0.25;
+        }), test, "Volume did not reach the mirror");
+
+        // Paused, so the clock does not move it on from where Seeked put it.
+        player.seek(93'500'000us);
+        expect(eventually([&] {
+            auto position = session.getCurrentPositionPrecise();
+            return position && *position == 93'500ms;
+        }), test, "Seeked did not reach the mirror");
+    }
+
+    // The player sends titles while sessions initialize; each must settle on the last one.
+    void signalsAroundInitialize(const Options& options, Player& player, const std::shared_ptr<audio::platform::MprisConnection>& connection,
+        const std::shared_ptr<audio::ThumbnailCache>& thumbnails) {
+        const char* test = "signals around initialize";
+        uint64_t next = 0;
+        for (uint64_t round = 0; round < options.rounds && !failed; ++round) {
+            auto session = openSession(connection, thumbnails);
+            std::atomic<bool> started{ false };
+            std::thread sender([&] {
+                started.store(true, std::memory_order_release);
+                for (int i = 0; i < 20; ++i)
+                    player.setTitle("Round " + std::to_string(round) + " title " + std::to_string(next++));
+            });
+            while (!started.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            const bool initialized = session->initialize().has_value();
+            sender.join();
+            if (!expect(initialized, test, "initialize failed"))
+                return;
+            const auto last = player.title();
+            if (!expect(eventually([&] { return titleOf(*session) == last; }), test, "the session lost a title sent during initialize"))
+                std::fprintf(stderr, "  round %llu: player sent \"%s\", session shows \"%s\"\n", static_cast<unsigned long long>(round),
+                    last.c_str(), titleOf(*session).c_str());
+        }
+    }
+
+    void signalLatency(const Options& options, Player& player, audio::platform::MprisAudioSession& session) {
+        const char* test = "signal latency";
+        std::vector<double> micros;
+        micros.reserve(options.signals);
+        for (uint64_t n = 0; n < options.signals; ++n) {
+            const auto title = "Latency " + std::to_string(n);
+            const auto sent = Clock::now();
+            player.setTitle(title);
+            if (!expect(eventually([&] { return titleOf(session) == title; }), test, "a title did not reach the mirror"))
+                return;
+            micros.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sent).count());
+        }
+        if (micros.empty())
+            return;
+        std::sort(micros.begin(), micros.end());
+        std::printf("%zu PropertiesChanged to mirror: median %.1f us, p99 %.1f us, max %.1f us\n", micros.size(),
+            micros[micros.size() / 2], micros[micros.size() * 99 / 100], micros.back());
+    }
+
+    void playerVanishes(Player& player, audio::platform::MprisAudioSession& session) {
+        const char* test = "player vanishes";
+        player.vanish();
+        expect(eventually([&] {
+            auto title = session.getTitle();
+            return !title && title.error().category() == audio::ErrorCategory::NoSession;
+        }), test, "the session outlived its player");
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = true;
+            if (name == "--dbus-daemon")
+                options.daemon = std::string(value);
+            else if (name == "--rounds")
+                parsed = parseNumber(value, options.rounds);
+            else if (name == "--signals")
+                parsed = parseNumber(value, options.signals);
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    PrivateBus bus;
+    if (!bus.start(options.daemon)) {
+        std::fprintf(stderr, "Cannot start %s\n", options.daemon.c_str());
+        return 2;
+    }
+    Player player;
+    if (!player.start(bus.address())) {
+        std::fprintf(stderr, "Cannot register a player on %s\n", bus.address().c_str());
+        return 2;
+    }
+    auto connection = audio::platform::MprisConnection::open(bus.address());
+    if (!connection) {
+        std::fprintf(stderr, "Cannot connect to %s: %s\n", bus.address().c_str(), connection.error().message().c_str());
+        return 2;
+    }
+    auto thumbnails = std::make_shared<audio::ThumbnailCache>();
+    auto session = openSession(*connection, thumbnails);
+
+    const struct {
+        const char* name;
+        std::function<void()> run;
+    } cases[] = {
+        { "mirror follows signals", [&] { followsSignals(player, *session); } },
+        { "signals around initialize", [&] { signalsAroundInitialize(options, player, *connection, thumbnails); } },
+        { "signal latency", [&] { signalLatency(options, player, *session); } },
+        { "player vanishes", [&] { playerVanishes(player, *session); } },
+    };
+    for (const auto& test : cases) {
+        test.run();
+        if (failed) {
+            std::printf("FAILED: %s\n", test.name);
+            return 1;
+        }
+        std::printf("ok: %s\n", test.name);
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+// Behaviour checks of audio::PlaybackDiffer and audio::PlaybackDebouncer.
+//
+// The differ must report nothing for a state equal to the last one, name exactly the fields
+// that changed otherwise, and start over from the baseline given to reset. The debouncer must
+// deliver at once on the submitting thread with a zero window; with a window, a burst of
+// --burst events must arrive as one event from the state before it to the state after it, on
+// the debouncer's thread, and a burst that ends where it started must arrive as nothing. A
+// steady stream is reported about once per window, setWindow(0) flushes a pending burst, and
+// stop discards it. The first mismatch is printed and the run fails.
+//
+// Build it from this file, PlaybackEvents.cpp and AudioError.cpp.
+//
+//     PlaybackEventsBenchmark [--burst N] [--window MS]
+
+#include "PlaybackEvents.h"
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using namespace std::chrono_literals;
+    using Clock = std::chrono::steady_clock;
+    using audio::PlaybackEvent;
+    using audio::PlaybackState;
+    using audio::PlaybackStatus;
+
+    struct Options {
+        uint64_t burst{ 1000 };
+        uint64_t window{ 50 };
+    };
+
+    bool failed = false;
+
+    bool expect(bool condition, const char* test, const char* what) {
+        if (!condition && !failed) {
+            std::fprintf(stderr, "%s: %s\n", test, what);
+            failed = true;
+        }
+        return condition;
+    }
+
+    PlaybackState state(PlaybackStatus status, double rate = 1.0) {
+        PlaybackState value;
+        value.status = status;
+        value.rate = rate;
+        return value;
+    }
+
+    PlaybackEvent event(const PlaybackState& previous, const PlaybackState& current) {
+        return { previous, current, audio::PlaybackDiffer::changedFields(previous, current) };
+    }
+
+    uint32_t bits(PlaybackEvent::Field field) {
+        return static_cast<uint32_t>(field);
+    }
+
+    // What a debouncer delivered, and on which thread.
+    struct Collector {
+        std::mutex mutex;
+        std::condition_variable arrived;
+        std::vector<PlaybackEvent> events;
+        std::vector<std::thread::id> threads;
+
+        audio::PlaybackDebouncer::Deliver deliver() {
+            return [this](const PlaybackEvent& event) {
+                {
+                    std::scoped_lock lock(mutex);
+                    events.push_back(event);
+                    threads.push_back(std::this_thread::get_id());
+                }
+                arrived.notify_all();
+            };
+        }
+
+        // False when fewer than count events arrived within timeout.
+        bool waitFor(size_t count, std::chrono::milliseconds timeout) {
+            std::unique_lock lock(mutex);
+            return arrived.wait_for(lock, timeout, [&] { return events.size() >= count; });
+        }
+
+        size_t size() {
+            std::scoped_lock lock(mutex);
+            return events.size();
+        }
+    };
+
+    void differ(const Options&) {
+        audio::PlaybackDiffer differ;
+        differ.reset(state(PlaybackStatus::Paused));
+        expect(!differ.update(state(PlaybackStatus::Paused)), "differ", "an unchanged state was reported");
+
+        const auto played = differ.update(state(PlaybackStatus::Playing));
+        expect(played && played->changed == bits(PlaybackEvent::Field::Status), "differ", "a status change was not reported as one");
+        expect(played && played->previous.status == PlaybackStatus::Paused && played->current.status == PlaybackStatus::Playing, "differ", "wrong states around a status change");
+        expect(!differ.update(state(PlaybackStatus::Playing)), "differ", "a repeated state was reported");
+
+        const auto faster = differ.update(state(PlaybackStatus::Playing, 2.0));
+        expect(faster && faster->changed == bits(PlaybackEvent::Field::Rate), "differ", "a rate change was not reported alone");
+
+        auto shuffled = state(PlaybackStatus::Playing, 2.0);
+        shuffled.shuffle = true;
+        shuffled.repeat = audio::RepeatMode::List;
+        const auto both = differ.update(shuffled);
+        expect(both && both->changed == (bits(PlaybackEvent::Field::Shuffle) | bits(PlaybackEvent::Field::Repeat)), "differ", "fields changed together were not all named");
+
+        differ.reset(shuffled);
+        expect(!differ.update(shuffled), "differ", "the baseline given to reset was reported");
+        differ.reset();
+        expect(bool(differ.update(shuffled)), "differ", "reset did not forget the last state");
+    }
+
+    void zeroWindow(const Options&) {
+        Collector collector;
+        audio::PlaybackDebouncer debouncer(collector.deliver());
+        debouncer.submit(event(state(PlaybackStatus::Paused), state(PlaybackStatus::Playing)));
+        expect(collector.size() == 1, "zero window", "the event was not delivered before submit returned");
+        expect(collector.size() == 1 && collector.threads.front() == std::this_thread::get_id(), "zero window", "the event was not delivered on the submitting thread");
+        const auto stats = debouncer.stats();
+        expect(stats.received == 1 && stats.delivered == 1 && stats.collapsed == 0, "zero window", "wrong counters");
+    }
+
+    void burst(const Options& options) {
+        Collector collector;
+        audio::PlaybackDebouncer debouncer(collector.deliver(), std::chrono::milliseconds(options.window));
+        auto previous = state(PlaybackStatus::Paused);
+        const auto start = previous;
+        for (uint64_t i = 0; i < options.burst; ++i) {
+            const auto next = state(i % 2 == 0 ? PlaybackStatus::Playing : PlaybackStatus::Paused, 1.0 + static_cast<double>(i % 4) / 4.0);
+            debouncer.submit(event(previous, next));
+            previous = next;
+        }
+        expect(collector.waitFor(1, std::chrono::milliseconds(options.window) + 1s), "burst", "the burst was not delivered");
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.window) * 2);
+
+        std::scoped_lock lock(collector.mutex);
+        if (!expect(collector.events.size() == 1, "burst", "the burst was not delivered as one event"))
+            return;
+        const auto& folded = collector.events.front();
+        expect(folded.previous == start && folded.current == previous, "burst", "the event does not span the burst");
+        expect(folded.changed == audio::PlaybackDiffer::changedFields(start, previous), "burst", "the event names the wrong fields");
+        expect(collector.threads.front() != std::this_thread::get_id(), "burst", "the burst was delivered on the submitting thread");
+        const auto stats = debouncer.stats();
+        expect(stats.received == options.burst && stats.delivered == 1 && stats.collapsed == options.burst - 1, "burst", "wrong counters");
+    }
+
+    void cancelled(const Options& options) {
+        Collector collector;
+        audio::PlaybackDebouncer debouncer(collector.deliver(), std::chrono::milliseconds(options.window));
+        const auto paused = state(PlaybackStatus::Paused);
+        const auto playing = state(PlaybackStatus::Playing);
+        debouncer.submit(event(playing, paused));
+        debouncer.submit(event(paused, playing));
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.window) * 3);
+        expect(collector.size() == 0, "cancelled", "a burst that ended where it started was delivered");
+        expect(debouncer.stats().cancelled == 1, "cancelled", "the burst was not counted as cancelled");
+    }
+
+    void steadyStream(const Options& options) {
+        Collector collector;
+        const auto window = std::chrono::milliseconds(options.window);
+        audio::PlaybackDebouncer debouncer(collector.deliver(), window);
+        auto previous = state(PlaybackStatus::Paused);
+        const auto started = Clock::now();
+        for (uint64_t i = 0; Clock::now() - started < window * 5; ++i) {
+            const auto next = state(PlaybackStatus::Playing, 1.0 + static_cast<double>(i % 8 + 1) / 8.0);
+            debouncer.submit(event(previous, next));
+            previous = next;
+            std::this_thread::sleep_for(1ms);
+        }
+        collector.waitFor(1, window + 1s);
+        std::this_thread::sleep_for(window * 2);
+        const auto delivered = collector.size();
+        std::printf("steady stream over 5 windows: %zu events\n", delivered);
+        expect(delivered >= 2, "steady stream", "a steady stream was held back past its windows");
+        expect(delivered <= 6, "steady stream", "a steady stream was not folded per window");
+    }
+
+    void flushAndStop(const Options&) {
+        Collector collector;
+        audio::PlaybackDebouncer debouncer(collector.deliver(), 10s);
+        debouncer.submit(event(state(PlaybackStatus::Paused), state(PlaybackStatus::Playing)));
+        debouncer.setWindow(0ms);
+        expect(collector.waitFor(1, 1s), "flush and stop", "setWindow(0) did not flush the pending burst");
+
+        debouncer.setWindow(10s);
+        debouncer.submit(event(state(PlaybackStatus::Playing), state(PlaybackStatus::Stopped)));
+        debouncer.stop();
+        debouncer.submit(event(state(PlaybackStatus::Stopped), state(PlaybackStatus::Playing)));
+        expect(collector.size() == 1, "flush and stop", "stop delivered the pending burst or a later event");
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = false;
+            if (name == "--burst")
+                parsed = parseNumber(value, options.burst) && options.burst > 0;
+            else if (name == "--window")
+                parsed = parseNumber(value, options.window) && options.window > 0;
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    const struct {
+        const char* name;
+        void (*run)(const Options&);
+    } cases[] = {
+        { "differ", differ },
+        { "zero window", zeroWindow },
+        { "burst", burst },
+        { "cancelled", cancelled },
+        { "steady stream", steadyStream },
+        { "flush and stop", flushAndStop },
+    };
+    for (const auto& test : cases) {
+        test.run(options);
+        if (failed) {
+            std::printf("FAILED: %s\n", test.name);
+            return 1;
+        }
+        std::printf("ok: %s\n", test.name);
+    }
+    return 0;
+}
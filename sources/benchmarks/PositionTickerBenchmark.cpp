@@ -0,0 +1,329 @@
+// Behaviour checks of audio::PositionTicker, the process-wide position timer.
+//
+// A source that always reports playing feeds most cases. Unsubscribing with another source's
+// handle must fail and leave the subscription ticking. A subscriber must get its first tick at
+// once and later ones where the position crosses a multiple of its interval, from a source
+// sampled about once per ResyncInterval. Pausing must bring one tick with the frozen position
+// and then none, with the timer thread asleep, and resuming must bring ticks again from where
+// playback stopped. Then --threads threads subscribe and
+// unsubscribe --rounds times each, at the ticker's resolution and next to a crowd of
+// background subscribers so that turns are long and unsubscribes land in the middle of them;
+// a callback that runs after its unsubscribe returned is counted, and any such late tick fails
+// the run.
+//
+// Build it from this file, PositionTicker.cpp, PlaybackClock.cpp and AudioError.cpp.
+//
+//     PositionTickerBenchmark [--threads N] [--rounds N] [--background N]
+
+#include "PositionTicker.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using namespace std::chrono_literals;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        uint64_t threads{ 16 };
+        uint64_t rounds{ 300 };
+        uint64_t background{ 2000 };
+    };
+
+    bool failed = false;
+
+    bool expect(bool condition, const char* test, const char* what) {
+        if (!condition && !failed) {
+            std::fprintf(stderr, "%s: %s\n", test, what);
+            failed = true;
+        }
+        return condition;
+    }
+
+    audio::PositionTicker::Sampler playing() {
+        return [] {
+            audio::PositionTicker::Sample sample;
+            sample.playback.status = audio::PlaybackStatus::Playing;
+            sample.timeline.end = std::chrono::hours(1);
+            return std::expected<audio::PositionTicker::Sample, audio::AudioError>(sample);
+        };
+    }
+
+    // Spins until count moves past start or a second has gone by.
+    bool waitPast(const std::atomic<uint64_t>& count, uint64_t start) {
+        const auto deadline = Clock::now() + 1s;
+        while (count.load() <= start) {
+            if (Clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+    void foreignSource(const Options&) {
+        auto& ticker = audio::PositionTicker::shared();
+        auto mine = ticker.addSource(playing());
+        auto theirs = ticker.addSource(playing());
+        std::atomic<uint64_t> ticks{ 0 };
+        const auto id = ticker.subscribe(mine, 20ms, [&](const audio::PositionTicker::Tick&) { ++ticks; });
+        expect(id != 0, "foreign source", "subscribe failed");
+        expect(!ticker.unsubscribe(theirs, id), "foreign source", "another source's handle cancelled the subscription");
+        expect(!ticker.unsubscribe(nullptr, id), "foreign source", "a null source cancelled the subscription");
+        expect(waitPast(ticks, ticks.load()), "foreign source", "the subscription stopped ticking");
+        expect(ticker.unsubscribe(mine, id), "foreign source", "the owning source could not unsubscribe");
+        expect(!ticker.unsubscribe(mine, id), "foreign source", "unsubscribed twice");
+        ticker.removeSource(theirs);
+        ticker.removeSource(mine);
+    }
+
+    // A player whose position runs from the moment it last started playing; set() changes its
+    // status the way a user would, so a sample taken afterwards sees the new state.
+    struct Player {
+        std::mutex mutex;
+        audio::PlaybackStatus status{ audio::PlaybackStatus::Playing };
+        std::chrono::milliseconds position{ 0 };
+        Clock::time_point since{ Clock::now() };
+        std::atomic<uint64_t> samples{ 0 };
+
+        void set(audio::PlaybackStatus next) {
+            std::scoped_lock lock(mutex);
+            position = positionLocked();
+            since = Clock::now();
+            status = next;
+        }
+
+        audio::PositionTicker::Sampler sampler() {
+            return [this] {
+                samples.fetch_add(1);
+                std::scoped_lock lock(mutex);
+                audio::PositionTicker::Sample sample;
+                sample.playback.status = status;
+                sample.timeline.end = std::chrono::hours(1);
+                sample.timeline.position = positionLocked();
+                return std::expected<audio::PositionTicker::Sample, audio::AudioError>(sample);
+            };
+        }
+
+    private:
+        std::chrono::milliseconds positionLocked() const {
+            if (status != audio::PlaybackStatus::Playing)
+                return position;
+            return position + std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - since);
+        }
+    };
+
+    struct Recorder {
+        std::mutex mutex;
+        std::vector<std::pair<Clock::time_point, audio::PositionTicker::Tick>> ticks;
+
+        audio::PositionTicker::Callback callback() {
+            return [this](const audio::PositionTicker::Tick& tick) {
+                std::scoped_lock lock(mutex);
+                ticks.emplace_back(Clock::now(), tick);
+            };
+        }
+
+        size_t size() {
+            std::scoped_lock lock(mutex);
+            return ticks.size();
+        }
+    };
+
+    void intervals(const Options&) {
+        constexpr auto Interval = 250ms;
+        // Timer resolution plus scheduling on a busy machine.
+        constexpr auto Slack = 4 * audio::PositionTicker::Resolution;
+        auto& ticker = audio::PositionTicker::shared();
+        Player player;
+        auto source = ticker.addSource(player.sampler());
+        Recorder recorder;
+        const auto subscribed = Clock::now();
+        const auto id = ticker.subscribe(source, Interval, recorder.callback());
+        std::this_thread::sleep_for(Interval * 5 + Interval / 2);
+        ticker.unsubscribe(source, id);
+        ticker.removeSource(source);
+
+        std::scoped_lock lock(recorder.mutex);
+        const auto& ticks = recorder.ticks;
+        if (!expect(!ticks.empty(), "intervals", "no tick arrived"))
+            return;
+        expect(ticks.front().first - subscribed < Interval / 2, "intervals", "the first tick did not come at once");
+        expect(ticks.size() >= 5 && ticks.size() <= 7, "intervals", "the tick count does not match the interval");
+        std::chrono::milliseconds worst{ 0 };
+        for (size_t i = 1; i < ticks.size(); ++i) {
+            worst = std::max(worst, ticks[i].second.position % Interval);
+            expect(ticks[i].second.position > ticks[i - 1].second.position, "intervals", "the position did not advance between ticks");
+        }
+        std::printf("%zu ticks at %lld ms, furthest %lld ms past a boundary, %llu samples\n", ticks.size(),
+            static_cast<long long>(Interval.count()), static_cast<long long>(worst.count()), static_cast<unsigned long long>(player.samples.load()));
+        expect(worst <= Slack, "intervals", "a tick fell away from a multiple of the interval");
+        expect(player.samples.load() <= 3, "intervals", "the source was sampled for ticks it could extrapolate");
+    }
+
+    void pauseResume(const Options&) {
+        constexpr auto Interval = 50ms;
+        auto& ticker = audio::PositionTicker::shared();
+        Player player;
+        auto source = ticker.addSource(player.sampler());
+        Recorder recorder;
+        const auto id = ticker.subscribe(source, Interval, recorder.callback());
+        std::this_thread::sleep_for(Interval * 4);
+
+        player.set(audio::PlaybackStatus::Paused);
+        ticker.resync(source);
+        std::this_thread::sleep_for(Interval * 3);
+        const auto atPause = recorder.size();
+        const auto turns = ticker.stats().turns;
+        std::this_thread::sleep_for(Interval * 6);
+        const auto stats = ticker.stats();
+        expect(recorder.size() == atPause, "pause and resume", "a paused subscriber kept ticking");
+        expect(stats.parked == 1 && stats.subscribers == 1, "pause and resume", "the paused subscriber was not parked");
+        expect(stats.turns == turns, "pause and resume", "the timer thread woke with nothing armed");
+
+        player.set(audio::PlaybackStatus::Playing);
+        ticker.resync(source);
+        const auto deadline = Clock::now() + 1s;
+        while (recorder.size() < atPause + 3 && Clock::now() < deadline)
+            std::this_thread::sleep_for(Interval / 5);
+        ticker.unsubscribe(source, id);
+        ticker.removeSource(source);
+
+        std::scoped_lock lock(recorder.mutex);
+        const auto& ticks = recorder.ticks;
+        expect(ticks.size() >= atPause + 3, "pause and resume", "resuming did not bring ticks back");
+        if (!expect(atPause >= 2, "pause and resume", "too few ticks before the pause"))
+            return;
+        const auto& paused = ticks[atPause - 1].second;
+        expect(paused.status == audio::PlaybackStatus::Paused, "pause and resume", "the last tick before the gap was not the paused one");
+        expect(ticks[atPause - 2].second.status == audio::PlaybackStatus::Playing, "pause and resume", "the pause was announced more than once");
+        bool resumed = ticks.size() > atPause;
+        for (size_t i = atPause; i < ticks.size(); ++i)
+            resumed &= ticks[i].second.status == audio::PlaybackStatus::Playing && ticks[i].second.position >= paused.position;
+        expect(resumed, "pause and resume", "ticks after resuming did not continue from the paused position");
+    }
+
+    // What one subscription under test shares with its callback; kept alive past unsubscribe
+    // so a late tick is counted instead of touching freed memory.
+    struct Probe {
+        std::atomic<bool> closed{ false };
+        std::atomic<uint64_t> calls{ 0 };
+    };
+
+    void unsubscribeRace(const Options& options) {
+        auto& ticker = audio::PositionTicker::shared();
+        auto source = ticker.addSource(playing());
+        std::vector<audio::PositionTicker::SubscriptionId> crowd;
+        for (uint64_t i = 0; i < options.background; ++i)
+            crowd.push_back(ticker.subscribe(source, audio::PositionTicker::Resolution, [](const audio::PositionTicker::Tick&) {}));
+
+        std::atomic<uint64_t> late{ 0 };
+        std::atomic<uint64_t> delivered{ 0 };
+        std::atomic<uint64_t> refused{ 0 };
+        const auto started = Clock::now();
+        std::vector<std::thread> threads;
+        for (uint64_t t = 0; t < options.threads; ++t) {
+            threads.emplace_back([&, t] {
+                std::mt19937_64 random(t + 1);
+                for (uint64_t round = 0; round < options.rounds; ++round) {
+                    auto probe = std::make_shared<Probe>();
+                    const auto id = ticker.subscribe(source, audio::PositionTicker::Resolution, [probe, &late](const audio::PositionTicker::Tick&) {
+                        probe->calls.fetch_add(1);
+                        std::this_thread::sleep_for(std::chrono::microseconds(50));
+                        if (probe->closed.load())
+                            late.fetch_add(1);
+                    });
+                    std::this_thread::sleep_for(std::chrono::microseconds(random() % 15000));
+                    if (!ticker.unsubscribe(source, id))
+                        refused.fetch_add(1);
+                    probe->closed.store(true);
+                    delivered.fetch_add(probe->calls.load());
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        const auto seconds = std::chrono::duration<double>(Clock::now() - started).count();
+        // Ticks already queued for a probe show up once the ticker gets to them.
+        std::this_thread::sleep_for(50ms);
+
+        for (auto id : crowd)
+            ticker.unsubscribe(source, id);
+        ticker.removeSource(source);
+        const auto total = options.threads * options.rounds;
+        std::printf("%llu subscribe/unsubscribe rounds on %llu threads in %.2f s, %llu ticks delivered to them, %llu late\n",
+            static_cast<unsigned long long>(total), static_cast<unsigned long long>(options.threads), seconds,
+            static_cast<unsigned long long>(delivered.load()), static_cast<unsigned long long>(late.load()));
+        expect(refused.load() == 0, "unsubscribe race", "unsubscribe refused a live subscription");
+        expect(late.load() == 0, "unsubscribe race", "a callback ran after its unsubscribe returned");
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = false;
+            if (name == "--threads")
+                parsed = parseNumber(value, options.threads) && options.threads > 0;
+            else if (name == "--rounds")
+                parsed = parseNumber(value, options.rounds);
+            else if (name == "--background")
+                parsed = parseNumber(value, options.background);
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    const struct {
+        const char* name;
+        void (*run)(const Options&);
+    } cases[] = {
+        { "foreign source", foreignSource },
+        { "intervals", intervals },
+        { "pause and resume", pauseResume },
+        { "unsubscribe race", unsubscribeRace },
+    };
+    for (const auto& test : cases) {
+        test.run(options);
+        if (failed) {
+            std::printf("FAILED: %s\n", test.name);
+            return 1;
+        }
+        std::printf("ok: %s\n", test.name);
+    }
+    return 0;
+}
@@ -0,0 +1,231 @@
+// Behaviour checks and getter cost of the session state cache, through
+// audio::platform::ScriptedAudioSession, whose fetchCount() counts every trip to the "player".
+//
+// Before initialize every getter fails with NoSession; after it, a getter whose part of the
+// state is missing goes to the player once, and getters sharing that part then hit the cache.
+// A change made without an event (set*) stays invisible until the matching emit* republishes
+// it, and the artwork is read from the player once per new stream and then served from the
+// thumbnail cache. Once every part is primed, --iterations rounds of every getter must not
+// reach the player at all, and the hit and miss counters must account for every call exactly.
+// The first mismatch is printed and the run fails; then the cost of a primed getter is timed.
+//
+// Build it from this file, ScriptedAudioSession.cpp, SessionStateCache.cpp, PlaybackEvents.cpp,
+// TrackChangeWatcher.cpp, VolumeController.cpp, FakeVolumeEndpoint.cpp, ThumbnailCache.cpp,
+// PlaybackClock.cpp, StringPool.cpp, OperationStats.cpp, TickClock.cpp, Tracer.cpp, Utf16.cpp
+// and AudioError.cpp.
+//
+//     SessionCacheBenchmark [--iterations N]
+
+#include "ScriptedAudioSession.h"
+#include "StringPool.h"
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using audio::platform::ScriptedAudioSession;
+
+    struct Options {
+        uint64_t iterations{ 100000 };
+    };
+
+    bool failed = false;
+
+    bool expect(bool condition, const char* test, const char* what) {
+        if (!condition && !failed) {
+            std::fprintf(stderr, "%s: %s\n", test, what);
+            failed = true;
+        }
+        return condition;
+    }
+
+    audio::MediaInfo media(const char* title) {
+        audio::MediaInfo value;
+        value.title = title;
+        value.artist = "Artist";
+        value.album = "Album";
+        value.trackNumber = 3;
+        return value;
+    }
+
+    audio::PlaybackState playback(audio::PlaybackStatus status) {
+        audio::PlaybackState value;
+        value.status = status;
+        return value;
+    }
+
+    audio::TimelineState timeline(int64_t seconds) {
+        audio::TimelineState value;
+        value.end = std::chrono::seconds(240);
+        value.position = std::chrono::seconds(seconds);
+        value.lastUpdated = std::chrono::system_clock::now();
+        return value;
+    }
+
+    void beforeInitialize(const Options&) {
+        ScriptedAudioSession session;
+        session.setMediaProperties(media("Early"));
+        const auto title = session.getTitle();
+        expect(!title && title.error().category() == audio::ErrorCategory::NoSession, "before initialize", "a getter worked before initialize");
+        expect(!session.getTrackSnapshot(), "before initialize", "a snapshot was taken before initialize");
+        expect(session.fetchCount() == 0, "before initialize", "the player was asked before initialize");
+    }
+
+    void missThenHit(const Options&) {
+        ScriptedAudioSession session;
+        (void)session.initialize();
+        const auto missing = session.getTitle();
+        expect(!missing && missing.error().category() == audio::ErrorCategory::NotFound, "miss then hit", "a title came from a player that has none");
+        expect(session.fetchCount() == 1, "miss then hit", "a missing title was not looked up exactly once");
+
+        session.setMediaProperties(media("First"));
+        expect(session.getTitle().value_or("") == "First", "miss then hit", "wrong title");
+        expect(session.fetchCount() == 2, "miss then hit", "the first title was not fetched exactly once");
+        audio::StringPool pool;
+        expect(session.getArtist().value_or("") == "Artist", "miss then hit", "wrong artist");
+        expect(session.getAlbum().value_or("") == "Album", "miss then hit", "wrong album");
+        expect(session.getText(audio::MediaText::Title, pool).value_or("") == "First", "miss then hit", "wrong pooled title");
+        expect(session.fetchCount() == 2, "miss then hit", "getters sharing the media went back to the player");
+        const auto stats = session.cacheStats();
+        expect(stats.misses == 2 && stats.hits == 3, "miss then hit", "hits and misses do not match the calls");
+    }
+
+    void staleUntilEvent(const Options&) {
+        ScriptedAudioSession session;
+        (void)session.initialize();
+        session.emitMediaPropertiesChanged(media("Old"));
+        expect(session.getTitle().value_or("") == "Old", "stale until event", "wrong title");
+        session.setMediaProperties(media("Silent"));
+        expect(session.getTitle().value_or("") == "Old", "stale until event", "a change without an event reached the cache");
+        session.emitMediaPropertiesChanged(media("New"));
+        expect(session.getTitle().value_or("") == "New", "stale until event", "the event did not update the cache");
+        expect(session.fetchCount() == 0, "stale until event", "published media was fetched again");
+    }
+
+    void thumbnail(const Options&) {
+        ScriptedAudioSession session;
+        (void)session.initialize();
+        session.emitMediaPropertiesChanged(media("Art"));
+        session.setThumbnail(std::vector<uint8_t>(4096, 0x42));
+        const auto first = session.getThumbnail();
+        const auto second = session.getThumbnail();
+        if (!expect(first && second, "thumbnail", "the thumbnail could not be read"))
+            return;
+        expect(*first == *second && (*first)->size() == 4096, "thumbnail", "the second read did not get the cached buffer");
+        expect(session.fetchCount() == 1, "thumbnail", "one stream was read more than once");
+        session.setThumbnail(std::vector<uint8_t>(512, 0x17));
+        const auto third = session.getThumbnail();
+        expect(third && (*third)->size() == 512 && (*third)->front() == 0x17, "thumbnail", "a new stream was not read");
+        expect(session.fetchCount() == 2, "thumbnail", "a new stream was not read exactly once");
+    }
+
+    void primedGetters(const Options& options) {
+        ScriptedAudioSession session;
+        (void)session.initialize();
+        session.emitMediaPropertiesChanged(media("Primed"));
+        session.emitPlaybackInfoChanged(playback(audio::PlaybackStatus::Playing));
+        session.emitTimelinePropertiesChanged(timeline(30));
+        session.setThumbnail(std::vector<uint8_t>(1024, 0x01));
+        (void)session.getThumbnail();
+        const auto fetches = session.fetchCount();
+        const auto before = session.cacheStats();
+
+        // Cache loads per round: title, artist, album and thumbnail one each, duration one,
+        // precise position two (timeline and playback), snapshot three.
+        constexpr uint64_t LoadsPerRound = 10;
+        bool wrong = false;
+        for (uint64_t i = 0; i < options.iterations; ++i) {
+            wrong |= session.getTitle().value_or("") != "Primed";
+            wrong |= !session.getArtist() || !session.getAlbum() || !session.getThumbnail();
+            wrong |= session.getDuration().value_or(std::chrono::seconds(0)) != std::chrono::seconds(240);
+            wrong |= !session.getCurrentPositionPrecise();
+            wrong |= session.getTrackSnapshot().value_or(audio::TrackSnapshot{}).title != "Primed";
+        }
+        const auto after = session.cacheStats();
+        expect(!wrong, "primed getters", "a primed getter returned the wrong value");
+        expect(session.fetchCount() == fetches, "primed getters", "a primed getter reached the player");
+        expect(after.misses == before.misses, "primed getters", "a primed getter missed the cache");
+        expect(after.hits - before.hits == options.iterations * LoadsPerRound, "primed getters", "hits do not match the calls");
+    }
+
+    void timeGetters(const Options& options) {
+        ScriptedAudioSession session;
+        (void)session.initialize();
+        session.emitMediaPropertiesChanged(media("Timed"));
+        session.emitPlaybackInfoChanged(playback(audio::PlaybackStatus::Playing));
+        session.emitTimelinePropertiesChanged(timeline(30));
+        uint64_t sink = 0;
+        auto started = Clock::now();
+        for (uint64_t i = 0; i < options.iterations; ++i)
+            sink += session.getTitle()->size();
+        const auto title = std::chrono::duration<double, std::nano>(Clock::now() - started).count() / static_cast<double>(options.iterations);
+        started = Clock::now();
+        for (uint64_t i = 0; i < options.iterations; ++i)
+            sink += session.getTrackSnapshot()->title.size();
+        const auto snapshot = std::chrono::duration<double, std::nano>(Clock::now() - started).count() / static_cast<double>(options.iterations);
+        expect(sink == options.iterations * 10, "primed getter cost", "a timed getter returned the wrong title");
+        std::printf("primed getTitle %.0f ns, getTrackSnapshot %.0f ns\n", title, snapshot);
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = false;
+            if (name == "--iterations")
+                parsed = parseNumber(value, options.iterations) && options.iterations > 0;
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    const struct {
+        const char* name;
+        void (*run)(const Options&);
+    } cases[] = {
+        { "before initialize", beforeInitialize },
+        { "miss then hit", missThenHit },
+        { "stale until event", staleUntilEvent },
+        { "thumbnail", thumbnail },
+        { "primed getters", primedGetters },
+    };
+    for (const auto& test : cases) {
+        test.run(options);
+        if (failed) {
+            std::printf("FAILED: %s\n", test.name);
+            return 1;
+        }
+        std::printf("ok: %s\n", test.name);
+    }
+    timeGetters(options);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,235 @@
+// Behaviour checks of audio::SessionRegistry, over audio::platform::ScriptedSessionSource
+// standing in for the system's session manager and ScriptedAudioSession for each app.
+//
+// The registry must hold exactly the sessions the source reports: an app that starts gets one
+// session, created once, an app that closes loses it, and the apps in between keep the session
+// they had. The active session follows the current one, or a pinned id once pinned; every change
+// of it is announced once, closing the current app announces an empty id, and only the active
+// app's playback events get through. --rounds rounds of opening, focusing and closing apps then
+// check that the registry still matches the source and every switch was announced.
+// The first mismatch is printed and the run fails.
+//
+// Build it from this file, SessionRegistry.cpp, ScriptedSessionSource.cpp, CommandQueue.cpp
+// and the sources listed in SessionCacheBenchmark.cpp.
+//
+//     SessionRegistryBenchmark [--rounds N]
+
+#include "SessionRegistry.h"
+#include "ScriptedAudioSession.h"
+#include "ScriptedSessionSource.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using audio::platform::ScriptedAudioSession;
+    using audio::platform::ScriptedSessionSource;
+
+    struct Options {
+        uint64_t rounds{ 500 };
+    };
+
+    bool failed = false;
+
+    bool expect(bool condition, const char* test, const char* what) {
+        if (!condition && !failed) {
+            std::fprintf(stderr, "%s: %s\n", test, what);
+            failed = true;
+        }
+        return condition;
+    }
+
+    // The registry owns its source; the raw pointer stays valid as long as it does.
+    struct Fixture {
+        ScriptedSessionSource* source;
+        audio::SessionRegistry registry;
+        std::vector<std::string> announced;
+
+        Fixture() : Fixture(std::make_unique<ScriptedSessionSource>()) {}
+
+        std::shared_ptr<ScriptedAudioSession> open(std::string id) {
+            auto session = std::make_shared<ScriptedAudioSession>();
+            source->addSession(std::move(id), session);
+            return session;
+        }
+
+    private:
+        explicit Fixture(std::unique_ptr<ScriptedSessionSource> owned) : source(owned.get()), registry(std::move(owned)) {
+            registry.setActiveSessionChangedCallback([this](std::string_view id) { announced.emplace_back(id); });
+        }
+    };
+
+    std::vector<std::string> sorted(std::vector<std::string> ids) {
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    audio::PlaybackState playback(audio::PlaybackStatus status) {
+        audio::PlaybackState value;
+        value.status = status;
+        return value;
+    }
+
+    void sessionsFollowSource(const Options&) {
+        Fixture fixture;
+        fixture.open("a");
+        fixture.open("b");
+        expect(bool(fixture.registry.initialize()), "sessions follow source", "initialize failed");
+        expect(sorted(fixture.registry.sessionIds()) == std::vector<std::string>{ "a", "b" }, "sessions follow source", "the first sessions are missing");
+        const auto first = fixture.registry.find("a");
+
+        fixture.open("c");
+        expect(fixture.registry.find("c") != nullptr, "sessions follow source", "a started app has no session");
+        expect(fixture.source->createCount() == 3, "sessions follow source", "a session was created more than once");
+        expect(fixture.registry.find("a") == first, "sessions follow source", "an app's session was replaced by an unrelated start");
+
+        fixture.source->removeSession("b");
+        expect(fixture.registry.find("b") == nullptr, "sessions follow source", "a closed app kept its session");
+        expect(sorted(fixture.registry.sessionIds()) == std::vector<std::string>{ "a", "c" }, "sessions follow source", "the sessions do not match the source");
+        expect(fixture.registry.find("a") == first && fixture.source->createCount() == 3, "sessions follow source", "a remaining app's session was recreated");
+    }
+
+    void activeFollowsCurrent(const Options&) {
+        Fixture fixture;
+        auto a = fixture.open("a");
+        auto b = fixture.open("b");
+        std::vector<audio::PlaybackStatus> events;
+        fixture.registry.setPlaybackEventCallback([&](const audio::PlaybackEvent& event) { events.push_back(event.current.status); });
+        (void)fixture.registry.initialize();
+        expect(fixture.registry.active() == nullptr && fixture.announced.empty(), "active follows current", "a session is active with no current one");
+
+        fixture.source->setCurrentSession("a");
+        expect(fixture.registry.activeId() == "a", "active follows current", "the current session is not active");
+        fixture.source->setCurrentSession("a");
+        fixture.source->setCurrentSession("b");
+        expect(fixture.registry.activeId() == "b", "active follows current", "the active session did not switch");
+        expect(fixture.announced == std::vector<std::string>{ "a", "b" }, "active follows current", "switches were missed or repeated");
+
+        a->emitPlaybackInfoChanged(playback(audio::PlaybackStatus::Playing));
+        b->emitPlaybackInfoChanged(playback(audio::PlaybackStatus::Paused));
+        expect(events == std::vector<audio::PlaybackStatus>{ audio::PlaybackStatus::Paused }, "active follows current", "an inactive session's event got through");
+
+        // The current-session event can come before the list change that introduces the app.
+        fixture.source->setCurrentSession("c");
+        expect(fixture.registry.active() == nullptr, "active follows current", "an unknown app is active");
+        fixture.open("c");
+        expect(fixture.registry.activeId() == "c", "active follows current", "an app that showed up late did not become active");
+
+        fixture.source->removeSession("c");
+        expect(fixture.registry.active() == nullptr, "active follows current", "a closed app stayed active");
+        expect(fixture.announced == std::vector<std::string>{ "a", "b", "", "c", "" }, "active follows current", "switches were missed or repeated");
+    }
+
+    void pinned(const Options&) {
+        Fixture fixture;
+        fixture.open("a");
+        (void)fixture.registry.initialize();
+        fixture.source->setCurrentSession("a");
+
+        fixture.registry.pin("d");
+        expect(fixture.registry.mode() == audio::SessionRegistry::Mode::Pinned, "pinned", "pin did not pin");
+        expect(fixture.registry.active() == nullptr, "pinned", "a missing pinned app is active");
+        fixture.source->setCurrentSession("a");
+        fixture.open("d");
+        expect(fixture.registry.activeId() == "d", "pinned", "the pinned app did not become active when it started");
+        fixture.registry.followCurrent();
+        expect(fixture.registry.activeId() == "a", "pinned", "following again did not return to the current session");
+        expect(fixture.announced == std::vector<std::string>{ "a", "", "d", "a" }, "pinned", "switches were missed or repeated");
+    }
+
+    void churn(const Options& options) {
+        Fixture fixture;
+        (void)fixture.registry.initialize();
+        std::vector<std::string> open;
+        std::string current;
+        size_t switches = 0;
+        for (uint64_t round = 0; round < options.rounds && !failed; ++round) {
+            const auto id = "app" + std::to_string(round % 7);
+            if (std::find(open.begin(), open.end(), id) != open.end()) {
+                fixture.source->removeSession(id);
+                std::erase(open, id);
+                if (current == id) {
+                    current.clear();
+                    ++switches;
+                }
+            }
+            else {
+                fixture.open(id);
+                open.push_back(id);
+                if (round % 3 == 0) {
+                    fixture.source->setCurrentSession(id);
+                    switches += current != id;
+                    current = id;
+                }
+            }
+            expect(sorted(fixture.registry.sessionIds()) == sorted(open), "churn", "the sessions do not match the source");
+            expect(fixture.registry.activeId() == current, "churn", "the active session is not the current one");
+        }
+        expect(fixture.announced.size() == switches, "churn", "switches were missed or repeated");
+        expect(fixture.announced.empty() || fixture.announced.back() == current, "churn", "the last announcement is not the active session");
+        std::printf("%llu rounds, %zu sessions created, %zu switches\n", static_cast<unsigned long long>(options.rounds),
+            static_cast<size_t>(fixture.source->createCount()), switches);
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = false;
+            if (name == "--rounds")
+                parsed = parseNumber(value, options.rounds);
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    const struct {
+        const char* name;
+        void (*run)(const Options&);
+    } cases[] = {
+        { "sessions follow source", sessionsFollowSource },
+        { "active follows current", activeFollowsCurrent },
+        { "pinned", pinned },
+        { "churn", churn },
+    };
+    for (const auto& test : cases) {
+        test.run(options);
+        if (failed) {
+            std::printf("FAILED: %s\n", test.name);
+            return 1;
+        }
+        std::printf("ok: %s\n", test.name);
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Torn-read stress test and read throughput of audio::StateBlock.
+//
+// Writer threads publish states in which every field is derived from one number n: status,
+// flags, position, anchor, duration, rate, volume and track id, and title, artist and album
+// strings whose length and content depend on n, some long enough to be cut at TextCapacity.
+// Reader threads spin on read() and check that each state they get is whole, every field
+// telling the same n. The first mixed state is printed and the run fails. Writers take turns
+// on the block's lock, so the test is about readers overlapping writes, not writers racing.
+//
+// Build it from this file and StateBlock.cpp; it needs nothing else.
+//
+//     StateBlockBenchmark [--seconds N] [--writers N] [--readers N] [--pause-us N]
+
+#include "StateBlock.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        uint64_t seconds{ 5 };
+        uint64_t writers{ 2 };
+        uint64_t readers{ 4 };
+        // Between one writer's publishes; 0 writes back to back.
+        uint64_t pauseMicros{ 0 };
+    };
+
+    // Some titles outgrow the block on their own, pushing artist and album out of it.
+    std::string text(char tag, uint64_t n) {
+        const auto length = static_cast<size_t>(n % 97 == 0 ? 2000 : n % 61);
+        std::string value = std::to_string(n) + tag;
+        while (value.size() < length)
+            value.push_back(static_cast<char>('a' + (value.size() + n) % 26));
+        return value;
+    }
+
+    void fill(audio::StateBlock::State& state, uint64_t n) {
+        state.status = static_cast<audio::PlaybackStatus>(n % 6);
+        state.hasSession = n % 2 == 0;
+        state.muted = n % 3 == 0;
+        state.position = std::chrono::milliseconds(static_cast<int64_t>(n));
+        state.anchoredAt = audio::StateBlock::Clock::time_point(std::chrono::nanoseconds(static_cast<int64_t>(n * 7)));
+        state.duration = std::chrono::milliseconds(static_cast<int64_t>(n * 2));
+        state.rate = static_cast<double>(n) + 0.5;
+        state.volume = static_cast<double>(n) / 4.0;
+        state.trackId = n * 0x9E3779B97F4A7C15ull;
+        state.title = text('t', n);
+        state.artist = text('a', n + 1);
+        state.album = text('b', n + 2);
+    }
+
+    // What a whole state built by fill(n) reads back as, text cut where the block cuts it.
+    bool whole(const audio::StateBlock::State& state) {
+        const auto n = static_cast<uint64_t>(state.position.count());
+        audio::StateBlock::State expected;
+        fill(expected, n);
+        size_t room = audio::StateBlock::TextCapacity;
+        const auto cut = [&room](const std::string& value) {
+            auto kept = std::min(value.size(), room);
+            room -= kept;
+            return value.substr(0, kept);
+        };
+        return state.status == expected.status && state.hasSession == expected.hasSession && state.muted == expected.muted
+            && state.anchoredAt == expected.anchoredAt && state.duration == expected.duration && state.rate == expected.rate
+            && state.volume == expected.volume && state.trackId == expected.trackId
+            && state.title == cut(expected.title) && state.artist == cut(expected.artist) && state.album == cut(expected.album);
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = false;
+            if (name == "--seconds")
+                parsed = parseNumber(value, options.seconds);
+            else if (name == "--writers")
+                parsed = parseNumber(value, options.writers);
+            else if (name == "--readers")
+                parsed = parseNumber(value, options.readers);
+            else if (name == "--pause-us")
+                parsed = parseNumber(value, options.pauseMicros);
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    audio::StateBlock block;
+    block.update([](audio::StateBlock::State& state) { fill(state, 0); });
+
+    std::atomic<bool> stop{ false };
+    std::atomic<bool> torn{ false };
+    std::atomic<uint64_t> next{ 1 };
+    std::vector<uint64_t> reads(options.readers, 0);
+    std::vector<std::thread> threads;
+
+    for (uint64_t w = 0; w < options.writers; ++w) {
+        threads.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto n = next.fetch_add(1, std::memory_order_relaxed);
+                block.update([n](audio::StateBlock::State& state) { fill(state, n); });
+                if (options.pauseMicros != 0)
+                    std::this_thread::sleep_for(std::chrono::microseconds(options.pauseMicros));
+            }
+        });
+    }
+    for (uint64_t r = 0; r < options.readers; ++r) {
+        threads.emplace_back([&, r] {
+            uint64_t count = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto state = block.read();
+                ++count;
+                if (!whole(state) && !torn.exchange(true)) {
+                    std::fprintf(stderr, "Torn read: position %lld, duration %lld, track %llu, title of %zu bytes\n",
+                        static_cast<long long>(state.position.count()), static_cast<long long>(state.duration.count()),
+                        static_cast<unsigned long long>(state.trackId), state.title.size());
+                    stop = true;
+                }
+            }
+            reads[r] = count;
+        });
+    }
+
+    const auto started = Clock::now();
+    while (!stop.load() && Clock::now() - started < std::chrono::seconds(options.seconds))
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    stop = true;
+    for (auto& thread : threads)
+        thread.join();
+    const auto seconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+    uint64_t totalReads = 0;
+    for (auto count : reads)
+        totalReads += count;
+    const auto stats = block.stats();
+    std::printf("%llu writers, %llu readers, %.1f s\n", static_cast<unsigned long long>(options.writers),
+        static_cast<unsigned long long>(options.readers), seconds);
+    std::printf("writes        %14llu  %12.0f /s\n", static_cast<unsigned long long>(stats.writes), static_cast<double>(stats.writes) / seconds);
+    std::printf("reads         %14llu  %12.0f /s\n", static_cast<unsigned long long>(totalReads), static_cast<double>(totalReads) / seconds);
+    std::printf("read retries  %14llu  %12.4f per read\n", static_cast<unsigned long long>(stats.retries),
+        totalReads ? static_cast<double>(stats.retries) / static_cast<double>(totalReads) : 0.0);
+    if (torn) {
+        std::printf("FAILED: a reader saw a torn state\n");
+        return 1;
+    }
+    std::printf("no torn reads\n");
+    return 0;
+}
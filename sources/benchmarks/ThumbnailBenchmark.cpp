@@ -0,0 +1,275 @@
+// Decoding checks and timing of audio::platform::BmpImageDecoder and audio::ThumbnailProcessor.
+//
+// Every bitmap in samples/ is decoded and compared pixel by pixel with the premultiplied RGBA
+// it must produce: 24-bit and 32-bit, bottom-up and top-down, widths whose rows need padding,
+// a 32-bit image whose header declares an alpha mask and one whose fourth byte must be ignored.
+// Each is then handed to a ThumbnailProcessor registered for 64, 128 and 512 pixels, and every
+// variant is checked: images that fit come back unchanged, larger ones are box-averaged to
+// values known exactly in advance, including red stripes on a transparent background that must
+// average to half-transparent red rather than dark red. The first mismatch is printed and the
+// run fails; then decoding and scaling are timed over --iterations rounds.
+//
+// Build it from this file, BmpImageDecoder.cpp, ThumbnailProcessor.cpp, ImageScaler.cpp,
+// ThumbnailCache.cpp, Tracer.cpp, TickClock.cpp and AudioError.cpp. It finds the samples next
+// to its source unless --samples says otherwise.
+//
+//     ThumbnailBenchmark [--samples DIR] [--iterations N]
+
+#include "BmpImageDecoder.h"
+#include "ThumbnailProcessor.h"
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using Pixel = std::array<uint8_t, 4>;
+
+    constexpr uint32_t Sizes[] = { 64, 128, 512 };
+
+    struct Options {
+        std::filesystem::path samples{ std::filesystem::path(__FILE__).parent_path() / "samples" };
+        uint64_t iterations{ 200 };
+    };
+
+    // The variant a sample must scale to at one registered size; every pixel of it is pixel.
+    struct Scaled {
+        uint32_t size;
+        uint32_t width;
+        uint32_t height;
+        Pixel pixel;
+    };
+
+    struct Sample {
+        const char* file;
+        uint32_t width;
+        uint32_t height;
+        // The decoded pixel at column x of row y, counted from the top.
+        Pixel (*at)(uint32_t x, uint32_t y);
+        // Sizes the sample does not fit; at the others the variant is the decoded image.
+        std::vector<Scaled> scaled;
+    };
+
+    template <size_t N>
+    Pixel fromTable(const uint8_t (&table)[N], uint32_t width, uint32_t x, uint32_t y) {
+        const auto* pixel = table + (static_cast<size_t>(y) * width + x) * 4;
+        return { pixel[0], pixel[1], pixel[2], pixel[3] };
+    }
+
+    constexpr uint8_t BottomUp24[] = {
+        10, 20, 250, 255, 50, 20, 220, 255, 90, 20, 190, 255, 130, 20, 160, 255, 170, 20, 130, 255,
+        10, 110, 200, 255, 50, 110, 170, 255, 90, 110, 140, 255, 130, 110, 110, 255, 170, 110, 80, 255,
+        10, 200, 150, 255, 50, 200, 120, 255, 90, 200, 90, 255, 130, 200, 60, 255, 170, 200, 30, 255,
+    };
+
+    constexpr uint8_t TopDown24[] = {
+        255, 3, 0, 255, 225, 3, 17, 255, 195, 3, 34, 255, 165, 3, 51, 255, 135, 3, 68, 255, 105, 3, 85, 255, 75, 3, 102, 255,
+        255, 123, 1, 255, 225, 123, 18, 255, 195, 123, 35, 255, 165, 123, 52, 255, 135, 123, 69, 255, 105, 123, 86, 255, 75, 123, 103, 255,
+    };
+
+    // Stored as (200,100,50,128), (255,255,255,64), (90,180,240,1) and so on, straight alpha.
+    constexpr uint8_t BottomUpAlpha32[] = {
+        200, 100, 50, 255, 100, 50, 25, 128, 0, 0, 0, 0,
+        64, 64, 64, 64, 7, 15, 22, 191, 0, 1, 1, 1,
+        0, 0, 0, 0, 254, 0, 0, 254, 0, 1, 1, 100,
+    };
+
+    // The fourth byte is 0x40 throughout; without an alpha mask it is padding.
+    constexpr uint8_t TopDownNoAlpha32[] = {
+        1, 2, 33, 255, 12, 2, 33, 255, 23, 2, 33, 255,
+        1, 24, 33, 255, 12, 24, 33, 255, 23, 24, 33, 255,
+    };
+
+    const Sample Samples[] = {
+        { "rgb24-bottom-up-5x3.bmp", 5, 3, [](uint32_t x, uint32_t y) { return fromTable(BottomUp24, 5, x, y); }, {} },
+        { "rgb24-top-down-7x2.bmp", 7, 2, [](uint32_t x, uint32_t y) { return fromTable(TopDown24, 7, x, y); }, {} },
+        { "rgba32-bottom-up-3x3.bmp", 3, 3, [](uint32_t x, uint32_t y) { return fromTable(BottomUpAlpha32, 3, x, y); }, {} },
+        { "rgbx32-top-down-3x2.bmp", 3, 2, [](uint32_t x, uint32_t y) { return fromTable(TopDownNoAlpha32, 3, x, y); }, {} },
+        // Opaque red columns between fully transparent green ones.
+        { "rgba32-stripes-128x64.bmp", 128, 64,
+            [](uint32_t x, uint32_t) { return x % 2 == 0 ? Pixel{ 255, 0, 0, 255 } : Pixel{ 0, 0, 0, 0 }; },
+            { { 64, 64, 32, { 128, 0, 0, 128 } } } },
+        // 99 is not a multiple of 64, so every output column straddles input columns.
+        { "rgb24-flat-99x33.bmp", 99, 33, [](uint32_t, uint32_t) { return Pixel{ 10, 20, 30, 255 }; },
+            { { 64, 64, 21, { 10, 20, 30, 255 } } } },
+    };
+
+    bool failed = false;
+
+    bool expect(bool condition, const char* test, const std::string& what) {
+        if (!condition && !failed) {
+            std::fprintf(stderr, "%s: %s\n", test, what.c_str());
+            failed = true;
+        }
+        return condition;
+    }
+
+    std::string describe(const Pixel& pixel) {
+        return "(" + std::to_string(pixel[0]) + ", " + std::to_string(pixel[1]) + ", " + std::to_string(pixel[2]) + ", "
+            + std::to_string(pixel[3]) + ")";
+    }
+
+    Pixel pixelOf(const audio::RgbaImage& image, uint32_t x, uint32_t y) {
+        const auto* pixel = image.pixels.data() + (static_cast<size_t>(y) * image.width + x) * 4;
+        return { pixel[0], pixel[1], pixel[2], pixel[3] };
+    }
+
+    // Compares image with what expected(x, y) says, reporting the first pixel that differs.
+    template <typename Expected>
+    bool matches(const audio::RgbaImage& image, uint32_t width, uint32_t height, Expected&& expected, const char* test, const char* stage) {
+        if (!expect(image.width == width && image.height == height && image.pixels.size() == static_cast<size_t>(width) * height * 4, test,
+                std::string(stage) + ": " + std::to_string(image.width) + "x" + std::to_string(image.height) + ", expected "
+                    + std::to_string(width) + "x" + std::to_string(height)))
+            return false;
+        for (uint32_t y = 0; y < height; ++y) {
+            for (uint32_t x = 0; x < width; ++x) {
+                const auto actual = pixelOf(image, x, y);
+                const Pixel wanted = expected(x, y);
+                if (!expect(actual == wanted, test, std::string(stage) + ": pixel " + std::to_string(x) + "," + std::to_string(y) + " is "
+                        + describe(actual) + ", expected " + describe(wanted)))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    std::shared_ptr<const std::vector<uint8_t>> load(const Options& options, const Sample& sample) {
+        std::ifstream file(options.samples / sample.file, std::ios::binary);
+        if (!expect(static_cast<bool>(file), sample.file, "cannot read " + (options.samples / sample.file).string()))
+            return nullptr;
+        return std::make_shared<const std::vector<uint8_t>>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void decodes(const Options& options, const Sample& sample) {
+        auto encoded = load(options, sample);
+        if (!encoded)
+            return;
+        audio::platform::BmpImageDecoder decoder;
+        auto decoded = decoder.decode(*encoded);
+        if (!expect(decoded.has_value(), sample.file, decoded ? std::string() : "decode failed: " + decoded.error().message()))
+            return;
+        matches(*decoded, sample.width, sample.height, sample.at, sample.file, "decoded");
+    }
+
+    void scales(const Options& options, const Sample& sample) {
+        auto encoded = load(options, sample);
+        if (!encoded)
+            return;
+        audio::ThumbnailProcessor processor(std::make_unique<audio::platform::BmpImageDecoder>(),
+            std::vector<uint32_t>(std::begin(Sizes), std::end(Sizes)));
+        processor.refresh([encoded]() -> std::expected<audio::ThumbnailCache::Buffer, audio::AudioError> { return encoded; });
+
+        for (uint32_t size : Sizes) {
+            auto image = processor.get(size);
+            const auto deadline = Clock::now() + std::chrono::seconds(5);
+            while (!image && image.error().category() == audio::ErrorCategory::NotReady && Clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                image = processor.get(size);
+            }
+            const std::string stage = std::to_string(size) + " px";
+            if (!expect(image.has_value(), sample.file, stage + ": " + (image ? std::string() : image.error().message())))
+                return;
+            const Scaled* scaled = nullptr;
+            for (const auto& candidate : sample.scaled) {
+                if (candidate.size == size)
+                    scaled = &candidate;
+            }
+            if (scaled)
+                matches(**image, scaled->width, scaled->height, [scaled](uint32_t, uint32_t) { return scaled->pixel; }, sample.file, stage.c_str());
+            else
+                matches(**image, sample.width, sample.height, sample.at, sample.file, stage.c_str());
+            if (failed)
+                return;
+        }
+        expect(processor.stats().decodes == 1 && processor.stats().failures == 0, sample.file, "the processor decoded more than once or failed");
+    }
+
+    void timing(const Options& options) {
+        for (const auto& sample : Samples) {
+            auto encoded = load(options, sample);
+            if (!encoded)
+                return;
+            audio::platform::BmpImageDecoder decoder;
+            double decodeSeconds = 0;
+            double scaleSeconds = 0;
+            for (uint64_t i = 0; i < options.iterations; ++i) {
+                auto started = Clock::now();
+                auto decoded = decoder.decode(*encoded);
+                auto middle = Clock::now();
+                if (!expect(decoded.has_value(), sample.file, "decode failed while timing"))
+                    return;
+                const audio::RgbaImage* from = &*decoded;
+                audio::RgbaImage variants[std::size(Sizes)];
+                for (size_t v = std::size(Sizes); v-- > 0;) {
+                    variants[v] = audio::ImageScaler::fit(*from, Sizes[v]);
+                    from = &variants[v];
+                }
+                decodeSeconds += std::chrono::duration<double>(middle - started).count();
+                scaleSeconds += std::chrono::duration<double>(Clock::now() - middle).count();
+            }
+            std::printf("%-28s decode %8.2f us, scale to all sizes %8.2f us\n", sample.file,
+                decodeSeconds / static_cast<double>(options.iterations) * 1e6, scaleSeconds / static_cast<double>(options.iterations) * 1e6);
+        }
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = true;
+            if (name == "--samples")
+                options.samples = std::filesystem::path(value);
+            else if (name == "--iterations")
+                parsed = parseNumber(value, options.iterations) && options.iterations > 0;
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    for (const auto& sample : Samples) {
+        decodes(options, sample);
+        scales(options, sample);
+        if (failed) {
+            std::printf("FAILED: %s\n", sample.file);
+            return 1;
+        }
+        std::printf("ok: %s\n", sample.file);
+    }
+    timing(options);
+    return failed ? 1 : 0;
+}
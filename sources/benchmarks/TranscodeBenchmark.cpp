@@ -0,0 +1,248 @@
+// Throughput of audio::Utf16, vector path against the scalar one, in both directions over
+// text shaped like player metadata: pure ASCII, mostly ASCII with accents, Cyrillic, CJK and
+// text with emoji (surrogate pairs).
+//
+// Before timing anything it fuzzes the converters: --verify random strings, each built from
+// ASCII, two- and three-unit characters, valid surrogate pairs, lone surrogates and (for
+// UTF-8) stray bytes, are converted with both paths into buffers of random capacity. The two
+// paths must agree unit for unit, stay within the capacity, and round-trip any UTF-16 without
+// lone surrogates; the first disagreement is printed and the run fails. The strings run up to
+// 96 units, so each goes through the block loop and, with the capacity cut short, the
+// character-at-a-time tail.
+//
+// Build it from this file and Utf16.cpp; it needs nothing else.
+//
+//     TranscodeBenchmark [--bytes N] [--rounds N] [--verify N] [--seed N]
+
+#include "Utf16.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        uint64_t bytes{ 1 << 20 };
+        uint64_t rounds{ 200 };
+        uint64_t verify{ 200000 };
+        uint64_t seed{ 1 };
+    };
+
+    struct Corpus {
+        const char* name;
+        // Characters drawn from, as code points; one in every `every` comes from rare.
+        std::u32string common;
+        std::u32string rare;
+        unsigned every;
+    };
+
+    std::u32string range(char32_t first, char32_t last) {
+        std::u32string codes;
+        for (auto code = first; code <= last; ++code)
+            codes.push_back(code);
+        return codes;
+    }
+
+    std::vector<Corpus> corpora() {
+        const auto ascii = range(U' ', U'~');
+        return {
+            { "ascii", ascii, {}, 0 },
+            { "latin", ascii, range(0xC0, 0xFF), 12 },
+            { "cyrillic", range(0x410, 0x44F), ascii, 6 },
+            { "cjk", range(0x4E00, 0x4FFF), range(0x3041, 0x3096), 4 },
+            { "emoji", ascii, range(0x1F600, 0x1F64F), 8 },
+        };
+    }
+
+    void append(std::u16string& text, char32_t code) {
+        if (code < 0x10000) {
+            text.push_back(static_cast<char16_t>(code));
+            return;
+        }
+        text.push_back(static_cast<char16_t>(0xD800 + ((code - 0x10000) >> 10)));
+        text.push_back(static_cast<char16_t>(0xDC00 + ((code - 0x10000) & 0x3FF)));
+    }
+
+    std::u16string generate(const Corpus& corpus, size_t units, std::mt19937_64& random) {
+        std::u16string text;
+        while (text.size() < units) {
+            const auto& pool = corpus.every != 0 && random() % corpus.every == 0 ? corpus.rare : corpus.common;
+            append(text, pool[random() % pool.size()]);
+        }
+        return text;
+    }
+
+    std::u16string randomUtf16(std::mt19937_64& random) {
+        std::u16string text;
+        const auto length = random() % 96;
+        while (text.size() < length) {
+            const auto kind = random() % 100;
+            if (kind < 55)
+                text.push_back(static_cast<char16_t>(random() % 0x80));
+            else if (kind < 70)
+                text.push_back(static_cast<char16_t>(0x80 + random() % 0x780));
+            else if (kind < 85)
+                text.push_back(static_cast<char16_t>(0x800 + random() % 0xD000));
+            else if (kind < 95)
+                append(text, static_cast<char32_t>(0x10000 + random() % 0x100000));
+            else
+                text.push_back(static_cast<char16_t>(0xD800 + random() % 0x800));
+        }
+        return text;
+    }
+
+    std::string randomUtf8(std::mt19937_64& random) {
+        auto text = audio::Utf16::toUtf8(randomUtf16(random));
+        const auto strays = random() % 4;
+        for (uint64_t i = 0; i < strays && !text.empty(); ++i)
+            text[random() % text.size()] = static_cast<char>(0x80 + random() % 0x80);
+        return text;
+    }
+
+    bool hasLoneSurrogate(std::u16string_view text) {
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] >= 0xDC00 && text[i] <= 0xDFFF)
+                return true;
+            if (text[i] >= 0xD800 && text[i] <= 0xDBFF) {
+                if (i + 1 == text.size() || text[i + 1] < 0xDC00 || text[i + 1] > 0xDFFF)
+                    return true;
+                ++i;
+            }
+        }
+        return false;
+    }
+
+    template <typename Unit>
+    bool sameOutput(const std::vector<Unit>& vector, size_t vectorSize, const std::vector<Unit>& scalar, size_t scalarSize, size_t capacity, Unit guard) {
+        return vectorSize == scalarSize && vectorSize <= capacity && vector[capacity] == guard
+            && std::equal(vector.begin(), vector.begin() + static_cast<ptrdiff_t>(vectorSize), scalar.begin());
+    }
+
+    // Random capacities, a third of the time short of what the text needs, exercise the
+    // never-split-a-character rule on both paths.
+    size_t randomCapacity(size_t needed, std::mt19937_64& random) {
+        return random() % 3 == 0 ? static_cast<size_t>(random() % (needed + 1)) : needed;
+    }
+
+    bool verify(const Options& options) {
+        std::mt19937_64 random(options.seed);
+        for (uint64_t i = 0; i < options.verify; ++i) {
+            const auto utf16 = randomUtf16(random);
+            const auto bytes = randomCapacity(utf16.size() * audio::Utf16::MaxUtf8PerUnit, random);
+            std::vector<char> vectorOut(bytes + 1, '\x7F');
+            std::vector<char> scalarOut(bytes + 1, '\x7F');
+            const auto vectorBytes = audio::Utf16::toUtf8(utf16, vectorOut.data(), bytes);
+            const auto scalarBytes = audio::Utf16::toUtf8Scalar(utf16, scalarOut.data(), bytes);
+            if (!sameOutput(vectorOut, vectorBytes, scalarOut, scalarBytes, bytes, '\x7F')) {
+                std::fprintf(stderr, "UTF-16 to UTF-8 mismatch on case %llu (%zu units, capacity %zu)\n",
+                    static_cast<unsigned long long>(i), utf16.size(), bytes);
+                return false;
+            }
+            if (!hasLoneSurrogate(utf16) && audio::Utf16::toUtf16(audio::Utf16::toUtf8(utf16)) != utf16) {
+                std::fprintf(stderr, "Round trip failed on case %llu\n", static_cast<unsigned long long>(i));
+                return false;
+            }
+
+            const auto utf8 = randomUtf8(random);
+            const auto units = randomCapacity(utf8.size() * audio::Utf16::MaxUtf16PerByte, random);
+            std::vector<char16_t> vectorUnits(units + 1, u'\x7F');
+            std::vector<char16_t> scalarUnits(units + 1, u'\x7F');
+            const auto vectorCount = audio::Utf16::toUtf16(utf8, vectorUnits.data(), units);
+            const auto scalarCount = audio::Utf16::toUtf16Scalar(utf8, scalarUnits.data(), units);
+            if (!sameOutput(vectorUnits, vectorCount, scalarUnits, scalarCount, units, u'\x7F')) {
+                std::fprintf(stderr, "UTF-8 to UTF-16 mismatch on case %llu (%zu bytes, capacity %zu)\n",
+                    static_cast<unsigned long long>(i), utf8.size(), units);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Input megabytes per second over the rounds, after one untimed round.
+    template <typename Convert>
+    double throughput(size_t inputBytes, uint64_t rounds, Convert&& convert) {
+        size_t sink = convert();
+        const auto started = Clock::now();
+        for (uint64_t round = 0; round < rounds; ++round)
+            sink += convert();
+        const auto seconds = std::chrono::duration<double>(Clock::now() - started).count();
+        if (sink == 0)
+            std::fprintf(stderr, "Nothing was converted\n");
+        return seconds > 0 ? static_cast<double>(inputBytes * rounds) / seconds / 1e6 : 0.0;
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = false;
+            if (name == "--bytes")
+                parsed = parseNumber(value, options.bytes);
+            else if (name == "--rounds")
+                parsed = parseNumber(value, options.rounds);
+            else if (name == "--verify")
+                parsed = parseNumber(value, options.verify);
+            else if (name == "--seed")
+                parsed = parseNumber(value, options.seed);
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    if (!verify(options))
+        return 1;
+    std::printf("verified %llu random strings in each direction\n\n", static_cast<unsigned long long>(options.verify));
+
+    std::printf("%-9s %-12s %12s %12s %8s\n", "corpus", "direction", "scalar MB/s", "vector MB/s", "speedup");
+    std::mt19937_64 random(options.seed);
+    for (const auto& corpus : corpora()) {
+        const auto utf16 = generate(corpus, options.bytes / sizeof(char16_t), random);
+        const auto utf8 = audio::Utf16::toUtf8(utf16);
+        std::vector<char> bytes(utf16.size() * audio::Utf16::MaxUtf8PerUnit);
+        std::vector<char16_t> units(utf8.size() * audio::Utf16::MaxUtf16PerByte);
+
+        const auto inputUtf16 = utf16.size() * sizeof(char16_t);
+        const auto scalarTo8 = throughput(inputUtf16, options.rounds, [&] { return audio::Utf16::toUtf8Scalar(utf16, bytes.data(), bytes.size()); });
+        const auto vectorTo8 = throughput(inputUtf16, options.rounds, [&] { return audio::Utf16::toUtf8(utf16, bytes.data(), bytes.size()); });
+        std::printf("%-9s %-12s %12.0f %12.0f %7.2fx\n", corpus.name, "utf16->utf8", scalarTo8, vectorTo8, vectorTo8 / scalarTo8);
+
+        const auto scalarTo16 = throughput(utf8.size(), options.rounds, [&] { return audio::Utf16::toUtf16Scalar(utf8, units.data(), units.size()); });
+        const auto vectorTo16 = throughput(utf8.size(), options.rounds, [&] { return audio::Utf16::toUtf16(utf8, units.data(), units.size()); });
+        std::printf("%-9s %-12s %12.0f %12.0f %7.2fx\n", corpus.name, "utf8->utf16", scalarTo16, vectorTo16, vectorTo16 / scalarTo16);
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+// Behaviour checks and read cost of audio::VolumeController, over the in-memory
+// audio::platform::FakeVolumeEndpoint, whose counters show every call that reached the endpoint.
+//
+// The endpoint is opened once and read once for each half of the state; later reads come from
+// the controller. Each change reaches listeners exactly once: our own write, the endpoint
+// echoing it back, an external change and a repeat of the current state must produce one,
+// one, one and no notification. Then --threads threads set volume and mute against each other
+// --rounds times; every notification must carry the state the controller holds while it is
+// delivered, no two in a row may be the same, and the last one must match the final state.
+// The first mismatch is printed and the run fails; then a cached read is timed.
+//
+// Build it from this file, VolumeController.cpp, FakeVolumeEndpoint.cpp, OperationStats.cpp,
+// TickClock.cpp, Tracer.cpp and AudioError.cpp.
+//
+//     VolumeBenchmark [--threads N] [--rounds N] [--iterations N]
+
+#include "VolumeController.h"
+#include "FakeVolumeEndpoint.h"
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using audio::platform::FakeVolumeEndpoint;
+
+    struct Options {
+        uint64_t threads{ 4 };
+        uint64_t rounds{ 2000 };
+        uint64_t iterations{ 1000000 };
+    };
+
+    bool failed = false;
+
+    bool expect(bool condition, const char* test, const char* what) {
+        if (!condition && !failed) {
+            std::fprintf(stderr, "%s: %s\n", test, what);
+            failed = true;
+        }
+        return condition;
+    }
+
+    // The controller owns its endpoint; the raw pointer stays valid as long as it does.
+    struct Fixture {
+        FakeVolumeEndpoint* endpoint;
+        audio::VolumeController controller;
+
+        Fixture() : Fixture(std::make_unique<FakeVolumeEndpoint>()) {}
+
+    private:
+        explicit Fixture(std::unique_ptr<FakeVolumeEndpoint> owned) : endpoint(owned.get()), controller(std::move(owned)) {}
+    };
+
+    struct Recorder {
+        std::mutex mutex;
+        std::vector<std::pair<double, bool>> notes;
+
+        audio::VolumeController::VolumeChangedCallback callback() {
+            return [this](double volume, bool muted) {
+                std::scoped_lock lock(mutex);
+                notes.emplace_back(volume, muted);
+            };
+        }
+    };
+
+    void cachedReads(const Options&) {
+        Fixture fixture;
+        for (int i = 0; i < 100; ++i) {
+            expect(fixture.controller.getVolume().value_or(-1.0) == 1.0, "cached reads", "wrong initial volume");
+            expect(fixture.controller.isMuted().has_value() && !*fixture.controller.isMuted(), "cached reads", "wrong initial mute");
+        }
+        expect(fixture.endpoint->opens() == 1, "cached reads", "the endpoint was not opened exactly once");
+        expect(fixture.endpoint->reads() == 2, "cached reads", "reads went past the cached state");
+        expect(fixture.endpoint->writes() == 0, "cached reads", "a read wrote to the endpoint");
+    }
+
+    void notifiedOnce(const Options&) {
+        Fixture fixture;
+        Recorder recorder;
+        const auto id = fixture.controller.subscribe(recorder.callback());
+        const auto invalid = fixture.controller.setVolume(1.5);
+        expect(!invalid && invalid.error().category() == audio::ErrorCategory::InvalidArgument, "notified once", "an out-of-range volume was accepted");
+
+        (void)fixture.controller.setVolume(0.5);
+        fixture.endpoint->simulateExternalChange(0.5f, false);
+        (void)fixture.controller.setVolume(0.5);
+        (void)fixture.controller.setMuted(true);
+        fixture.endpoint->simulateExternalChange(0.25f, true);
+        expect(fixture.controller.getVolume().value_or(-1.0) == 0.25, "notified once", "an external change was not picked up");
+        fixture.controller.unsubscribe(id);
+        (void)fixture.controller.setMuted(false);
+
+        const std::vector<std::pair<double, bool>> expected{ { 0.5, false }, { 0.5, true }, { 0.25, true } };
+        expect(recorder.notes == expected, "notified once", "notifications were missing, repeated or out of order");
+        expect(fixture.endpoint->writes() == 4, "notified once", "a write did not reach the endpoint");
+        expect(fixture.endpoint->reads() == 2, "notified once", "a change was read back from the endpoint");
+    }
+
+    void racingWriters(const Options& options) {
+        uint64_t notifications = 0;
+        for (uint64_t round = 0; round < options.rounds && !failed; ++round) {
+            Fixture fixture;
+            (void)fixture.controller.getVolume();
+            std::mutex mutex;
+            std::vector<std::pair<double, bool>> notes;
+            bool torn = false;
+            fixture.controller.subscribe([&](double volume, bool muted) {
+                // Delivery runs in the same critical section as the update, so the controller
+                // still holds exactly this state.
+                const bool held = fixture.controller.getVolume().value_or(-1.0) == volume && fixture.controller.isMuted().value_or(!muted) == muted;
+                std::scoped_lock lock(mutex);
+                torn |= !held;
+                notes.emplace_back(volume, muted);
+            });
+            std::vector<std::thread> threads;
+            for (uint64_t t = 0; t < options.threads; ++t) {
+                threads.emplace_back([&, t] {
+                    for (int i = 0; i < 25; ++i) {
+                        if (t % 2 == 0)
+                            (void)fixture.controller.setMuted((i + t) % 2 == 0);
+                        else
+                            (void)fixture.controller.setVolume(static_cast<double>((i * 7 + t) % 100) / 100.0);
+                    }
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+
+            expect(!torn, "racing writers", "a listener was told a state the controller did not hold");
+            bool repeated = false;
+            for (size_t i = 1; i < notes.size(); ++i)
+                repeated |= notes[i] == notes[i - 1];
+            expect(!repeated, "racing writers", "the same state was announced twice in a row");
+            const std::pair<double, bool> last{ fixture.controller.getVolume().value_or(-1.0), fixture.controller.isMuted().value_or(false) };
+            expect(!notes.empty() && notes.back() == last, "racing writers", "the last notification is not the final state");
+            notifications += notes.size();
+        }
+        std::printf("%llu rounds of %llu racing writers, %llu notifications\n", static_cast<unsigned long long>(options.rounds),
+            static_cast<unsigned long long>(options.threads), static_cast<unsigned long long>(notifications));
+    }
+
+    void timeReads(const Options& options) {
+        Fixture fixture;
+        double sum = 0.0;
+        const auto started = Clock::now();
+        for (uint64_t i = 0; i < options.iterations; ++i)
+            sum += fixture.controller.getVolume().value_or(0.0);
+        const auto nanos = std::chrono::duration<double, std::nano>(Clock::now() - started).count() / static_cast<double>(options.iterations);
+        expect(sum == static_cast<double>(options.iterations) && fixture.endpoint->reads() == 2, "cached read cost", "a timed read reached the endpoint");
+        std::printf("cached getVolume %.1f ns\n", nanos);
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = false;
+            if (name == "--threads")
+                parsed = parseNumber(value, options.threads) && options.threads > 0;
+            else if (name == "--rounds")
+                parsed = parseNumber(value, options.rounds);
+            else if (name == "--iterations")
+                parsed = parseNumber(value, options.iterations) && options.iterations > 0;
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                return false;
+            }
+            if (!parsed) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    const struct {
+        const char* name;
+        void (*run)(const Options&);
+    } cases[] = {
+        { "cached reads", cachedReads },
+        { "notified once", notifiedOnce },
+        { "racing writers", racingWriters },
+    };
+    for (const auto& test : cases) {
+        test.run(options);
+        if (failed) {
+            std::printf("FAILED: %s\n", test.name);
+            return 1;
+        }
+        std::printf("ok: %s\n", test.name);
+    }
+    timeReads(options);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include "AudioError.h"
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace audio {
+
+    namespace detail {
+
+        template <typename T>
+        class AsyncState {
+        public:
+            using value_type = std::expected<T, AudioError>;
+
+            void complete(value_type value) {
+                std::function<void()> continuation;
+                {
+                    std::scoped_lock lock(m_mutex);
+                    if (m_result)
+                        return;
+                    m_result.emplace(std::move(value));
+                    continuation = std::move(m_continuation);
+                }
+                m_ready.notify_all();
+                if (continuation)
+                    continuation();
+            }
+
+            // Returns false when the result is already there, in which case continuation is not stored.
+            bool setContinuation(std::function<void()> continuation) {
+                std::scoped_lock lock(m_mutex);
+                if (m_result)
+                    return false;
+                m_continuation = std::move(continuation);
+                return true;
+            }
+
+            [[nodiscard]] bool ready() const {
+                std::scoped_lock lock(m_mutex);
+                return m_result.has_value();
+            }
+
+            value_type wait() {
+                std::unique_lock lock(m_mutex);
+                m_ready.wait(lock, [this] { return m_result.has_value(); });
+                return *m_result;
+            }
+
+        private:
+            mutable std::mutex m_mutex;
+            std::condition_variable m_ready;
+            std::optional<value_type> m_result;
+            std::function<void()> m_continuation;
+        };
+
+    }
+
+    // Eagerly started operation that completes with std::expected<T, AudioError>. It is the
+    // return type of the *Async coroutines and can be co_awaited, chained with then() for
+    // callback-style completion, or waited on with get(). The continuation runs on whichever
+    // thread completes the operation, so no thread is parked while the backend works.
+    template <typename T>
+    class AsyncResult {
+    public:
+        using value_type = std::expected<T, AudioError>;
+
+        struct promise_type {
+            std::shared_ptr<detail::AsyncState<T>> state = std::make_shared<detail::AsyncState<T>>();
+
+            AsyncResult get_return_object() noexcept { return AsyncResult(state); }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_value(value_type value) { state->complete(std::move(value)); }
+            void unhandled_exception() noexcept {
+                try {
+                    std::rethrow_exception(std::current_exception());
+                }
+                catch (const std::exception& ex) {
+                    state->complete(std::unexpected(AudioError::fromException("Asynchronous operation", ex)));
+                }
+                catch (...) {
+                    state->complete(std::unexpected(AudioError(ErrorCategory::Internal, "Asynchronous operation")));
+                }
+            }
+        };
+
+        // Lets producers that are not coroutines, such as worker queues, finish an AsyncResult.
+        class Completer {
+        public:
+            void operator()(value_type value) const { m_state->complete(std::move(value)); }
+
+        private:
+            friend class AsyncResult;
+            explicit Completer(std::shared_ptr<detail::AsyncState<T>> state) : m_state(std::move(state)) {}
+            std::shared_ptr<detail::AsyncState<T>> m_state;
+        };
+
+        [[nodiscard]] static std::pair<AsyncResult, Completer> pending() {
+            auto state = std::make_shared<detail::AsyncState<T>>();
+            return { AsyncResult(state), Completer(state) };
+        }
+
+        [[nodiscard]] static AsyncResult completed(value_type value) {
+            auto state = std::make_shared<detail::AsyncState<T>>();
+            state->complete(std::move(value));
+            return AsyncResult(std::move(state));
+        }
+
+        [[nodiscard]] bool isReady() const { return m_state->ready(); }
+
+        value_type get() const { return m_state->wait(); }
+
+        // Invokes callback once with the result, immediately if it is already available.
+        template <typename Callback>
+            requires std::invocable<Callback, const value_type&>
+        void then(Callback&& callback) const {
+            auto state = m_state;
+            auto run = [state, callback = std::forward<Callback>(callback)]() mutable {
+                callback(state->wait());
+            };
+            if (!m_state->setContinuation(run))
+                run();
+        }
+
+        bool await_ready() const { return m_state->ready(); }
+
+        bool await_suspend(std::coroutine_handle<> handle) const {
+            return m_state->setContinuation([handle] { handle.resume(); });
+        }
+
+        value_type await_resume() const { return m_state->wait(); }
+
+    private:
+        explicit AsyncResult(std::shared_ptr<detail::AsyncState<T>> state) : m_state(std::move(state)) {}
+
+        std::shared_ptr<detail::AsyncState<T>> m_state;
+    };
+
+}
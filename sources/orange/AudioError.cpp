@@ -0,0 +1,58 @@
+#include "AudioError.h"
+#include <charconv>
+
+namespace audio {
+
+    AudioError::AudioError(ErrorCategory category, const char* operation, int32_t hresult, std::string_view detail)
+        : m_category(category), m_hresult(hresult), m_operation(operation) {
+        if (!detail.empty())
+            m_detail = std::make_shared<const std::string>(detail);
+    }
+
+    AudioError AudioError::fromException(const char* operation, const std::exception& ex) noexcept {
+        try {
+            return AudioError(ErrorCategory::Internal, operation, 0, ex.what());
+        }
+        catch (...) {
+            return AudioError(ErrorCategory::Internal, operation);
+        }
+    }
+
+    std::string_view AudioError::detail() const noexcept {
+        return m_detail ? std::string_view(*m_detail) : std::string_view();
+    }
+
+    std::string AudioError::message() const {
+        std::string text = m_operation ? m_operation : "Operation";
+        text += " failed: ";
+        text += describe(m_category);
+        if (m_hresult != 0) {
+            char digits[8];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), static_cast<uint32_t>(m_hresult), 16);
+            text += " (HRESULT 0x";
+            text.append(static_cast<size_t>(8 - (end - digits)), '0');
+            text.append(digits, end);
+            text += ')';
+        }
+        if (m_detail) {
+            text += ": ";
+            text += *m_detail;
+        }
+        return text;
+    }
+
+    std::string_view AudioError::describe(ErrorCategory category) noexcept {
+        switch (category) {
+        case ErrorCategory::NoSession: return "no active session";
+        case ErrorCategory::NotReady: return "not ready yet";
+        case ErrorCategory::NotFound: return "not found";
+        case ErrorCategory::InvalidArgument: return "invalid argument";
+        case ErrorCategory::Unsupported: return "not supported";
+        case ErrorCategory::Interrupted: return "interrupted";
+        case ErrorCategory::Platform: return "platform error";
+        case ErrorCategory::Internal: return "internal error";
+        }
+        return "unknown error";
+    }
+
+}
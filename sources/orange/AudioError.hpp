@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace audio {
+
+    enum class ErrorCategory : uint8_t {
+        // No player is running, or the session the call was routed to has gone away.
+        NoSession,
+        // The result is being produced in the background and is not available yet.
+        NotReady,
+        // The session has no such item: no artwork, unknown session id.
+        NotFound,
+        InvalidArgument,
+        Unsupported,
+        // The state changed underneath the call, or the component serving it is shutting down.
+        Interrupted,
+        // An operating-system call failed; hresult() carries its code.
+        Platform,
+        Internal
+    };
+
+    // Failure value carried by every std::expected in the audio layer. The operation is a string
+    // literal and the common failures carry nothing else, so creating, copying and returning one
+    // never allocates; the readable text is only put together when message() is called. Errors
+    // with free-form detail (an exception's what(), a platform message) keep it in a shared
+    // string, which only happens on genuinely exceptional paths.
+    class AudioError {
+    public:
+        constexpr AudioError(ErrorCategory category, const char* operation, int32_t hresult = 0) noexcept
+            : m_category(category), m_hresult(hresult), m_operation(operation) {
+        }
+        AudioError(ErrorCategory category, const char* operation, int32_t hresult, std::string_view detail);
+
+        static AudioError fromException(const char* operation, const std::exception& ex) noexcept;
+
+        [[nodiscard]] constexpr ErrorCategory category() const noexcept { return m_category; }
+        [[nodiscard]] constexpr int32_t hresult() const noexcept { return m_hresult; }
+        [[nodiscard]] constexpr const char* operation() const noexcept { return m_operation; }
+        [[nodiscard]] std::string_view detail() const noexcept;
+
+        // "<operation> failed: <category>[ (HRESULT 0x........)][: <detail>]"
+        [[nodiscard]] std::string message() const;
+
+        [[nodiscard]] static std::string_view describe(ErrorCategory category) noexcept;
+
+    private:
+        ErrorCategory m_category;
+        int32_t m_hresult;
+        const char* m_operation;
+        std::shared_ptr<const std::string> m_detail;
+    };
+
+}
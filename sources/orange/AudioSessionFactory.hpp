@@ -1,14 +1,20 @@
 #pragma once
 #include "IAudioSession.h"
+#include "SessionRegistry.h"
+#include "ThumbnailProcessor.h"
 #include <memory>
 #include <expected>
 #include <string>
 
 namespace audio {
 
+    // The one place that knows which backend this build talks to: GSMTC and WIC on Windows,
+    // MPRIS over D-Bus on Linux. Everything above it only sees the interfaces.
     class AudioSessionFactory {
     public:
-        static std::expected<std::shared_ptr<IAudioSession>, std::string> createCurrentSession() noexcept;
+        static std::expected<std::shared_ptr<IAudioSession>, AudioError> createCurrentSession() noexcept;
+        static std::unique_ptr<ISessionSource> createSessionSource(std::shared_ptr<ThumbnailCache> thumbnails);
+        static std::unique_ptr<IImageDecoder> createImageDecoder();
     };
 
 } 
\ No newline at end of file
@@ -1,94 +1,710 @@
 #include "AudioSessionManager.h"
+#ifdef _WIN32
 #include "WinRTAudioSession.h"
+#include "WinRTSessionSource.h"
+#include "WicImageDecoder.h"
+#else
+#include "MprisSessionSource.h"
+#include "BmpImageDecoder.h"
+#endif
+#include "ScriptedSessionSource.h"
+#include "CommandQueue.h"
+#include "Tracer.h"
+#include <atomic>
 #include <memory>
-#include <format>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
 #include "AudioSessionFactory.h" 
 namespace audio {
 
     class AudioSessionManager::Impl {
     public:
-        std::shared_ptr<platform::WinRTAudioSession> session;
-        Impl() : session(std::make_shared<platform::WinRTAudioSession>()) {}
+        std::shared_ptr<ThumbnailCache> thumbnails = std::make_shared<ThumbnailCache>();
+        // Declared before the registry so its worker can still reach the registry until ~Impl stops it.
+        ThumbnailProcessor thumbnailProcessor{ AudioSessionFactory::createImageDecoder() };
+        // Likewise: sessions submit to it until the registry is gone; ~Impl stops it first.
+        PlaybackDebouncer playbackDebouncer{ [this](const PlaybackEvent& event) { deliverPlaybackEvent(event); } };
+        // Likewise written by the registry callbacks; shared with the volume listener, which a
+        // session may still call once after it is unsubscribed.
+        std::shared_ptr<StateBlock> state = std::make_shared<StateBlock>();
+        EventQueue events;
+        EventSubscribers subscribers;
+        OperationStats stats;
+        StringPool strings;
+
+        std::mutex callbackMutex;
+        PlaybackChangedCallback playbackChanged;
+        PlaybackEventCallback playbackEvent;
+        TrackChangedCallback trackChanged;
+        SessionRegistry::ActiveSessionChangedCallback activeChanged;
+        std::shared_ptr<PlayTracker> history;
+        // Registered with the shared ticker on the first subscribePosition.
+        std::shared_ptr<PositionTicker::Source> positionSource;
+        // Rate of the last playback event, as the session getters do not report it.
+        std::atomic<double> playbackRate{ 1.0 };
+        // The session whose volume changes feed the state block; moved on every active change.
+        std::mutex volumeMutex;
+        std::shared_ptr<SessionRegistry::Entry> volumeEntry;
+        VolumeController::SubscriptionId volumeSubscription{ 0 };
+        // Declared last, so it is destroyed first: its source and sessions call the handlers
+        // from wireRegistryCallbacks, which reach every member above, until it is gone.
+        SessionRegistry registry;
+
+        Impl() : registry(AudioSessionFactory::createSessionSource(thumbnails)) {
+            Tracer::startFromEnvironment();
+            wireRegistryCallbacks();
+        }
+        explicit Impl(std::shared_ptr<IAudioSession> session)
+            : registry(std::make_unique<platform::ScriptedSessionSource>(std::string(InjectedSessionId), std::move(session))) {
+            Tracer::startFromEnvironment();
+            wireRegistryCallbacks();
+        }
+        ~Impl() {
+            PositionTicker::shared().removeSource(positionSource);
+            followVolume(nullptr);
+            playbackDebouncer.stop();
+            thumbnailProcessor.stop();
+        }
+
+        // The registry has one slot per event; the manager keeps those slots, records each event
+        // in the queue and schedules the artwork of a new track or session, then forwards to the
+        // caller's callback and every subscriber of that kind.
+        void wireRegistryCallbacks() {
+            registry.setPlaybackEventCallback([this](const PlaybackEvent& event) {
+                if (auto tracker = historyTracker())
+                    tracker->playbackChanged(event.current.status);
+                playbackRate.store(event.current.rate, std::memory_order_relaxed);
+                publishPlayback(event.current);
+                resyncPosition();
+                playbackDebouncer.submit(event);
+            });
+            registry.setTrackChangedCallback([this](std::string_view title, std::string_view artist) {
+                TraceSpan trace("event", "Track changed");
+                events.push(SessionEvent::Kind::TrackChanged);
+                stats.recordEvent(SessionEvent::Kind::TrackChanged);
+                refreshThumbnail();
+                followTrack();
+                publishState();
+                resyncPosition();
+                TrackChangedCallback callback;
+                {
+                    std::scoped_lock lock(callbackMutex);
+                    callback = trackChanged;
+                }
+                if (callback)
+                    callback(title, artist);
+                SessionNotification notification;
+                notification.kind = SessionEvent::Kind::TrackChanged;
+                notification.title = title;
+                notification.artist = artist;
+                subscribers.publish(notification);
+            });
+            registry.setActiveSessionChangedCallback([this](std::string_view id) {
+                TraceSpan trace("event", "Active session changed");
+                events.push(SessionEvent::Kind::ActiveSessionChanged);
+                stats.recordEvent(SessionEvent::Kind::ActiveSessionChanged);
+                refreshThumbnail();
+                followTrack();
+                playbackRate.store(1.0, std::memory_order_relaxed);
+                followVolume(registry.active());
+                publishState();
+                resyncPosition();
+                SessionRegistry::ActiveSessionChangedCallback callback;
+                {
+                    std::scoped_lock lock(callbackMutex);
+                    callback = activeChanged;
+                }
+                if (callback)
+                    callback(id);
+                SessionNotification notification;
+                notification.kind = SessionEvent::Kind::ActiveSessionChanged;
+                notification.sessionId = id;
+                subscribers.publish(notification);
+            });
+        }
+
+        // Playback events pass the debouncer first, so the queue and both callbacks see the same
+        // collapsed stream.
+        void deliverPlaybackEvent(const PlaybackEvent& event) {
+            TraceSpan trace("event", "Playback changed");
+            events.push(SessionEvent::Kind::PlaybackChanged);
+            stats.recordEvent(SessionEvent::Kind::PlaybackChanged);
+            PlaybackEventCallback typed;
+            PlaybackChangedCallback changed;
+            {
+                std::scoped_lock lock(callbackMutex);
+                typed = playbackEvent;
+                changed = playbackChanged;
+            }
+            if (typed)
+                typed(event);
+            if (changed)
+                changed("Playback info updated");
+            SessionNotification notification;
+            notification.kind = SessionEvent::Kind::PlaybackChanged;
+            notification.playback = &event;
+            subscribers.publish(notification);
+        }
+
+        void refreshThumbnail() {
+            thumbnailProcessor.refresh([this]() -> std::expected<ThumbnailCache::Buffer, AudioError> {
+                auto entry = registry.active();
+                if (!entry)
+                    return std::unexpected(AudioError(ErrorCategory::NoSession, "Get thumbnail"));
+                return entry->session->getThumbnail();
+            });
+        }
+
+        // What the ticker extrapolates from between resyncs: the active session's status and
+        // duration from its snapshot, and its precise position.
+        std::expected<PositionTicker::Sample, AudioError> samplePosition() {
+            auto entry = registry.active();
+            if (!entry)
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Get position"));
+            auto snapshot = entry->session->getTrackSnapshot();
+            if (!snapshot)
+                return std::unexpected(snapshot.error());
+            auto position = entry->session->getCurrentPositionPrecise();
+            if (!position)
+                return std::unexpected(position.error());
+            publishPosition(*position);
+            PositionTicker::Sample sample;
+            sample.timeline.position = *position;
+            sample.timeline.end = std::chrono::duration_cast<std::chrono::milliseconds>(snapshot->duration);
+            sample.playback.status = snapshot->status;
+            sample.playback.rate = playbackRate.load(std::memory_order_relaxed);
+            return sample;
+        }
+
+        void resyncPosition() {
+            std::shared_ptr<PositionTicker::Source> source;
+            {
+                std::scoped_lock lock(callbackMutex);
+                source = positionSource;
+            }
+            PositionTicker::shared().resync(source);
+        }
+
+        // Rewrites the whole state block from the active session, for track and session changes.
+        void publishState() {
+            auto entry = registry.active();
+            if (!entry) {
+                state->update([](StateBlock::State& current) { current = StateBlock::State{}; });
+                return;
+            }
+            auto snapshot = entry->session->getTrackSnapshot();
+            auto position = entry->session->getCurrentPositionPrecise();
+            auto volume = entry->session->getVolume();
+            const auto anchoredAt = StateBlock::Clock::now();
+            const auto rate = playbackRate.load(std::memory_order_relaxed);
+            state->update([&](StateBlock::State& current) {
+                const auto muted = current.muted;
+                current = StateBlock::State{};
+                current.hasSession = true;
+                current.muted = muted;
+                current.rate = rate;
+                current.anchoredAt = anchoredAt;
+                if (snapshot) {
+                    current.status = snapshot->status;
+                    current.position = snapshot->position;
+                    current.duration = snapshot->duration;
+                    current.trackId = HistoryJournal::trackId(snapshot->title, snapshot->artist, snapshot->album, snapshot->duration);
+                    current.title = std::move(snapshot->title);
+                    current.artist = std::move(snapshot->artist);
+                    current.album = std::move(snapshot->album);
+                }
+                if (position)
+                    current.position = *position;
+                if (volume)
+                    current.volume = *volume;
+            });
+        }
+
+        // Playback events change status and rate; the position is re-anchored with them, as
+        // extrapolating across a pause or a rate change would drift.
+        void publishPlayback(const PlaybackState& playback) {
+            std::optional<std::chrono::milliseconds> position;
+            if (auto entry = registry.active()) {
+                if (auto precise = entry->session->getCurrentPositionPrecise())
+                    position = *precise;
+            }
+            const auto anchoredAt = StateBlock::Clock::now();
+            state->update([&](StateBlock::State& current) {
+                current.status = playback.status;
+                current.rate = playback.rate;
+                if (position) {
+                    current.position = *position;
+                    current.anchoredAt = anchoredAt;
+                }
+            });
+        }
+
+        void publishPosition(std::chrono::milliseconds position) {
+            const auto anchoredAt = StateBlock::Clock::now();
+            state->update([&](StateBlock::State& current) {
+                current.position = position;
+                current.anchoredAt = anchoredAt;
+            });
+        }
+
+        // Sessions report mute only through change events, so a new session starts unmuted. The
+        // listener holds the block weakly: it may outlive the manager by one call.
+        void followVolume(std::shared_ptr<SessionRegistry::Entry> entry) {
+            std::scoped_lock lock(volumeMutex);
+            if (entry == volumeEntry)
+                return;
+            if (volumeEntry)
+                volumeEntry->session->unsubscribeVolumeChanged(volumeSubscription);
+            volumeEntry = std::move(entry);
+            volumeSubscription = 0;
+            state->update([](StateBlock::State& current) { current.muted = false; });
+            if (!volumeEntry)
+                return;
+            volumeSubscription = volumeEntry->session->subscribeVolumeChanged([block = std::weak_ptr<StateBlock>(state)](double volume, bool muted) {
+                if (auto target = block.lock()) {
+                    target->update([&](StateBlock::State& current) {
+                        current.volume = volume;
+                        current.muted = muted;
+                    });
+                }
+            });
+        }
+
+        std::shared_ptr<PlayTracker> historyTracker() {
+            std::scoped_lock lock(callbackMutex);
+            return history;
+        }
+
+        // Hands the history the track the active session is on now; the play before it ends.
+        void followTrack() {
+            auto tracker = historyTracker();
+            if (!tracker)
+                return;
+            auto entry = registry.active();
+            if (!entry) {
+                tracker->finish();
+                return;
+            }
+            auto snapshot = entry->session->getTrackSnapshot();
+            if (snapshot)
+                tracker->trackChanged(*snapshot);
+            else
+                tracker->finish();
+        }
+
+        // The no-session error carries only literals, so polling without a player never allocates.
+        // Every call is timed, the no-session case included, and counted as an error if it fails.
+        template <typename Call>
+        auto withActive(StatOperation statistic, const char* operation, Call&& call) {
+            using Result = std::invoke_result_t<Call, SessionRegistry::Entry&>;
+            return stats.measure(statistic, [&]() -> Result {
+                auto entry = registry.active();
+                if (!entry)
+                    return std::unexpected(AudioError(ErrorCategory::NoSession, operation));
+                return call(*entry);
+            });
+        }
+
+        template <typename Call>
+        auto withActiveAsync(const char* operation, Call&& call) const {
+            using Result = std::invoke_result_t<Call, SessionRegistry::Entry&>;
+            auto entry = registry.active();
+            if (!entry)
+                return Result::completed(std::unexpected(AudioError(ErrorCategory::NoSession, operation)));
+            return call(*entry);
+        }
     };
 
-    std::expected<std::shared_ptr<IAudioSession>, std::string> AudioSessionFactory::createCurrentSession() noexcept {
+    std::expected<std::shared_ptr<IAudioSession>, AudioError> AudioSessionFactory::createCurrentSession() noexcept {
         try {
+#ifdef _WIN32
             auto session = std::make_shared<platform::WinRTAudioSession>();
             if (auto result = session->initialize(); !result)
                 return std::unexpected(result.error());
             return session;
+#else
+            // MPRIS has no system-wide current player; the source elects one. The session keeps
+            // the bus connection alive after the source is gone.
+            auto source = createSessionSource(std::make_shared<ThumbnailCache>());
+            if (auto opened = source->open({}); !opened)
+                return std::unexpected(opened.error());
+            auto id = source->currentSessionId();
+            if (!id)
+                return std::unexpected(id.error());
+            if (id->empty())
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Create audio session"));
+            auto session = source->createSession(*id);
+            if (!session)
+                return std::unexpected(session.error());
+            if (auto result = (*session)->initialize(); !result)
+                return std::unexpected(result.error());
+            return *session;
+#endif
         }
         catch (const std::exception& ex) {
-            return std::unexpected(std::format("Failed to create audio session: {}", ex.what()));
+            return std::unexpected(AudioError::fromException("Create audio session", ex));
         }
     }
 
+    std::unique_ptr<ISessionSource> AudioSessionFactory::createSessionSource(std::shared_ptr<ThumbnailCache> thumbnails) {
+#ifdef _WIN32
+        return std::make_unique<platform::WinRTSessionSource>(std::move(thumbnails));
+#else
+        return std::make_unique<platform::MprisSessionSource>(std::move(thumbnails));
+#endif
+    }
+
+    // MPRIS artwork is usually PNG or JPEG, which the portable decoder does not read; those
+    // thumbnails are still served as encoded bytes, only the resized variants are missing.
+    std::unique_ptr<IImageDecoder> AudioSessionFactory::createImageDecoder() {
+#ifdef _WIN32
+        return std::make_unique<platform::WicImageDecoder>();
+#else
+        return std::make_unique<platform::BmpImageDecoder>();
+#endif
+    }
+
     AudioSessionManager::AudioSessionManager() : m_pImpl(std::make_unique<Impl>()) {}
 
+    AudioSessionManager::AudioSessionManager(std::shared_ptr<IAudioSession> session)
+        : m_pImpl(std::make_unique<Impl>(std::move(session))) {
+    }
+
     AudioSessionManager::~AudioSessionManager() = default;
 
-    std::expected<void, std::string> AudioSessionManager::initialize() noexcept {
-        return m_pImpl->session->initialize();
+    std::expected<void, AudioError> AudioSessionManager::initialize() noexcept {
+        return m_pImpl->stats.measure(StatOperation::Initialize, [&] { return m_pImpl->registry.initialize(); });
+    }
+
+    AsyncResult<void> AudioSessionManager::initializeAsync() noexcept {
+        return m_pImpl->registry.initializeAsync();
+    }
+
+    std::expected<std::chrono::seconds, AudioError> AudioSessionManager::getDuration() noexcept {
+        return m_pImpl->withActive(StatOperation::GetDuration, "Get duration", [&](SessionRegistry::Entry& entry) { return entry.session->getDuration(); });
+    }
+
+    std::expected<std::chrono::seconds, AudioError> AudioSessionManager::getCurrentPosition() noexcept {
+        return m_pImpl->withActive(StatOperation::GetPosition, "Get position", [&](SessionRegistry::Entry& entry) { return entry.session->getCurrentPosition(); });
+    }
+
+    std::expected<std::chrono::milliseconds, AudioError> AudioSessionManager::getCurrentPositionPrecise() noexcept {
+        return m_pImpl->withActive(StatOperation::GetPosition, "Get position", [&](SessionRegistry::Entry& entry) { return entry.session->getCurrentPositionPrecise(); });
+    }
+
+    std::expected<std::string, AudioError> AudioSessionManager::getTitle() const noexcept {
+        return m_pImpl->withActive(StatOperation::GetTitle, "Get title", [&](SessionRegistry::Entry& entry) { return entry.session->getTitle(); });
+    }
+
+    std::expected<std::string, AudioError> AudioSessionManager::getArtist() const noexcept {
+        return m_pImpl->withActive(StatOperation::GetArtist, "Get artist", [&](SessionRegistry::Entry& entry) { return entry.session->getArtist(); });
+    }
+
+    std::expected<std::string, AudioError> AudioSessionManager::getAlbum() const noexcept {
+        return m_pImpl->withActive(StatOperation::GetAlbum, "Get album", [&](SessionRegistry::Entry& entry) { return entry.session->getAlbum(); });
+    }
+
+    std::expected<std::u16string, AudioError> AudioSessionManager::getTextUtf16(MediaText field) const noexcept {
+        const auto operation = field == MediaText::Title ? StatOperation::GetTitle : field == MediaText::Artist ? StatOperation::GetArtist : StatOperation::GetAlbum;
+        const char* name = field == MediaText::Title ? "Get title" : field == MediaText::Artist ? "Get artist" : "Get album";
+        return m_pImpl->withActive(operation, name, [&](SessionRegistry::Entry& entry) { return entry.session->getTextUtf16(field); });
+    }
+
+    std::expected<std::string_view, AudioError> AudioSessionManager::getTitleView() noexcept {
+        return m_pImpl->withActive(StatOperation::GetTitle, "Get title", [&](SessionRegistry::Entry& entry) { return entry.session->getText(MediaText::Title, m_pImpl->strings); });
+    }
+
+    std::expected<std::string_view, AudioError> AudioSessionManager::getArtistView() noexcept {
+        return m_pImpl->withActive(StatOperation::GetArtist, "Get artist", [&](SessionRegistry::Entry& entry) { return entry.session->getText(MediaText::Artist, m_pImpl->strings); });
+    }
+
+    std::expected<std::string_view, AudioError> AudioSessionManager::getAlbumView() noexcept {
+        return m_pImpl->withActive(StatOperation::GetAlbum, "Get album", [&](SessionRegistry::Entry& entry) { return entry.session->getText(MediaText::Album, m_pImpl->strings); });
+    }
+
+    void AudioSessionManager::releaseStrings() noexcept {
+        m_pImpl->strings.advanceEpoch();
+    }
+
+    StringPool::Stats AudioSessionManager::getStringPoolStats() const noexcept {
+        return m_pImpl->strings.stats();
+    }
+
+    std::expected<std::span<const uint8_t>, AudioError> AudioSessionManager::getThumbnailBytes() noexcept {
+        return m_pImpl->withActive(StatOperation::GetThumbnail, "Get thumbnail", [&](SessionRegistry::Entry& entry) { return entry.session->getThumbnailBytes(); });
+    }
+
+    std::expected<ThumbnailCache::Buffer, AudioError> AudioSessionManager::getThumbnail() noexcept {
+        return m_pImpl->withActive(StatOperation::GetThumbnail, "Get thumbnail", [&](SessionRegistry::Entry& entry) { return entry.session->getThumbnail(); });
+    }
+
+    std::expected<TrackSnapshot, AudioError> AudioSessionManager::getTrackSnapshot() noexcept {
+        return m_pImpl->withActive(StatOperation::GetTrackSnapshot, "Get track snapshot", [&](SessionRegistry::Entry& entry) { return entry.session->getTrackSnapshot(); });
+    }
+
+    std::expected<void, AudioError> AudioSessionManager::play() noexcept {
+        return m_pImpl->withActive(StatOperation::Play, "Play", [&](SessionRegistry::Entry& entry) { return entry.commands.submit(CommandQueue::Kind::Play).get(); });
+    }
+
+    std::expected<void, AudioError> AudioSessionManager::pause() noexcept {
+        return m_pImpl->withActive(StatOperation::Pause, "Pause", [&](SessionRegistry::Entry& entry) { return entry.commands.submit(CommandQueue::Kind::Pause).get(); });
+    }
+
+    std::expected<void, AudioError> AudioSessionManager::next() noexcept {
+        return m_pImpl->withActive(StatOperation::Next, "Next track", [&](SessionRegistry::Entry& entry) { return entry.commands.submit(CommandQueue::Kind::Next).get(); });
+    }
+
+    std::expected<void, AudioError> AudioSessionManager::previous() noexcept {
+        return m_pImpl->withActive(StatOperation::Previous, "Previous track", [&](SessionRegistry::Entry& entry) { return entry.commands.submit(CommandQueue::Kind::Previous).get(); });
     }
 
-    std::expected<std::chrono::seconds, std::string> AudioSessionManager::getDuration() noexcept {
-        return m_pImpl->session->getDuration();
+    std::expected<void, AudioError> AudioSessionManager::seek(std::chrono::seconds position) noexcept {
+        auto result = m_pImpl->withActive(StatOperation::Seek, "Seek", [&](SessionRegistry::Entry& entry) { return entry.commands.seek(position).get(); });
+        // Seeks raise no event of their own.
+        if (result)
+            m_pImpl->publishPosition(position);
+        return result;
     }
 
-    std::expected<std::chrono::seconds, std::string> AudioSessionManager::getCurrentPosition() noexcept {
-        return m_pImpl->session->getCurrentPosition();
+    std::expected<void, AudioError> AudioSessionManager::setVolume(double volume) noexcept {
+        return m_pImpl->withActive(StatOperation::SetVolume, "Set volume", [&](SessionRegistry::Entry& entry) { return entry.commands.setVolume(volume).get(); });
     }
 
-    std::expected<std::string, std::string> AudioSessionManager::getTitle() const noexcept {
-        return m_pImpl->session->getTitle();
+    std::expected<double, AudioError> AudioSessionManager::getVolume() noexcept {
+        return m_pImpl->withActive(StatOperation::GetVolume, "Get volume", [&](SessionRegistry::Entry& entry) { return entry.session->getVolume(); });
     }
 
-    std::expected<std::string, std::string> AudioSessionManager::getArtist() const noexcept {
-        return m_pImpl->session->getArtist();
+    AsyncResult<void> AudioSessionManager::playAsync() noexcept {
+        return m_pImpl->withActiveAsync("Play", [&](SessionRegistry::Entry& entry) { return entry.commands.submit(CommandQueue::Kind::Play); });
     }
 
-    std::expected<std::string, std::string> AudioSessionManager::getAlbum() const noexcept {
-        return m_pImpl->session->getAlbum();
+    AsyncResult<void> AudioSessionManager::pauseAsync() noexcept {
+        return m_pImpl->withActiveAsync("Pause", [&](SessionRegistry::Entry& entry) { return entry.commands.submit(CommandQueue::Kind::Pause); });
     }
 
-    std::expected<std::span<const uint8_t>, std::string> AudioSessionManager::getThumbnailBytes() noexcept {
-        return m_pImpl->session->getThumbnailBytes();
+    AsyncResult<void> AudioSessionManager::nextAsync() noexcept {
+        return m_pImpl->withActiveAsync("Next track", [&](SessionRegistry::Entry& entry) { return entry.commands.submit(CommandQueue::Kind::Next); });
     }
 
-    std::expected<void, std::string> AudioSessionManager::play() noexcept {
-        return m_pImpl->session->play();
+    AsyncResult<void> AudioSessionManager::previousAsync() noexcept {
+        return m_pImpl->withActiveAsync("Previous track", [&](SessionRegistry::Entry& entry) { return entry.commands.submit(CommandQueue::Kind::Previous); });
     }
 
-    std::expected<void, std::string> AudioSessionManager::pause() noexcept {
-        return m_pImpl->session->pause();
+    AsyncResult<void> AudioSessionManager::seekAsync(std::chrono::seconds position) noexcept {
+        return m_pImpl->withActiveAsync("Seek", [&](SessionRegistry::Entry& entry) { return entry.commands.seek(position); });
     }
 
-    std::expected<void, std::string> AudioSessionManager::next() noexcept {
-        return m_pImpl->session->next();
+    AsyncResult<void> AudioSessionManager::setVolumeAsync(double volume) noexcept {
+        return m_pImpl->withActiveAsync("Set volume", [&](SessionRegistry::Entry& entry) { return entry.commands.setVolume(volume); });
     }
 
-    std::expected<void, std::string> AudioSessionManager::previous() noexcept {
-        return m_pImpl->session->previous();
+    AsyncResult<double> AudioSessionManager::getVolumeAsync() noexcept {
+        return m_pImpl->withActiveAsync("Get volume", [&](SessionRegistry::Entry& entry) { return entry.session->getVolumeAsync(); });
     }
 
-    std::expected<void, std::string> AudioSessionManager::seek(std::chrono::seconds position) noexcept {
-        return m_pImpl->session->seek(position);
+    AsyncResult<TrackSnapshot> AudioSessionManager::getTrackSnapshotAsync() noexcept {
+        return m_pImpl->withActiveAsync("Get track snapshot", [&](SessionRegistry::Entry& entry) { return entry.session->getTrackSnapshotAsync(); });
     }
 
-    std::expected<void, std::string> AudioSessionManager::setVolume(double volume) noexcept {
-        return m_pImpl->session->setVolume(volume);
+    CommandQueue::Stats AudioSessionManager::getCommandStats() const noexcept {
+        auto entry = m_pImpl->registry.active();
+        return entry ? entry->commands.stats() : CommandQueue::Stats{};
     }
 
-    std::expected<double, std::string> AudioSessionManager::getVolume() noexcept {
-        return m_pImpl->session->getVolume();
+    std::vector<std::string> AudioSessionManager::getSessionIds() const {
+        return m_pImpl->registry.sessionIds();
+    }
+
+    std::string AudioSessionManager::getActiveSessionId() const {
+        return m_pImpl->registry.activeId();
+    }
+
+    void AudioSessionManager::selectSession(std::string_view id) {
+        m_pImpl->registry.pin(id);
+    }
+
+    void AudioSessionManager::followCurrentSession() {
+        m_pImpl->registry.followCurrent();
+    }
+
+    void AudioSessionManager::setActiveSessionChangedCallback(SessionRegistry::ActiveSessionChangedCallback callback) {
+        std::scoped_lock lock(m_pImpl->callbackMutex);
+        m_pImpl->activeChanged = std::move(callback);
+    }
+
+    void AudioSessionManager::setThumbnailCacheBudget(size_t budgetBytes) {
+        m_pImpl->thumbnails->setBudget(budgetBytes);
+    }
+
+    ThumbnailCache::Stats AudioSessionManager::getThumbnailCacheStats() const {
+        return m_pImpl->thumbnails->stats();
+    }
+
+    void AudioSessionManager::setThumbnailSizes(std::vector<uint32_t> sizes) {
+        m_pImpl->thumbnailProcessor.setSizes(std::move(sizes));
+    }
+
+    std::vector<uint32_t> AudioSessionManager::getThumbnailSizes() const {
+        return m_pImpl->thumbnailProcessor.sizes();
+    }
+
+    std::expected<ThumbnailProcessor::Image, AudioError> AudioSessionManager::getThumbnailRgba(uint32_t size) const noexcept {
+        try {
+            return m_pImpl->thumbnailProcessor.get(size);
+        }
+        catch (const std::exception& ex) {
+            return std::unexpected(AudioError::fromException("Get scaled thumbnail", ex));
+        }
+    }
+
+    ThumbnailProcessor::Stats AudioSessionManager::getThumbnailProcessorStats() const noexcept {
+        return m_pImpl->thumbnailProcessor.stats();
+    }
+
+    size_t AudioSessionManager::pollEvents(std::span<SessionEvent> buffer) noexcept {
+        return m_pImpl->events.poll(buffer);
+    }
+
+    bool AudioSessionManager::waitForEvents(std::chrono::milliseconds timeout) {
+        return m_pImpl->events.wait(timeout);
+    }
+
+    EventQueue::Stats AudioSessionManager::getEventQueueStats() const noexcept {
+        return m_pImpl->events.stats();
+    }
+
+    OperationStats::Stats AudioSessionManager::getStats() const noexcept {
+        auto stats = m_pImpl->stats.stats();
+        stats.merge(OperationStats::platform().stats());
+        return stats;
+    }
+
+    std::expected<void, AudioError> AudioSessionManager::enableHistory(const std::filesystem::path& path) noexcept {
+        auto journal = HistoryJournal::open(path);
+        if (!journal)
+            return std::unexpected(journal.error());
+        try {
+            auto tracker = std::make_shared<PlayTracker>(std::move(*journal));
+            std::shared_ptr<PlayTracker> previous;
+            {
+                std::scoped_lock lock(m_pImpl->callbackMutex);
+                previous = std::exchange(m_pImpl->history, std::move(tracker));
+            }
+            previous.reset();
+            m_pImpl->followTrack();
+            return {};
+        }
+        catch (const std::exception& ex) {
+            return std::unexpected(AudioError::fromException("Enable history", ex));
+        }
+    }
+
+    void AudioSessionManager::disableHistory() noexcept {
+        std::shared_ptr<PlayTracker> previous;
+        {
+            std::scoped_lock lock(m_pImpl->callbackMutex);
+            previous = std::move(m_pImpl->history);
+        }
+    }
+
+    std::expected<void, AudioError> AudioSessionManager::flushHistory() {
+        auto tracker = m_pImpl->historyTracker();
+        if (!tracker)
+            return std::unexpected(AudioError(ErrorCategory::NotFound, "Flush history"));
+        return tracker->journal().flush();
+    }
+
+    HistoryJournal::Stats AudioSessionManager::getHistoryStats() const noexcept {
+        auto tracker = m_pImpl->historyTracker();
+        return tracker ? tracker->journal().stats() : HistoryJournal::Stats{};
     }
 
     void AudioSessionManager::setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept {
-        m_pImpl->session->setPlaybackChangedCallback(std::move(callback));
+        try {
+            std::scoped_lock lock(m_pImpl->callbackMutex);
+            m_pImpl->playbackChanged = std::move(callback);
+        }
+        catch (...) {
+        }
+    }
+
+    void AudioSessionManager::setPlaybackEventCallback(PlaybackEventCallback callback) noexcept {
+        try {
+            std::scoped_lock lock(m_pImpl->callbackMutex);
+            m_pImpl->playbackEvent = std::move(callback);
+        }
+        catch (...) {
+        }
+    }
+
+    void AudioSessionManager::setPlaybackEventDebounce(std::chrono::milliseconds window) {
+        m_pImpl->playbackDebouncer.setWindow(window);
+    }
+
+    PlaybackDebouncer::Stats AudioSessionManager::getPlaybackEventStats() const noexcept {
+        return m_pImpl->playbackDebouncer.stats();
     }
 
     void AudioSessionManager::setTrackChangedCallback(TrackChangedCallback callback) noexcept {
-        m_pImpl->session->setTrackChangedCallback(std::move(callback));
+        try {
+            std::scoped_lock lock(m_pImpl->callbackMutex);
+            m_pImpl->trackChanged = std::move(callback);
+        }
+        catch (...) {
+        }
+    }
+
+    EventSubscribers::SubscriptionId AudioSessionManager::subscribe(SessionEvent::Kind kind, EventSubscribers::Callback callback) {
+        return m_pImpl->subscribers.subscribe(kind, std::move(callback));
+    }
+
+    bool AudioSessionManager::unsubscribe(EventSubscribers::SubscriptionId id) {
+        return m_pImpl->subscribers.unsubscribe(id);
+    }
+
+    PositionTicker::SubscriptionId AudioSessionManager::subscribePosition(std::chrono::milliseconds interval, PositionTicker::Callback callback) {
+        if (!callback || interval < PositionTicker::Resolution)
+            return 0;
+        std::shared_ptr<PositionTicker::Source> source;
+        {
+            std::scoped_lock lock(m_pImpl->callbackMutex);
+            if (!m_pImpl->positionSource)
+                m_pImpl->positionSource = PositionTicker::shared().addSource([impl = m_pImpl.get()] { return impl->samplePosition(); });
+            source = m_pImpl->positionSource;
+        }
+        return PositionTicker::shared().subscribe(source, interval, std::move(callback));
+    }
+
+    bool AudioSessionManager::unsubscribePosition(PositionTicker::SubscriptionId id) {
+        std::shared_ptr<PositionTicker::Source> source;
+        {
+            std::scoped_lock lock(m_pImpl->callbackMutex);
+            source = m_pImpl->positionSource;
+        }
+        return PositionTicker::shared().unsubscribe(source, id);
+    }
+
+    const StateBlock& AudioSessionManager::getStateBlock() const noexcept {
+        return *m_pImpl->state;
+    }
+
+    TrackChangeStats AudioSessionManager::getTrackChangeStats() const noexcept {
+        auto entry = m_pImpl->registry.active();
+        return entry ? entry->session->getTrackChangeStats() : TrackChangeStats{};
+    }
+
+    // Subscriptions land on the session that is active now. WinRT sessions share one volume
+    // controller, so there they keep working when the active session changes.
+    VolumeController::SubscriptionId AudioSessionManager::subscribeVolumeChanged(VolumeChangedCallback callback) noexcept {
+        auto entry = m_pImpl->registry.active();
+        return entry ? entry->session->subscribeVolumeChanged(std::move(callback)) : 0;
+    }
+
+    void AudioSessionManager::unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept {
+        if (auto entry = m_pImpl->registry.active())
+            entry->session->unsubscribeVolumeChanged(id);
     }
 
-} 
+}
\ No newline at end of file
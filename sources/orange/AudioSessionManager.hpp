@@ -1,43 +1,160 @@
 #pragma once
 #include "IAudioSession.h"
+#include "CommandQueue.h"
+#include "EventQueue.h"
+#include "EventSubscribers.h"
+#include "HistoryJournal.h"
+#include "OperationStats.h"
+#include "PlaybackEvents.h"
+#include "PositionTicker.h"
+#include "SessionRegistry.h"
+#include "StateBlock.h"
+#include "ThumbnailProcessor.h"
 #include <memory>
 #include <chrono>
 #include <expected>
+#include <filesystem>
 #include <span>
 #include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace audio {
 
-    class AudioSessionManager : public IAudioTrackInfo, public IAudioPlaybackControl, public IAudioEventNotifier {
+    class AudioSessionManager : public IAudioTrackInfo, public IAudioPlaybackControl, public IAudioAsyncControl, public IAudioEventNotifier {
     private:
         class Impl;
         std::unique_ptr<Impl> m_pImpl;
 
     public:
+        // Id under which a session passed to the injecting constructor is registered.
+        static constexpr std::string_view InjectedSessionId = "injected";
+
         AudioSessionManager();
+        explicit AudioSessionManager(std::shared_ptr<IAudioSession> session);
         ~AudioSessionManager() override;
 
-        [[nodiscard]] std::expected<void, std::string> initialize() noexcept;
+        [[nodiscard]] std::expected<void, AudioError> initialize() noexcept;
+        AsyncResult<void> initializeAsync() noexcept;
+
+        std::expected<std::chrono::seconds, AudioError> getDuration() noexcept override;
+        std::expected<std::chrono::seconds, AudioError> getCurrentPosition() noexcept override;
+        std::expected<std::chrono::milliseconds, AudioError> getCurrentPositionPrecise() noexcept override;
+        std::expected<std::string, AudioError> getTitle() const noexcept override;
+        std::expected<std::string, AudioError> getArtist() const noexcept override;
+        std::expected<std::string, AudioError> getAlbum() const noexcept override;
+        std::expected<std::span<const uint8_t>, AudioError> getThumbnailBytes() noexcept override;
+        std::expected<ThumbnailCache::Buffer, AudioError> getThumbnail() noexcept override;
+        std::expected<TrackSnapshot, AudioError> getTrackSnapshot() noexcept override;
+        // Counted as a getTitle, getArtist or getAlbum call.
+        std::expected<std::u16string, AudioError> getTextUtf16(MediaText field) const noexcept override;
+
+        // Borrowed counterparts of getTitle, getArtist and getAlbum: the text is interned in this
+        // manager's pool, so equal strings share storage and a poll whose text is already pooled
+        // copies and allocates nothing. Each view stays valid, whatever the sessions do, until
+        // the next releaseStrings() call; callers sharing a manager must agree on who releases.
+        std::expected<std::string_view, AudioError> getTitleView() noexcept;
+        std::expected<std::string_view, AudioError> getArtistView() noexcept;
+        std::expected<std::string_view, AudioError> getAlbumView() noexcept;
+        void releaseStrings() noexcept;
+        [[nodiscard]] StringPool::Stats getStringPoolStats() const noexcept;
+
+        std::expected<void, AudioError> play() noexcept override;
+        std::expected<void, AudioError> pause() noexcept override;
+        std::expected<void, AudioError> next() noexcept override;
+        std::expected<void, AudioError> previous() noexcept override;
+        std::expected<void, AudioError> seek(std::chrono::seconds position) noexcept override;
+
+        std::expected<void, AudioError> setVolume(double volume) noexcept override;
+        std::expected<double, AudioError> getVolume() noexcept override;
+
+        AsyncResult<void> playAsync() noexcept override;
+        AsyncResult<void> pauseAsync() noexcept override;
+        AsyncResult<void> nextAsync() noexcept override;
+        AsyncResult<void> previousAsync() noexcept override;
+        AsyncResult<void> seekAsync(std::chrono::seconds position) noexcept override;
+        AsyncResult<void> setVolumeAsync(double volume) noexcept override;
+        AsyncResult<double> getVolumeAsync() noexcept override;
+        AsyncResult<TrackSnapshot> getTrackSnapshotAsync() noexcept override;
+
+        // Transport and volume calls, sync and async alike, go through the session's CommandQueue.
+        [[nodiscard]] CommandQueue::Stats getCommandStats() const noexcept;
+
+        // Every call above is routed to the active session: the system's current one by default,
+        // or the one picked with selectSession until followCurrentSession is called again.
+        [[nodiscard]] std::vector<std::string> getSessionIds() const;
+        [[nodiscard]] std::string getActiveSessionId() const;
+        void selectSession(std::string_view id);
+        void followCurrentSession();
+        void setActiveSessionChangedCallback(SessionRegistry::ActiveSessionChangedCallback callback);
+
+        // Artwork of all discovered sessions shares one cache; sessions passed in by the caller keep their own.
+        void setThumbnailCacheBudget(size_t budgetBytes);
+        [[nodiscard]] ThumbnailCache::Stats getThumbnailCacheStats() const;
+
+        // The active session's artwork is decoded off-thread whenever its track or the active
+        // session changes, and kept as premultiplied RGBA no larger than each registered edge
+        // length (64, 128 and 512 px by default). getThumbnailRgba only returns finished variants.
+        void setThumbnailSizes(std::vector<uint32_t> sizes);
+        [[nodiscard]] std::vector<uint32_t> getThumbnailSizes() const;
+        [[nodiscard]] std::expected<ThumbnailProcessor::Image, AudioError> getThumbnailRgba(uint32_t size) const noexcept;
+        [[nodiscard]] ThumbnailProcessor::Stats getThumbnailProcessorStats() const noexcept;
+
+        // Playback, track and active-session changes are also recorded in a bounded queue, for
+        // consumers that would rather drain them in batches on their own thread than take
+        // callbacks on system threads. The queue fills whether or not anyone drains it.
+        size_t pollEvents(std::span<SessionEvent> buffer) noexcept;
+        bool waitForEvents(std::chrono::milliseconds timeout);
+        [[nodiscard]] EventQueue::Stats getEventQueueStats() const noexcept;
+
+        // Latency histograms and error counts of the synchronous calls above, as this manager
+        // made them, plus the platform calls and state cache reads of every session in the
+        // process, and how many events of each kind were delivered. Async calls are not timed.
+        [[nodiscard]] OperationStats::Stats getStats() const noexcept;
+
+        // Records every finished play of the active session (when it started, which track, how
+        // long it played and whether it was skipped) to an append-only journal at path, written
+        // off the event threads. Query it with HistoryReader. Enabling again switches files.
+        std::expected<void, AudioError> enableHistory(const std::filesystem::path& path) noexcept;
+        // Ends the play in progress, commits it and closes the journal.
+        void disableHistory() noexcept;
+        // Waits until every finished play is on disk.
+        std::expected<void, AudioError> flushHistory();
+        // Zero when no journal is open.
+        [[nodiscard]] HistoryJournal::Stats getHistoryStats() const noexcept;
 
-        std::expected<std::chrono::seconds, std::string> getDuration() noexcept override;
-        std::expected<std::chrono::seconds, std::string> getCurrentPosition() noexcept override;
-        std::expected<std::string, std::string> getTitle() const noexcept override;
-        std::expected<std::string, std::string> getArtist() const noexcept override;
-        std::expected<std::string, std::string> getAlbum() const noexcept override;
-        std::expected<std::span<const uint8_t>, std::string> getThumbnailBytes() noexcept override;
+        // The set*Callback methods keep one callback per event; subscribe adds any number of
+        // listeners next to it. Both are fed by the same single handler per event kind.
+        EventSubscribers::SubscriptionId subscribe(SessionEvent::Kind kind, EventSubscribers::Callback callback);
+        bool unsubscribe(EventSubscribers::SubscriptionId id);
 
-        std::expected<void, std::string> play() noexcept override;
-        std::expected<void, std::string> pause() noexcept override;
-        std::expected<void, std::string> next() noexcept override;
-        std::expected<void, std::string> previous() noexcept override;
-        std::expected<void, std::string> seek(std::chrono::seconds position) noexcept override;
+        // Pushes the active session's position every interval of playback, from the one timer
+        // thread PositionTicker runs for the process. The session is asked about once a second
+        // whatever the number of subscribers; ticks in between are extrapolated. Ticks stop
+        // while it is paused or stopped and resume on the next playback, track or session change.
+        // Returns 0 for an empty callback or an interval below PositionTicker::Resolution.
+        PositionTicker::SubscriptionId subscribePosition(std::chrono::milliseconds interval, PositionTicker::Callback callback);
+        // False for an id this manager did not hand out. Waits for a tick under way.
+        bool unsubscribePosition(PositionTicker::SubscriptionId id);
 
-        std::expected<void, std::string> setVolume(double volume) noexcept override;
-        std::expected<double, std::string> getVolume() noexcept override;
+        // The active session's status, position anchor, rate, volume, track id and text, kept
+        // current from the session's events (and seeks made here) and published under a seqlock
+        // for readers that map the block rather than call in. It lives as long as the manager.
+        [[nodiscard]] const StateBlock& getStateBlock() const noexcept;
 
+        // Playback callbacks and queue entries only follow changes to the fields of PlaybackState.
+        // A non-zero debounce window folds each burst of changes into one event, delivered on a
+        // worker thread once the window closes; zero (the default) delivers every change at once.
         void setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept override;
+        void setPlaybackEventCallback(PlaybackEventCallback callback) noexcept override;
+        void setPlaybackEventDebounce(std::chrono::milliseconds window);
+        [[nodiscard]] PlaybackDebouncer::Stats getPlaybackEventStats() const noexcept;
         void setTrackChangedCallback(TrackChangedCallback callback) noexcept override;
+        // Counters of the active session; zero when there is none.
+        [[nodiscard]] TrackChangeStats getTrackChangeStats() const noexcept override;
+        VolumeController::SubscriptionId subscribeVolumeChanged(VolumeChangedCallback callback) noexcept override;
+        void unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept override;
     };
 
 } 
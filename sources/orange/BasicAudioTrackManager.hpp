@@ -0,0 +1,296 @@
+#pragma once
+#include "IAudioSession.h"
+#include "CommandQueue.h"
+#include "EventQueue.h"
+#include "EventSubscribers.h"
+#include "HistoryJournal.h"
+#include "OperationStats.h"
+#include "PlaybackEvents.h"
+#include "PositionTicker.h"
+#include "SessionRegistry.h"
+#include "StateBlock.h"
+#include "ThumbnailProcessor.h"
+#include <chrono>
+#include <concepts>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace audio {
+
+    namespace detail {
+
+        // A backend is either the session object itself or something that dereferences to one
+        // (shared_ptr, unique_ptr, raw pointer).
+        template <typename Backend>
+        struct BackendSession {
+            using type = Backend;
+        };
+
+        template <typename Backend>
+            requires requires(Backend& backend) { *backend; }
+        struct BackendSession<Backend> {
+            using type = std::remove_reference_t<decltype(*std::declval<Backend&>())>;
+        };
+
+    }
+
+    // What every session offers, whether reached through IAudioSession or as a concrete class.
+    template <typename Session>
+    concept AudioSessionBackend = requires(Session& session, const Session& constSession) {
+        { session.initialize() } -> std::same_as<std::expected<void, AudioError>>;
+        { constSession.getTitle() } -> std::same_as<std::expected<std::string, AudioError>>;
+        { session.getTrackSnapshot() } -> std::same_as<std::expected<TrackSnapshot, AudioError>>;
+        { session.play() } -> std::same_as<std::expected<void, AudioError>>;
+        { session.getVolume() } -> std::same_as<std::expected<double, AudioError>>;
+        { constSession.getTrackChangeStats() } -> std::same_as<TrackChangeStats>;
+    };
+
+    // What AudioSessionManager adds on top of one session: choosing among sessions, the command
+    // queue, the event queue and subscribers, debouncing, and shared artwork processing.
+    template <typename Session>
+    concept SessionManagerBackend = AudioSessionBackend<Session> && requires(Session& session, const Session& constSession) {
+        { constSession.getSessionIds() } -> std::same_as<std::vector<std::string>>;
+        { constSession.getCommandStats() } -> std::same_as<CommandQueue::Stats>;
+        { session.pollEvents(std::span<SessionEvent>{}) } -> std::same_as<size_t>;
+        session.setPlaybackEventDebounce(std::chrono::milliseconds{});
+        session.setThumbnailCacheBudget(size_t{});
+    };
+
+    // The public manager with its backend fixed at compile time. Every call is an inline
+    // forward to the backend, so with a concrete session class (held in place, or through a
+    // pointer to a final class) a getter compiles down to a direct call into that session.
+    //
+    // AudioTrackManager is this template over AudioSessionManager, which keeps the type-erased
+    // path: any number of sessions behind IAudioSession, picked at run time, with transport
+    // commands serialized through a CommandQueue. A single-session backend has none of that;
+    // the members that need it are only there when the backend is a SessionManagerBackend.
+    template <typename Backend>
+        requires AudioSessionBackend<typename detail::BackendSession<Backend>::type>
+    class BasicAudioTrackManager {
+    public:
+        using backend_type = Backend;
+        using session_type = typename detail::BackendSession<Backend>::type;
+
+    private:
+        Backend m_backend;
+
+        [[nodiscard]] session_type& session() noexcept {
+            if constexpr (std::is_same_v<session_type, Backend>)
+                return m_backend;
+            else
+                return *m_backend;
+        }
+
+        [[nodiscard]] const session_type& session() const noexcept {
+            if constexpr (std::is_same_v<session_type, Backend>)
+                return m_backend;
+            else
+                return *m_backend;
+        }
+
+    public:
+        // Arguments go to the backend's constructor, so an in-place backend is built where it lives.
+        template <typename... Args>
+            requires std::constructible_from<Backend, Args...>
+        explicit BasicAudioTrackManager(Args&&... args)
+            : m_backend(std::forward<Args>(args)...) {
+        }
+
+        [[nodiscard]] Backend& backend() noexcept { return m_backend; }
+        [[nodiscard]] const Backend& backend() const noexcept { return m_backend; }
+
+        [[nodiscard]] std::expected<void, AudioError> initialize() noexcept { return session().initialize(); }
+        AsyncResult<void> initializeAsync() noexcept { return session().initializeAsync(); }
+        [[nodiscard]] std::expected<std::chrono::seconds, AudioError> getDuration() noexcept { return session().getDuration(); }
+        [[nodiscard]] std::expected<std::chrono::seconds, AudioError> getCurrentPosition() noexcept { return session().getCurrentPosition(); }
+        [[nodiscard]] std::expected<std::chrono::milliseconds, AudioError> getCurrentPositionPrecise() noexcept { return session().getCurrentPositionPrecise(); }
+        [[nodiscard]] std::expected<std::string, AudioError> getTitle() const noexcept { return session().getTitle(); }
+        [[nodiscard]] std::expected<std::string, AudioError> getArtist() const noexcept { return session().getArtist(); }
+        [[nodiscard]] std::expected<std::string, AudioError> getAlbum() const noexcept { return session().getAlbum(); }
+        [[nodiscard]] std::expected<std::u16string, AudioError> getTextUtf16(MediaText field) const noexcept { return session().getTextUtf16(field); }
+        [[nodiscard]] std::expected<TrackSnapshot, AudioError> getTrackSnapshot() noexcept { return session().getTrackSnapshot(); }
+        std::expected<void, AudioError> play() noexcept { return session().play(); }
+        std::expected<void, AudioError> pause() noexcept { return session().pause(); }
+        std::expected<void, AudioError> next() noexcept { return session().next(); }
+        std::expected<void, AudioError> previous() noexcept { return session().previous(); }
+        std::expected<void, AudioError> seek(std::chrono::seconds position) noexcept { return session().seek(position); }
+        [[nodiscard]] std::expected<std::span<const uint8_t>, AudioError> getThumbnailBytes() noexcept { return session().getThumbnailBytes(); }
+        [[nodiscard]] std::expected<ThumbnailCache::Buffer, AudioError> getThumbnail() noexcept { return session().getThumbnail(); }
+        std::expected<void, AudioError> setVolume(double volume) noexcept { return session().setVolume(volume); }
+        std::expected<double, AudioError> getVolume() noexcept { return session().getVolume(); }
+
+        AsyncResult<void> playAsync() noexcept { return session().playAsync(); }
+        AsyncResult<void> pauseAsync() noexcept { return session().pauseAsync(); }
+        AsyncResult<void> nextAsync() noexcept { return session().nextAsync(); }
+        AsyncResult<void> previousAsync() noexcept { return session().previousAsync(); }
+        AsyncResult<void> seekAsync(std::chrono::seconds position) noexcept { return session().seekAsync(position); }
+        AsyncResult<void> setVolumeAsync(double volume) noexcept { return session().setVolumeAsync(volume); }
+        [[nodiscard]] AsyncResult<double> getVolumeAsync() noexcept { return session().getVolumeAsync(); }
+        [[nodiscard]] AsyncResult<TrackSnapshot> getTrackSnapshotAsync() noexcept { return session().getTrackSnapshotAsync(); }
+
+        void setThumbnailCacheBudget(size_t budgetBytes) requires SessionManagerBackend<session_type> {
+            session().setThumbnailCacheBudget(budgetBytes);
+        }
+        [[nodiscard]] ThumbnailCache::Stats getThumbnailCacheStats() const requires SessionManagerBackend<session_type> {
+            return session().getThumbnailCacheStats();
+        }
+        // Ready-to-draw artwork: register the edge lengths the UI paints at, then poll on track
+        // change; a variant that is still being decoded reports "Thumbnail is not ready." at once.
+        void setThumbnailSizes(std::vector<uint32_t> sizes) requires SessionManagerBackend<session_type> {
+            session().setThumbnailSizes(std::move(sizes));
+        }
+        [[nodiscard]] std::vector<uint32_t> getThumbnailSizes() const requires SessionManagerBackend<session_type> {
+            return session().getThumbnailSizes();
+        }
+        [[nodiscard]] std::expected<ThumbnailProcessor::Image, AudioError> getThumbnailRgba(uint32_t size) const noexcept requires SessionManagerBackend<session_type> {
+            return session().getThumbnailRgba(size);
+        }
+        [[nodiscard]] ThumbnailProcessor::Stats getThumbnailProcessorStats() const noexcept requires SessionManagerBackend<session_type> {
+            return session().getThumbnailProcessorStats();
+        }
+
+        // Slider-driven callers should prefer seekAsync/setVolumeAsync: queued values that are
+        // superseded before they run are dropped, so the last one lands after at most one round-trip.
+        [[nodiscard]] CommandQueue::Stats getCommandStats() const noexcept requires SessionManagerBackend<session_type> {
+            return session().getCommandStats();
+        }
+
+        // Borrowed text, valid until releaseStrings(); see AudioSessionManager::getTitleView.
+        [[nodiscard]] std::expected<std::string_view, AudioError> getTitleView() noexcept requires SessionManagerBackend<session_type> {
+            return session().getTitleView();
+        }
+        [[nodiscard]] std::expected<std::string_view, AudioError> getArtistView() noexcept requires SessionManagerBackend<session_type> {
+            return session().getArtistView();
+        }
+        [[nodiscard]] std::expected<std::string_view, AudioError> getAlbumView() noexcept requires SessionManagerBackend<session_type> {
+            return session().getAlbumView();
+        }
+        void releaseStrings() noexcept requires SessionManagerBackend<session_type> {
+            session().releaseStrings();
+        }
+        [[nodiscard]] StringPool::Stats getStringPoolStats() const noexcept requires SessionManagerBackend<session_type> {
+            return session().getStringPoolStats();
+        }
+
+        std::expected<void, AudioError> enableHistory(const std::filesystem::path& path) noexcept requires SessionManagerBackend<session_type> {
+            return session().enableHistory(path);
+        }
+        void disableHistory() noexcept requires SessionManagerBackend<session_type> {
+            session().disableHistory();
+        }
+        std::expected<void, AudioError> flushHistory() requires SessionManagerBackend<session_type> {
+            return session().flushHistory();
+        }
+        [[nodiscard]] HistoryJournal::Stats getHistoryStats() const noexcept requires SessionManagerBackend<session_type> {
+            return session().getHistoryStats();
+        }
+
+        [[nodiscard]] std::vector<std::string> getSessionIds() const requires SessionManagerBackend<session_type> {
+            return session().getSessionIds();
+        }
+        [[nodiscard]] std::string getActiveSessionId() const requires SessionManagerBackend<session_type> {
+            return session().getActiveSessionId();
+        }
+        void selectSession(std::string_view id) requires SessionManagerBackend<session_type> {
+            session().selectSession(id);
+        }
+        void followCurrentSession() requires SessionManagerBackend<session_type> {
+            session().followCurrentSession();
+        }
+        void onActiveSessionChanged(SessionRegistry::ActiveSessionChangedCallback callback) requires SessionManagerBackend<session_type> {
+            session().setActiveSessionChangedCallback(std::move(callback));
+        }
+
+        // Batched alternative to the callbacks below: poll a buffer full of events at a time, or
+        // block a thread of your own until some arrive. Oldest events are dropped on overflow.
+        size_t pollEvents(std::span<SessionEvent> buffer) noexcept requires SessionManagerBackend<session_type> {
+            return session().pollEvents(buffer);
+        }
+        bool waitForEvents(std::chrono::milliseconds timeout) requires SessionManagerBackend<session_type> {
+            return session().waitForEvents(timeout);
+        }
+        [[nodiscard]] EventQueue::Stats getEventQueueStats() const noexcept requires SessionManagerBackend<session_type> {
+            return session().getEventQueueStats();
+        }
+
+        // Per-operation latency histograms and error counts, state cache hits and misses, and
+        // delivered events; see AudioSessionManager::getStats.
+        [[nodiscard]] OperationStats::Stats getStats() const noexcept requires SessionManagerBackend<session_type> {
+            return session().getStats();
+        }
+
+        // Any number of listeners per event kind, each removed again with the id it got; 0 means
+        // the kind was unknown or the callback empty. The on* methods below hold a single callback
+        // each, replaced on every call.
+        EventSubscribers::SubscriptionId subscribe(SessionEvent::Kind kind, EventSubscribers::Callback callback) requires SessionManagerBackend<session_type> {
+            return session().subscribe(kind, std::move(callback));
+        }
+        bool unsubscribe(EventSubscribers::SubscriptionId id) requires SessionManagerBackend<session_type> {
+            return session().unsubscribe(id);
+        }
+
+        // Position every interval while the active session plays; see AudioSessionManager.
+        PositionTicker::SubscriptionId subscribePosition(std::chrono::milliseconds interval, PositionTicker::Callback callback) requires SessionManagerBackend<session_type> {
+            return session().subscribePosition(interval, std::move(callback));
+        }
+        bool unsubscribePosition(PositionTicker::SubscriptionId id) requires SessionManagerBackend<session_type> {
+            return session().unsubscribePosition(id);
+        }
+
+        [[nodiscard]] const StateBlock& getStateBlock() const noexcept requires SessionManagerBackend<session_type> {
+            return session().getStateBlock();
+        }
+
+        void onPlaybackStatusChanged(IAudioEventNotifier::PlaybackChangedCallback callback) {
+            session().setPlaybackChangedCallback(std::move(callback));
+        }
+        // Old and new status, rate, shuffle, repeat mode and available controls, plus which changed.
+        void onPlaybackChanged(IAudioEventNotifier::PlaybackEventCallback callback) {
+            session().setPlaybackEventCallback(std::move(callback));
+        }
+        // Collapses bursts of playback changes (e.g. a player toggling state while seeking) into one.
+        void setPlaybackDebounce(std::chrono::milliseconds window) requires SessionManagerBackend<session_type> {
+            session().setPlaybackEventDebounce(window);
+        }
+        [[nodiscard]] PlaybackDebouncer::Stats getPlaybackEventStats() const noexcept requires SessionManagerBackend<session_type> {
+            return session().getPlaybackEventStats();
+        }
+        void onTrackChanged(IAudioEventNotifier::TrackChangedCallback callback) {
+            session().setTrackChangedCallback(std::move(callback));
+        }
+        // Property-change notifications received versus track-changed callbacks delivered.
+        [[nodiscard]] TrackChangeStats getTrackChangeStats() const noexcept { return session().getTrackChangeStats(); }
+        VolumeController::SubscriptionId onVolumeChanged(IAudioEventNotifier::VolumeChangedCallback callback) {
+            return session().subscribeVolumeChanged(std::move(callback));
+        }
+        void removeVolumeChangedListener(VolumeController::SubscriptionId id) noexcept {
+            session().unsubscribeVolumeChanged(id);
+        }
+
+        template <typename Callback>
+            requires std::invocable<Callback, std::string_view>
+        void onPlaybackStatusChangedT(Callback&& callback) {
+            onPlaybackStatusChanged(std::forward<Callback>(callback));
+        }
+
+        template <typename Callback>
+            requires std::invocable<Callback, const PlaybackEvent&>
+        void onPlaybackChangedT(Callback&& callback) {
+            onPlaybackChanged(std::forward<Callback>(callback));
+        }
+
+        template <typename Callback>
+            requires std::invocable<Callback, std::string_view, std::string_view>
+        void onTrackChangedT(Callback&& callback) {
+            onTrackChanged(std::forward<Callback>(callback));
+        }
+    };
+
+}
@@ -0,0 +1,91 @@
+#include "BmpImageDecoder.h"
+#include <cstring>
+
+namespace audio {
+    namespace platform {
+
+        namespace {
+
+            constexpr size_t FileHeaderSize = 14;
+            constexpr size_t InfoHeaderSize = 40;
+            constexpr size_t V4HeaderSize = 108;
+            constexpr uint32_t CompressionRgb = 0;
+            constexpr uint32_t CompressionBitfields = 3;
+            // Largest edge accepted; anything bigger is not artwork and would only waste memory.
+            constexpr int32_t MaxEdge = 16384;
+
+            template <typename T>
+            T read(std::span<const uint8_t> bytes, size_t offset) {
+                T value;
+                std::memcpy(&value, bytes.data() + offset, sizeof(value));
+                return value;
+            }
+
+        }
+
+        std::expected<RgbaImage, AudioError> BmpImageDecoder::decode(std::span<const uint8_t> encoded) noexcept {
+            try {
+                if (encoded.size() < FileHeaderSize + InfoHeaderSize || encoded[0] != 'B' || encoded[1] != 'M')
+                    return std::unexpected(AudioError(ErrorCategory::Unsupported, "Decode bitmap", 0, "not a bitmap image"));
+
+                const auto pixelOffset = read<uint32_t>(encoded, 10);
+                const auto headerSize = read<uint32_t>(encoded, FileHeaderSize);
+                const auto width = read<int32_t>(encoded, FileHeaderSize + 4);
+                const auto rawHeight = read<int32_t>(encoded, FileHeaderSize + 8);
+                const auto bitsPerPixel = read<uint16_t>(encoded, FileHeaderSize + 14);
+                const auto compression = read<uint32_t>(encoded, FileHeaderSize + 16);
+
+                const bool topDown = rawHeight < 0;
+                const int32_t height = topDown ? -rawHeight : rawHeight;
+                if (width <= 0 || height <= 0 || width > MaxEdge || height > MaxEdge)
+                    return std::unexpected(AudioError(ErrorCategory::Unsupported, "Decode bitmap", 0, "dimensions out of range"));
+                if (bitsPerPixel != 24 && bitsPerPixel != 32)
+                    return std::unexpected(AudioError(ErrorCategory::Unsupported, "Decode bitmap", 0, "pixel format"));
+                if (compression != CompressionRgb && !(compression == CompressionBitfields && bitsPerPixel == 32))
+                    return std::unexpected(AudioError(ErrorCategory::Unsupported, "Decode bitmap", 0, "compressed bitmap"));
+
+                // Bitfield masks follow the 40-byte header, either inside a V4/V5 header or as a
+                // separate block. Only the usual BGRA layout is accepted.
+                bool hasAlpha = false;
+                if (compression == CompressionBitfields) {
+                    const size_t masks = FileHeaderSize + InfoHeaderSize;
+                    const size_t maskCount = headerSize >= V4HeaderSize ? 4 : 3;
+                    if (encoded.size() < masks + maskCount * 4)
+                        return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Decode bitmap", 0, "truncated header"));
+                    if (read<uint32_t>(encoded, masks) != 0x00FF0000u || read<uint32_t>(encoded, masks + 4) != 0x0000FF00u
+                        || read<uint32_t>(encoded, masks + 8) != 0x000000FFu)
+                        return std::unexpected(AudioError(ErrorCategory::Unsupported, "Decode bitmap", 0, "channel layout"));
+                    hasAlpha = maskCount == 4 && read<uint32_t>(encoded, masks + 12) == 0xFF000000u;
+                }
+
+                const size_t bytesPerPixel = bitsPerPixel / 8;
+                const size_t stride = (static_cast<size_t>(width) * bytesPerPixel + 3) & ~size_t{ 3 };
+                if (pixelOffset > encoded.size() || (encoded.size() - pixelOffset) / stride < static_cast<size_t>(height))
+                    return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Decode bitmap", 0, "truncated pixel data"));
+
+                RgbaImage image;
+                image.width = static_cast<uint32_t>(width);
+                image.height = static_cast<uint32_t>(height);
+                image.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+                for (int32_t y = 0; y < height; ++y) {
+                    const size_t sourceRow = topDown ? y : height - 1 - y;
+                    const uint8_t* source = encoded.data() + pixelOffset + sourceRow * stride;
+                    uint8_t* target = image.pixels.data() + static_cast<size_t>(y) * width * 4;
+                    for (int32_t x = 0; x < width; ++x, source += bytesPerPixel, target += 4) {
+                        const uint32_t alpha = hasAlpha ? source[3] : 255;
+                        target[0] = static_cast<uint8_t>((source[2] * alpha + 127) / 255);
+                        target[1] = static_cast<uint8_t>((source[1] * alpha + 127) / 255);
+                        target[2] = static_cast<uint8_t>((source[0] * alpha + 127) / 255);
+                        target[3] = static_cast<uint8_t>(alpha);
+                    }
+                }
+                return image;
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Decode bitmap", ex));
+            }
+        }
+
+    }
+}
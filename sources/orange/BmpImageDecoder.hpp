@@ -0,0 +1,16 @@
+#pragma once
+#include "ThumbnailProcessor.h"
+
+namespace audio {
+    namespace platform {
+
+        // Decoder with no operating-system dependency, for scripted sessions and for exercising the
+        // processing stage off Windows. Reads uncompressed 24- and 32-bit bitmaps, bottom-up or
+        // top-down; 32-bit images carry alpha only when their header declares an alpha mask.
+        class BmpImageDecoder : public IImageDecoder {
+        public:
+            std::expected<RgbaImage, AudioError> decode(std::span<const uint8_t> encoded) noexcept override;
+        };
+
+    }
+}
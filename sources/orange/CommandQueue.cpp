@@ -0,0 +1,135 @@
+#include "CommandQueue.h"
+#include <utility>
+
+namespace audio {
+
+    CommandQueue::CommandQueue(std::shared_ptr<IAudioSession> session)
+        : m_session(std::move(session)),
+        m_worker([this] { run(); }) {
+    }
+
+    CommandQueue::~CommandQueue() {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        if (m_worker.joinable())
+            m_worker.join();
+    }
+
+    AsyncResult<void> CommandQueue::submit(Kind kind) {
+        Command command{};
+        command.kind = kind;
+        return enqueue(std::move(command));
+    }
+
+    AsyncResult<void> CommandQueue::seek(std::chrono::seconds position) {
+        Command command{};
+        command.kind = Kind::Seek;
+        command.position = position;
+        return enqueue(std::move(command));
+    }
+
+    AsyncResult<void> CommandQueue::setVolume(double volume) {
+        Command command{};
+        command.kind = Kind::SetVolume;
+        command.volume = volume;
+        return enqueue(std::move(command));
+    }
+
+    AsyncResult<void> CommandQueue::enqueue(Command command) {
+        auto [result, completer] = AsyncResult<void>::pending();
+        command.enqueuedAt = Clock::now();
+        command.completers.push_back(std::move(completer));
+        m_submitted.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            std::scoped_lock lock(m_mutex);
+            if (m_stopping) {
+                command.completers.front()(std::unexpected(AudioError(ErrorCategory::Interrupted, "Queue command")));
+                return result;
+            }
+            if (!tryCoalesce(command))
+                m_pending.push_back(std::move(command));
+        }
+        m_wake.notify_one();
+        return result;
+    }
+
+    // Caller holds m_mutex. On success the waiting command takes the new value and the new
+    // caller's completer; it keeps its original enqueue time so waits are not understated.
+    bool CommandQueue::tryCoalesce(Command& command) {
+        if (command.kind != Kind::Seek && command.kind != Kind::SetVolume)
+            return false;
+
+        for (auto it = m_pending.rbegin(); it != m_pending.rend(); ++it) {
+            if (command.kind == Kind::Seek && (it->kind == Kind::Next || it->kind == Kind::Previous))
+                return false;
+            if (it->kind != command.kind)
+                continue;
+
+            it->position = command.position;
+            it->volume = command.volume;
+            for (auto& completer : command.completers)
+                it->completers.push_back(std::move(completer));
+            m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    std::expected<void, AudioError> CommandQueue::execute(const Command& command) noexcept {
+        switch (command.kind) {
+        case Kind::Play:
+            return m_session->play();
+        case Kind::Pause:
+            return m_session->pause();
+        case Kind::Next:
+            return m_session->next();
+        case Kind::Previous:
+            return m_session->previous();
+        case Kind::Seek:
+            return m_session->seek(command.position);
+        case Kind::SetVolume:
+            return m_session->setVolume(command.volume);
+        }
+        return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Run command"));
+    }
+
+    void CommandQueue::run() {
+        for (;;) {
+            Command command;
+            {
+                std::unique_lock lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+                if (m_pending.empty())
+                    return;
+                command = std::move(m_pending.front());
+                m_pending.pop_front();
+            }
+
+            auto waited = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - command.enqueuedAt).count();
+            m_totalWaitMicros.fetch_add(waited, std::memory_order_relaxed);
+            auto previousMax = m_maxWaitMicros.load(std::memory_order_relaxed);
+            while (waited > previousMax && !m_maxWaitMicros.compare_exchange_weak(previousMax, waited, std::memory_order_relaxed)) {
+            }
+
+            auto result = execute(command);
+            m_executed.fetch_add(1, std::memory_order_relaxed);
+            for (auto& completer : command.completers)
+                completer(result);
+        }
+    }
+
+    CommandQueue::Stats CommandQueue::stats() const noexcept {
+        return {
+            m_submitted.load(std::memory_order_relaxed),
+            m_executed.load(std::memory_order_relaxed),
+            m_coalesced.load(std::memory_order_relaxed),
+            std::chrono::microseconds(m_totalWaitMicros.load(std::memory_order_relaxed)),
+            std::chrono::microseconds(m_maxWaitMicros.load(std::memory_order_relaxed))
+        };
+    }
+
+}
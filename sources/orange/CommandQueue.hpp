@@ -0,0 +1,83 @@
+#pragma once
+#include "IAudioSession.h"
+#include "AsyncResult.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace audio {
+
+    // Runs a session's transport and volume commands in submission order on one dedicated worker.
+    // A seek or volume command that is still waiting when a newer one of the same kind arrives is
+    // folded into the newer value, and every caller of the folded commands completes with the
+    // result of the value that was actually applied. Seeks never fold across a next/previous,
+    // since those change which track the position refers to.
+    class CommandQueue {
+    public:
+        enum class Kind {
+            Play,
+            Pause,
+            Next,
+            Previous,
+            Seek,
+            SetVolume
+        };
+
+        struct Stats {
+            uint64_t submitted{ 0 };
+            uint64_t executed{ 0 };
+            uint64_t coalesced{ 0 };
+            std::chrono::microseconds totalWait{ 0 };
+            std::chrono::microseconds maxWait{ 0 };
+        };
+
+        explicit CommandQueue(std::shared_ptr<IAudioSession> session);
+        ~CommandQueue();
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+
+        AsyncResult<void> submit(Kind kind);
+        AsyncResult<void> seek(std::chrono::seconds position);
+        AsyncResult<void> setVolume(double volume);
+
+        [[nodiscard]] Stats stats() const noexcept;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Command {
+            Kind kind;
+            std::chrono::seconds position{ 0 };
+            double volume{ 0.0 };
+            Clock::time_point enqueuedAt;
+            std::vector<AsyncResult<void>::Completer> completers;
+        };
+
+        AsyncResult<void> enqueue(Command command);
+        bool tryCoalesce(Command& command);
+        std::expected<void, AudioError> execute(const Command& command) noexcept;
+        void run();
+
+        std::shared_ptr<IAudioSession> m_session;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::deque<Command> m_pending;
+        bool m_stopping{ false };
+
+        std::atomic<uint64_t> m_submitted{ 0 };
+        std::atomic<uint64_t> m_executed{ 0 };
+        std::atomic<uint64_t> m_coalesced{ 0 };
+        std::atomic<int64_t> m_totalWaitMicros{ 0 };
+        std::atomic<int64_t> m_maxWaitMicros{ 0 };
+
+        std::thread m_worker;
+    };
+
+}
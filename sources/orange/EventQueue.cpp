@@ -0,0 +1,122 @@
+#include "EventQueue.h"
+#include <bit>
+
+namespace audio {
+
+    // Each cell's turn says whose move it is: equal to a position, the cell is free for the
+    // producer claiming that position; one past it, the cell holds that position's event for a
+    // consumer. Claiming a position is a single CAS on head or tail.
+    EventQueue::EventQueue(size_t capacity)
+        : m_mask(std::bit_ceil(capacity < 2 ? size_t{ 2 } : capacity) - 1),
+        m_cells(std::make_unique<Cell[]>(m_mask + 1)) {
+        for (size_t i = 0; i <= m_mask; ++i)
+            m_cells[i].turn.store(i, std::memory_order_relaxed);
+    }
+
+    void EventQueue::push(SessionEvent::Kind kind) noexcept {
+        SessionEvent event;
+        event.kind = kind;
+        event.timestampMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        if (!tryPush(event)) {
+            m_overflows.fetch_add(1, std::memory_order_relaxed);
+            do {
+                SessionEvent oldest;
+                if (tryPop(oldest))
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+            } while (!tryPush(event));
+        }
+        m_pushed.fetch_add(1, std::memory_order_relaxed);
+
+        // Pairs with the increment in wait(): either the waiter sees the event or we see the waiter.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) != 0) {
+            { std::scoped_lock lock(m_waitMutex); }
+            m_wake.notify_all();
+        }
+    }
+
+    size_t EventQueue::poll(std::span<SessionEvent> buffer) noexcept {
+        size_t count = 0;
+        while (count < buffer.size() && tryPop(buffer[count]))
+            ++count;
+        if (count != 0)
+            m_delivered.fetch_add(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    bool EventQueue::wait(std::chrono::milliseconds timeout) {
+        if (!empty())
+            return true;
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        bool ready;
+        {
+            std::unique_lock lock(m_waitMutex);
+            ready = m_wake.wait_for(lock, timeout, [this] { return !empty(); });
+        }
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        return ready;
+    }
+
+    EventQueue::Stats EventQueue::stats() const noexcept {
+        Stats stats;
+        stats.pushed = m_pushed.load(std::memory_order_relaxed);
+        stats.delivered = m_delivered.load(std::memory_order_relaxed);
+        stats.overflows = m_overflows.load(std::memory_order_relaxed);
+        stats.dropped = m_dropped.load(std::memory_order_relaxed);
+        stats.capacity = m_mask + 1;
+        return stats;
+    }
+
+    bool EventQueue::tryPush(SessionEvent& event) noexcept {
+        uint64_t position = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[position & m_mask];
+            const uint64_t turn = cell.turn.load(std::memory_order_acquire);
+            const auto lag = static_cast<int64_t>(turn - position);
+            if (lag == 0) {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    event.sequence = position + 1;
+                    cell.event = event;
+                    cell.turn.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0) {
+                return false;
+            }
+            else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool EventQueue::tryPop(SessionEvent& event) noexcept {
+        uint64_t position = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[position & m_mask];
+            const uint64_t turn = cell.turn.load(std::memory_order_acquire);
+            const auto lag = static_cast<int64_t>(turn - (position + 1));
+            if (lag == 0) {
+                if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    event = cell.event;
+                    cell.turn.store(position + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0) {
+                return false;
+            }
+            else {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool EventQueue::empty() const noexcept {
+        const uint64_t position = m_head.load(std::memory_order_acquire);
+        return m_cells[position & m_mask].turn.load(std::memory_order_acquire) != position + 1;
+    }
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+namespace audio {
+
+    // One notification as recorded by the session layer. Plain data, so a batch can be copied
+    // straight into a caller's buffer; consumers ask the manager for details they need.
+    struct SessionEvent {
+        enum class Kind : uint32_t {
+            PlaybackChanged = 1,
+            TrackChanged = 2,
+            ActiveSessionChanged = 3
+        };
+
+        Kind kind{ Kind::PlaybackChanged };
+        uint32_t reserved{ 0 };
+        // Increases by one per recorded event in queue order, so a gap shows where events were
+        // dropped or taken by another consumer.
+        uint64_t sequence{ 0 };
+        // System clock, microseconds since the Unix epoch.
+        int64_t timestampMicros{ 0 };
+    };
+
+    // Bounded multi-producer, multi-consumer ring of SessionEvents. Pushing and polling never take a
+    // lock and never allocate; only wait() does, and producers touch its mutex only while a thread
+    // is actually waiting. When the ring is full the oldest event is dropped, so a slow consumer
+    // loses history rather than the latest state.
+    class EventQueue {
+    public:
+        static constexpr size_t DefaultCapacity = 1024;
+
+        struct Stats {
+            uint64_t pushed{ 0 };
+            uint64_t delivered{ 0 };
+            // Pushes that found the ring full.
+            uint64_t overflows{ 0 };
+            // Events discarded to make room. Differs from overflows when several producers race
+            // for the same free slot, or a consumer frees one first.
+            uint64_t dropped{ 0 };
+            size_t capacity{ 0 };
+        };
+
+        // capacity is rounded up to a power of two.
+        explicit EventQueue(size_t capacity = DefaultCapacity);
+        EventQueue(const EventQueue&) = delete;
+        EventQueue& operator=(const EventQueue&) = delete;
+
+        void push(SessionEvent::Kind kind) noexcept;
+        // Copies up to buffer.size() of the oldest events into buffer and returns how many.
+        size_t poll(std::span<SessionEvent> buffer) noexcept;
+        // Blocks until at least one event is queued or timeout passes; true if events are queued.
+        bool wait(std::chrono::milliseconds timeout);
+
+        [[nodiscard]] Stats stats() const noexcept;
+
+    private:
+        struct alignas(64) Cell {
+            std::atomic<uint64_t> turn{ 0 };
+            SessionEvent event;
+        };
+
+        bool tryPush(SessionEvent& event) noexcept;
+        bool tryPop(SessionEvent& event) noexcept;
+        [[nodiscard]] bool empty() const noexcept;
+
+        const size_t m_mask;
+        std::unique_ptr<Cell[]> m_cells;
+        alignas(64) std::atomic<uint64_t> m_head{ 0 };
+        alignas(64) std::atomic<uint64_t> m_tail{ 0 };
+
+        std::atomic<uint32_t> m_waiters{ 0 };
+        std::mutex m_waitMutex;
+        std::condition_variable m_wake;
+
+        std::atomic<uint64_t> m_pushed{ 0 };
+        std::atomic<uint64_t> m_delivered{ 0 };
+        std::atomic<uint64_t> m_overflows{ 0 };
+        std::atomic<uint64_t> m_dropped{ 0 };
+    };
+
+}
@@ -0,0 +1,39 @@
+#include "EventSubscribers.h"
+
+namespace audio {
+
+    EventSubscribers::SubscriptionId EventSubscribers::subscribe(SessionEvent::Kind kind, Callback callback) {
+        if (!valid(kind) || !callback)
+            return 0;
+        const auto id = m_nextId.fetch_add(1, std::memory_order_relaxed);
+        m_lists[slot(kind)].add(id, std::move(callback));
+        return id;
+    }
+
+    bool EventSubscribers::unsubscribe(SubscriptionId id) {
+        for (auto& list : m_lists) {
+            if (list.remove(id))
+                return true;
+        }
+        return false;
+    }
+
+    void EventSubscribers::publish(const SessionNotification& notification) const {
+        if (valid(notification.kind))
+            m_lists[slot(notification.kind)].dispatch(notification);
+    }
+
+    size_t EventSubscribers::count(SessionEvent::Kind kind) const noexcept {
+        return valid(kind) ? m_lists[slot(kind)].size() : 0;
+    }
+
+    bool EventSubscribers::valid(SessionEvent::Kind kind) noexcept {
+        const auto value = static_cast<uint32_t>(kind);
+        return value >= 1 && value <= KindCount;
+    }
+
+    size_t EventSubscribers::slot(SessionEvent::Kind kind) noexcept {
+        return static_cast<size_t>(kind) - 1;
+    }
+
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include "EventQueue.h"
+#include "IAudioSession.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+namespace audio {
+
+    // Copy-on-write list of callbacks. Dispatch loads the current list and calls it without any
+    // lock, so a listener may subscribe or unsubscribe from inside its own callback; writers copy
+    // the list under a mutex and publish the copy. Each listener counts the calls it is in, so
+    // remove can wait for the removed listener alone: once it returns that callback is not
+    // running and will not run again, unless remove was called from it, which cannot wait for
+    // itself. Dispatches of the other listeners are neither waited for nor held up.
+    template <typename Callback>
+    class ListenerList {
+    public:
+        using Id = uint64_t;
+
+        void add(Id id, Callback callback) {
+            std::scoped_lock lock(m_writeMutex);
+            auto entries = std::make_shared<Entries>(*m_entries.load(std::memory_order_acquire));
+            entries->push_back(std::make_shared<Listener>(id, std::move(callback)));
+            m_entries.store(std::move(entries), std::memory_order_release);
+        }
+
+        bool remove(Id id) {
+            std::shared_ptr<Listener> removed;
+            {
+                std::scoped_lock lock(m_writeMutex);
+                auto current = m_entries.load(std::memory_order_acquire);
+                auto entries = std::make_shared<Entries>();
+                entries->reserve(current->size());
+                for (const auto& entry : *current) {
+                    if (entry->id == id)
+                        removed = entry;
+                    else
+                        entries->push_back(entry);
+                }
+                if (!removed)
+                    return false;
+                m_entries.store(std::move(entries), std::memory_order_release);
+            }
+            // A dispatch that loaded the old list either sees the mark and skips the listener
+            // or is already counted in calls; both are seq_cst, so one of them sees the other.
+            removed->removed.store(true);
+            const auto own = static_cast<uint32_t>(std::count(callsOnThisThread().begin(), callsOnThisThread().end(), removed.get()));
+            for (auto calls = removed->calls.load(); calls > own; calls = removed->calls.load())
+                removed->calls.wait(calls);
+            return true;
+        }
+
+        template <typename... Args>
+        void dispatch(const Args&... args) const {
+            auto entries = m_entries.load(std::memory_order_acquire);
+            for (const auto& entry : *entries) {
+                Call call(*entry);
+                if (!entry->removed.load())
+                    entry->callback(args...);
+            }
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_entries.load(std::memory_order_acquire)->size();
+        }
+
+    private:
+        struct Listener {
+            Listener(Id id, Callback callback) : id(id), callback(std::move(callback)) {}
+
+            Id id;
+            Callback callback;
+            // Dispatches inside callback right now, on any thread.
+            std::atomic<uint32_t> calls{ 0 };
+            std::atomic<bool> removed{ false };
+        };
+
+        // Counts one dispatch into a listener, also on this thread's own list, and wakes a
+        // remove waiting for the count to drop.
+        class Call {
+        public:
+            explicit Call(Listener& listener) : m_listener(listener) {
+                m_listener.calls.fetch_add(1);
+                callsOnThisThread().push_back(&m_listener);
+            }
+            ~Call() {
+                callsOnThisThread().pop_back();
+                m_listener.calls.fetch_sub(1);
+                if (m_listener.removed.load())
+                    m_listener.calls.notify_all();
+            }
+            Call(const Call&) = delete;
+            Call& operator=(const Call&) = delete;
+
+        private:
+            Listener& m_listener;
+        };
+
+        using Entries = std::vector<std::shared_ptr<Listener>>;
+
+        // The listeners this thread is calling, innermost last.
+        static std::vector<const Listener*>& callsOnThisThread() {
+            thread_local std::vector<const Listener*> calls;
+            return calls;
+        }
+
+        std::mutex m_writeMutex;
+        std::atomic<std::shared_ptr<const Entries>> m_entries{ std::make_shared<const Entries>() };
+    };
+
+    // What a subscriber of one event kind receives. Only the fields of that kind are set; the
+    // views and the pointer are valid for the duration of the call.
+    struct SessionNotification {
+        SessionEvent::Kind kind{ SessionEvent::Kind::PlaybackChanged };
+        // PlaybackChanged.
+        const PlaybackEvent* playback{ nullptr };
+        // TrackChanged.
+        std::string_view title;
+        std::string_view artist;
+        // ActiveSessionChanged; empty when no session is active.
+        std::string_view sessionId;
+    };
+
+    // Any number of subscribers per event kind, fed from the single handler the manager installs
+    // for that kind. Ids are unique across kinds, so unsubscribe needs only the id.
+    class EventSubscribers {
+    public:
+        using SubscriptionId = uint64_t;
+        using Callback = std::function<void(const SessionNotification&)>;
+
+        // Returns 0 for an unknown kind or an empty callback.
+        SubscriptionId subscribe(SessionEvent::Kind kind, Callback callback);
+        // False if id is not (or no longer) subscribed. Once it returns true the callback is not
+        // running and will not run again, unless unsubscribe is called from that callback, which
+        // cannot wait for itself. Other subscribers' calls are not waited for.
+        bool unsubscribe(SubscriptionId id);
+        void publish(const SessionNotification& notification) const;
+        [[nodiscard]] size_t count(SessionEvent::Kind kind) const noexcept;
+
+    private:
+        static constexpr size_t KindCount = 3;
+
+        [[nodiscard]] static bool valid(SessionEvent::Kind kind) noexcept;
+        [[nodiscard]] static size_t slot(SessionEvent::Kind kind) noexcept;
+
+        std::array<ListenerList<Callback>, KindCount> m_lists;
+        std::atomic<SubscriptionId> m_nextId{ 1 };
+    };
+
+}
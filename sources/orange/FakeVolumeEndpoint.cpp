@@ -0,0 +1,53 @@
+#include "FakeVolumeEndpoint.h"
+#include <utility>
+
+namespace audio {
+    namespace platform {
+
+        std::expected<void, AudioError> FakeVolumeEndpoint::open(ChangeHandler onChanged) noexcept {
+            std::scoped_lock lock(m_mutex);
+            m_onChanged = std::move(onChanged);
+            m_opens.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+
+        std::expected<float, AudioError> FakeVolumeEndpoint::readVolume() noexcept {
+            m_reads.fetch_add(1, std::memory_order_relaxed);
+            std::scoped_lock lock(m_mutex);
+            return m_volume;
+        }
+
+        std::expected<bool, AudioError> FakeVolumeEndpoint::readMute() noexcept {
+            m_reads.fetch_add(1, std::memory_order_relaxed);
+            std::scoped_lock lock(m_mutex);
+            return m_muted;
+        }
+
+        std::expected<void, AudioError> FakeVolumeEndpoint::writeVolume(float volume) noexcept {
+            m_writes.fetch_add(1, std::memory_order_relaxed);
+            std::scoped_lock lock(m_mutex);
+            m_volume = volume;
+            return {};
+        }
+
+        std::expected<void, AudioError> FakeVolumeEndpoint::writeMute(bool muted) noexcept {
+            m_writes.fetch_add(1, std::memory_order_relaxed);
+            std::scoped_lock lock(m_mutex);
+            m_muted = muted;
+            return {};
+        }
+
+        void FakeVolumeEndpoint::simulateExternalChange(float volume, bool muted) {
+            ChangeHandler handler;
+            {
+                std::scoped_lock lock(m_mutex);
+                m_volume = volume;
+                m_muted = muted;
+                handler = m_onChanged;
+            }
+            if (handler)
+                handler(volume, muted);
+        }
+
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "VolumeController.h"
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+namespace audio {
+    namespace platform {
+
+        // In-memory endpoint for exercising VolumeController off Windows. The counters show how
+        // often the controller actually reached the endpoint; simulateExternalChange behaves like
+        // another application moving the mixer slider.
+        class FakeVolumeEndpoint : public IVolumeEndpoint {
+        public:
+            std::expected<void, AudioError> open(ChangeHandler onChanged) noexcept override;
+            std::expected<float, AudioError> readVolume() noexcept override;
+            std::expected<bool, AudioError> readMute() noexcept override;
+            std::expected<void, AudioError> writeVolume(float volume) noexcept override;
+            std::expected<void, AudioError> writeMute(bool muted) noexcept override;
+
+            void simulateExternalChange(float volume, bool muted);
+
+            [[nodiscard]] uint64_t opens() const noexcept { return m_opens.load(std::memory_order_relaxed); }
+            [[nodiscard]] uint64_t reads() const noexcept { return m_reads.load(std::memory_order_relaxed); }
+            [[nodiscard]] uint64_t writes() const noexcept { return m_writes.load(std::memory_order_relaxed); }
+
+        private:
+            std::mutex m_mutex;
+            ChangeHandler m_onChanged;
+            float m_volume{ 1.0f };
+            bool m_muted{ false };
+            std::atomic<uint64_t> m_opens{ 0 };
+            std::atomic<uint64_t> m_reads{ 0 };
+            std::atomic<uint64_t> m_writes{ 0 };
+        };
+
+    }
+}
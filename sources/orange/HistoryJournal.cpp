@@ -0,0 +1,666 @@
+#include "HistoryJournal.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace audio {
+
+    namespace {
+
+        // Leads the file; records follow back to back.
+        struct JournalHeader {
+            char magic[4]{ 'A', 'H', 'J', 'L' };
+            uint16_t version{ 1 };
+            uint16_t recordSize{ sizeof(HistoryRecord) };
+            // File length, header included, up to the end of the last commit that reached the
+            // disk; 0 if unknown. Readers map no further and the writer never cuts below it, so
+            // a mapping can not lose pages under a reader (SIGBUS on POSIX).
+            uint64_t committedBytes{ 0 };
+        };
+
+        static_assert(sizeof(JournalHeader) == 16);
+        constexpr uint64_t CommittedBytesOffset = offsetof(JournalHeader, committedBytes);
+
+        constexpr size_t RecordsOffset = sizeof(JournalHeader);
+        // Records read per call while checking an existing journal on open.
+        constexpr size_t RecoveryChunk = 4096;
+
+        [[nodiscard]] bool validHeader(const JournalHeader& header) noexcept {
+            const JournalHeader expected;
+            return std::memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0
+                && header.version == expected.version && header.recordSize == expected.recordSize;
+        }
+
+        [[nodiscard]] int32_t lastSystemError() noexcept {
+#ifdef _WIN32
+            return static_cast<int32_t>(HRESULT_FROM_WIN32(GetLastError()));
+#else
+            return errno;
+#endif
+        }
+
+        [[nodiscard]] AudioError systemError(const char* operation) {
+            return AudioError(ErrorCategory::Platform, operation, lastSystemError());
+        }
+
+        // FNV-1a, 32 and 64 bit.
+        template <typename Word, Word Basis, Word Prime>
+        struct Fnv {
+            Word value{ Basis };
+
+            void add(const void* data, size_t size) noexcept {
+                const auto* bytes = static_cast<const uint8_t*>(data);
+                for (size_t i = 0; i < size; ++i)
+                    value = (value ^ bytes[i]) * Prime;
+            }
+        };
+
+        using Fnv32 = Fnv<uint32_t, 0x811C9DC5u, 0x01000193u>;
+        using Fnv64 = Fnv<uint64_t, 0xCBF29CE484222325ull, 0x00000100000001B3ull>;
+
+        // Completed once this share of the duration has been played.
+        constexpr double CompletedShare = 0.9;
+
+    }
+
+    uint32_t HistoryRecord::computeChecksum() const noexcept {
+        Fnv32 hash;
+        hash.add(this, offsetof(HistoryRecord, checksum));
+        return hash.value;
+    }
+
+    uint64_t HistoryJournal::trackId(std::string_view title, std::string_view artist, std::string_view album, std::chrono::seconds duration) noexcept {
+        constexpr uint8_t Separator = 0x1F;
+        Fnv64 hash;
+        for (auto field : { title, artist, album }) {
+            hash.add(field.data(), field.size());
+            hash.add(&Separator, 1);
+        }
+        const auto seconds = static_cast<int64_t>(duration.count());
+        for (size_t shift = 0; shift < 64; shift += 8) {
+            const auto byte = static_cast<uint8_t>(static_cast<uint64_t>(seconds) >> shift);
+            hash.add(&byte, 1);
+        }
+        return hash.value;
+    }
+
+    // The journal's file handle. Only the writer thread uses it once the journal is open.
+    class HistoryJournal::File {
+    public:
+        static std::expected<std::unique_ptr<File>, AudioError> open(const std::filesystem::path& path) {
+#ifdef _WIN32
+            HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (handle == INVALID_HANDLE_VALUE)
+                return std::unexpected(systemError("Open history"));
+            auto file = std::unique_ptr<File>(new File(handle));
+            LARGE_INTEGER size{};
+            if (!GetFileSizeEx(handle, &size))
+                return std::unexpected(systemError("Open history"));
+            file->m_size = static_cast<uint64_t>(size.QuadPart);
+#else
+            const int descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (descriptor < 0)
+                return std::unexpected(systemError("Open history"));
+            auto file = std::unique_ptr<File>(new File(descriptor));
+            struct stat status {};
+            if (fstat(descriptor, &status) != 0)
+                return std::unexpected(systemError("Open history"));
+            file->m_size = static_cast<uint64_t>(status.st_size);
+#endif
+            return file;
+        }
+
+        ~File() {
+#ifdef _WIN32
+            CloseHandle(m_handle);
+#else
+            ::close(m_descriptor);
+#endif
+        }
+
+        [[nodiscard]] uint64_t size() const noexcept { return m_size; }
+
+        std::expected<void, AudioError> read(uint64_t offset, void* data, size_t size) {
+            auto* bytes = static_cast<uint8_t*>(data);
+            while (size > 0) {
+#ifdef _WIN32
+                OVERLAPPED position{};
+                position.Offset = static_cast<DWORD>(offset);
+                position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD done = 0;
+                if (!ReadFile(m_handle, bytes, static_cast<DWORD>(std::min<size_t>(size, 1u << 30)), &done, &position))
+                    return std::unexpected(systemError("Read history"));
+#else
+                const auto done = ::pread(m_descriptor, bytes, size, static_cast<off_t>(offset));
+                if (done < 0 && errno == EINTR)
+                    continue;
+                if (done < 0)
+                    return std::unexpected(systemError("Read history"));
+#endif
+                if (done == 0)
+                    return std::unexpected(AudioError(ErrorCategory::Interrupted, "Read history"));
+                bytes += done;
+                offset += static_cast<uint64_t>(done);
+                size -= static_cast<size_t>(done);
+            }
+            return {};
+        }
+
+        // Records in the header how far the file is durable. Written after the data is flushed
+        // and not flushed itself: a lost update only leaves the value behind the data, which
+        // the next open puts right.
+        std::expected<void, AudioError> publishCommitted(uint64_t size) {
+            return write(CommittedBytesOffset, &size, sizeof(size), "Write history");
+        }
+
+        // Appends data and makes it durable. A write that fails halfway is cut off again, so
+        // the next commit starts right after the last complete one; that only cuts bytes past
+        // the published committed length.
+        std::expected<void, AudioError> append(const void* data, size_t size) {
+            const auto start = m_size;
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            auto offset = start;
+            while (size > 0) {
+#ifdef _WIN32
+                OVERLAPPED position{};
+                position.Offset = static_cast<DWORD>(offset);
+                position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD done = 0;
+                if (!WriteFile(m_handle, bytes, static_cast<DWORD>(std::min<size_t>(size, 1u << 30)), &done, &position)) {
+                    auto error = systemError("Write history");
+                    (void)truncate(start);
+                    return std::unexpected(error);
+                }
+#else
+                const auto done = ::pwrite(m_descriptor, bytes, size, static_cast<off_t>(offset));
+                if (done < 0 && errno == EINTR)
+                    continue;
+                if (done <= 0) {
+                    auto error = systemError("Write history");
+                    (void)truncate(start);
+                    return std::unexpected(error);
+                }
+#endif
+                bytes += done;
+                offset += static_cast<uint64_t>(done);
+                size -= static_cast<size_t>(done);
+            }
+            m_size = offset;
+            if (!sync()) {
+                auto error = systemError("Flush history");
+                (void)truncate(start);
+                return std::unexpected(error);
+            }
+            return {};
+        }
+
+        // Readers map at most the committed length, so this never takes pages from under them.
+        // Windows refuses while any mapping of the file is open; the bytes then stay, past the
+        // committed length, and the next commit overwrites them.
+        std::expected<void, AudioError> truncate(uint64_t size) {
+#ifdef _WIN32
+            FILE_END_OF_FILE_INFO end{};
+            end.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+            if (!SetFileInformationByHandle(m_handle, FileEndOfFileInfo, &end, sizeof(end)))
+                return std::unexpected(systemError("Truncate history"));
+#else
+            if (::ftruncate(m_descriptor, static_cast<off_t>(size)) != 0)
+                return std::unexpected(systemError("Truncate history"));
+#endif
+            m_size = size;
+            return {};
+        }
+
+    private:
+        std::expected<void, AudioError> write(uint64_t offset, const void* data, size_t size, const char* operation) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            while (size > 0) {
+#ifdef _WIN32
+                OVERLAPPED position{};
+                position.Offset = static_cast<DWORD>(offset);
+                position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD done = 0;
+                if (!WriteFile(m_handle, bytes, static_cast<DWORD>(size), &done, &position))
+                    return std::unexpected(systemError(operation));
+#else
+                const auto done = ::pwrite(m_descriptor, bytes, size, static_cast<off_t>(offset));
+                if (done < 0 && errno == EINTR)
+                    continue;
+                if (done <= 0)
+                    return std::unexpected(systemError(operation));
+#endif
+                bytes += done;
+                offset += static_cast<uint64_t>(done);
+                size -= static_cast<size_t>(done);
+            }
+            return {};
+        }
+
+#ifdef _WIN32
+        explicit File(HANDLE handle) noexcept : m_handle(handle) {}
+
+        bool sync() noexcept { return FlushFileBuffers(m_handle) != 0; }
+
+        HANDLE m_handle;
+#else
+        explicit File(int descriptor) noexcept : m_descriptor(descriptor) {}
+
+        bool sync() noexcept {
+#ifdef __APPLE__
+            return ::fsync(m_descriptor) == 0;
+#else
+            return ::fdatasync(m_descriptor) == 0;
+#endif
+        }
+
+        int m_descriptor;
+#endif
+        uint64_t m_size{ 0 };
+    };
+
+    // Writes the header into an empty file, or checks it and cuts the file back to its longest
+    // prefix of whole records with valid checksums. Commits only ever append, so everything
+    // after the first bad record comes from the same torn commit.
+    std::expected<std::unique_ptr<HistoryJournal>, AudioError> HistoryJournal::open(const std::filesystem::path& path) noexcept {
+        try {
+            auto file = File::open(path);
+            if (!file)
+                return std::unexpected(file.error());
+            auto& handle = **file;
+
+            JournalHeader header;
+            header.committedBytes = RecordsOffset;
+            if (handle.size() < RecordsOffset) {
+                if (handle.size() != 0) {
+                    if (auto truncated = handle.truncate(0); !truncated)
+                        return std::unexpected(truncated.error());
+                }
+                if (auto written = handle.append(&header, sizeof(header)); !written)
+                    return std::unexpected(written.error());
+                return std::unique_ptr<HistoryJournal>(new HistoryJournal(path, std::move(*file), 0, 0));
+            }
+
+            JournalHeader existing;
+            if (auto read = handle.read(0, &existing, sizeof(existing)); !read)
+                return std::unexpected(read.error());
+            if (!validHeader(existing))
+                return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Open history", 0, "not a history journal"));
+
+            const uint64_t available = (handle.size() - RecordsOffset) / sizeof(HistoryRecord);
+            std::vector<HistoryRecord> chunk(RecoveryChunk);
+            uint64_t valid = 0;
+            while (valid < available) {
+                const auto count = static_cast<size_t>(std::min<uint64_t>(RecoveryChunk, available - valid));
+                if (auto read = handle.read(RecordsOffset + valid * sizeof(HistoryRecord), chunk.data(), count * sizeof(HistoryRecord)); !read)
+                    return std::unexpected(read.error());
+                const auto end = chunk.begin() + static_cast<ptrdiff_t>(count);
+                const auto bad = std::find_if(chunk.begin(), end, [](const HistoryRecord& record) { return !record.valid(); });
+                valid += static_cast<uint64_t>(bad - chunk.begin());
+                if (bad != end)
+                    break;
+            }
+
+            const uint64_t keep = RecordsOffset + valid * sizeof(HistoryRecord);
+            const uint64_t truncated = handle.size() - keep;
+            if (truncated > 0) {
+                if (auto cut = handle.truncate(keep); !cut)
+                    return std::unexpected(cut.error());
+            }
+            if (existing.committedBytes != keep) {
+                if (auto published = handle.publishCommitted(keep); !published)
+                    return std::unexpected(published.error());
+            }
+            return std::unique_ptr<HistoryJournal>(new HistoryJournal(path, std::move(*file), valid, truncated));
+        }
+        catch (const std::exception& ex) {
+            return std::unexpected(AudioError::fromException("Open history", ex));
+        }
+    }
+
+    HistoryJournal::HistoryJournal(std::filesystem::path path, std::unique_ptr<File> file, uint64_t recovered, uint64_t truncatedBytes)
+        : m_path(std::move(path)), m_file(std::move(file)), m_recovered(recovered), m_truncatedBytes(truncatedBytes) {
+        m_writer = std::thread([this] { run(); });
+    }
+
+    HistoryJournal::~HistoryJournal() {
+        close();
+    }
+
+    void HistoryJournal::append(HistoryRecord record) {
+        record.checksum = record.computeChecksum();
+        {
+            std::scoped_lock lock(m_mutex);
+            if (m_stopping)
+                return;
+            m_pending.push_back(record);
+            ++m_appended;
+        }
+        m_wake.notify_one();
+    }
+
+    // Reports the first failure since the previous flush, if any commit failed meanwhile.
+    std::expected<void, AudioError> HistoryJournal::flush() {
+        std::unique_lock lock(m_mutex);
+        const auto target = m_appended;
+        m_committedWake.wait(lock, [&] { return m_settled >= target; });
+        if (m_lastError) {
+            auto error = std::move(*m_lastError);
+            m_lastError.reset();
+            return std::unexpected(std::move(error));
+        }
+        return {};
+    }
+
+    void HistoryJournal::close() {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        if (m_writer.joinable())
+            m_writer.join();
+    }
+
+    HistoryJournal::Stats HistoryJournal::stats() const noexcept {
+        Stats stats;
+        {
+            std::scoped_lock lock(m_mutex);
+            stats.appended = m_appended;
+        }
+        stats.committed = m_committed.load(std::memory_order_relaxed);
+        stats.commits = m_commits.load(std::memory_order_relaxed);
+        stats.failures = m_failures.load(std::memory_order_relaxed);
+        stats.recovered = m_recovered;
+        stats.truncatedBytes = m_truncatedBytes;
+        return stats;
+    }
+
+    // Whatever queues up while a commit is on its way to disk goes out with the next one, so the
+    // number of flushes follows the disk's pace rather than the event rate.
+    void HistoryJournal::run() {
+        std::vector<HistoryRecord> batch;
+        for (;;) {
+            batch.clear();
+            {
+                std::unique_lock lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+                if (m_pending.empty())
+                    return;
+                batch.swap(m_pending);
+            }
+
+            auto written = m_file->append(batch.data(), batch.size() * sizeof(HistoryRecord));
+            if (written)
+                written = m_file->publishCommitted(m_file->size());
+            if (written) {
+                m_committed.fetch_add(batch.size(), std::memory_order_relaxed);
+                m_commits.fetch_add(1, std::memory_order_relaxed);
+            }
+            else {
+                m_failures.fetch_add(1, std::memory_order_relaxed);
+            }
+            {
+                std::scoped_lock lock(m_mutex);
+                m_settled += batch.size();
+                if (!written && !m_lastError)
+                    m_lastError = written.error();
+            }
+            m_committedWake.notify_all();
+        }
+    }
+
+    namespace {
+
+        // How much of a file of size bytes a reader may map: up to the committed length in its
+        // header, when there is one, and whole records only.
+        [[nodiscard]] uint64_t mappableSize(const JournalHeader& header, uint64_t size) noexcept {
+            if (size < RecordsOffset || !validHeader(header))
+                return size;
+            if (header.committedBytes >= RecordsOffset)
+                size = std::min(size, header.committedBytes);
+            return RecordsOffset + (size - RecordsOffset) / sizeof(HistoryRecord) * sizeof(HistoryRecord);
+        }
+
+    }
+
+    // A read-only mapping of the file's committed records as they were when opened. Nothing
+    // past the committed length is mapped, so the writer cutting a failed commit or a torn
+    // tail never takes pages from under it.
+    class HistoryReader::Mapping {
+    public:
+        static std::expected<std::unique_ptr<Mapping>, AudioError> open(const std::filesystem::path& path) {
+            auto mapping = std::unique_ptr<Mapping>(new Mapping());
+#ifdef _WIN32
+            mapping->m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (mapping->m_file == INVALID_HANDLE_VALUE)
+                return std::unexpected(systemError("Open history"));
+            LARGE_INTEGER size{};
+            if (!GetFileSizeEx(mapping->m_file, &size))
+                return std::unexpected(systemError("Open history"));
+            JournalHeader header;
+            DWORD done = 0;
+            OVERLAPPED start{};
+            if (static_cast<uint64_t>(size.QuadPart) >= RecordsOffset
+                && (!ReadFile(mapping->m_file, &header, sizeof(header), &done, &start) || done != sizeof(header)))
+                return std::unexpected(systemError("Open history"));
+            const auto mapped = mappableSize(header, static_cast<uint64_t>(size.QuadPart));
+            mapping->m_size = static_cast<size_t>(mapped);
+            if (mapping->m_size == 0)
+                return mapping;
+            mapping->m_section = CreateFileMappingW(mapping->m_file, nullptr, PAGE_READONLY,
+                static_cast<DWORD>(mapped >> 32), static_cast<DWORD>(mapped), nullptr);
+            if (!mapping->m_section)
+                return std::unexpected(systemError("Map history"));
+            mapping->m_data = MapViewOfFile(mapping->m_section, FILE_MAP_READ, 0, 0, mapping->m_size);
+            if (!mapping->m_data)
+                return std::unexpected(systemError("Map history"));
+#else
+            const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (descriptor < 0)
+                return std::unexpected(systemError("Open history"));
+            // The mapping stays valid once the descriptor is closed.
+            struct stat status {};
+            if (fstat(descriptor, &status) != 0) {
+                auto error = systemError("Open history");
+                ::close(descriptor);
+                return std::unexpected(error);
+            }
+            JournalHeader header;
+            const auto size = static_cast<uint64_t>(status.st_size);
+            if (size >= RecordsOffset && ::pread(descriptor, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+                auto error = systemError("Open history");
+                ::close(descriptor);
+                return std::unexpected(error);
+            }
+            mapping->m_size = static_cast<size_t>(mappableSize(header, size));
+            if (mapping->m_size > 0) {
+                void* data = mmap(nullptr, mapping->m_size, PROT_READ, MAP_SHARED, descriptor, 0);
+                if (data == MAP_FAILED) {
+                    auto error = systemError("Map history");
+                    ::close(descriptor);
+                    return std::unexpected(error);
+                }
+                mapping->m_data = data;
+            }
+            ::close(descriptor);
+#endif
+            return mapping;
+        }
+
+        ~Mapping() {
+#ifdef _WIN32
+            if (m_data)
+                UnmapViewOfFile(m_data);
+            if (m_section)
+                CloseHandle(m_section);
+            if (m_file != INVALID_HANDLE_VALUE)
+                CloseHandle(m_file);
+#else
+            if (m_data)
+                munmap(m_data, m_size);
+#endif
+        }
+
+        [[nodiscard]] const uint8_t* data() const noexcept { return static_cast<const uint8_t*>(m_data); }
+        [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+    private:
+        Mapping() = default;
+
+#ifdef _WIN32
+        HANDLE m_file{ INVALID_HANDLE_VALUE };
+        HANDLE m_section{ nullptr };
+#endif
+        void* m_data{ nullptr };
+        size_t m_size{ 0 };
+    };
+
+    std::expected<HistoryReader, AudioError> HistoryReader::open(const std::filesystem::path& path) noexcept {
+        try {
+            auto mapping = Mapping::open(path);
+            if (!mapping)
+                return std::unexpected(mapping.error());
+            const auto size = (*mapping)->size();
+            if (size == 0)
+                return HistoryReader(std::move(*mapping));
+            JournalHeader header;
+            if (size < RecordsOffset)
+                return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Open history", 0, "not a history journal"));
+            std::memcpy(&header, (*mapping)->data(), sizeof(header));
+            if (!validHeader(header))
+                return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Open history", 0, "not a history journal"));
+            return HistoryReader(std::move(*mapping));
+        }
+        catch (const std::exception& ex) {
+            return std::unexpected(AudioError::fromException("Open history", ex));
+        }
+    }
+
+    // Mappings are page aligned and the header is 16 bytes, so the records are suitably aligned
+    // to be read in place.
+    HistoryReader::HistoryReader(std::unique_ptr<Mapping> mapping) noexcept
+        : m_mapping(std::move(mapping)) {
+        if (m_mapping->size() < RecordsOffset)
+            return;
+        const auto* first = reinterpret_cast<const HistoryRecord*>(m_mapping->data() + RecordsOffset);
+        auto count = (m_mapping->size() - RecordsOffset) / sizeof(HistoryRecord);
+        while (count > 0 && !first[count - 1].valid())
+            --count;
+        m_records = std::span<const HistoryRecord>(first, count);
+    }
+
+    HistoryReader::~HistoryReader() = default;
+    HistoryReader::HistoryReader(HistoryReader&& other) noexcept = default;
+    HistoryReader& HistoryReader::operator=(HistoryReader&& other) noexcept = default;
+
+    std::vector<HistoryRecord> HistoryReader::recent(size_t count) const {
+        count = std::min(count, m_records.size());
+        return std::vector<HistoryRecord>(m_records.rbegin(), m_records.rbegin() + static_cast<ptrdiff_t>(count));
+    }
+
+    HistoryReader::PlayCount HistoryReader::playCount(uint64_t trackId) const noexcept {
+        PlayCount count;
+        uint64_t playedMillis = 0;
+        for (const auto& record : m_records) {
+            if (record.trackId != trackId)
+                continue;
+            ++count.plays;
+            if (record.outcome == PlayOutcome::Completed)
+                ++count.completed;
+            playedMillis += record.playedMillis;
+        }
+        count.played = std::chrono::milliseconds(playedMillis);
+        return count;
+    }
+
+    PlayTracker::PlayTracker(std::unique_ptr<HistoryJournal> journal) noexcept
+        : m_journal(std::move(journal)) {
+    }
+
+    PlayTracker::~PlayTracker() {
+        finish();
+    }
+
+    // A track-changed notification also fires when only the artwork changes; the play goes on
+    // if the track is still the same one.
+    void PlayTracker::trackChanged(const TrackSnapshot& snapshot, Clock::time_point now) {
+        const auto id = HistoryJournal::trackId(snapshot.title, snapshot.artist, snapshot.album, snapshot.duration);
+        std::scoped_lock lock(m_mutex);
+        if (m_current && m_current->trackId == id) {
+            playbackLocked(snapshot.status, now);
+            return;
+        }
+        finishLocked(now);
+        if (snapshot.title.empty())
+            return;
+        Play play;
+        play.trackId = id;
+        play.startedMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        play.duration = snapshot.duration;
+        if (snapshot.status == PlaybackStatus::Playing)
+            play.playingSince = now;
+        m_current = play;
+    }
+
+    void PlayTracker::playbackChanged(PlaybackStatus status, Clock::time_point now) {
+        std::scoped_lock lock(m_mutex);
+        playbackLocked(status, now);
+    }
+
+    void PlayTracker::finish(Clock::time_point now) {
+        std::scoped_lock lock(m_mutex);
+        finishLocked(now);
+    }
+
+    void PlayTracker::playbackLocked(PlaybackStatus status, Clock::time_point now) {
+        if (!m_current)
+            return;
+        auto& play = *m_current;
+        if (status == PlaybackStatus::Playing) {
+            if (!play.playingSince)
+                play.playingSince = now;
+        }
+        else if (play.playingSince) {
+            play.played += now - *play.playingSince;
+            play.playingSince.reset();
+        }
+    }
+
+    void PlayTracker::finishLocked(Clock::time_point now) {
+        if (!m_current)
+            return;
+        playbackLocked(PlaybackStatus::Paused, now);
+        const auto& play = *m_current;
+        const auto played = std::chrono::duration_cast<std::chrono::milliseconds>(play.played);
+        const bool completed = play.duration.count() <= 0
+            || std::chrono::duration<double>(played).count() >= CompletedShare * static_cast<double>(play.duration.count());
+
+        HistoryRecord record;
+        record.startedMicros = play.startedMicros;
+        record.trackId = play.trackId;
+        record.playedMillis = static_cast<uint32_t>(std::clamp<int64_t>(played.count(), 0, UINT32_MAX));
+        record.durationSeconds = static_cast<uint32_t>(std::clamp<int64_t>(play.duration.count(), 0, UINT32_MAX));
+        record.outcome = completed ? PlayOutcome::Completed : PlayOutcome::Skipped;
+        m_journal->append(record);
+        m_current.reset();
+    }
+
+}
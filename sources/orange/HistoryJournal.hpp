@@ -0,0 +1,178 @@
+#pragma once
+#include "IAudioSession.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <cstdint>
+
+namespace audio {
+
+    enum class PlayOutcome : uint8_t {
+        // Left before 90% of its duration had been played.
+        Skipped = 1,
+        // Played for at least 90% of its duration, or of unknown duration.
+        Completed = 2
+    };
+
+    // One finished play, exactly as stored in the journal: 32 bytes, little-endian, no padding.
+    struct HistoryRecord {
+        // When the play started, in microseconds since the Unix epoch.
+        int64_t startedMicros{ 0 };
+        uint64_t trackId{ 0 };
+        // Time spent in the Playing state, seeks and pauses excluded.
+        uint32_t playedMillis{ 0 };
+        uint32_t durationSeconds{ 0 };
+        PlayOutcome outcome{ PlayOutcome::Skipped };
+        uint8_t reserved[3]{};
+        // Over the bytes above; a torn or zero-filled record fails it.
+        uint32_t checksum{ 0 };
+
+        [[nodiscard]] uint32_t computeChecksum() const noexcept;
+        [[nodiscard]] bool valid() const noexcept { return checksum == computeChecksum(); }
+    };
+
+    static_assert(sizeof(HistoryRecord) == 32 && std::is_trivially_copyable_v<HistoryRecord>);
+
+    // Append-only journal of finished plays. append() only queues the record, so it is safe to
+    // call from event handlers; a writer thread takes everything queued while its previous
+    // commit was in flight and commits it as one write followed by one flush to disk. Opening
+    // an existing journal drops a torn tail left by a crash in the middle of a commit.
+    class HistoryJournal {
+    public:
+        struct Stats {
+            uint64_t appended{ 0 };
+            uint64_t committed{ 0 };
+            // Group commits, each one write and one flush.
+            uint64_t commits{ 0 };
+            uint64_t failures{ 0 };
+            // Records in the file when it was opened, and bytes of torn tail cut off then.
+            uint64_t recovered{ 0 };
+            uint64_t truncatedBytes{ 0 };
+        };
+
+        // Creates the file if needed. Fails if it exists and is not a journal.
+        static std::expected<std::unique_ptr<HistoryJournal>, AudioError> open(const std::filesystem::path& path) noexcept;
+        ~HistoryJournal();
+        HistoryJournal(const HistoryJournal&) = delete;
+        HistoryJournal& operator=(const HistoryJournal&) = delete;
+
+        // Fills in the checksum.
+        void append(HistoryRecord record);
+        // Blocks until everything appended so far is on disk, or has failed to get there.
+        std::expected<void, AudioError> flush();
+        // Commits what is queued and joins the writer; later appends are dropped.
+        void close();
+
+        [[nodiscard]] Stats stats() const noexcept;
+        [[nodiscard]] const std::filesystem::path& path() const noexcept { return m_path; }
+
+        // Stable across runs and platforms: FNV-1a over the UTF-8 fields and the duration.
+        [[nodiscard]] static uint64_t trackId(std::string_view title, std::string_view artist, std::string_view album, std::chrono::seconds duration) noexcept;
+
+    private:
+        class File;
+
+        HistoryJournal(std::filesystem::path path, std::unique_ptr<File> file, uint64_t recovered, uint64_t truncatedBytes);
+        void run();
+
+        const std::filesystem::path m_path;
+        std::unique_ptr<File> m_file;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_committedWake;
+        std::vector<HistoryRecord> m_pending;
+        bool m_stopping{ false };
+        uint64_t m_appended{ 0 };
+        uint64_t m_settled{ 0 };
+        std::optional<AudioError> m_lastError;
+
+        std::atomic<uint64_t> m_committed{ 0 };
+        std::atomic<uint64_t> m_commits{ 0 };
+        std::atomic<uint64_t> m_failures{ 0 };
+        const uint64_t m_recovered;
+        const uint64_t m_truncatedBytes;
+
+        std::thread m_writer;
+    };
+
+    // Read-only view of a journal through a memory mapping, for queries over the whole history.
+    // The view covers the records committed when it was opened, as recorded in the header, so
+    // a commit in progress stays out of it and the writer cutting a torn tail never pulls
+    // pages from under it. Torn records at its end (a crash the writer has not recovered from
+    // yet) are left out as well.
+    class HistoryReader {
+    public:
+        struct PlayCount {
+            uint64_t plays{ 0 };
+            uint64_t completed{ 0 };
+            std::chrono::milliseconds played{ 0 };
+        };
+
+        static std::expected<HistoryReader, AudioError> open(const std::filesystem::path& path) noexcept;
+        ~HistoryReader();
+        HistoryReader(HistoryReader&& other) noexcept;
+        HistoryReader& operator=(HistoryReader&& other) noexcept;
+
+        [[nodiscard]] std::span<const HistoryRecord> records() const noexcept { return m_records; }
+        // Up to count plays, newest first.
+        [[nodiscard]] std::vector<HistoryRecord> recent(size_t count) const;
+        [[nodiscard]] PlayCount playCount(uint64_t trackId) const noexcept;
+
+    private:
+        class Mapping;
+
+        explicit HistoryReader(std::unique_ptr<Mapping> mapping) noexcept;
+
+        std::unique_ptr<Mapping> m_mapping;
+        std::span<const HistoryRecord> m_records;
+    };
+
+    // Turns the track and playback events of the active session into finished plays: a play
+    // ends when the track or the active session changes, and its played time is the time the
+    // session spent in the Playing state meanwhile. Safe to call from several event threads.
+    class PlayTracker {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit PlayTracker(std::unique_ptr<HistoryJournal> journal) noexcept;
+        ~PlayTracker();
+        PlayTracker(const PlayTracker&) = delete;
+        PlayTracker& operator=(const PlayTracker&) = delete;
+
+        // A new track started, or the active session changed to one playing snapshot's track.
+        void trackChanged(const TrackSnapshot& snapshot, Clock::time_point now = Clock::now());
+        void playbackChanged(PlaybackStatus status, Clock::time_point now = Clock::now());
+        // Ends the current play, e.g. because the session went away.
+        void finish(Clock::time_point now = Clock::now());
+
+        [[nodiscard]] HistoryJournal& journal() noexcept { return *m_journal; }
+
+    private:
+        struct Play {
+            uint64_t trackId{ 0 };
+            int64_t startedMicros{ 0 };
+            std::chrono::seconds duration{ 0 };
+            Clock::duration played{ 0 };
+            std::optional<Clock::time_point> playingSince;
+        };
+
+        void playbackLocked(PlaybackStatus status, Clock::time_point now);
+        void finishLocked(Clock::time_point now);
+
+        std::unique_ptr<HistoryJournal> m_journal;
+        std::mutex m_mutex;
+        std::optional<Play> m_current;
+    };
+
+}
@@ -0,0 +1,208 @@
+#pragma once
+#include "AsyncResult.h"
+#include "VolumeController.h"
+#include "ThumbnailCache.h"
+#include "StringPool.h"
+#include "Utf16.h"
+#include <chrono>
+#include <expected>
+#include <span>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <functional>
+
+namespace audio {
+
+    // Mirrors GlobalSystemMediaTransportControlsSessionPlaybackStatus so values can cross the C ABI unchanged.
+    enum class PlaybackStatus : int32_t {
+        Closed = 0,
+        Opened = 1,
+        Changing = 2,
+        Stopped = 3,
+        Playing = 4,
+        Paused = 5
+    };
+
+    // Mirrors Windows.Media.MediaPlaybackAutoRepeatMode.
+    enum class RepeatMode : int32_t {
+        None = 0,
+        Track = 1,
+        List = 2
+    };
+
+    // Bits of PlaybackState::controls, one per transport action the player currently accepts.
+    enum class PlaybackControl : uint32_t {
+        Play = 1u << 0,
+        Pause = 1u << 1,
+        Stop = 1u << 2,
+        Next = 1u << 3,
+        Previous = 1u << 4,
+        PlayPauseToggle = 1u << 5,
+        Shuffle = 1u << 6,
+        Repeat = 1u << 7,
+        PlaybackRate = 1u << 8,
+        PlaybackPosition = 1u << 9,
+        FastForward = 1u << 10,
+        Rewind = 1u << 11
+    };
+
+    struct PlaybackState {
+        PlaybackStatus status{ PlaybackStatus::Closed };
+        double rate{ 1.0 };
+        bool shuffle{ false };
+        RepeatMode repeat{ RepeatMode::None };
+        uint32_t controls{ 0 };
+
+        [[nodiscard]] bool allows(PlaybackControl control) const noexcept {
+            return (controls & static_cast<uint32_t>(control)) != 0;
+        }
+        bool operator==(const PlaybackState&) const = default;
+    };
+
+    // A playback change as seen by the session: the state before and after, and which fields differ.
+    // Only raised when at least one field does.
+    struct PlaybackEvent {
+        enum class Field : uint32_t {
+            Status = 1u << 0,
+            Rate = 1u << 1,
+            Shuffle = 1u << 2,
+            Repeat = 1u << 3,
+            Controls = 1u << 4
+        };
+
+        PlaybackState previous;
+        PlaybackState current;
+        uint32_t changed{ 0 };
+
+        [[nodiscard]] bool has(Field field) const noexcept {
+            return (changed & static_cast<uint32_t>(field)) != 0;
+        }
+    };
+
+    // Everything the overlay needs for one refresh, gathered from a single properties fetch
+    // and a single timeline fetch. thumbnailHandle is 0 when the track has no artwork and
+    // otherwise changes whenever the artwork reference changes.
+    struct TrackSnapshot {
+        std::string title;
+        std::string artist;
+        std::string album;
+        std::string albumArtist;
+        int32_t trackNumber{ 0 };
+        std::chrono::seconds duration{ 0 };
+        std::chrono::seconds position{ 0 };
+        PlaybackStatus status{ PlaybackStatus::Closed };
+        uint64_t thumbnailHandle{ 0 };
+    };
+
+    // The text fields IAudioTrackInfo::getText can read.
+    enum class MediaText : uint32_t {
+        Title = 0,
+        Artist = 1,
+        Album = 2
+    };
+
+    class IAudioTrackInfo {
+    public:
+        virtual ~IAudioTrackInfo() = default;
+
+        virtual std::expected<std::chrono::seconds, AudioError> getDuration() noexcept = 0;
+        virtual std::expected<std::chrono::seconds, AudioError> getCurrentPosition() noexcept = 0;
+        virtual std::expected<std::chrono::milliseconds, AudioError> getCurrentPositionPrecise() noexcept = 0;
+        virtual std::expected<std::string, AudioError> getTitle() const noexcept = 0;
+        virtual std::expected<std::string, AudioError> getArtist() const noexcept = 0;
+        virtual std::expected<std::string, AudioError> getAlbum() const noexcept = 0;
+        // The span stays valid until the artwork changes; getThumbnail hands out a buffer the caller co-owns.
+        virtual std::expected<std::span<const uint8_t>, AudioError> getThumbnailBytes() noexcept = 0;
+        virtual std::expected<ThumbnailCache::Buffer, AudioError> getThumbnail() noexcept = 0;
+        virtual std::expected<TrackSnapshot, AudioError> getTrackSnapshot() noexcept = 0;
+
+        // The field interned into pool, for as long as StringPool guarantees. Sessions that keep
+        // their metadata cached intern straight from the cache; this default copies through the
+        // std::string getters first.
+        virtual std::expected<std::string_view, AudioError> getText(MediaText field, StringPool& pool) const noexcept {
+            auto text = field == MediaText::Title ? getTitle() : field == MediaText::Artist ? getArtist() : getAlbum();
+            if (!text)
+                return std::unexpected(text.error());
+            return pool.intern(*text);
+        }
+        // The field as UTF-16, for callers that keep their text that way (Java, Win32). Sessions
+        // whose platform reports UTF-16 hand it over as received; this default converts.
+        virtual std::expected<std::u16string, AudioError> getTextUtf16(MediaText field) const noexcept {
+            auto text = field == MediaText::Title ? getTitle() : field == MediaText::Artist ? getArtist() : getAlbum();
+            if (!text)
+                return std::unexpected(text.error());
+            return Utf16::toUtf16(*text);
+        }
+    };
+
+    class IAudioPlaybackControl {
+    public:
+        virtual ~IAudioPlaybackControl() = default;
+
+        virtual std::expected<void, AudioError> play() noexcept = 0;
+        virtual std::expected<void, AudioError> pause() noexcept = 0;
+        virtual std::expected<void, AudioError> next() noexcept = 0;
+        virtual std::expected<void, AudioError> previous() noexcept = 0;
+        virtual std::expected<void, AudioError> seek(std::chrono::seconds position) noexcept = 0;
+        virtual std::expected<void, AudioError> setVolume(double volume) noexcept = 0;
+        virtual std::expected<double, AudioError> getVolume() noexcept = 0;
+    };
+
+    // Non-blocking counterparts of the transport and query calls. Each returns as soon as the
+    // request has been issued; the result completes on the backend's completion thread.
+    class IAudioAsyncControl {
+    public:
+        virtual ~IAudioAsyncControl() = default;
+
+        virtual AsyncResult<void> playAsync() noexcept = 0;
+        virtual AsyncResult<void> pauseAsync() noexcept = 0;
+        virtual AsyncResult<void> nextAsync() noexcept = 0;
+        virtual AsyncResult<void> previousAsync() noexcept = 0;
+        virtual AsyncResult<void> seekAsync(std::chrono::seconds position) noexcept = 0;
+        virtual AsyncResult<void> setVolumeAsync(double volume) noexcept = 0;
+        virtual AsyncResult<double> getVolumeAsync() noexcept = 0;
+        virtual AsyncResult<TrackSnapshot> getTrackSnapshotAsync() noexcept = 0;
+    };
+
+    // How a session's MediaPropertiesChanged notifications turned into track-changed callbacks.
+    struct TrackChangeStats {
+        uint64_t received{ 0 };
+        uint64_t fetches{ 0 };
+        uint64_t delivered{ 0 };
+        // Fetches whose metadata matched what was last delivered.
+        uint64_t unchanged{ 0 };
+        uint64_t failures{ 0 };
+    };
+
+    class IAudioEventNotifier {
+    public:
+        // Fires with a fixed message, and only when a PlaybackEvent is raised; kept for callers that
+        // only need to know that something changed.
+        using PlaybackChangedCallback = std::function<void(std::string_view)>;
+        using PlaybackEventCallback = std::function<void(const PlaybackEvent&)>;
+        using TrackChangedCallback = std::function<void(std::string_view, std::string_view)>;
+        using VolumeChangedCallback = VolumeController::VolumeChangedCallback;
+
+        virtual ~IAudioEventNotifier() = default;
+
+        virtual void setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept = 0;
+        virtual void setPlaybackEventCallback(PlaybackEventCallback callback) noexcept = 0;
+        // Fires from a worker thread, at most once per burst of property changes and only when the
+        // title, artist, album, album artist, track number or artwork differ from the last call.
+        virtual void setTrackChangedCallback(TrackChangedCallback callback) noexcept = 0;
+        [[nodiscard]] virtual TrackChangeStats getTrackChangeStats() const noexcept = 0;
+        // Returns 0 if the subscription could not be registered.
+        virtual VolumeController::SubscriptionId subscribeVolumeChanged(VolumeChangedCallback callback) noexcept = 0;
+        virtual void unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept = 0;
+    };
+
+    class IAudioSession : public IAudioTrackInfo, public IAudioPlaybackControl, public IAudioAsyncControl, public IAudioEventNotifier {
+    public:
+        ~IAudioSession() override = default;
+
+        virtual std::expected<void, AudioError> initialize() noexcept = 0;
+        virtual AsyncResult<void> initializeAsync() noexcept = 0;
+    };
+
+}
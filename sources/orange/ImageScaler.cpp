@@ -0,0 +1,131 @@
+#include "ImageScaler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_SCALER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace audio {
+
+    namespace {
+
+        // For every destination index, the run of source indices it covers and the share of each.
+        struct Contributions {
+            std::vector<uint32_t> first;
+            std::vector<uint32_t> count;
+            std::vector<uint32_t> offset;
+            std::vector<float> weights;
+        };
+
+        Contributions contributions(uint32_t sourceSize, uint32_t targetSize) {
+            Contributions result;
+            result.first.resize(targetSize);
+            result.count.resize(targetSize);
+            result.offset.resize(targetSize);
+
+            const double scale = static_cast<double>(sourceSize) / targetSize;
+            for (uint32_t i = 0; i < targetSize; ++i) {
+                const double begin = i * scale;
+                const double end = std::min<double>((i + 1) * scale, sourceSize);
+                const auto first = static_cast<uint32_t>(begin);
+                const auto last = std::min<uint32_t>(static_cast<uint32_t>(std::ceil(end)), sourceSize);
+
+                result.first[i] = first;
+                result.count[i] = last - first;
+                result.offset[i] = static_cast<uint32_t>(result.weights.size());
+                for (uint32_t j = first; j < last; ++j) {
+                    const double overlap = std::min<double>(end, j + 1.0) - std::max<double>(begin, j);
+                    result.weights.push_back(static_cast<float>(overlap / scale));
+                }
+            }
+            return result;
+        }
+
+        // One pixel's four channels are one vector throughout, so both passes are plain
+        // multiply-adds of 4-float lanes.
+        void horizontalPass(const RgbaImage& source, uint32_t targetWidth, const Contributions& columns, std::vector<float>& out) {
+            out.assign(static_cast<size_t>(targetWidth) * source.height * 4, 0.0f);
+            for (uint32_t y = 0; y < source.height; ++y) {
+                const uint8_t* row = source.pixels.data() + static_cast<size_t>(y) * source.width * 4;
+                float* target = out.data() + static_cast<size_t>(y) * targetWidth * 4;
+                for (uint32_t x = 0; x < targetWidth; ++x) {
+                    const uint8_t* pixel = row + static_cast<size_t>(columns.first[x]) * 4;
+                    const float* weight = columns.weights.data() + columns.offset[x];
+#ifdef AUDIO_SCALER_SSE2
+                    const __m128i zero = _mm_setzero_si128();
+                    __m128 sum = _mm_setzero_ps();
+                    for (uint32_t k = 0; k < columns.count[x]; ++k, pixel += 4) {
+                        int32_t packed;
+                        std::memcpy(&packed, pixel, sizeof(packed));
+                        __m128i wide = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+                        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(wide), _mm_set1_ps(weight[k])));
+                    }
+                    _mm_storeu_ps(target + static_cast<size_t>(x) * 4, sum);
+#else
+                    float* sum = target + static_cast<size_t>(x) * 4;
+                    for (uint32_t k = 0; k < columns.count[x]; ++k, pixel += 4) {
+                        for (int channel = 0; channel < 4; ++channel)
+                            sum[channel] += pixel[channel] * weight[k];
+                    }
+#endif
+                }
+            }
+        }
+
+        void verticalPass(const std::vector<float>& source, uint32_t width, uint32_t targetHeight, const Contributions& rows, RgbaImage& out) {
+            const size_t rowFloats = static_cast<size_t>(width) * 4;
+            std::vector<float> sum(rowFloats);
+            for (uint32_t y = 0; y < targetHeight; ++y) {
+                std::fill(sum.begin(), sum.end(), 0.0f);
+                const float* weight = rows.weights.data() + rows.offset[y];
+                for (uint32_t k = 0; k < rows.count[y]; ++k) {
+                    const float* row = source.data() + (rows.first[y] + k) * rowFloats;
+                    size_t i = 0;
+#ifdef AUDIO_SCALER_SSE2
+                    const __m128 w = _mm_set1_ps(weight[k]);
+                    for (; i < rowFloats; i += 4)
+                        _mm_storeu_ps(sum.data() + i, _mm_add_ps(_mm_loadu_ps(sum.data() + i), _mm_mul_ps(_mm_loadu_ps(row + i), w)));
+#endif
+                    for (; i < rowFloats; ++i)
+                        sum[i] += row[i] * weight[k];
+                }
+
+                uint8_t* target = out.pixels.data() + static_cast<size_t>(y) * rowFloats;
+                size_t i = 0;
+#ifdef AUDIO_SCALER_SSE2
+                const __m128 half = _mm_set1_ps(0.5f);
+                for (; i < rowFloats; i += 4) {
+                    __m128i rounded = _mm_cvttps_epi32(_mm_add_ps(_mm_loadu_ps(sum.data() + i), half));
+                    __m128i narrow = _mm_packs_epi32(rounded, rounded);
+                    int32_t packed = _mm_cvtsi128_si32(_mm_packus_epi16(narrow, narrow));
+                    std::memcpy(target + i, &packed, sizeof(packed));
+                }
+#endif
+                for (; i < rowFloats; ++i)
+                    target[i] = static_cast<uint8_t>(std::clamp(sum[i] + 0.5f, 0.0f, 255.0f));
+            }
+        }
+
+    }
+
+    RgbaImage ImageScaler::fit(const RgbaImage& source, uint32_t maxEdge) {
+        const uint32_t longest = std::max(source.width, source.height);
+        if (maxEdge == 0 || longest <= maxEdge)
+            return source;
+
+        const double scale = static_cast<double>(maxEdge) / longest;
+        RgbaImage result;
+        result.width = std::max<uint32_t>(1, static_cast<uint32_t>(std::lround(source.width * scale)));
+        result.height = std::max<uint32_t>(1, static_cast<uint32_t>(std::lround(source.height * scale)));
+        result.pixels.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+        std::vector<float> intermediate;
+        horizontalPass(source, result.width, contributions(source.width, result.width), intermediate);
+        verticalPass(intermediate, result.width, result.height, contributions(source.height, result.height), result);
+        return result;
+    }
+
+}
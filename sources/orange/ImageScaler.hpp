@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace audio {
+
+    // Tightly packed 8-bit RGBA with premultiplied alpha; row stride is width * 4.
+    struct RgbaImage {
+        uint32_t width{ 0 };
+        uint32_t height{ 0 };
+        std::vector<uint8_t> pixels;
+    };
+
+    class ImageScaler {
+    public:
+        // Area-averaging (box) downscale so the longer edge is at most maxEdge, keeping the aspect
+        // ratio. Images that already fit are returned unchanged; nothing is ever upscaled.
+        // Premultiplied input is what makes plain averaging correct at transparent edges.
+        [[nodiscard]] static RgbaImage fit(const RgbaImage& source, uint32_t maxEdge);
+    };
+
+}
@@ -0,0 +1,629 @@
+#include "MprisAudioSession.h"
+#include "PlaybackClock.h"
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace audio {
+    namespace platform {
+
+        namespace {
+
+            constexpr std::string_view NoTrack = "/org/mpris/MediaPlayer2/TrackList/NoTrack";
+
+            PlaybackStatus toStatus(const std::optional<std::string>& status) noexcept {
+                if (status == "Playing")
+                    return PlaybackStatus::Playing;
+                if (status == "Paused")
+                    return PlaybackStatus::Paused;
+                if (status == "Stopped")
+                    return PlaybackStatus::Stopped;
+                return PlaybackStatus::Opened;
+            }
+
+            RepeatMode toRepeat(const std::optional<std::string>& loop) noexcept {
+                if (loop == "Track")
+                    return RepeatMode::Track;
+                if (loop == "Playlist")
+                    return RepeatMode::List;
+                return RepeatMode::None;
+            }
+
+            // CanControl false means the player takes no commands at all, whatever the other flags say.
+            uint32_t controlBits(const MprisPlayerProperties& properties) noexcept {
+                if (!properties.canControl.value_or(true))
+                    return 0;
+                uint32_t bits = static_cast<uint32_t>(PlaybackControl::Stop)
+                    | static_cast<uint32_t>(PlaybackControl::Shuffle)
+                    | static_cast<uint32_t>(PlaybackControl::Repeat)
+                    | static_cast<uint32_t>(PlaybackControl::PlaybackRate);
+                auto allow = [&bits](const std::optional<bool>& flag, PlaybackControl control) {
+                    if (flag.value_or(false))
+                        bits |= static_cast<uint32_t>(control);
+                };
+                allow(properties.canPlay, PlaybackControl::Play);
+                allow(properties.canPause, PlaybackControl::Pause);
+                allow(properties.canGoNext, PlaybackControl::Next);
+                allow(properties.canGoPrevious, PlaybackControl::Previous);
+                allow(properties.canSeek, PlaybackControl::PlaybackPosition);
+                if (properties.canPlay.value_or(false) && properties.canPause.value_or(false))
+                    bits |= static_cast<uint32_t>(PlaybackControl::PlayPauseToggle);
+                return bits;
+            }
+
+            PlaybackState toPlayback(const MprisPlayerProperties& properties) noexcept {
+                PlaybackState playback;
+                playback.status = toStatus(properties.playbackStatus);
+                playback.rate = properties.rate.value_or(1.0);
+                playback.shuffle = properties.shuffle.value_or(false);
+                playback.repeat = toRepeat(properties.loopStatus);
+                playback.controls = controlBits(properties);
+                return playback;
+            }
+
+            MediaInfo toMedia(const MprisPlayerProperties& properties, uint64_t thumbnailHandle) {
+                MediaInfo media;
+                if (properties.metadata) {
+                    media.title = properties.metadata->title;
+                    media.artist = properties.metadata->artist;
+                    media.album = properties.metadata->album;
+                    media.albumArtist = properties.metadata->albumArtist;
+                    media.trackNumber = properties.metadata->trackNumber;
+                }
+                media.thumbnailHandle = thumbnailHandle;
+                return media;
+            }
+
+            bool touchesPlayback(const MprisPlayerProperties& changed) noexcept {
+                return changed.playbackStatus || changed.loopStatus || changed.rate || changed.shuffle
+                    || changed.canGoNext || changed.canGoPrevious || changed.canPlay || changed.canPause
+                    || changed.canSeek || changed.canControl;
+            }
+
+            template <typename T>
+            void mergeField(std::optional<T>& into, const std::optional<T>& from) {
+                if (from)
+                    into = from;
+            }
+
+            void merge(MprisPlayerProperties& into, const MprisPlayerProperties& from) {
+                mergeField(into.playbackStatus, from.playbackStatus);
+                mergeField(into.loopStatus, from.loopStatus);
+                mergeField(into.rate, from.rate);
+                mergeField(into.shuffle, from.shuffle);
+                mergeField(into.metadata, from.metadata);
+                mergeField(into.volume, from.volume);
+                mergeField(into.position, from.position);
+                mergeField(into.canGoNext, from.canGoNext);
+                mergeField(into.canGoPrevious, from.canGoPrevious);
+                mergeField(into.canPlay, from.canPlay);
+                mergeField(into.canPause, from.canPause);
+                mergeField(into.canSeek, from.canSeek);
+                mergeField(into.canControl, from.canControl);
+            }
+
+            // file:///home/me/Cover%20Art.jpg -> /home/me/Cover Art.jpg; empty for any other scheme.
+            std::string filePath(std::string_view url) {
+                constexpr std::string_view scheme = "file://";
+                if (!url.starts_with(scheme))
+                    return {};
+                url.remove_prefix(scheme.size());
+                auto hex = [](char c) -> int {
+                    if (c >= '0' && c <= '9')
+                        return c - '0';
+                    if (c >= 'a' && c <= 'f')
+                        return c - 'a' + 10;
+                    if (c >= 'A' && c <= 'F')
+                        return c - 'A' + 10;
+                    return -1;
+                };
+                std::string path;
+                path.reserve(url.size());
+                for (size_t i = 0; i < url.size(); ++i) {
+                    if (url[i] == '%' && i + 2 < url.size() && hex(url[i + 1]) >= 0 && hex(url[i + 2]) >= 0) {
+                        path.push_back(static_cast<char>(hex(url[i + 1]) * 16 + hex(url[i + 2])));
+                        i += 2;
+                    }
+                    else {
+                        path.push_back(url[i]);
+                    }
+                }
+                return path;
+            }
+
+        }
+
+        MprisAudioSession::MprisAudioSession(std::shared_ptr<MprisConnection> connection, std::string busName, std::shared_ptr<ThumbnailCache> thumbnails)
+            : MprisAudioSession(connection, busName, std::make_unique<MprisVolumeEndpoint>(connection, busName), std::move(thumbnails)) {
+        }
+
+        MprisAudioSession::MprisAudioSession(std::shared_ptr<MprisConnection> connection, std::string busName,
+            std::unique_ptr<MprisVolumeEndpoint> volumeEndpoint, std::shared_ptr<ThumbnailCache> thumbnails)
+            : m_connection(std::move(connection)),
+            m_busName(std::move(busName)),
+            m_thumbnails(std::move(thumbnails)),
+            m_volumeEndpoint(volumeEndpoint.get()),
+            m_volume(std::move(volumeEndpoint)),
+            m_trackWatcher([this] { return fetchMediaForWatcher(); }, [this](const MediaInfo& media) { deliverTrackChanged(media); }) {
+        }
+
+        // Unsubscribing waits for a signal being handled, so nothing below is reached afterwards.
+        MprisAudioSession::~MprisAudioSession() noexcept {
+            if (m_subscription)
+                m_connection->unsubscribe(m_subscription);
+            m_trackWatcher.stop();
+        }
+
+        // Subscribes before the GetAll, so a change made while the reply is in flight is not lost.
+        // Signals are held back until the reply has been applied; those the player sent before it
+        // carry a lower serial and are dropped, the rest are replayed in the order they arrived.
+        std::expected<void, AudioError> MprisAudioSession::initialize() noexcept {
+            try {
+                {
+                    std::scoped_lock lock(m_applyMutex);
+                    m_priming = true;
+                    m_primed = false;
+                    m_early.clear();
+                }
+                if (!m_subscription)
+                    m_subscription = m_connection->subscribe([this](const MprisSignal& signal) { onSignal(signal); });
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Initialize session", ex));
+            }
+            auto properties = m_connection->getAll(m_busName);
+            std::scoped_lock lock(m_applyMutex);
+            m_priming = false;
+            if (!properties) {
+                m_early.clear();
+                return std::unexpected(properties.error());
+            }
+
+            try {
+                {
+                    std::scoped_lock mirrorLock(m_mirror.mutex);
+                    m_mirror.properties = {};
+                }
+                m_baseline = properties->serial;
+                m_cache.clear();
+                apply(*properties, false);
+                auto state = m_cache.load();
+                m_playbackDiff.reset(state->playback.value_or(PlaybackState{}));
+                m_trackWatcher.reset(state->media);
+                m_initialized.store(true, std::memory_order_release);
+                m_primed = true;
+                auto early = std::move(m_early);
+                m_early.clear();
+                for (auto& item : early) {
+                    if (item.properties)
+                        item.signal.properties = &*item.properties;
+                    handleSignal(item.signal);
+                }
+            }
+            catch (const std::exception& ex) {
+                m_early.clear();
+                return std::unexpected(AudioError::fromException("Initialize session", ex));
+            }
+            return {};
+        }
+
+        void MprisAudioSession::onSignal(const MprisSignal& signal) {
+            if (signal.busName != m_busName)
+                return;
+            std::scoped_lock lock(m_applyMutex);
+            if (m_primed) {
+                handleSignal(signal);
+                return;
+            }
+            // Before initialize() there is nothing to apply it to; its GetAll will see the change.
+            if (!m_priming)
+                return;
+            EarlySignal early{ signal, std::nullopt };
+            // The view points into the connection's buffer; the bus name is known anyway.
+            early.signal.busName = m_busName;
+            if (signal.properties)
+                early.properties = *signal.properties;
+            early.signal.properties = nullptr;
+            m_early.push_back(std::move(early));
+        }
+
+        // Called with m_applyMutex held. Player-name changes come from the bus, not the player,
+        // and carry no serial.
+        void MprisAudioSession::handleSignal(const MprisSignal& signal) {
+            if (signal.serial != 0 && signal.serial <= m_baseline)
+                return;
+            switch (signal.kind) {
+            case MprisSignal::Kind::PropertiesChanged:
+                if (!signal.properties)
+                    return;
+                if (!signal.properties->invalidated) {
+                    apply(*signal.properties, true);
+                }
+                else if (auto properties = m_connection->getAll(m_busName)) {
+                    apply(*properties, true);
+                }
+                break;
+            case MprisSignal::Kind::Seeked:
+                applySeek(signal.position);
+                break;
+            case MprisSignal::Kind::PlayerVanished:
+                close();
+                break;
+            case MprisSignal::Kind::PlayerAppeared:
+                break;
+            }
+        }
+
+        // Folds changed into the mirror and publishes the parts of the session state it touches.
+        // The timeline goes out before the playback state, so a reader never extrapolates the old
+        // position with the new status.
+        void MprisAudioSession::apply(const MprisPlayerProperties& changed, bool announce) {
+            const auto previous = m_cache.load();
+            MprisPlayerProperties mirror;
+            uint64_t thumbnailHandle = 0;
+            bool newTrack = false;
+            {
+                std::scoped_lock lock(m_mirror.mutex);
+                if (changed.metadata) {
+                    const auto& before = m_mirror.properties.metadata;
+                    newTrack = !before || before->trackId != changed.metadata->trackId;
+                    if (!m_mirror.artUrl || *m_mirror.artUrl != changed.metadata->artUrl) {
+                        m_mirror.artUrl = changed.metadata->artUrl.empty() ? nullptr
+                            : std::make_shared<const std::string>(changed.metadata->artUrl);
+                        m_mirror.thumbnail.reset();
+                        if (m_mirror.artUrl)
+                            ++m_mirror.thumbnailHandle;
+                    }
+                }
+                merge(m_mirror.properties, changed);
+                // Position is only ever meaningful at the instant it was reported.
+                m_mirror.properties.position.reset();
+                mirror = m_mirror.properties;
+                thumbnailHandle = m_mirror.artUrl ? m_mirror.thumbnailHandle : 0;
+            }
+
+            const bool playbackChanged = touchesPlayback(changed);
+            if (changed.metadata || !previous->media)
+                m_cache.publishMedia(toMedia(mirror, thumbnailHandle));
+            if (changed.metadata || changed.position || playbackChanged || !previous->timeline) {
+                TimelineState timeline = previous->timeline.value_or(TimelineState{});
+                if (changed.position)
+                    timeline.position = std::chrono::duration_cast<std::chrono::milliseconds>(*changed.position);
+                else if (newTrack)
+                    timeline.position = std::chrono::milliseconds(0);
+                else if (previous->timeline)
+                    timeline.position = PlaybackClock::position(*previous->timeline, previous->playback);
+                timeline.start = std::chrono::milliseconds(0);
+                timeline.end = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    mirror.metadata ? mirror.metadata->length : std::chrono::microseconds(0));
+                timeline.lastUpdated = std::chrono::system_clock::now();
+                m_cache.publishTimeline(timeline);
+            }
+            const PlaybackState playback = toPlayback(mirror);
+            if (playbackChanged || !previous->playback)
+                m_cache.publishPlayback(playback);
+
+            if (changed.volume)
+                m_volumeEndpoint->report(*changed.volume);
+            if (!announce)
+                return;
+            if (playbackChanged)
+                raisePlaybackEvent(playback);
+            if (changed.metadata)
+                m_trackWatcher.notify();
+        }
+
+        void MprisAudioSession::applySeek(std::chrono::microseconds position) {
+            auto state = m_cache.load();
+            TimelineState timeline = state->timeline.value_or(TimelineState{});
+            timeline.position = std::chrono::duration_cast<std::chrono::milliseconds>(position);
+            timeline.lastUpdated = std::chrono::system_clock::now();
+            m_cache.publishTimeline(timeline);
+        }
+
+        // The player left the bus. The registry drops the session on the same notification; until
+        // then calls fail with NoSession and listeners see the status go to Closed.
+        void MprisAudioSession::close() {
+            if (!m_initialized.exchange(false, std::memory_order_acq_rel))
+                return;
+            auto playback = m_cache.load()->playback.value_or(PlaybackState{});
+            playback.status = PlaybackStatus::Closed;
+            playback.controls = 0;
+            m_cache.publishPlayback(playback);
+            raisePlaybackEvent(playback);
+        }
+
+        void MprisAudioSession::raisePlaybackEvent(const PlaybackState& playback) {
+            auto event = m_playbackDiff.update(playback);
+            if (!event)
+                return;
+            PlaybackChangedCallback changed;
+            PlaybackEventCallback typed;
+            {
+                std::scoped_lock lock(m_callbackMutex);
+                changed = m_playbackChanged;
+                typed = m_playbackEvent;
+            }
+            if (typed)
+                typed(*event);
+            if (changed)
+                changed("Playback info updated");
+        }
+
+        // The mirror already holds the metadata the signal carried, so this costs no bus call.
+        std::expected<MediaInfo, AudioError> MprisAudioSession::fetchMediaForWatcher() const {
+            std::scoped_lock lock(m_mirror.mutex);
+            if (!m_mirror.properties.metadata)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "Fetch media properties"));
+            return toMedia(m_mirror.properties, m_mirror.artUrl ? m_mirror.thumbnailHandle : 0);
+        }
+
+        void MprisAudioSession::deliverTrackChanged(const MediaInfo& media) {
+            TrackChangedCallback callback;
+            {
+                std::scoped_lock lock(m_callbackMutex);
+                callback = m_trackChanged;
+            }
+            if (callback)
+                callback(media.title, media.artist);
+        }
+
+        std::expected<std::shared_ptr<const SessionState>, AudioError> MprisAudioSession::currentState(const char* operation) const noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, operation));
+            auto state = m_cache.load();
+            if (!state->media || !state->playback || !state->timeline) {
+                m_cache.recordMiss();
+                return std::unexpected(AudioError(ErrorCategory::Interrupted, operation));
+            }
+            m_cache.recordHit();
+            return state;
+        }
+
+        std::expected<std::chrono::seconds, AudioError> MprisAudioSession::getDuration() noexcept {
+            auto state = currentState("Get duration");
+            if (!state)
+                return std::unexpected(state.error());
+            const auto& timeline = *(*state)->timeline;
+            return std::chrono::duration_cast<std::chrono::seconds>(timeline.end - timeline.start);
+        }
+
+        std::expected<std::chrono::seconds, AudioError> MprisAudioSession::getCurrentPosition() noexcept {
+            auto position = getCurrentPositionPrecise();
+            if (!position)
+                return std::unexpected(position.error());
+            return std::chrono::duration_cast<std::chrono::seconds>(*position);
+        }
+
+        std::expected<std::chrono::milliseconds, AudioError> MprisAudioSession::getCurrentPositionPrecise() noexcept {
+            auto state = currentState("Get position");
+            if (!state)
+                return std::unexpected(state.error());
+            return PlaybackClock::position(*(*state)->timeline, (*state)->playback);
+        }
+
+        std::expected<std::string, AudioError> MprisAudioSession::getTitle() const noexcept {
+            auto state = currentState("Get media properties");
+            if (!state)
+                return std::unexpected(state.error());
+            return (*state)->media->title;
+        }
+
+        std::expected<std::string, AudioError> MprisAudioSession::getArtist() const noexcept {
+            auto state = currentState("Get media properties");
+            if (!state)
+                return std::unexpected(state.error());
+            return (*state)->media->artist;
+        }
+
+        std::expected<std::string, AudioError> MprisAudioSession::getAlbum() const noexcept {
+            auto state = currentState("Get media properties");
+            if (!state)
+                return std::unexpected(state.error());
+            return (*state)->media->album;
+        }
+
+        std::expected<std::string_view, AudioError> MprisAudioSession::getText(MediaText field, StringPool& pool) const noexcept {
+            auto state = currentState("Get media properties");
+            if (!state)
+                return std::unexpected(state.error());
+            return pool.intern((*state)->media->text(field));
+        }
+
+        std::expected<std::span<const uint8_t>, AudioError> MprisAudioSession::getThumbnailBytes() noexcept {
+            auto thumbnail = getThumbnail();
+            if (!thumbnail)
+                return std::unexpected(thumbnail.error());
+            return std::span<const uint8_t>((*thumbnail)->data(), (*thumbnail)->size());
+        }
+
+        // Only artwork the player left on disk (file:// URLs) is read; other schemes report
+        // Unsupported rather than have the backend fetch from the network.
+        std::expected<ThumbnailCache::Buffer, AudioError> MprisAudioSession::getThumbnail() noexcept {
+            if (auto state = currentState("Get thumbnail"); !state)
+                return std::unexpected(state.error());
+            std::shared_ptr<const std::string> reference;
+            {
+                std::scoped_lock lock(m_mirror.mutex);
+                if (m_mirror.thumbnail)
+                    return m_mirror.thumbnail;
+                reference = m_mirror.artUrl;
+            }
+            if (!reference)
+                return std::unexpected(AudioError(ErrorCategory::NotFound, "Get thumbnail"));
+            try {
+                auto buffer = m_thumbnails->find(reference.get());
+                if (!buffer) {
+                    const auto path = filePath(*reference);
+                    if (path.empty())
+                        return std::unexpected(AudioError(ErrorCategory::Unsupported, "Get thumbnail"));
+                    std::ifstream file(path, std::ios::binary);
+                    if (!file)
+                        return std::unexpected(AudioError(ErrorCategory::NotFound, "Get thumbnail"));
+                    std::vector<uint8_t> bytes{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+                    if (bytes.empty())
+                        return std::unexpected(AudioError(ErrorCategory::NotFound, "Get thumbnail"));
+                    buffer = m_thumbnails->insert(reference.get(), reference, std::move(bytes));
+                }
+                std::scoped_lock lock(m_mirror.mutex);
+                if (m_mirror.artUrl == reference)
+                    m_mirror.thumbnail = buffer;
+                return buffer;
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Get thumbnail", ex));
+            }
+        }
+
+        std::expected<TrackSnapshot, AudioError> MprisAudioSession::getTrackSnapshot() noexcept {
+            auto state = currentState("Get track snapshot");
+            if (!state)
+                return std::unexpected(state.error());
+
+            const SessionState& current = **state;
+            TrackSnapshot snapshot;
+            snapshot.title = current.media->title;
+            snapshot.artist = current.media->artist;
+            snapshot.album = current.media->album;
+            snapshot.albumArtist = current.media->albumArtist;
+            snapshot.trackNumber = current.media->trackNumber;
+            snapshot.duration = std::chrono::duration_cast<std::chrono::seconds>(current.timeline->end - current.timeline->start);
+            snapshot.position = std::chrono::duration_cast<std::chrono::seconds>(PlaybackClock::position(*current.timeline, current.playback));
+            snapshot.status = current.playback->status;
+            snapshot.thumbnailHandle = current.media->thumbnailHandle;
+            return snapshot;
+        }
+
+        std::expected<void, AudioError> MprisAudioSession::play() noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Play"));
+            return m_connection->callPlayer(m_busName, "Play", "Play");
+        }
+
+        std::expected<void, AudioError> MprisAudioSession::pause() noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Pause"));
+            return m_connection->callPlayer(m_busName, "Pause", "Pause");
+        }
+
+        std::expected<void, AudioError> MprisAudioSession::next() noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Next track"));
+            return m_connection->callPlayer(m_busName, "Next", "Next track");
+        }
+
+        std::expected<void, AudioError> MprisAudioSession::previous() noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Previous track"));
+            return m_connection->callPlayer(m_busName, "Previous", "Previous track");
+        }
+
+        // SetPosition needs the current track id; players without one only take a relative Seek.
+        std::expected<void, AudioError> MprisAudioSession::seek(std::chrono::seconds position) noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Seek"));
+            if (position.count() < 0)
+                return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Seek"));
+            std::string trackId;
+            try {
+                std::scoped_lock lock(m_mirror.mutex);
+                if (m_mirror.properties.metadata)
+                    trackId = m_mirror.properties.metadata->trackId;
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Seek", ex));
+            }
+            const auto target = std::chrono::duration_cast<std::chrono::microseconds>(position);
+            if (!trackId.empty() && trackId != NoTrack)
+                return m_connection->setPosition(m_busName, trackId, target);
+            auto current = getCurrentPositionPrecise();
+            if (!current)
+                return std::unexpected(current.error());
+            return m_connection->seekBy(m_busName, target - std::chrono::duration_cast<std::chrono::microseconds>(*current));
+        }
+
+        std::expected<void, AudioError> MprisAudioSession::setVolume(double volume) noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Set volume"));
+            return m_volume.setVolume(volume);
+        }
+
+        std::expected<double, AudioError> MprisAudioSession::getVolume() noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Get volume"));
+            return m_volume.getVolume();
+        }
+
+        // A method call is one round trip to a local bus daemon, so the async forms complete it on
+        // the calling thread, as the scripted backend does; the manager's command queues already
+        // keep it off the caller's own thread.
+        AsyncResult<void> MprisAudioSession::initializeAsync() noexcept {
+            co_return initialize();
+        }
+
+        AsyncResult<void> MprisAudioSession::playAsync() noexcept {
+            co_return play();
+        }
+
+        AsyncResult<void> MprisAudioSession::pauseAsync() noexcept {
+            co_return pause();
+        }
+
+        AsyncResult<void> MprisAudioSession::nextAsync() noexcept {
+            co_return next();
+        }
+
+        AsyncResult<void> MprisAudioSession::previousAsync() noexcept {
+            co_return previous();
+        }
+
+        AsyncResult<void> MprisAudioSession::seekAsync(std::chrono::seconds position) noexcept {
+            co_return seek(position);
+        }
+
+        AsyncResult<void> MprisAudioSession::setVolumeAsync(double volume) noexcept {
+            co_return setVolume(volume);
+        }
+
+        AsyncResult<double> MprisAudioSession::getVolumeAsync() noexcept {
+            co_return getVolume();
+        }
+
+        AsyncResult<TrackSnapshot> MprisAudioSession::getTrackSnapshotAsync() noexcept {
+            co_return getTrackSnapshot();
+        }
+
+        VolumeController::SubscriptionId MprisAudioSession::subscribeVolumeChanged(VolumeChangedCallback callback) noexcept {
+            try {
+                return m_volume.subscribe(std::move(callback));
+            }
+            catch (...) {
+                return 0;
+            }
+        }
+
+        void MprisAudioSession::unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept {
+            m_volume.unsubscribe(id);
+        }
+
+        void MprisAudioSession::setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept {
+            std::scoped_lock lock(m_callbackMutex);
+            m_playbackChanged = std::move(callback);
+        }
+
+        void MprisAudioSession::setPlaybackEventCallback(PlaybackEventCallback callback) noexcept {
+            std::scoped_lock lock(m_callbackMutex);
+            m_playbackEvent = std::move(callback);
+        }
+
+        void MprisAudioSession::setTrackChangedCallback(TrackChangedCallback callback) noexcept {
+            std::scoped_lock lock(m_callbackMutex);
+            m_trackChanged = std::move(callback);
+        }
+
+        TrackChangeStats MprisAudioSession::getTrackChangeStats() const noexcept {
+            return m_trackWatcher.stats();
+        }
+
+    }
+}
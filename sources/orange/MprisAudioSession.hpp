@@ -0,0 +1,134 @@
+#pragma once
+#include "IAudioSession.h"
+#include "MprisConnection.h"
+#include "MprisVolumeEndpoint.h"
+#include "PlaybackEvents.h"
+#include "SessionStateCache.h"
+#include "TrackChangeWatcher.h"
+#include "VolumeController.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <span>
+#include <expected>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace audio {
+    namespace platform {
+
+        // One MPRIS player, addressed by its well-known bus name. initialize() reads every Player
+        // property with a single GetAll; from then on a local mirror is kept current from
+        // PropertiesChanged and Seeked, so reads never go to the bus. MPRIS does not signal
+        // Position as it advances: the mirror re-anchors it on every status, rate or track change
+        // and PlaybackClock extrapolates in between, as for GSMTC's timeline.
+        class MprisAudioSession final : public IAudioSession {
+        private:
+            struct Mirror {
+                std::mutex mutex;
+                MprisPlayerProperties properties;
+                // A new object per artwork change; it keys the shared ThumbnailCache.
+                std::shared_ptr<const std::string> artUrl;
+                uint64_t thumbnailHandle{ 0 };
+                ThumbnailCache::Buffer thumbnail;
+            };
+
+            // A signal that arrived before initialize() applied its GetAll reply, with a copy of
+            // the properties the signal only pointed to.
+            struct EarlySignal {
+                MprisSignal signal;
+                std::optional<MprisPlayerProperties> properties;
+            };
+
+            std::shared_ptr<MprisConnection> m_connection;
+            const std::string m_busName;
+            std::shared_ptr<ThumbnailCache> m_thumbnails;
+
+            mutable Mirror m_mirror;
+            mutable SessionStateCache m_cache;
+            // Serializes initialize() with signal handling. While its GetAll is in flight signals
+            // are queued; then the ones newer than the reply are replayed on top of it. Playback
+            // and track callbacks run with it held.
+            std::mutex m_applyMutex;
+            bool m_priming{ false };
+            bool m_primed{ false };
+            uint64_t m_baseline{ 0 };
+            std::vector<EarlySignal> m_early;
+            std::atomic<bool> m_initialized{ false };
+            MprisVolumeEndpoint* m_volumeEndpoint;
+            VolumeController m_volume;
+
+            PlaybackDiffer m_playbackDiff;
+            std::mutex m_callbackMutex;
+            PlaybackChangedCallback m_playbackChanged;
+            PlaybackEventCallback m_playbackEvent;
+            TrackChangedCallback m_trackChanged;
+            MprisConnection::SubscriptionId m_subscription{ 0 };
+            // Last, so its worker is joined before anything it reads goes away.
+            TrackChangeWatcher m_trackWatcher;
+
+            MprisAudioSession(std::shared_ptr<MprisConnection> connection, std::string busName,
+                std::unique_ptr<MprisVolumeEndpoint> volumeEndpoint, std::shared_ptr<ThumbnailCache> thumbnails);
+
+            std::expected<std::shared_ptr<const SessionState>, AudioError> currentState(const char* operation) const noexcept;
+            void onSignal(const MprisSignal& signal);
+            void handleSignal(const MprisSignal& signal);
+            void apply(const MprisPlayerProperties& changed, bool announce);
+            void applySeek(std::chrono::microseconds position);
+            void close();
+            void raisePlaybackEvent(const PlaybackState& playback);
+            std::expected<MediaInfo, AudioError> fetchMediaForWatcher() const;
+            void deliverTrackChanged(const MediaInfo& media);
+
+        public:
+            MprisAudioSession(std::shared_ptr<MprisConnection> connection, std::string busName, std::shared_ptr<ThumbnailCache> thumbnails);
+            ~MprisAudioSession() noexcept override;
+            MprisAudioSession(const MprisAudioSession&) = delete;
+            MprisAudioSession& operator=(const MprisAudioSession&) = delete;
+
+            [[nodiscard]] const std::string& busName() const noexcept { return m_busName; }
+            [[nodiscard]] SessionStateCache::Stats cacheStats() const noexcept { return m_cache.stats(); }
+
+            std::expected<void, AudioError> initialize() noexcept override;
+            AsyncResult<void> initializeAsync() noexcept override;
+            std::expected<std::chrono::seconds, AudioError> getDuration() noexcept override;
+            std::expected<std::chrono::seconds, AudioError> getCurrentPosition() noexcept override;
+            std::expected<std::chrono::milliseconds, AudioError> getCurrentPositionPrecise() noexcept override;
+            std::expected<std::string, AudioError> getTitle() const noexcept override;
+            std::expected<std::string, AudioError> getArtist() const noexcept override;
+            std::expected<std::string, AudioError> getAlbum() const noexcept override;
+            std::expected<std::string_view, AudioError> getText(MediaText field, StringPool& pool) const noexcept override;
+            std::expected<std::span<const uint8_t>, AudioError> getThumbnailBytes() noexcept override;
+            std::expected<ThumbnailCache::Buffer, AudioError> getThumbnail() noexcept override;
+            std::expected<TrackSnapshot, AudioError> getTrackSnapshot() noexcept override;
+
+            std::expected<void, AudioError> play() noexcept override;
+            std::expected<void, AudioError> pause() noexcept override;
+            std::expected<void, AudioError> next() noexcept override;
+            std::expected<void, AudioError> previous() noexcept override;
+            std::expected<void, AudioError> seek(std::chrono::seconds position) noexcept override;
+            std::expected<void, AudioError> setVolume(double volume) noexcept override;
+            std::expected<double, AudioError> getVolume() noexcept override;
+
+            AsyncResult<void> playAsync() noexcept override;
+            AsyncResult<void> pauseAsync() noexcept override;
+            AsyncResult<void> nextAsync() noexcept override;
+            AsyncResult<void> previousAsync() noexcept override;
+            AsyncResult<void> seekAsync(std::chrono::seconds position) noexcept override;
+            AsyncResult<void> setVolumeAsync(double volume) noexcept override;
+            AsyncResult<double> getVolumeAsync() noexcept override;
+            AsyncResult<TrackSnapshot> getTrackSnapshotAsync() noexcept override;
+
+            void setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept override;
+            void setPlaybackEventCallback(PlaybackEventCallback callback) noexcept override;
+            void setTrackChangedCallback(TrackChangedCallback callback) noexcept override;
+            TrackChangeStats getTrackChangeStats() const noexcept override;
+            VolumeController::SubscriptionId subscribeVolumeChanged(VolumeChangedCallback callback) noexcept override;
+            void unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept override;
+        };
+
+    }
+}
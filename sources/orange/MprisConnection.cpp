@@ -0,0 +1,629 @@
+#include "MprisConnection.h"
+#include "OperationStats.h"
+#include <systemd/sd-bus.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace audio {
+    namespace platform {
+
+        namespace {
+
+            constexpr const char* PlayerPath = "/org/mpris/MediaPlayer2";
+            constexpr const char* PlayerInterface = "org.mpris.MediaPlayer2.Player";
+            constexpr const char* PropertiesInterface = "org.freedesktop.DBus.Properties";
+
+            constexpr const char* NameOwnerChangedRule =
+                "type='signal',sender='org.freedesktop.DBus',interface='org.freedesktop.DBus',"
+                "member='NameOwnerChanged',arg0namespace='org.mpris.MediaPlayer2'";
+            constexpr const char* PropertiesChangedRule =
+                "type='signal',interface='org.freedesktop.DBus.Properties',member='PropertiesChanged',"
+                "path='/org/mpris/MediaPlayer2',arg0='org.mpris.MediaPlayer2.Player'";
+            constexpr const char* SeekedRule =
+                "type='signal',interface='org.mpris.MediaPlayer2.Player',member='Seeked',path='/org/mpris/MediaPlayer2'";
+
+            struct MessageDeleter {
+                void operator()(sd_bus_message* message) const noexcept { sd_bus_message_unref(message); }
+            };
+            using MessagePtr = std::unique_ptr<sd_bus_message, MessageDeleter>;
+
+            AudioError busError(const char* operation, int result, const sd_bus_error* error = nullptr) {
+                if (error && error->message)
+                    return AudioError(ErrorCategory::Platform, operation, result, error->message);
+                return AudioError(ErrorCategory::Platform, operation, result);
+            }
+
+            bool isPlayerName(std::string_view name) noexcept {
+                return name.starts_with(MprisConnection::NamePrefix) && name.size() > MprisConnection::NamePrefix.size();
+            }
+
+            // MPRIS fixes the type of every property, but players get them wrong often enough
+            // (trackNumber as int64, Rate as int) that values are read by whatever type was sent.
+            using Value = std::variant<std::monostate, bool, int64_t, double, std::string, std::vector<std::string>>;
+
+            int readBasic(sd_bus_message* message, char type, Value& value) {
+                int r = 0;
+                switch (type) {
+                case 'b': { int v = 0; r = sd_bus_message_read_basic(message, type, &v); value = v != 0; break; }
+                case 'y': { uint8_t v = 0; r = sd_bus_message_read_basic(message, type, &v); value = int64_t{ v }; break; }
+                case 'n': { int16_t v = 0; r = sd_bus_message_read_basic(message, type, &v); value = int64_t{ v }; break; }
+                case 'q': { uint16_t v = 0; r = sd_bus_message_read_basic(message, type, &v); value = int64_t{ v }; break; }
+                case 'i': { int32_t v = 0; r = sd_bus_message_read_basic(message, type, &v); value = int64_t{ v }; break; }
+                case 'u': { uint32_t v = 0; r = sd_bus_message_read_basic(message, type, &v); value = int64_t{ v }; break; }
+                case 'x': { int64_t v = 0; r = sd_bus_message_read_basic(message, type, &v); value = v; break; }
+                case 't': { uint64_t v = 0; r = sd_bus_message_read_basic(message, type, &v); value = static_cast<int64_t>(v); break; }
+                case 'd': { double v = 0; r = sd_bus_message_read_basic(message, type, &v); value = v; break; }
+                case 's':
+                case 'o':
+                case 'g': { const char* v = nullptr; r = sd_bus_message_read_basic(message, type, &v); value = std::string(v ? v : ""); break; }
+                default:
+                    value = std::monostate{};
+                    return 0;
+                }
+                return r;
+            }
+
+            // Reads the variant at the read position; types other than basics and string arrays are skipped.
+            int readVariant(sd_bus_message* message, Value& value) {
+                char type = 0;
+                const char* contents = nullptr;
+                int r = sd_bus_message_peek_type(message, &type, &contents);
+                if (r <= 0)
+                    return r < 0 ? r : -EBADMSG;
+                const std::string_view signature = contents ? contents : "";
+                if (signature.size() == 1 && signature != "v") {
+                    if ((r = sd_bus_message_enter_container(message, 'v', contents)) < 0)
+                        return r;
+                    if ((r = readBasic(message, signature[0], value)) < 0)
+                        return r;
+                    return sd_bus_message_exit_container(message);
+                }
+                if (signature == "as" || signature == "ao") {
+                    if ((r = sd_bus_message_enter_container(message, 'v', contents)) < 0)
+                        return r;
+                    if ((r = sd_bus_message_enter_container(message, 'a', contents + 1)) < 0)
+                        return r;
+                    std::vector<std::string> strings;
+                    const char* item = nullptr;
+                    while ((r = sd_bus_message_read_basic(message, contents[1], &item)) > 0)
+                        strings.emplace_back(item ? item : "");
+                    if (r < 0)
+                        return r;
+                    value = std::move(strings);
+                    if ((r = sd_bus_message_exit_container(message)) < 0)
+                        return r;
+                    return sd_bus_message_exit_container(message);
+                }
+                value = std::monostate{};
+                return sd_bus_message_skip(message, "v");
+            }
+
+            std::optional<double> asDouble(const Value& value) {
+                if (auto real = std::get_if<double>(&value))
+                    return *real;
+                if (auto integer = std::get_if<int64_t>(&value))
+                    return static_cast<double>(*integer);
+                return std::nullopt;
+            }
+
+            std::optional<int64_t> asInteger(const Value& value) {
+                if (auto integer = std::get_if<int64_t>(&value))
+                    return *integer;
+                if (auto real = std::get_if<double>(&value))
+                    return static_cast<int64_t>(*real);
+                return std::nullopt;
+            }
+
+            std::optional<bool> asBool(const Value& value) {
+                if (auto flag = std::get_if<bool>(&value))
+                    return *flag;
+                return std::nullopt;
+            }
+
+            std::string asString(const Value& value) {
+                if (auto text = std::get_if<std::string>(&value))
+                    return *text;
+                if (auto list = std::get_if<std::vector<std::string>>(&value)) {
+                    std::string joined;
+                    for (const auto& item : *list) {
+                        if (!joined.empty())
+                            joined += ", ";
+                        joined += item;
+                    }
+                    return joined;
+                }
+                return {};
+            }
+
+            int readMetadata(sd_bus_message* message, MprisMetadata& metadata) {
+                int r = sd_bus_message_enter_container(message, 'v', "a{sv}");
+                if (r < 0)
+                    return r;
+                if ((r = sd_bus_message_enter_container(message, 'a', "{sv}")) < 0)
+                    return r;
+                while ((r = sd_bus_message_enter_container(message, 'e', "sv")) > 0) {
+                    const char* key = nullptr;
+                    Value value;
+                    if ((r = sd_bus_message_read_basic(message, 's', &key)) < 0)
+                        return r;
+                    if ((r = readVariant(message, value)) < 0)
+                        return r;
+                    const std::string_view name = key ? key : "";
+                    if (name == "mpris:trackid")
+                        metadata.trackId = asString(value);
+                    else if (name == "mpris:length")
+                        metadata.length = std::chrono::microseconds(asInteger(value).value_or(0));
+                    else if (name == "mpris:artUrl")
+                        metadata.artUrl = asString(value);
+                    else if (name == "xesam:title")
+                        metadata.title = asString(value);
+                    else if (name == "xesam:artist")
+                        metadata.artist = asString(value);
+                    else if (name == "xesam:album")
+                        metadata.album = asString(value);
+                    else if (name == "xesam:albumArtist")
+                        metadata.albumArtist = asString(value);
+                    else if (name == "xesam:trackNumber")
+                        metadata.trackNumber = static_cast<int32_t>(asInteger(value).value_or(0));
+                    if ((r = sd_bus_message_exit_container(message)) < 0)
+                        return r;
+                }
+                if (r < 0)
+                    return r;
+                if ((r = sd_bus_message_exit_container(message)) < 0)
+                    return r;
+                return sd_bus_message_exit_container(message);
+            }
+
+            // Reads an a{sv} of Player properties, as returned by GetAll and sent in PropertiesChanged.
+            int readProperties(sd_bus_message* message, MprisPlayerProperties& properties) {
+                int r = sd_bus_message_enter_container(message, 'a', "{sv}");
+                if (r < 0)
+                    return r;
+                while ((r = sd_bus_message_enter_container(message, 'e', "sv")) > 0) {
+                    const char* key = nullptr;
+                    if ((r = sd_bus_message_read_basic(message, 's', &key)) < 0)
+                        return r;
+                    const std::string_view name = key ? key : "";
+                    if (name == "Metadata") {
+                        MprisMetadata metadata;
+                        if ((r = readMetadata(message, metadata)) < 0)
+                            return r;
+                        properties.metadata = std::move(metadata);
+                    }
+                    else {
+                        Value value;
+                        if ((r = readVariant(message, value)) < 0)
+                            return r;
+                        if (name == "PlaybackStatus")
+                            properties.playbackStatus = asString(value);
+                        else if (name == "LoopStatus")
+                            properties.loopStatus = asString(value);
+                        else if (name == "Rate")
+                            properties.rate = asDouble(value);
+                        else if (name == "Shuffle")
+                            properties.shuffle = asBool(value);
+                        else if (name == "Volume")
+                            properties.volume = asDouble(value);
+                        else if (name == "Position") {
+                            if (auto position = asInteger(value))
+                                properties.position = std::chrono::microseconds(*position);
+                        }
+                        else if (name == "CanGoNext")
+                            properties.canGoNext = asBool(value);
+                        else if (name == "CanGoPrevious")
+                            properties.canGoPrevious = asBool(value);
+                        else if (name == "CanPlay")
+                            properties.canPlay = asBool(value);
+                        else if (name == "CanPause")
+                            properties.canPause = asBool(value);
+                        else if (name == "CanSeek")
+                            properties.canSeek = asBool(value);
+                        else if (name == "CanControl")
+                            properties.canControl = asBool(value);
+                    }
+                    if ((r = sd_bus_message_exit_container(message)) < 0)
+                        return r;
+                }
+                if (r < 0)
+                    return r;
+                return sd_bus_message_exit_container(message);
+            }
+
+        }
+
+        std::expected<std::shared_ptr<MprisConnection>, AudioError> MprisConnection::open(std::string_view address) noexcept {
+            sd_bus* bus = nullptr;
+            int r = 0;
+            if (address.empty()) {
+                r = sd_bus_open_user(&bus);
+            }
+            else {
+                const std::string target(address);
+                if ((r = sd_bus_new(&bus)) >= 0 && (r = sd_bus_set_address(bus, target.c_str())) >= 0
+                    && (r = sd_bus_set_bus_client(bus, 1)) >= 0)
+                    r = sd_bus_start(bus);
+            }
+            if (r < 0) {
+                sd_bus_unref(bus);
+                return std::unexpected(busError("Connect to session bus", r));
+            }
+            try {
+                std::shared_ptr<MprisConnection> connection(new MprisConnection(bus));
+                if (auto started = connection->start(); !started)
+                    return std::unexpected(started.error());
+                return connection;
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Connect to session bus", ex));
+            }
+        }
+
+        MprisConnection::MprisConnection(sd_bus* bus) : m_bus(bus) {
+        }
+
+        MprisConnection::~MprisConnection() {
+            m_stopping.store(true, std::memory_order_release);
+            wake();
+            if (m_worker.joinable())
+                m_worker.join();
+            if (m_wakeFd >= 0)
+                ::close(m_wakeFd);
+            sd_bus_flush_close_unref(m_bus);
+        }
+
+        // The match rules go in before the names are listed, so a player that appears in between
+        // is reported by NameOwnerChanged rather than missed.
+        std::expected<void, AudioError> MprisConnection::start() {
+            m_wakeFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (m_wakeFd < 0)
+                return std::unexpected(busError("Connect to session bus", -errno));
+
+            std::scoped_lock lock(m_busMutex);
+            int r = 0;
+            if ((r = sd_bus_add_match(m_bus, nullptr, NameOwnerChangedRule, &MprisConnection::onNameOwnerChanged, this)) < 0
+                || (r = sd_bus_add_match(m_bus, nullptr, PropertiesChangedRule, &MprisConnection::onPropertiesChanged, this)) < 0
+                || (r = sd_bus_add_match(m_bus, nullptr, SeekedRule, &MprisConnection::onSeeked, this)) < 0)
+                return std::unexpected(busError("Watch media players", r));
+
+            sd_bus_error error = SD_BUS_ERROR_NULL;
+            sd_bus_message* reply = nullptr;
+            r = sd_bus_call_method(m_bus, "org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus",
+                "ListNames", &error, &reply, "");
+            MessagePtr names(reply);
+            if (r < 0) {
+                auto failure = busError("List media players", r, &error);
+                sd_bus_error_free(&error);
+                return std::unexpected(std::move(failure));
+            }
+            std::vector<std::string> players;
+            if ((r = sd_bus_message_enter_container(reply, 'a', "s")) < 0)
+                return std::unexpected(busError("List media players", r));
+            const char* name = nullptr;
+            while ((r = sd_bus_message_read_basic(reply, 's', &name)) > 0) {
+                if (isPlayerName(name))
+                    players.emplace_back(name);
+            }
+            if (r < 0)
+                return std::unexpected(busError("List media players", r));
+
+            for (const auto& player : players) {
+                reply = nullptr;
+                r = sd_bus_call_method(m_bus, "org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus",
+                    "GetNameOwner", &error, &reply, "s", player.c_str());
+                MessagePtr owner(reply);
+                sd_bus_error_free(&error);
+                const char* unique = nullptr;
+                // A player that quit since ListNames has no owner; NameOwnerChanged reports that.
+                if (r >= 0 && sd_bus_message_read_basic(reply, 's', &unique) > 0 && unique)
+                    m_owners.insert_or_assign(player, unique);
+            }
+
+            m_worker = std::thread([this] { run(); });
+            return {};
+        }
+
+        std::vector<std::string> MprisConnection::playerNames() const {
+            std::scoped_lock lock(m_busMutex);
+            std::vector<std::string> names;
+            names.reserve(m_owners.size());
+            for (const auto& owner : m_owners)
+                names.push_back(owner.first);
+            return names;
+        }
+
+        // Runs one method call on the caller's thread. read is applied to the reply while the bus
+        // is still locked, since messages share the bus's non-atomic reference counts.
+        template <typename Append, typename Read>
+        auto MprisConnection::call(const char* operation, std::string_view busName, const char* interface, const char* member,
+            Append&& append, Read&& read) noexcept -> std::invoke_result_t<Read, sd_bus_message*> {
+            m_calls.fetch_add(1, std::memory_order_relaxed);
+            const std::string destination(busName);
+            sd_bus_error error = SD_BUS_ERROR_NULL;
+            std::invoke_result_t<Read, sd_bus_message*> result = std::unexpected(AudioError(ErrorCategory::Internal, operation));
+            {
+                std::scoped_lock lock(m_busMutex);
+                sd_bus_message* request = nullptr;
+                int r = sd_bus_message_new_method_call(m_bus, &request, destination.c_str(), PlayerPath, interface, member);
+                MessagePtr requestRef(request);
+                if (r >= 0)
+                    r = append(request);
+                sd_bus_message* reply = nullptr;
+                if (r >= 0)
+                    r = sd_bus_call(m_bus, request, std::chrono::microseconds(CallTimeout).count(), &error, &reply);
+                MessagePtr replyRef(reply);
+                if (r < 0)
+                    result = std::unexpected(busError(operation, r, &error));
+                else
+                    result = read(reply);
+            }
+            sd_bus_error_free(&error);
+            if (!result)
+                m_failedCalls.fetch_add(1, std::memory_order_relaxed);
+            // sd_bus_call queues whatever else arrived while it waited for the reply; the socket
+            // no longer shows it as readable, so the dispatch thread has to be told.
+            wake();
+            return result;
+        }
+
+        std::expected<MprisPlayerProperties, AudioError> MprisConnection::getAll(std::string_view busName) noexcept {
+            return OperationStats::platform().measure(StatOperation::FetchMediaProperties, [&] {
+                return call("Get player properties", busName, PropertiesInterface, "GetAll",
+                    [](sd_bus_message* request) { return sd_bus_message_append(request, "s", PlayerInterface); },
+                    [](sd_bus_message* reply) -> std::expected<MprisPlayerProperties, AudioError> {
+                        try {
+                            MprisPlayerProperties properties;
+                            if (int r = readProperties(reply, properties); r < 0)
+                                return std::unexpected(busError("Get player properties", r));
+                            sd_bus_message_get_cookie(reply, &properties.serial);
+                            return properties;
+                        }
+                        catch (const std::exception& ex) {
+                            return std::unexpected(AudioError::fromException("Get player properties", ex));
+                        }
+                    });
+            });
+        }
+
+        std::expected<std::chrono::microseconds, AudioError> MprisConnection::getPosition(std::string_view busName) noexcept {
+            return OperationStats::platform().measure(StatOperation::FetchTimeline, [&] {
+                return call("Get position", busName, PropertiesInterface, "Get",
+                    [](sd_bus_message* request) { return sd_bus_message_append(request, "ss", PlayerInterface, "Position"); },
+                    [](sd_bus_message* reply) -> std::expected<std::chrono::microseconds, AudioError> {
+                        try {
+                            Value value;
+                            if (int r = readVariant(reply, value); r < 0)
+                                return std::unexpected(busError("Get position", r));
+                            auto position = asInteger(value);
+                            if (!position)
+                                return std::unexpected(AudioError(ErrorCategory::Platform, "Get position"));
+                            return std::chrono::microseconds(*position);
+                        }
+                        catch (const std::exception& ex) {
+                            return std::unexpected(AudioError::fromException("Get position", ex));
+                        }
+                    });
+            });
+        }
+
+        std::expected<void, AudioError> MprisConnection::callPlayer(std::string_view busName, const char* method, const char* operation) noexcept {
+            return call(operation, busName, PlayerInterface, method,
+                [](sd_bus_message*) { return 0; },
+                [](sd_bus_message*) -> std::expected<void, AudioError> { return {}; });
+        }
+
+        std::expected<void, AudioError> MprisConnection::setPosition(std::string_view busName, std::string_view trackId, std::chrono::microseconds position) noexcept {
+            std::string track;
+            try {
+                track.assign(trackId);
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Seek", ex));
+            }
+            return call("Seek", busName, PlayerInterface, "SetPosition",
+                [&track, position](sd_bus_message* request) {
+                    return sd_bus_message_append(request, "ox", track.c_str(), static_cast<int64_t>(position.count()));
+                },
+                [](sd_bus_message*) -> std::expected<void, AudioError> { return {}; });
+        }
+
+        std::expected<void, AudioError> MprisConnection::seekBy(std::string_view busName, std::chrono::microseconds offset) noexcept {
+            return call("Seek", busName, PlayerInterface, "Seek",
+                [offset](sd_bus_message* request) { return sd_bus_message_append(request, "x", static_cast<int64_t>(offset.count())); },
+                [](sd_bus_message*) -> std::expected<void, AudioError> { return {}; });
+        }
+
+        std::expected<void, AudioError> MprisConnection::setVolume(std::string_view busName, double volume) noexcept {
+            return call("Set volume", busName, PropertiesInterface, "Set",
+                [volume](sd_bus_message* request) { return sd_bus_message_append(request, "ssv", PlayerInterface, "Volume", "d", volume); },
+                [](sd_bus_message*) -> std::expected<void, AudioError> { return {}; });
+        }
+
+        MprisConnection::SubscriptionId MprisConnection::subscribe(SignalCallback callback) {
+            if (!callback)
+                return 0;
+            const auto id = m_nextId.fetch_add(1, std::memory_order_relaxed);
+            m_listeners.add(id, std::move(callback));
+            return id;
+        }
+
+        void MprisConnection::unsubscribe(SubscriptionId id) {
+            m_listeners.remove(id);
+            if (std::this_thread::get_id() != m_worker.get_id()) {
+                std::scoped_lock barrier(m_dispatchMutex);
+            }
+        }
+
+        MprisConnection::Stats MprisConnection::stats() const noexcept {
+            Stats stats;
+            stats.calls = m_calls.load(std::memory_order_relaxed);
+            stats.failedCalls = m_failedCalls.load(std::memory_order_relaxed);
+            stats.signals = m_signals.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        void MprisConnection::wake() noexcept {
+            const uint64_t one = 1;
+            if (m_wakeFd >= 0) {
+                [[maybe_unused]] auto written = ::write(m_wakeFd, &one, sizeof(one));
+            }
+        }
+
+        void MprisConnection::run() {
+            while (!m_stopping.load(std::memory_order_acquire)) {
+                pollfd fds[2]{};
+                uint64_t deadline = UINT64_MAX;
+                {
+                    std::scoped_lock lock(m_busMutex);
+                    int r = 0;
+                    while ((r = sd_bus_process(m_bus, nullptr)) > 0) {
+                    }
+                    // The connection is gone; nothing more will arrive.
+                    if (r < 0)
+                        return;
+                    fds[0].fd = sd_bus_get_fd(m_bus);
+                    fds[0].events = static_cast<short>(sd_bus_get_events(m_bus));
+                    sd_bus_get_timeout(m_bus, &deadline);
+                }
+                deliverPending();
+
+                int timeout = -1;
+                if (deadline != UINT64_MAX) {
+                    timespec now{};
+                    clock_gettime(CLOCK_MONOTONIC, &now);
+                    const uint64_t nowUs = static_cast<uint64_t>(now.tv_sec) * 1000000u + static_cast<uint64_t>(now.tv_nsec) / 1000u;
+                    timeout = deadline > nowUs ? static_cast<int>(std::min<uint64_t>((deadline - nowUs + 999) / 1000, 60000)) : 0;
+                }
+                fds[1].fd = m_wakeFd;
+                fds[1].events = POLLIN;
+                if (::poll(fds, 2, timeout) > 0 && (fds[1].revents & POLLIN)) {
+                    uint64_t count = 0;
+                    [[maybe_unused]] auto drained = ::read(m_wakeFd, &count, sizeof(count));
+                }
+            }
+        }
+
+        void MprisConnection::deliverPending() {
+            std::vector<Pending> pending;
+            {
+                std::scoped_lock lock(m_busMutex);
+                pending.swap(m_pending);
+            }
+            if (pending.empty())
+                return;
+            std::scoped_lock lock(m_dispatchMutex);
+            for (const auto& item : pending) {
+                MprisSignal signal;
+                signal.kind = item.kind;
+                signal.properties = &item.properties;
+                signal.position = item.position;
+                signal.serial = item.serial;
+                for (const auto& name : item.busNames) {
+                    signal.busName = name;
+                    // A subscriber that throws must not take the dispatch thread down with it.
+                    try {
+                        m_listeners.dispatch(signal);
+                    }
+                    catch (...) {
+                    }
+                }
+            }
+        }
+
+        std::vector<std::string> MprisConnection::namesOwnedBy(std::string_view uniqueName) const {
+            std::vector<std::string> names;
+            for (const auto& owner : m_owners) {
+                if (owner.second == uniqueName)
+                    names.push_back(owner.first);
+            }
+            return names;
+        }
+
+        // The handlers below run inside sd_bus_process with the bus locked: they only record.
+
+        int MprisConnection::onNameOwnerChanged(sd_bus_message* message, void* userdata, sd_bus_error*) {
+            auto* self = static_cast<MprisConnection*>(userdata);
+            const char* name = nullptr;
+            const char* oldOwner = nullptr;
+            const char* newOwner = nullptr;
+            if (sd_bus_message_read(message, "sss", &name, &oldOwner, &newOwner) < 0 || !name || !isPlayerName(name))
+                return 0;
+            self->m_signals.fetch_add(1, std::memory_order_relaxed);
+            try {
+                const bool hadOwner = self->m_owners.contains(std::string_view(name));
+                Pending pending{ MprisSignal::Kind::PlayerAppeared, { name }, {}, {} };
+                if (newOwner && *newOwner) {
+                    self->m_owners.insert_or_assign(name, newOwner);
+                    // A hand-over between owners is reported as the old player leaving first.
+                    if (hadOwner) {
+                        Pending vanished{ MprisSignal::Kind::PlayerVanished, { name }, {}, {} };
+                        self->m_pending.push_back(std::move(vanished));
+                    }
+                }
+                else {
+                    if (!hadOwner)
+                        return 0;
+                    self->m_owners.erase(self->m_owners.find(std::string_view(name)));
+                    pending.kind = MprisSignal::Kind::PlayerVanished;
+                }
+                self->m_pending.push_back(std::move(pending));
+            }
+            catch (...) {
+            }
+            return 0;
+        }
+
+        int MprisConnection::onPropertiesChanged(sd_bus_message* message, void* userdata, sd_bus_error*) {
+            auto* self = static_cast<MprisConnection*>(userdata);
+            const char* sender = sd_bus_message_get_sender(message);
+            if (!sender)
+                return 0;
+            self->m_signals.fetch_add(1, std::memory_order_relaxed);
+            try {
+                Pending pending{ MprisSignal::Kind::PropertiesChanged, self->namesOwnedBy(sender), {}, {} };
+                if (pending.busNames.empty())
+                    return 0;
+                sd_bus_message_get_cookie(message, &pending.serial);
+                const char* interface = nullptr;
+                if (sd_bus_message_read_basic(message, 's', &interface) < 0 || readProperties(message, pending.properties) < 0)
+                    return 0;
+                if (sd_bus_message_enter_container(message, 'a', "s") > 0) {
+                    const char* invalidated = nullptr;
+                    if (sd_bus_message_read_basic(message, 's', &invalidated) > 0)
+                        pending.properties.invalidated = true;
+                }
+                pending.properties.serial = pending.serial;
+                self->m_pending.push_back(std::move(pending));
+            }
+            catch (...) {
+            }
+            return 0;
+        }
+
+        int MprisConnection::onSeeked(sd_bus_message* message, void* userdata, sd_bus_error*) {
+            auto* self = static_cast<MprisConnection*>(userdata);
+            const char* sender = sd_bus_message_get_sender(message);
+            int64_t position = 0;
+            if (!sender || sd_bus_message_read_basic(message, 'x', &position) < 0)
+                return 0;
+            self->m_signals.fetch_add(1, std::memory_order_relaxed);
+            try {
+                Pending pending{ MprisSignal::Kind::Seeked, self->namesOwnedBy(sender), {}, std::chrono::microseconds(position) };
+                sd_bus_message_get_cookie(message, &pending.serial);
+                if (!pending.busNames.empty())
+                    self->m_pending.push_back(std::move(pending));
+            }
+            catch (...) {
+            }
+            return 0;
+        }
+
+    }
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include "AudioError.h"
+#include "EventSubscribers.h"
+#include <atomic>
+#include <chrono>
+#include <expected>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+struct sd_bus;
+struct sd_bus_message;
+struct sd_bus_error;
+
+namespace audio {
+    namespace platform {
+
+        // The parts of an MPRIS track's metadata map the audio layer uses.
+        struct MprisMetadata {
+            std::string trackId;
+            std::string title;
+            // xesam:artist and xesam:albumArtist are lists; they are joined with ", ".
+            std::string artist;
+            std::string album;
+            std::string albumArtist;
+            int32_t trackNumber{ 0 };
+            std::chrono::microseconds length{ 0 };
+            std::string artUrl;
+        };
+
+        // Properties of org.mpris.MediaPlayer2.Player as read by GetAll or carried by one
+        // PropertiesChanged signal; a signal only sets the properties it carries.
+        struct MprisPlayerProperties {
+            std::optional<std::string> playbackStatus;
+            std::optional<std::string> loopStatus;
+            std::optional<double> rate;
+            std::optional<bool> shuffle;
+            std::optional<MprisMetadata> metadata;
+            std::optional<double> volume;
+            std::optional<std::chrono::microseconds> position;
+            std::optional<bool> canGoNext;
+            std::optional<bool> canGoPrevious;
+            std::optional<bool> canPlay;
+            std::optional<bool> canPause;
+            std::optional<bool> canSeek;
+            std::optional<bool> canControl;
+            // The signal listed properties as invalidated instead of sending their values.
+            bool invalidated{ false };
+            // Serial of the reply or signal that carried them. A player numbers its messages in
+            // the order it sends them, so a signal older than a GetAll reply has a lower serial.
+            uint64_t serial{ 0 };
+        };
+
+        // One bus event, already resolved from the sender's unique name to the player's
+        // well-known name. The pointer is valid for the duration of the call.
+        struct MprisSignal {
+            enum class Kind {
+                PlayerAppeared,
+                PlayerVanished,
+                PropertiesChanged,
+                Seeked
+            };
+
+            Kind kind{ Kind::PropertiesChanged };
+            std::string_view busName;
+            const MprisPlayerProperties* properties{ nullptr };
+            // Seeked.
+            std::chrono::microseconds position{ 0 };
+            uint64_t serial{ 0 };
+        };
+
+        // One sd-bus connection shared by the MPRIS session source and every session it creates.
+        // It adds three match rules up front (player names coming and going, PropertiesChanged
+        // on the player interface, Seeked), so a player costs no extra bus round trips after its
+        // initial GetAll. sd-bus is not thread-safe: every bus access holds one mutex, and a
+        // dispatch thread waits on the socket outside it. Signals are parsed while the bus is
+        // locked but handed to subscribers only after it is released, so a subscriber may call
+        // back into the connection.
+        class MprisConnection {
+        public:
+            using SignalCallback = std::function<void(const MprisSignal&)>;
+            using SubscriptionId = uint64_t;
+
+            struct Stats {
+                uint64_t calls{ 0 };
+                uint64_t failedCalls{ 0 };
+                uint64_t signals{ 0 };
+            };
+
+            static constexpr std::string_view NamePrefix = "org.mpris.MediaPlayer2.";
+            static constexpr std::chrono::milliseconds CallTimeout{ 2000 };
+
+            // Connects to the user's session bus, or to address (a private bus, for example)
+            // when one is given.
+            static std::expected<std::shared_ptr<MprisConnection>, AudioError> open(std::string_view address = {}) noexcept;
+
+            ~MprisConnection();
+            MprisConnection(const MprisConnection&) = delete;
+            MprisConnection& operator=(const MprisConnection&) = delete;
+
+            // Well-known names of the players currently on the bus, in name order.
+            std::vector<std::string> playerNames() const;
+
+            std::expected<MprisPlayerProperties, AudioError> getAll(std::string_view busName) noexcept;
+            std::expected<std::chrono::microseconds, AudioError> getPosition(std::string_view busName) noexcept;
+            // Play, Pause, Next, Previous and the other argument-less Player methods.
+            std::expected<void, AudioError> callPlayer(std::string_view busName, const char* method, const char* operation) noexcept;
+            std::expected<void, AudioError> setPosition(std::string_view busName, std::string_view trackId, std::chrono::microseconds position) noexcept;
+            std::expected<void, AudioError> seekBy(std::string_view busName, std::chrono::microseconds offset) noexcept;
+            std::expected<void, AudioError> setVolume(std::string_view busName, double volume) noexcept;
+
+            // Callbacks run on the dispatch thread. Returns 0 for an empty callback. Once
+            // unsubscribe returns, the callback is not running and will not run again, unless
+            // unsubscribe is called from the callback itself.
+            SubscriptionId subscribe(SignalCallback callback);
+            void unsubscribe(SubscriptionId id);
+
+            [[nodiscard]] Stats stats() const noexcept;
+
+        private:
+            struct Pending {
+                MprisSignal::Kind kind;
+                std::vector<std::string> busNames;
+                MprisPlayerProperties properties;
+                std::chrono::microseconds position{ 0 };
+                uint64_t serial{ 0 };
+            };
+
+            explicit MprisConnection(sd_bus* bus);
+
+            std::expected<void, AudioError> start();
+            void run();
+            void wake() noexcept;
+            void deliverPending();
+
+            template <typename Append, typename Read>
+            auto call(const char* operation, std::string_view busName, const char* interface, const char* member,
+                Append&& append, Read&& read) noexcept -> std::invoke_result_t<Read, sd_bus_message*>;
+
+            static int onNameOwnerChanged(sd_bus_message* message, void* userdata, sd_bus_error* error);
+            static int onPropertiesChanged(sd_bus_message* message, void* userdata, sd_bus_error* error);
+            static int onSeeked(sd_bus_message* message, void* userdata, sd_bus_error* error);
+            std::vector<std::string> namesOwnedBy(std::string_view uniqueName) const;
+
+            // Guards m_bus, m_owners and m_pending.
+            mutable std::mutex m_busMutex;
+            sd_bus* m_bus;
+            // Well-known player name to the unique name that owns it.
+            std::map<std::string, std::string, std::less<>> m_owners;
+            std::vector<Pending> m_pending;
+
+            // Held while subscribers run, so unsubscribe can wait out a dispatch in progress.
+            std::mutex m_dispatchMutex;
+            ListenerList<SignalCallback> m_listeners;
+            std::atomic<SubscriptionId> m_nextId{ 1 };
+
+            std::atomic<uint64_t> m_calls{ 0 };
+            std::atomic<uint64_t> m_failedCalls{ 0 };
+            std::atomic<uint64_t> m_signals{ 0 };
+
+            int m_wakeFd{ -1 };
+            std::atomic<bool> m_stopping{ false };
+            std::thread m_worker;
+        };
+
+    }
+}
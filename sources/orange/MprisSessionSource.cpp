@@ -0,0 +1,181 @@
+#include "MprisSessionSource.h"
+#include "MprisAudioSession.h"
+#include <algorithm>
+#include <utility>
+
+namespace audio {
+    namespace platform {
+
+        MprisSessionSource::MprisSessionSource(std::shared_ptr<ThumbnailCache> thumbnails, std::string address)
+            : m_address(std::move(address)), m_thumbnails(std::move(thumbnails)) {
+        }
+
+        MprisSessionSource::~MprisSessionSource() noexcept {
+            std::shared_ptr<MprisConnection> connection;
+            MprisConnection::SubscriptionId subscription = 0;
+            {
+                std::scoped_lock lock(m_mutex);
+                connection = m_connection;
+                subscription = m_subscription;
+            }
+            if (connection && subscription)
+                connection->unsubscribe(subscription);
+        }
+
+        // Subscribes before asking each player for its status, so a player that starts playing in
+        // between is still seen; the GetAll per player is the only time the source asks.
+        std::expected<void, AudioError> MprisSessionSource::open(Handlers handlers) noexcept {
+            try {
+                std::shared_ptr<MprisConnection> connection;
+                {
+                    std::scoped_lock lock(m_mutex);
+                    connection = m_connection;
+                }
+                if (!connection) {
+                    auto opened = MprisConnection::open(m_address);
+                    if (!opened)
+                        return std::unexpected(opened.error());
+                    connection = std::move(*opened);
+                }
+                {
+                    std::scoped_lock lock(m_mutex);
+                    m_connection = connection;
+                    m_handlers = std::move(handlers);
+                    if (!m_subscription)
+                        m_subscription = connection->subscribe([this](const MprisSignal& signal) { onSignal(signal); });
+                }
+
+                const auto names = connection->playerNames();
+                std::vector<std::string> playing;
+                for (const auto& name : names) {
+                    auto properties = connection->getAll(name);
+                    if (properties && properties->playbackStatus == "Playing")
+                        playing.push_back(name);
+                }
+                std::scoped_lock lock(m_mutex);
+                m_playing.insert(playing.begin(), playing.end());
+                electCurrent(names);
+                return {};
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Open session manager", ex));
+            }
+        }
+
+        // Opening is a handful of round trips to a local bus daemon and completes on the calling thread.
+        AsyncResult<void> MprisSessionSource::openAsync(Handlers handlers) noexcept {
+            co_return open(std::move(handlers));
+        }
+
+        std::expected<std::vector<std::string>, AudioError> MprisSessionSource::sessionIds() noexcept {
+            std::shared_ptr<MprisConnection> connection;
+            {
+                std::scoped_lock lock(m_mutex);
+                connection = m_connection;
+            }
+            if (!connection)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "List sessions"));
+            try {
+                return connection->playerNames();
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("List sessions", ex));
+            }
+        }
+
+        std::expected<std::string, AudioError> MprisSessionSource::currentSessionId() noexcept {
+            std::scoped_lock lock(m_mutex);
+            if (!m_connection)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "Get current session"));
+            try {
+                return m_currentId;
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Get current session", ex));
+            }
+        }
+
+        std::expected<std::shared_ptr<IAudioSession>, AudioError> MprisSessionSource::createSession(std::string_view id) noexcept {
+            std::shared_ptr<MprisConnection> connection;
+            {
+                std::scoped_lock lock(m_mutex);
+                connection = m_connection;
+            }
+            if (!connection)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "Create session"));
+            try {
+                const auto names = connection->playerNames();
+                if (std::find(names.begin(), names.end(), id) == names.end())
+                    return std::unexpected(AudioError(ErrorCategory::NotFound, "Create session"));
+                return std::make_shared<MprisAudioSession>(std::move(connection), std::string(id), m_thumbnails);
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Create session", ex));
+            }
+        }
+
+        void MprisSessionSource::onSignal(const MprisSignal& signal) {
+            bool sessionsChanged = false;
+            bool currentChanged = false;
+            Handlers handlers;
+            {
+                std::scoped_lock lock(m_mutex);
+                switch (signal.kind) {
+                case MprisSignal::Kind::PlayerAppeared:
+                    sessionsChanged = true;
+                    currentChanged = electCurrent(m_connection->playerNames());
+                    break;
+                case MprisSignal::Kind::PlayerVanished:
+                    sessionsChanged = true;
+                    if (auto it = m_playing.find(signal.busName); it != m_playing.end())
+                        m_playing.erase(it);
+                    currentChanged = electCurrent(m_connection->playerNames());
+                    break;
+                case MprisSignal::Kind::PropertiesChanged:
+                    if (!signal.properties || !signal.properties->playbackStatus)
+                        return;
+                    if (*signal.properties->playbackStatus == "Playing") {
+                        m_playing.emplace(signal.busName);
+                        if (m_currentId != signal.busName) {
+                            m_currentId = signal.busName;
+                            currentChanged = true;
+                        }
+                    }
+                    else if (auto it = m_playing.find(signal.busName); it != m_playing.end()) {
+                        m_playing.erase(it);
+                    }
+                    break;
+                case MprisSignal::Kind::Seeked:
+                    return;
+                }
+                handlers = m_handlers;
+            }
+            if (sessionsChanged && handlers.sessionsChanged)
+                handlers.sessionsChanged();
+            if (currentChanged && handlers.currentSessionChanged)
+                handlers.currentSessionChanged();
+        }
+
+        bool MprisSessionSource::electCurrent(const std::vector<std::string>& names) {
+            auto present = [&names](std::string_view name) {
+                return std::find(names.begin(), names.end(), name) != names.end();
+            };
+            if (!m_currentId.empty() && present(m_currentId))
+                return false;
+            std::string elected;
+            for (const auto& name : m_playing) {
+                if (present(name)) {
+                    elected = name;
+                    break;
+                }
+            }
+            if (elected.empty() && !names.empty())
+                elected = names.front();
+            if (elected == m_currentId)
+                return false;
+            m_currentId = std::move(elected);
+            return true;
+        }
+
+    }
+}
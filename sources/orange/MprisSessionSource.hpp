@@ -0,0 +1,50 @@
+#pragma once
+#include "SessionRegistry.h"
+#include "MprisConnection.h"
+#include "ThumbnailCache.h"
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace audio {
+    namespace platform {
+
+        // Feeds SessionRegistry from the MPRIS players on the session bus. Sessions are keyed by
+        // the player's well-known name (org.mpris.MediaPlayer2.<app>). MPRIS has no notion of a
+        // current session, so the source elects one the way desktop shells do: the player that
+        // most recently started playing, else any player that is playing, else the first one.
+        class MprisSessionSource : public ISessionSource {
+        public:
+            // address selects a bus other than the user's session bus, e.g. a private test bus.
+            explicit MprisSessionSource(std::shared_ptr<ThumbnailCache> thumbnails, std::string address = {});
+            ~MprisSessionSource() noexcept override;
+            MprisSessionSource(const MprisSessionSource&) = delete;
+            MprisSessionSource& operator=(const MprisSessionSource&) = delete;
+
+            std::expected<void, AudioError> open(Handlers handlers) noexcept override;
+            AsyncResult<void> openAsync(Handlers handlers) noexcept override;
+            std::expected<std::vector<std::string>, AudioError> sessionIds() noexcept override;
+            std::expected<std::string, AudioError> currentSessionId() noexcept override;
+            std::expected<std::shared_ptr<IAudioSession>, AudioError> createSession(std::string_view id) noexcept override;
+
+        private:
+            void onSignal(const MprisSignal& signal);
+            // Called with m_mutex held; true if the current session changed.
+            bool electCurrent(const std::vector<std::string>& names);
+
+            const std::string m_address;
+            std::shared_ptr<ThumbnailCache> m_thumbnails;
+
+            mutable std::mutex m_mutex;
+            std::shared_ptr<MprisConnection> m_connection;
+            MprisConnection::SubscriptionId m_subscription{ 0 };
+            Handlers m_handlers;
+            std::string m_currentId;
+            std::set<std::string, std::less<>> m_playing;
+        };
+
+    }
+}
@@ -0,0 +1,88 @@
+#include "MprisVolumeEndpoint.h"
+#include <utility>
+
+namespace audio {
+    namespace platform {
+
+        MprisVolumeEndpoint::MprisVolumeEndpoint(std::shared_ptr<MprisConnection> connection, std::string busName)
+            : m_connection(std::move(connection)), m_busName(std::move(busName)) {
+        }
+
+        std::expected<void, AudioError> MprisVolumeEndpoint::open(ChangeHandler onChanged) noexcept {
+            std::scoped_lock lock(m_mutex);
+            m_onChanged = std::move(onChanged);
+            return {};
+        }
+
+        // Normally answered from the mirror; only a player whose GetAll left Volume out is asked again.
+        std::expected<float, AudioError> MprisVolumeEndpoint::readVolume() noexcept {
+            {
+                std::scoped_lock lock(m_mutex);
+                if (m_volume)
+                    return m_muted ? 0.0f : *m_volume;
+            }
+            auto properties = m_connection->getAll(m_busName);
+            if (!properties)
+                return std::unexpected(properties.error());
+            if (!properties->volume)
+                return std::unexpected(AudioError(ErrorCategory::Unsupported, "Get volume"));
+            std::scoped_lock lock(m_mutex);
+            m_volume = static_cast<float>(*properties->volume);
+            return *m_volume;
+        }
+
+        std::expected<bool, AudioError> MprisVolumeEndpoint::readMute() noexcept {
+            std::scoped_lock lock(m_mutex);
+            return m_muted;
+        }
+
+        std::expected<void, AudioError> MprisVolumeEndpoint::writeVolume(float volume) noexcept {
+            {
+                std::scoped_lock lock(m_mutex);
+                if (m_muted) {
+                    m_unmutedVolume = volume;
+                    return {};
+                }
+            }
+            return m_connection->setVolume(m_busName, volume);
+        }
+
+        std::expected<void, AudioError> MprisVolumeEndpoint::writeMute(bool muted) noexcept {
+            float target = 0.0f;
+            {
+                std::scoped_lock lock(m_mutex);
+                if (m_muted == muted)
+                    return {};
+                if (muted)
+                    m_unmutedVolume = m_volume.value_or(1.0f);
+                else
+                    target = m_unmutedVolume;
+                // Set first, so the player echoing the 0 back is already recognised as our mute.
+                m_muted = muted;
+            }
+            auto written = m_connection->setVolume(m_busName, target);
+            if (!written) {
+                std::scoped_lock lock(m_mutex);
+                m_muted = !muted;
+            }
+            return written;
+        }
+
+        void MprisVolumeEndpoint::report(double volume) {
+            ChangeHandler handler;
+            const float current = static_cast<float>(volume);
+            {
+                std::scoped_lock lock(m_mutex);
+                // The 0 written by writeMute coming back.
+                if (m_muted && current == 0.0f)
+                    return;
+                m_muted = false;
+                m_volume = current;
+                handler = m_onChanged;
+            }
+            if (handler)
+                handler(current, false);
+        }
+
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "VolumeController.h"
+#include "MprisConnection.h"
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace audio {
+    namespace platform {
+
+        // Steers one player's org.mpris.MediaPlayer2.Player.Volume. MPRIS has no mute, so muting
+        // writes 0 and unmuting restores the volume from before; a non-zero volume set from the
+        // player's side ends the mute. The owning session feeds report() from its property mirror.
+        class MprisVolumeEndpoint : public IVolumeEndpoint {
+        public:
+            MprisVolumeEndpoint(std::shared_ptr<MprisConnection> connection, std::string busName);
+
+            std::expected<void, AudioError> open(ChangeHandler onChanged) noexcept override;
+            std::expected<float, AudioError> readVolume() noexcept override;
+            std::expected<bool, AudioError> readMute() noexcept override;
+            std::expected<void, AudioError> writeVolume(float volume) noexcept override;
+            std::expected<void, AudioError> writeMute(bool muted) noexcept override;
+
+            void report(double volume);
+
+        private:
+            std::shared_ptr<MprisConnection> m_connection;
+            const std::string m_busName;
+
+            std::mutex m_mutex;
+            ChangeHandler m_onChanged;
+            std::optional<float> m_volume;
+            bool m_muted{ false };
+            float m_unmutedVolume{ 1.0f };
+        };
+
+    }
+}
@@ -0,0 +1,140 @@
+#include "OperationStats.h"
+#include <algorithm>
+#include <bit>
+
+namespace audio {
+
+    namespace {
+
+        constexpr size_t SubBucketBits = 2;
+        constexpr size_t SubBuckets = size_t{ 1 } << SubBucketBits;
+
+        constexpr const char* OperationNames[StatOperationCount] = {
+            "Initialize", "Get duration", "Get position", "Get title", "Get artist", "Get album",
+            "Get thumbnail", "Get track snapshot", "Play", "Pause", "Next track", "Previous track",
+            "Seek", "Set volume", "Get volume", "Fetch media properties", "Fetch playback info",
+            "Fetch timeline", "Volume endpoint"
+        };
+
+        std::chrono::nanoseconds toNanos(OperationStats::Ticks ticks, double nanosPerTick) noexcept {
+            return std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(ticks) * nanosPerTick));
+        }
+
+    }
+
+    std::chrono::nanoseconds OperationStats::Operation::percentile(double fraction) const noexcept {
+        if (calls == 0)
+            return std::chrono::nanoseconds(0);
+        const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(calls) + 0.999999));
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+            seen += buckets[bucket];
+            if (seen >= rank)
+                return std::min(max, toNanos(bucketUpperBound(bucket), nanosPerTick));
+        }
+        return max;
+    }
+
+    void OperationStats::Stats::merge(const Stats& other) noexcept {
+        for (size_t i = 0; i < operations.size(); ++i) {
+            auto& target = operations[i];
+            const auto& source = other.operations[i];
+            target.calls += source.calls;
+            target.errors += source.errors;
+            target.total += source.total;
+            target.max = std::max(target.max, source.max);
+            for (size_t bucket = 0; bucket < BucketCount; ++bucket)
+                target.buckets[bucket] += source.buckets[bucket];
+        }
+        cacheHits += other.cacheHits;
+        cacheMisses += other.cacheMisses;
+        for (size_t kind = 0; kind < events.size(); ++kind)
+            events[kind] += other.events[kind];
+    }
+
+    OperationStats::OperationStats() noexcept
+        : m_started(std::chrono::steady_clock::now()) {
+        TickClock::calibrate();
+    }
+
+    const char* OperationStats::name(StatOperation operation) noexcept {
+        const auto index = static_cast<size_t>(operation);
+        return index < StatOperationCount ? OperationNames[index] : "Unknown";
+    }
+
+    void OperationStats::traceCall(StatOperation operation, Ticks started, Ticks finished) noexcept {
+        const char* category = operation >= StatOperation::FetchMediaProperties ? "platform" : "api";
+        Tracer::record(category, name(operation), started, finished);
+    }
+
+    OperationStats& OperationStats::platform() noexcept {
+        static OperationStats stats;
+        return stats;
+    }
+
+    // Values below SubBuckets get a bucket each; above, every power of two is split into
+    // SubBuckets equal parts by the bits just below the leading one.
+    size_t OperationStats::bucketFor(Ticks ticks) noexcept {
+        if (ticks < SubBuckets)
+            return static_cast<size_t>(ticks);
+        const auto exponent = static_cast<size_t>(std::bit_width(ticks)) - 1;
+        const auto sub = static_cast<size_t>(ticks >> (exponent - SubBucketBits)) & (SubBuckets - 1);
+        return std::min(BucketCount - 1, (exponent - SubBucketBits + 1) * SubBuckets + sub);
+    }
+
+    uint64_t OperationStats::bucketUpperBound(size_t bucket) noexcept {
+        if (bucket < SubBuckets)
+            return bucket;
+        const auto exponent = bucket / SubBuckets + SubBucketBits - 1;
+        const auto sub = bucket % SubBuckets;
+        const auto width = uint64_t{ 1 } << (exponent - SubBucketBits);
+        return ((SubBuckets + sub) << (exponent - SubBucketBits)) + width - 1;
+    }
+
+    // A call that migrated between cores can read an earlier counter at its end; the unsigned
+    // difference is then huge and lands in the last bucket, so such calls are clamped to zero.
+    void OperationStats::record(StatOperation operation, Ticks elapsed, bool succeeded) noexcept {
+        auto& slot = m_slots[static_cast<size_t>(operation)];
+        if (static_cast<int64_t>(elapsed) < 0)
+            elapsed = 0;
+        slot.buckets[bucketFor(elapsed)].fetch_add(1, std::memory_order_relaxed);
+        slot.total.fetch_add(elapsed, std::memory_order_relaxed);
+        if (!succeeded)
+            slot.errors.fetch_add(1, std::memory_order_relaxed);
+        auto max = slot.max.load(std::memory_order_relaxed);
+        while (elapsed > max && !slot.max.compare_exchange_weak(max, elapsed, std::memory_order_relaxed)) {
+        }
+    }
+
+    void OperationStats::recordEvent(SessionEvent::Kind kind) noexcept {
+        const auto index = static_cast<size_t>(kind);
+        if (index < m_events.size())
+            m_events[index].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Each counter is read on its own, so a snapshot taken while calls are recorded may be off
+    // by the calls in flight.
+    OperationStats::Stats OperationStats::stats() const noexcept {
+        Stats stats;
+        const auto scale = TickClock::nanosPerTick();
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            const auto& slot = m_slots[i];
+            auto& operation = stats.operations[i];
+            operation.nanosPerTick = scale;
+            operation.errors = slot.errors.load(std::memory_order_relaxed);
+            operation.total = toNanos(slot.total.load(std::memory_order_relaxed), scale);
+            operation.max = toNanos(slot.max.load(std::memory_order_relaxed), scale);
+            for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+                operation.buckets[bucket] = slot.buckets[bucket].load(std::memory_order_relaxed);
+                operation.calls += operation.buckets[bucket];
+            }
+        }
+        stats.cacheHits = m_cacheHits.load(std::memory_order_relaxed);
+        stats.cacheMisses = m_cacheMisses.load(std::memory_order_relaxed);
+        for (size_t kind = 0; kind < m_events.size(); ++kind)
+            stats.events[kind] = m_events[kind].load(std::memory_order_relaxed);
+        stats.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_started);
+        return stats;
+    }
+
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include "EventQueue.h"
+#include "TickClock.h"
+#include "Tracer.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+
+namespace audio {
+
+    enum class StatOperation : uint32_t {
+        // Public calls, timed by AudioSessionManager around the active session.
+        Initialize = 0,
+        GetDuration = 1,
+        GetPosition = 2,
+        GetTitle = 3,
+        GetArtist = 4,
+        GetAlbum = 5,
+        GetThumbnail = 6,
+        GetTrackSnapshot = 7,
+        Play = 8,
+        Pause = 9,
+        Next = 10,
+        Previous = 11,
+        Seek = 12,
+        SetVolume = 13,
+        GetVolume = 14,
+        // Calls the backends make into the platform (TryGetMediaPropertiesAsync, MPRIS GetAll,
+        // GetPlaybackInfo, GetTimelineProperties, the volume endpoint's COM or D-Bus calls).
+        FetchMediaProperties = 15,
+        FetchPlaybackInfo = 16,
+        FetchTimeline = 17,
+        VolumeEndpoint = 18
+    };
+
+    inline constexpr size_t StatOperationCount = 19;
+
+    // Always-on counters and latency histograms, one per StatOperation. Recording a call costs
+    // two timestamp reads and two relaxed atomic increments (three if it failed) and never
+    // blocks or allocates; the call count is the sum of the histogram. The histogram has four
+    // buckets per power of two of ticks, so a percentile read from it is at most 25% high.
+    class OperationStats {
+    public:
+        static constexpr size_t BucketCount = 160;
+
+        using Ticks = TickClock::Ticks;
+
+        struct Operation {
+            uint64_t calls{ 0 };
+            uint64_t errors{ 0 };
+            std::chrono::nanoseconds total{ 0 };
+            std::chrono::nanoseconds max{ 0 };
+            // Counts per bucket of ticks, and the scale they were read with.
+            std::array<uint64_t, BucketCount> buckets{};
+            double nanosPerTick{ 1.0 };
+
+            // Upper bound of the bucket holding that fraction of the calls, capped at max.
+            [[nodiscard]] std::chrono::nanoseconds percentile(double fraction) const noexcept;
+        };
+
+        struct Stats {
+            std::array<Operation, StatOperationCount> operations{};
+            // SessionStateCache reads, across every session of the process.
+            uint64_t cacheHits{ 0 };
+            uint64_t cacheMisses{ 0 };
+            // Indexed by SessionEvent::Kind; slot 0 is unused.
+            std::array<uint64_t, 4> events{};
+            // Since the counters started, to turn the counts into rates.
+            std::chrono::nanoseconds elapsed{ 0 };
+
+            [[nodiscard]] const Operation& operator[](StatOperation operation) const noexcept {
+                return operations[static_cast<size_t>(operation)];
+            }
+            // Adds other's counts to these; elapsed and the tick scale are kept, as both were read together.
+            void merge(const Stats& other) noexcept;
+        };
+
+        // Times one call from construction to destruction. It counts as an error if fail() was
+        // called or the scope is left by an exception. Like measure, it also traces the call.
+        class Scope {
+        public:
+            Scope(OperationStats& stats, StatOperation operation) noexcept
+                : m_stats(stats), m_operation(operation), m_exceptions(std::uncaught_exceptions()),
+                m_started(TickClock::now()) {
+            }
+            ~Scope() {
+                const auto finished = TickClock::now();
+                m_stats.record(m_operation, finished - m_started, !m_failed && std::uncaught_exceptions() <= m_exceptions);
+                if (Tracer::enabled())
+                    traceCall(m_operation, m_started, finished);
+            }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            void fail() noexcept { m_failed = true; }
+
+        private:
+            OperationStats& m_stats;
+            const StatOperation m_operation;
+            const int m_exceptions;
+            bool m_failed{ false };
+            const Ticks m_started;
+        };
+
+        OperationStats() noexcept;
+        OperationStats(const OperationStats&) = delete;
+        OperationStats& operator=(const OperationStats&) = delete;
+
+        // Counters for the platform calls, shared by every session in the process as the
+        // platform connection (GSMTC manager, D-Bus connection, audio endpoint) is.
+        [[nodiscard]] static OperationStats& platform() noexcept;
+
+        void record(StatOperation operation, Ticks elapsed, bool succeeded) noexcept;
+        void recordCacheHit() noexcept { m_cacheHits.fetch_add(1, std::memory_order_relaxed); }
+        void recordCacheMiss() noexcept { m_cacheMisses.fetch_add(1, std::memory_order_relaxed); }
+        void recordEvent(SessionEvent::Kind kind) noexcept;
+
+        // Times call(), which returns a std::expected, and counts an error when it holds one.
+        // Cheaper than a Scope, which also watches for exceptions. While the Tracer runs, the
+        // call is recorded as a span too, from the same two timestamps.
+        template <typename Call>
+        auto measure(StatOperation operation, Call&& call) {
+            const auto started = TickClock::now();
+            auto result = call();
+            const auto finished = TickClock::now();
+            record(operation, finished - started, result.has_value());
+            if (Tracer::enabled())
+                traceCall(operation, started, finished);
+            return result;
+        }
+
+        [[nodiscard]] static const char* name(StatOperation operation) noexcept;
+
+        [[nodiscard]] Stats stats() const noexcept;
+
+        [[nodiscard]] static size_t bucketFor(Ticks ticks) noexcept;
+        [[nodiscard]] static uint64_t bucketUpperBound(size_t bucket) noexcept;
+
+    private:
+        static void traceCall(StatOperation operation, Ticks started, Ticks finished) noexcept;
+
+        struct Slot {
+            std::atomic<uint64_t> errors{ 0 };
+            std::atomic<Ticks> total{ 0 };
+            std::atomic<Ticks> max{ 0 };
+            std::array<std::atomic<uint64_t>, BucketCount> buckets{};
+        };
+
+        const std::chrono::steady_clock::time_point m_started;
+        std::array<Slot, StatOperationCount> m_slots{};
+        std::atomic<uint64_t> m_cacheHits{ 0 };
+        std::atomic<uint64_t> m_cacheMisses{ 0 };
+        std::array<std::atomic<uint64_t>, 4> m_events{};
+    };
+
+}
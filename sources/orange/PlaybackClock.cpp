@@ -0,0 +1,31 @@
+#include "PlaybackClock.h"
+#include <algorithm>
+
+namespace audio {
+
+    PlaybackClock::Clock::time_point PlaybackClock::anchorFor(std::chrono::system_clock::time_point lastUpdated,
+        Clock::time_point now) noexcept {
+        // Backends that never report LastUpdatedTime leave it at the epoch; treat those reports as fresh.
+        if (lastUpdated == std::chrono::system_clock::time_point{})
+            return now;
+        auto age = std::chrono::system_clock::now() - lastUpdated;
+        if (age < std::chrono::system_clock::duration::zero())
+            age = std::chrono::system_clock::duration::zero();
+        return now - std::chrono::duration_cast<Clock::duration>(age);
+    }
+
+    std::chrono::milliseconds PlaybackClock::position(const TimelineState& timeline,
+        const std::optional<PlaybackState>& playback, Clock::time_point now) noexcept {
+        auto position = timeline.position;
+        if (playback && playback->status == PlaybackStatus::Playing && now > timeline.anchoredAt) {
+            auto elapsed = std::chrono::duration<double, std::milli>(now - timeline.anchoredAt).count();
+            position += std::chrono::milliseconds(static_cast<int64_t>(elapsed * playback->rate));
+        }
+
+        position = std::max(position, timeline.start);
+        if (timeline.end > timeline.start)
+            position = std::min(position, timeline.end);
+        return position;
+    }
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "SessionStateCache.h"
+#include <chrono>
+#include <optional>
+
+namespace audio {
+
+    // Turns the last reported timeline into a live position without asking the backend again.
+    // A timeline report is pinned to the monotonic clock once, when it is published; reads then
+    // advance it by the elapsed steady time scaled by the playback rate while playing.
+    class PlaybackClock {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        [[nodiscard]] static Clock::time_point anchorFor(std::chrono::system_clock::time_point lastUpdated,
+            Clock::time_point now = Clock::now()) noexcept;
+
+        [[nodiscard]] static std::chrono::milliseconds position(const TimelineState& timeline,
+            const std::optional<PlaybackState>& playback, Clock::time_point now = Clock::now()) noexcept;
+    };
+
+}
@@ -0,0 +1,133 @@
+#include "PlaybackEvents.h"
+#include <utility>
+
+namespace audio {
+
+    uint32_t PlaybackDiffer::changedFields(const PlaybackState& before, const PlaybackState& after) noexcept {
+        uint32_t changed = 0;
+        if (before.status != after.status)
+            changed |= static_cast<uint32_t>(PlaybackEvent::Field::Status);
+        if (before.rate != after.rate)
+            changed |= static_cast<uint32_t>(PlaybackEvent::Field::Rate);
+        if (before.shuffle != after.shuffle)
+            changed |= static_cast<uint32_t>(PlaybackEvent::Field::Shuffle);
+        if (before.repeat != after.repeat)
+            changed |= static_cast<uint32_t>(PlaybackEvent::Field::Repeat);
+        if (before.controls != after.controls)
+            changed |= static_cast<uint32_t>(PlaybackEvent::Field::Controls);
+        return changed;
+    }
+
+    std::optional<PlaybackEvent> PlaybackDiffer::update(const PlaybackState& state) {
+        std::scoped_lock lock(m_mutex);
+        const uint32_t changed = changedFields(m_last, state);
+        if (changed == 0)
+            return std::nullopt;
+        PlaybackEvent event{ m_last, state, changed };
+        m_last = state;
+        return event;
+    }
+
+    void PlaybackDiffer::reset(const PlaybackState& baseline) {
+        std::scoped_lock lock(m_mutex);
+        m_last = baseline;
+    }
+
+    PlaybackDebouncer::PlaybackDebouncer(Deliver deliver, std::chrono::milliseconds window)
+        : m_deliver(std::move(deliver)),
+        m_window(window),
+        m_worker([this] { run(); }) {
+    }
+
+    PlaybackDebouncer::~PlaybackDebouncer() {
+        stop();
+    }
+
+    void PlaybackDebouncer::stop() {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopping = true;
+            m_pending.reset();
+        }
+        m_wake.notify_all();
+        if (m_worker.joinable())
+            m_worker.join();
+    }
+
+    void PlaybackDebouncer::submit(const PlaybackEvent& event) {
+        m_received.fetch_add(1, std::memory_order_relaxed);
+        bool deferred = false;
+        {
+            std::scoped_lock lock(m_mutex);
+            if (m_stopping)
+                return;
+            if (m_pending) {
+                m_pending->current = event.current;
+                m_pending->changed = PlaybackDiffer::changedFields(m_pending->previous, m_pending->current);
+                m_collapsed.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (m_window.count() > 0) {
+                m_pending = event;
+                m_due = Clock::now() + m_window;
+                deferred = true;
+            }
+        }
+        if (deferred)
+            m_wake.notify_one();
+        else
+            deliver(event);
+    }
+
+    void PlaybackDebouncer::setWindow(std::chrono::milliseconds window) {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_window = window;
+            if (window.count() <= 0 && m_pending)
+                m_due = Clock::now();
+        }
+        m_wake.notify_one();
+    }
+
+    std::chrono::milliseconds PlaybackDebouncer::window() const {
+        std::scoped_lock lock(m_mutex);
+        return m_window;
+    }
+
+    PlaybackDebouncer::Stats PlaybackDebouncer::stats() const noexcept {
+        Stats stats;
+        stats.received = m_received.load(std::memory_order_relaxed);
+        stats.delivered = m_delivered.load(std::memory_order_relaxed);
+        stats.collapsed = m_collapsed.load(std::memory_order_relaxed);
+        stats.cancelled = m_cancelled.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void PlaybackDebouncer::run() {
+        std::unique_lock lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [this] { return m_stopping || m_pending; });
+            // m_due is read again on every wake, so setWindow(0) can cut a window short.
+            while (!m_stopping && m_pending && Clock::now() < m_due)
+                m_wake.wait_until(lock, m_due);
+            if (m_stopping)
+                return;
+
+            PlaybackEvent event = *m_pending;
+            m_pending.reset();
+            lock.unlock();
+            if (event.changed != 0)
+                deliver(event);
+            else
+                m_cancelled.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+        }
+    }
+
+    void PlaybackDebouncer::deliver(const PlaybackEvent& event) {
+        m_delivered.fetch_add(1, std::memory_order_relaxed);
+        if (m_deliver)
+            m_deliver(event);
+    }
+
+}
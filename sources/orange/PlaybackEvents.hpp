@@ -0,0 +1,87 @@
+#pragma once
+#include "IAudioSession.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <cstdint>
+
+namespace audio {
+
+    // Remembers the last playback state a session reported and turns each new report into a
+    // PlaybackEvent naming the fields that changed. Players fire PlaybackInfoChanged for plenty
+    // of updates that change none of the fields we expose; those yield nothing. Safe to call
+    // from several event threads at once.
+    class PlaybackDiffer {
+    public:
+        [[nodiscard]] static uint32_t changedFields(const PlaybackState& before, const PlaybackState& after) noexcept;
+
+        std::optional<PlaybackEvent> update(const PlaybackState& state);
+        // Makes baseline the last known state without reporting it, e.g. when a session is primed.
+        void reset(const PlaybackState& baseline = {});
+
+    private:
+        std::mutex m_mutex;
+        PlaybackState m_last;
+    };
+
+    // Optionally collapses bursts of playback events. With a zero window (the default) events are
+    // delivered at once on the submitting thread. Otherwise the first event of a burst opens the
+    // window, later ones only move its end state, and when the window closes a single event from
+    // the state before the burst to the state after it is delivered on the debouncer's thread;
+    // a burst that ends where it started (play, pause, play) delivers nothing. The window is
+    // fixed from the first event, so a steady stream of changes is still reported once per window.
+    class PlaybackDebouncer {
+    public:
+        using Deliver = std::function<void(const PlaybackEvent&)>;
+
+        struct Stats {
+            uint64_t received{ 0 };
+            uint64_t delivered{ 0 };
+            // Events folded into another one of the same burst.
+            uint64_t collapsed{ 0 };
+            // Bursts that added up to no change.
+            uint64_t cancelled{ 0 };
+        };
+
+        explicit PlaybackDebouncer(Deliver deliver, std::chrono::milliseconds window = std::chrono::milliseconds(0));
+        ~PlaybackDebouncer();
+        PlaybackDebouncer(const PlaybackDebouncer&) = delete;
+        PlaybackDebouncer& operator=(const PlaybackDebouncer&) = delete;
+
+        void submit(const PlaybackEvent& event);
+        // Takes effect for the next burst; shrinking it to zero flushes a pending burst right away.
+        void setWindow(std::chrono::milliseconds window);
+        [[nodiscard]] std::chrono::milliseconds window() const;
+        // Joins the worker; a pending burst is discarded and later events are ignored.
+        void stop();
+
+        [[nodiscard]] Stats stats() const noexcept;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        void run();
+        void deliver(const PlaybackEvent& event);
+
+        Deliver m_deliver;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::chrono::milliseconds m_window;
+        std::optional<PlaybackEvent> m_pending;
+        Clock::time_point m_due{};
+        bool m_stopping{ false };
+
+        std::atomic<uint64_t> m_received{ 0 };
+        std::atomic<uint64_t> m_delivered{ 0 };
+        std::atomic<uint64_t> m_collapsed{ 0 };
+        std::atomic<uint64_t> m_cancelled{ 0 };
+
+        std::thread m_worker;
+    };
+
+}
@@ -0,0 +1,302 @@
+#include "PositionTicker.h"
+#include "PlaybackClock.h"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <utility>
+
+namespace audio {
+
+    namespace {
+
+        struct Reading {
+            PositionTicker::Tick tick;
+            double rate{ 1.0 };
+        };
+
+        // Until the position next crosses a multiple of interval, in steady time. A boundary
+        // closer than one slot is skipped, as it is the one just ticked seen from a new sample.
+        std::chrono::milliseconds untilBoundary(const Reading& reading, std::chrono::milliseconds interval) noexcept {
+            if (!(reading.rate > 0.0))
+                return interval;
+            auto remaining = interval - reading.tick.position % interval;
+            auto wait = std::chrono::milliseconds(static_cast<int64_t>(std::ceil(static_cast<double>(remaining.count()) / reading.rate)));
+            if (wait < PositionTicker::Resolution)
+                wait += std::chrono::milliseconds(static_cast<int64_t>(std::ceil(static_cast<double>(interval.count()) / reading.rate)));
+            return wait;
+        }
+
+    }
+
+    class PositionTicker::Source {
+    public:
+        explicit Source(Sampler sampler) : m_sampler(std::move(sampler)) {}
+
+        // Extrapolated to now from the last sample, sampling first when that is stale. Empty
+        // when sampling fails or the source has been removed.
+        std::optional<Reading> read(Clock::time_point now, PositionTicker& ticker) {
+            std::scoped_lock lock(m_mutex);
+            if (!m_sampler)
+                return std::nullopt;
+            const auto generation = m_generation.load(std::memory_order_acquire);
+            if (!m_sample || generation != m_sampledGeneration || now - m_sample->timeline.anchoredAt >= ResyncInterval) {
+                auto sample = m_sampler();
+                ticker.m_samples.fetch_add(1, std::memory_order_relaxed);
+                if (!sample) {
+                    ticker.m_sampleFailures.fetch_add(1, std::memory_order_relaxed);
+                    m_sample.reset();
+                    return std::nullopt;
+                }
+                sample->timeline.anchoredAt = Clock::now();
+                m_sample = *sample;
+                m_sampledGeneration = generation;
+            }
+            Reading reading;
+            reading.tick.position = PlaybackClock::position(m_sample->timeline, m_sample->playback, now);
+            reading.tick.duration = m_sample->timeline.end;
+            reading.tick.status = m_sample->playback.status;
+            reading.rate = m_sample->playback.rate;
+            return reading;
+        }
+
+        void markStale() noexcept { m_generation.fetch_add(1, std::memory_order_acq_rel); }
+        [[nodiscard]] uint64_t generation() const noexcept { return m_generation.load(std::memory_order_acquire); }
+
+        // Waits for a sample in progress.
+        void detach() {
+            std::scoped_lock lock(m_mutex);
+            m_sampler = nullptr;
+        }
+
+    private:
+        std::mutex m_mutex;
+        Sampler m_sampler;
+        std::optional<Sample> m_sample;
+        uint64_t m_sampledGeneration{ 0 };
+        std::atomic<uint64_t> m_generation{ 0 };
+    };
+
+    PositionTicker& PositionTicker::shared() {
+        // Leaked: the timer thread may still be running when statics are destroyed.
+        static auto* const instance = new PositionTicker;
+        return *instance;
+    }
+
+    std::shared_ptr<PositionTicker::Source> PositionTicker::addSource(Sampler sampler) {
+        auto source = std::make_shared<Source>(std::move(sampler));
+        std::scoped_lock lock(m_mutex);
+        ++m_sources;
+        return source;
+    }
+
+    void PositionTicker::removeSource(const std::shared_ptr<Source>& source) {
+        if (!source)
+            return;
+        std::thread::id worker;
+        {
+            std::scoped_lock lock(m_mutex);
+            for (auto it = m_subscriptions.begin(); it != m_subscriptions.end();) {
+                if (it->second.source == source) {
+                    if (!it->second.parked)
+                        --m_armed;
+                    it = m_subscriptions.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+            --m_sources;
+            worker = m_workerId;
+        }
+        source->detach();
+        if (std::this_thread::get_id() != worker) {
+            std::scoped_lock wait(m_delivering);
+        }
+    }
+
+    // The stale mark comes first: a subscriber being delivered to meanwhile sees it when the
+    // turn ends and is re-armed instead of parked.
+    void PositionTicker::resync(const std::shared_ptr<Source>& source) {
+        if (!source)
+            return;
+        source->markStale();
+        bool woken = false;
+        {
+            std::scoped_lock lock(m_mutex);
+            const auto now = turnAt(Clock::now());
+            for (auto& [id, subscription] : m_subscriptions) {
+                if (subscription.source != source || !subscription.parked)
+                    continue;
+                arm(id, subscription, now);
+                subscription.parked = false;
+                ++m_armed;
+                woken = true;
+            }
+        }
+        if (woken)
+            m_wake.notify_one();
+    }
+
+    PositionTicker::SubscriptionId PositionTicker::subscribe(const std::shared_ptr<Source>& source, std::chrono::milliseconds interval, Callback callback) {
+        if (!source || !callback || interval < Resolution)
+            return 0;
+        SubscriptionId id = 0;
+        {
+            std::scoped_lock lock(m_mutex);
+            if (!m_worker.joinable()) {
+                m_origin = Clock::now();
+                m_worker = std::thread([this] { run(); });
+                m_workerId = m_worker.get_id();
+            }
+            id = m_nextId++;
+            auto& subscription = m_subscriptions[id];
+            subscription.source = source;
+            subscription.interval = interval;
+            subscription.callback = std::make_shared<const Callback>(std::move(callback));
+            arm(id, subscription, turnAt(Clock::now()));
+            ++m_armed;
+        }
+        m_wake.notify_one();
+        return id;
+    }
+
+    bool PositionTicker::unsubscribe(const std::shared_ptr<Source>& source, SubscriptionId id) {
+        if (!source)
+            return false;
+        std::thread::id worker;
+        {
+            std::scoped_lock lock(m_mutex);
+            auto it = m_subscriptions.find(id);
+            if (it == m_subscriptions.end() || it->second.source != source)
+                return false;
+            if (!it->second.parked)
+                --m_armed;
+            m_subscriptions.erase(it);
+            worker = m_workerId;
+        }
+        if (std::this_thread::get_id() != worker) {
+            std::scoped_lock wait(m_delivering);
+        }
+        return true;
+    }
+
+    PositionTicker::Stats PositionTicker::stats() const noexcept {
+        Stats stats;
+        {
+            std::scoped_lock lock(m_mutex);
+            stats.sources = m_sources;
+            stats.subscribers = m_subscriptions.size();
+            stats.parked = m_subscriptions.size() - m_armed;
+        }
+        stats.ticks = m_ticks.load(std::memory_order_relaxed);
+        stats.samples = m_samples.load(std::memory_order_relaxed);
+        stats.sampleFailures = m_sampleFailures.load(std::memory_order_relaxed);
+        stats.turns = m_turns.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    uint64_t PositionTicker::turnAt(Clock::time_point time) const noexcept {
+        if (time <= m_origin)
+            return 0;
+        return static_cast<uint64_t>((time - m_origin + Resolution - Clock::duration(1)) / Resolution);
+    }
+
+    PositionTicker::Clock::time_point PositionTicker::timeOf(uint64_t turn) const noexcept {
+        return m_origin + Resolution * static_cast<int64_t>(turn);
+    }
+
+    // While nothing was armed the worker did not advance, so the wheel is first brought up to
+    // the present; nothing sits in a slot then, so skipping turns loses nothing.
+    void PositionTicker::arm(SubscriptionId id, Subscription& subscription, uint64_t turn) {
+        if (m_armed == 0) {
+            const auto present = turnAt(Clock::now());
+            m_turn = std::max(m_turn, present == 0 ? 0 : present - 1);
+        }
+        subscription.dueTurn = std::max(turn, m_turn + 1);
+        m_slots[subscription.dueTurn % SlotCount].push_back({ id, ++subscription.arming });
+        ++m_arms;
+    }
+
+    uint64_t PositionTicker::nextTurn() const noexcept {
+        for (auto turn = m_turn + 1; turn <= m_turn + SlotCount; ++turn) {
+            if (!m_slots[turn % SlotCount].empty())
+                return turn;
+        }
+        return m_turn + SlotCount;
+    }
+
+    // A slot holds every subscription due on a turn congruent to it; those due on a later lap
+    // stay put. The worker sleeps until the next occupied slot rather than visiting every one,
+    // and starts over when something is armed meanwhile. Slow callbacks only delay the turns
+    // after them.
+    // A subscriber that found its source paused, or could not sample it, is parked unless the
+    // source was resynced while it was being served.
+    void PositionTicker::run() {
+        std::vector<Due> due;
+        std::vector<std::optional<Reading>> readings;
+        std::vector<uint64_t> generations;
+        std::unique_lock lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [&] { return m_armed > 0; });
+            const auto next = nextTurn();
+            const auto arms = m_arms;
+            if (m_wake.wait_until(lock, timeOf(next), [&] { return m_armed == 0 || m_arms != arms; }))
+                continue;
+            m_turn = next;
+            m_turns.fetch_add(1, std::memory_order_relaxed);
+
+            auto& slot = m_slots[m_turn % SlotCount];
+            due.clear();
+            for (size_t i = 0; i < slot.size();) {
+                const auto entry = slot[i];
+                auto it = m_subscriptions.find(entry.id);
+                const bool current = it != m_subscriptions.end() && it->second.arming == entry.arming && !it->second.parked;
+                if (current && it->second.dueTurn > m_turn) {
+                    ++i;
+                    continue;
+                }
+                if (current)
+                    due.push_back({ entry.id, entry.arming, it->second.source, it->second.callback, it->second.interval });
+                slot[i] = slot.back();
+                slot.pop_back();
+            }
+            if (due.empty())
+                continue;
+
+            // Taken before m_mutex is let go, so an unsubscribe that finds the subscription
+            // erased after this point also finds this turn to wait for.
+            std::unique_lock delivering(m_delivering);
+            lock.unlock();
+            readings.assign(due.size(), std::nullopt);
+            generations.resize(due.size());
+            const auto sampledAt = Clock::now();
+            for (size_t i = 0; i < due.size(); ++i) {
+                generations[i] = due[i].source->generation();
+                readings[i] = due[i].source->read(sampledAt, *this);
+                if (!readings[i])
+                    continue;
+                (*due[i].callback)(readings[i]->tick);
+                m_ticks.fetch_add(1, std::memory_order_relaxed);
+            }
+            delivering.unlock();
+            lock.lock();
+
+            const auto now = Clock::now();
+            for (size_t i = 0; i < due.size(); ++i) {
+                auto it = m_subscriptions.find(due[i].id);
+                if (it == m_subscriptions.end() || it->second.arming != due[i].arming)
+                    continue;
+                const auto& reading = readings[i];
+                if (reading && reading->tick.status == PlaybackStatus::Playing)
+                    arm(due[i].id, it->second, turnAt(now + untilBoundary(*reading, due[i].interval)));
+                else if (due[i].source->generation() != generations[i])
+                    arm(due[i].id, it->second, turnAt(now));
+                else {
+                    it->second.parked = true;
+                    --m_armed;
+                }
+            }
+        }
+    }
+
+}
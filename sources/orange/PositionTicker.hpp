@@ -0,0 +1,150 @@
+#pragma once
+#include "AudioError.h"
+#include "SessionStateCache.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace audio {
+
+    // One timer thread for every position subscriber in the process. Each source (a manager)
+    // is sampled at most once per ResyncInterval, or sooner once it is marked stale, and ticks
+    // in between are extrapolated from that sample with PlaybackClock, so the backend sees the
+    // same few calls however many subscribers there are. Ticks fall where the position crosses
+    // a multiple of the interval, which keeps subscribers with the same interval in step and
+    // lets a m:ss display change on the second.
+    //
+    // A subscriber whose source is not playing gets one tick with the frozen position and is
+    // then parked; resync() re-arms it. The thread only wakes for a slot that holds something
+    // and waits without a timeout while nothing is armed. Callbacks run on that thread, one at
+    // a time, and should return quickly.
+    class PositionTicker {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using SubscriptionId = uint64_t;
+
+        struct Tick {
+            std::chrono::milliseconds position{ 0 };
+            // Zero when the session does not report one.
+            std::chrono::milliseconds duration{ 0 };
+            PlaybackStatus status{ PlaybackStatus::Closed };
+        };
+        using Callback = std::function<void(const Tick&)>;
+
+        // The session's timeline and playback state as of the sampling call; anchoredAt is
+        // filled in by the ticker.
+        struct Sample {
+            TimelineState timeline;
+            PlaybackState playback;
+        };
+        using Sampler = std::function<std::expected<Sample, AudioError>()>;
+
+        class Source;
+
+        struct Stats {
+            uint64_t sources{ 0 };
+            uint64_t subscribers{ 0 };
+            // Subscribers waiting for their source to play again.
+            uint64_t parked{ 0 };
+            uint64_t ticks{ 0 };
+            uint64_t samples{ 0 };
+            uint64_t sampleFailures{ 0 };
+            // Wake-ups of the timer thread; no growth while idle shows it is asleep.
+            uint64_t turns{ 0 };
+        };
+
+        static constexpr std::chrono::milliseconds Resolution{ 10 };
+        static constexpr size_t SlotCount = 256;
+        static constexpr std::chrono::milliseconds ResyncInterval{ 1000 };
+
+        // Started on the first subscription and never stopped.
+        [[nodiscard]] static PositionTicker& shared();
+
+        PositionTicker(const PositionTicker&) = delete;
+        PositionTicker& operator=(const PositionTicker&) = delete;
+
+        [[nodiscard]] std::shared_ptr<Source> addSource(Sampler sampler);
+        // Drops the source's subscriptions. Once it returns the sampler and those callbacks are
+        // not running and will not run again, unless it was called from one of them.
+        void removeSource(const std::shared_ptr<Source>& source);
+        // Marks the source's sample stale and re-arms its parked subscribers, for playback,
+        // track and session changes.
+        void resync(const std::shared_ptr<Source>& source);
+
+        // The first tick comes at once. Returns 0 for an empty callback or an interval below
+        // Resolution.
+        SubscriptionId subscribe(const std::shared_ptr<Source>& source, std::chrono::milliseconds interval, Callback callback);
+        // False unless id is subscribed to source, so one manager cannot cancel another's
+        // subscription with an id it was never given. Once it returns true the callback is not
+        // running and will not run again, unless it was called from a callback.
+        bool unsubscribe(const std::shared_ptr<Source>& source, SubscriptionId id);
+
+        [[nodiscard]] Stats stats() const noexcept;
+
+    private:
+        struct Subscription {
+            std::shared_ptr<Source> source;
+            std::chrono::milliseconds interval;
+            std::shared_ptr<const Callback> callback;
+            uint64_t dueTurn{ 0 };
+            // Bumped on every arm, so a slot entry left behind by an earlier arm is ignored.
+            uint64_t arming{ 0 };
+            bool parked{ false };
+        };
+
+        struct SlotEntry {
+            SubscriptionId id;
+            uint64_t arming;
+        };
+
+        struct Due {
+            SubscriptionId id;
+            uint64_t arming;
+            std::shared_ptr<Source> source;
+            std::shared_ptr<const Callback> callback;
+            std::chrono::milliseconds interval;
+        };
+
+        PositionTicker() = default;
+
+        void run();
+        // Called with m_mutex held.
+        void arm(SubscriptionId id, Subscription& subscription, uint64_t turn);
+        // The first turn after the current one whose slot holds anything, or a lap ahead.
+        [[nodiscard]] uint64_t nextTurn() const noexcept;
+        [[nodiscard]] uint64_t turnAt(Clock::time_point time) const noexcept;
+        [[nodiscard]] Clock::time_point timeOf(uint64_t turn) const noexcept;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::unordered_map<SubscriptionId, Subscription> m_subscriptions;
+        std::array<std::vector<SlotEntry>, SlotCount> m_slots;
+        SubscriptionId m_nextId{ 1 };
+        size_t m_armed{ 0 };
+        size_t m_sources{ 0 };
+        Clock::time_point m_origin{};
+        uint64_t m_turn{ 0 };
+        // Bumped by arm(), so a sleeping worker recomputes the turn it waits for.
+        uint64_t m_arms{ 0 };
+
+        // Held while a turn samples and delivers, so removeSource and unsubscribe can wait for it.
+        std::mutex m_delivering;
+        std::thread::id m_workerId;
+        std::thread m_worker;
+
+        std::atomic<uint64_t> m_ticks{ 0 };
+        std::atomic<uint64_t> m_samples{ 0 };
+        std::atomic<uint64_t> m_sampleFailures{ 0 };
+        std::atomic<uint64_t> m_turns{ 0 };
+    };
+
+}
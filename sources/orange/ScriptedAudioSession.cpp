@@ -0,0 +1,413 @@
+#include "ScriptedAudioSession.h"
+#include "PlaybackClock.h"
+#include <utility>
+
+namespace audio {
+    namespace platform {
+
+        ScriptedAudioSession::ScriptedAudioSession()
+            : ScriptedAudioSession(std::make_shared<ThumbnailCache>()) {
+        }
+
+        ScriptedAudioSession::ScriptedAudioSession(std::shared_ptr<ThumbnailCache> thumbnails)
+            : ScriptedAudioSession(std::make_unique<FakeVolumeEndpoint>(), std::move(thumbnails)) {
+        }
+
+        ScriptedAudioSession::ScriptedAudioSession(std::unique_ptr<FakeVolumeEndpoint> volumeEndpoint, std::shared_ptr<ThumbnailCache> thumbnails)
+            : m_volumeEndpoint(volumeEndpoint.get()),
+            m_volume(std::move(volumeEndpoint)),
+            m_thumbnails(std::move(thumbnails)),
+            m_trackWatcher([this] { return fetchMediaForWatcher(); }, [this](const MediaInfo& media) { deliverTrackChanged(media); }) {
+        }
+
+        std::expected<void, AudioError> ScriptedAudioSession::initialize() noexcept {
+            m_cache.clear();
+            {
+                std::scoped_lock lock(m_source.mutex);
+                m_playbackDiff.reset(m_source.playback.value_or(PlaybackState{}));
+                m_trackWatcher.reset(m_source.media);
+            }
+            m_initialized.store(true, std::memory_order_release);
+            return {};
+        }
+
+        void ScriptedAudioSession::setMediaProperties(MediaInfo media) {
+            std::scoped_lock lock(m_source.mutex);
+            m_source.media = std::move(media);
+        }
+
+        void ScriptedAudioSession::setPlaybackInfo(PlaybackState playback) {
+            std::scoped_lock lock(m_source.mutex);
+            m_source.playback = playback;
+        }
+
+        void ScriptedAudioSession::setTimeline(TimelineState timeline) {
+            std::scoped_lock lock(m_source.mutex);
+            m_source.timeline = timeline;
+        }
+
+        void ScriptedAudioSession::setThumbnail(std::vector<uint8_t> bytes) {
+            std::scoped_lock lock(m_source.mutex);
+            m_source.thumbnail = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+        }
+
+        void ScriptedAudioSession::emitMediaPropertiesChanged(MediaInfo media) {
+            setMediaProperties(media);
+            m_cache.publishMedia(std::move(media));
+            m_trackWatcher.notify();
+        }
+
+        // Reads the source directly, like the WinRT backend's fetch after a MediaPropertiesChanged;
+        // not counted in fetchCount(), which only tracks cache misses.
+        std::expected<MediaInfo, AudioError> ScriptedAudioSession::fetchMediaForWatcher() const {
+            std::scoped_lock lock(m_source.mutex);
+            if (!m_source.media)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "Fetch media properties"));
+            return *m_source.media;
+        }
+
+        void ScriptedAudioSession::deliverTrackChanged(const MediaInfo& media) {
+            TrackChangedCallback callback;
+            {
+                std::scoped_lock lock(m_callbackMutex);
+                callback = m_trackChanged;
+            }
+            if (callback)
+                callback(media.title, media.artist);
+        }
+
+        void ScriptedAudioSession::emitPlaybackInfoChanged(PlaybackState playback) {
+            setPlaybackInfo(playback);
+            m_cache.publishPlayback(playback);
+
+            auto event = m_playbackDiff.update(playback);
+            if (!event)
+                return;
+            PlaybackChangedCallback changed;
+            PlaybackEventCallback typed;
+            {
+                std::scoped_lock lock(m_callbackMutex);
+                changed = m_playbackChanged;
+                typed = m_playbackEvent;
+            }
+            if (typed)
+                typed(*event);
+            if (changed)
+                changed("Playback info updated");
+        }
+
+        void ScriptedAudioSession::emitTimelinePropertiesChanged(TimelineState timeline) {
+            setTimeline(timeline);
+            m_cache.publishTimeline(timeline);
+        }
+
+        std::expected<std::shared_ptr<const SessionState>, AudioError> ScriptedAudioSession::mediaState() const noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Get media properties"));
+            auto state = m_cache.load();
+            if (state->media) {
+                m_cache.recordHit();
+                return state;
+            }
+            m_cache.recordMiss();
+            m_fetches.fetch_add(1, std::memory_order_relaxed);
+            std::optional<MediaInfo> media;
+            {
+                std::scoped_lock lock(m_source.mutex);
+                media = m_source.media;
+            }
+            if (!media)
+                return std::unexpected(AudioError(ErrorCategory::NotFound, "Get media properties"));
+            m_cache.publishMedia(std::move(*media));
+            return m_cache.load();
+        }
+
+        std::expected<std::shared_ptr<const SessionState>, AudioError> ScriptedAudioSession::playbackState() const noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Get playback info"));
+            auto state = m_cache.load();
+            if (state->playback) {
+                m_cache.recordHit();
+                return state;
+            }
+            m_cache.recordMiss();
+            m_fetches.fetch_add(1, std::memory_order_relaxed);
+            std::optional<PlaybackState> playback;
+            {
+                std::scoped_lock lock(m_source.mutex);
+                playback = m_source.playback;
+            }
+            if (!playback)
+                return std::unexpected(AudioError(ErrorCategory::NotFound, "Get playback info"));
+            m_cache.publishPlayback(*playback);
+            return m_cache.load();
+        }
+
+        std::expected<std::shared_ptr<const SessionState>, AudioError> ScriptedAudioSession::timelineState() const noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Get timeline"));
+            auto state = m_cache.load();
+            if (state->timeline) {
+                m_cache.recordHit();
+                return state;
+            }
+            m_cache.recordMiss();
+            m_fetches.fetch_add(1, std::memory_order_relaxed);
+            std::optional<TimelineState> timeline;
+            {
+                std::scoped_lock lock(m_source.mutex);
+                timeline = m_source.timeline;
+            }
+            if (!timeline)
+                return std::unexpected(AudioError(ErrorCategory::NotFound, "Get timeline"));
+            m_cache.publishTimeline(*timeline);
+            return m_cache.load();
+        }
+
+        std::expected<std::chrono::seconds, AudioError> ScriptedAudioSession::getDuration() noexcept {
+            auto state = timelineState();
+            if (!state)
+                return std::unexpected(state.error());
+            const auto& timeline = *(*state)->timeline;
+            return std::chrono::duration_cast<std::chrono::seconds>(timeline.end - timeline.start);
+        }
+
+        std::expected<std::chrono::seconds, AudioError> ScriptedAudioSession::getCurrentPosition() noexcept {
+            auto position = getCurrentPositionPrecise();
+            if (!position)
+                return std::unexpected(position.error());
+            return std::chrono::duration_cast<std::chrono::seconds>(*position);
+        }
+
+        std::expected<std::chrono::milliseconds, AudioError> ScriptedAudioSession::getCurrentPositionPrecise() noexcept {
+            if (auto timeline = timelineState(); !timeline)
+                return std::unexpected(timeline.error());
+            auto state = playbackState();
+            if (!state)
+                return std::unexpected(state.error());
+            if (!(*state)->timeline)
+                return std::unexpected(AudioError(ErrorCategory::Interrupted, "Get position"));
+            return PlaybackClock::position(*(*state)->timeline, (*state)->playback);
+        }
+
+        std::expected<std::string, AudioError> ScriptedAudioSession::getTitle() const noexcept {
+            auto state = mediaState();
+            if (!state)
+                return std::unexpected(state.error());
+            return (*state)->media->title;
+        }
+
+        std::expected<std::string, AudioError> ScriptedAudioSession::getArtist() const noexcept {
+            auto state = mediaState();
+            if (!state)
+                return std::unexpected(state.error());
+            return (*state)->media->artist;
+        }
+
+        std::expected<std::string, AudioError> ScriptedAudioSession::getAlbum() const noexcept {
+            auto state = mediaState();
+            if (!state)
+                return std::unexpected(state.error());
+            return (*state)->media->album;
+        }
+
+        std::expected<std::string_view, AudioError> ScriptedAudioSession::getText(MediaText field, StringPool& pool) const noexcept {
+            auto state = mediaState();
+            if (!state)
+                return std::unexpected(state.error());
+            return pool.intern((*state)->media->text(field));
+        }
+
+        std::expected<std::span<const uint8_t>, AudioError> ScriptedAudioSession::getThumbnailBytes() noexcept {
+            auto thumbnail = getThumbnail();
+            if (!thumbnail)
+                return std::unexpected(thumbnail.error());
+            return std::span<const uint8_t>((*thumbnail)->data(), (*thumbnail)->size());
+        }
+
+        std::expected<ThumbnailCache::Buffer, AudioError> ScriptedAudioSession::getThumbnail() noexcept {
+            auto state = mediaState();
+            if (!state)
+                return std::unexpected(state.error());
+            std::shared_ptr<const std::vector<uint8_t>> reference;
+            {
+                std::scoped_lock lock(m_source.mutex);
+                reference = m_source.thumbnail;
+            }
+            if (!reference || reference->empty())
+                return std::unexpected(AudioError(ErrorCategory::NotFound, "Get thumbnail"));
+            try {
+                auto buffer = m_thumbnails->find(reference.get());
+                if (!buffer) {
+                    m_fetches.fetch_add(1, std::memory_order_relaxed);
+                    buffer = m_thumbnails->insert(reference.get(), reference, *reference);
+                }
+                std::scoped_lock lock(m_source.mutex);
+                m_source.servedThumbnail = buffer;
+                return buffer;
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Get thumbnail", ex));
+            }
+        }
+
+        std::expected<TrackSnapshot, AudioError> ScriptedAudioSession::getTrackSnapshot() noexcept {
+            if (auto timeline = timelineState(); !timeline)
+                return std::unexpected(timeline.error());
+            if (auto playback = playbackState(); !playback)
+                return std::unexpected(playback.error());
+            auto state = mediaState();
+            if (!state)
+                return std::unexpected(state.error());
+            if (!(*state)->timeline || !(*state)->playback)
+                return std::unexpected(AudioError(ErrorCategory::Interrupted, "Get track snapshot"));
+
+            const SessionState& current = **state;
+            TrackSnapshot snapshot;
+            snapshot.title = current.media->title;
+            snapshot.artist = current.media->artist;
+            snapshot.album = current.media->album;
+            snapshot.albumArtist = current.media->albumArtist;
+            snapshot.trackNumber = current.media->trackNumber;
+            snapshot.duration = std::chrono::duration_cast<std::chrono::seconds>(current.timeline->end - current.timeline->start);
+            snapshot.position = std::chrono::duration_cast<std::chrono::seconds>(PlaybackClock::position(*current.timeline, current.playback));
+            snapshot.status = current.playback->status;
+            snapshot.thumbnailHandle = current.media->thumbnailHandle;
+            return snapshot;
+        }
+
+        std::expected<void, AudioError> ScriptedAudioSession::play() noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Play"));
+            PlaybackState playback;
+            {
+                std::scoped_lock lock(m_source.mutex);
+                playback = m_source.playback.value_or(PlaybackState{});
+            }
+            playback.status = PlaybackStatus::Playing;
+            emitPlaybackInfoChanged(playback);
+            return {};
+        }
+
+        std::expected<void, AudioError> ScriptedAudioSession::pause() noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Pause"));
+            PlaybackState playback;
+            {
+                std::scoped_lock lock(m_source.mutex);
+                playback = m_source.playback.value_or(PlaybackState{});
+            }
+            playback.status = PlaybackStatus::Paused;
+            emitPlaybackInfoChanged(playback);
+            return {};
+        }
+
+        std::expected<void, AudioError> ScriptedAudioSession::next() noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Next track"));
+            return {};
+        }
+
+        std::expected<void, AudioError> ScriptedAudioSession::previous() noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Previous track"));
+            return {};
+        }
+
+        std::expected<void, AudioError> ScriptedAudioSession::seek(std::chrono::seconds position) noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Seek"));
+            TimelineState timeline;
+            {
+                std::scoped_lock lock(m_source.mutex);
+                timeline = m_source.timeline.value_or(TimelineState{});
+            }
+            timeline.position = position;
+            timeline.lastUpdated = std::chrono::system_clock::now();
+            emitTimelinePropertiesChanged(timeline);
+            return {};
+        }
+
+        std::expected<void, AudioError> ScriptedAudioSession::setVolume(double volume) noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Set volume"));
+            return m_volume.setVolume(volume);
+        }
+
+        std::expected<double, AudioError> ScriptedAudioSession::getVolume() noexcept {
+            if (!m_initialized.load(std::memory_order_acquire))
+                return std::unexpected(AudioError(ErrorCategory::NoSession, "Get volume"));
+            return m_volume.getVolume();
+        }
+
+        // Scripted operations finish synchronously, so the async forms complete before returning.
+        AsyncResult<void> ScriptedAudioSession::initializeAsync() noexcept {
+            co_return initialize();
+        }
+
+        AsyncResult<void> ScriptedAudioSession::playAsync() noexcept {
+            co_return play();
+        }
+
+        AsyncResult<void> ScriptedAudioSession::pauseAsync() noexcept {
+            co_return pause();
+        }
+
+        AsyncResult<void> ScriptedAudioSession::nextAsync() noexcept {
+            co_return next();
+        }
+
+        AsyncResult<void> ScriptedAudioSession::previousAsync() noexcept {
+            co_return previous();
+        }
+
+        AsyncResult<void> ScriptedAudioSession::seekAsync(std::chrono::seconds position) noexcept {
+            co_return seek(position);
+        }
+
+        AsyncResult<void> ScriptedAudioSession::setVolumeAsync(double volume) noexcept {
+            co_return setVolume(volume);
+        }
+
+        AsyncResult<double> ScriptedAudioSession::getVolumeAsync() noexcept {
+            co_return getVolume();
+        }
+
+        AsyncResult<TrackSnapshot> ScriptedAudioSession::getTrackSnapshotAsync() noexcept {
+            co_return getTrackSnapshot();
+        }
+
+        VolumeController::SubscriptionId ScriptedAudioSession::subscribeVolumeChanged(VolumeChangedCallback callback) noexcept {
+            try {
+                return m_volume.subscribe(std::move(callback));
+            }
+            catch (...) {
+                return 0;
+            }
+        }
+
+        void ScriptedAudioSession::unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept {
+            m_volume.unsubscribe(id);
+        }
+
+        void ScriptedAudioSession::setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept {
+            std::scoped_lock lock(m_callbackMutex);
+            m_playbackChanged = std::move(callback);
+        }
+
+        void ScriptedAudioSession::setPlaybackEventCallback(PlaybackEventCallback callback) noexcept {
+            std::scoped_lock lock(m_callbackMutex);
+            m_playbackEvent = std::move(callback);
+        }
+
+        void ScriptedAudioSession::setTrackChangedCallback(TrackChangedCallback callback) noexcept {
+            std::scoped_lock lock(m_callbackMutex);
+            m_trackChanged = std::move(callback);
+        }
+
+        TrackChangeStats ScriptedAudioSession::getTrackChangeStats() const noexcept {
+            return m_trackWatcher.stats();
+        }
+
+    }
+}
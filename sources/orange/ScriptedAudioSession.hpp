@@ -0,0 +1,123 @@
+#pragma once
+#include "IAudioSession.h"
+#include "PlaybackEvents.h"
+#include "SessionStateCache.h"
+#include "TrackChangeWatcher.h"
+#include "FakeVolumeEndpoint.h"
+#include "VolumeController.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <chrono>
+#include <span>
+#include <expected>
+#include <cstdint>
+#include <string>
+
+namespace audio {
+    namespace platform {
+
+        // Backend with no operating-system dependency. The "source" state stands in for what the
+        // media app would report; emit* updates it and fires the matching change event the way
+        // GSMTC does, set* changes it silently so stale-cache behaviour can be observed.
+        // fetchCount() counts how often the cache had to go back to the source.
+        class ScriptedAudioSession final : public IAudioSession {
+        private:
+            struct Source {
+                std::mutex mutex;
+                std::optional<MediaInfo> media;
+                std::optional<PlaybackState> playback;
+                std::optional<TimelineState> timeline;
+                // A new object per setThumbnail, standing in for the player's stream reference.
+                std::shared_ptr<const std::vector<uint8_t>> thumbnail;
+                ThumbnailCache::Buffer servedThumbnail;
+            };
+
+            mutable Source m_source;
+            mutable SessionStateCache m_cache;
+            mutable std::atomic<uint64_t> m_fetches{ 0 };
+            std::atomic<bool> m_initialized{ false };
+            FakeVolumeEndpoint* m_volumeEndpoint;
+            VolumeController m_volume;
+            std::shared_ptr<ThumbnailCache> m_thumbnails;
+
+            PlaybackDiffer m_playbackDiff;
+            std::mutex m_callbackMutex;
+            PlaybackChangedCallback m_playbackChanged;
+            PlaybackEventCallback m_playbackEvent;
+            TrackChangedCallback m_trackChanged;
+            // Last, so its worker is joined before anything it reads goes away.
+            TrackChangeWatcher m_trackWatcher;
+
+            ScriptedAudioSession(std::unique_ptr<FakeVolumeEndpoint> volumeEndpoint, std::shared_ptr<ThumbnailCache> thumbnails);
+
+            std::expected<std::shared_ptr<const SessionState>, AudioError> mediaState() const noexcept;
+            std::expected<std::shared_ptr<const SessionState>, AudioError> playbackState() const noexcept;
+            std::expected<std::shared_ptr<const SessionState>, AudioError> timelineState() const noexcept;
+            std::expected<MediaInfo, AudioError> fetchMediaForWatcher() const;
+            void deliverTrackChanged(const MediaInfo& media);
+
+        public:
+            ScriptedAudioSession();
+            explicit ScriptedAudioSession(std::shared_ptr<ThumbnailCache> thumbnails);
+            ~ScriptedAudioSession() noexcept override = default;
+            ScriptedAudioSession(const ScriptedAudioSession&) = delete;
+            ScriptedAudioSession& operator=(const ScriptedAudioSession&) = delete;
+
+            void setMediaProperties(MediaInfo media);
+            void setPlaybackInfo(PlaybackState playback);
+            void setTimeline(TimelineState timeline);
+            void setThumbnail(std::vector<uint8_t> bytes);
+
+            // As with a real player, the track-changed callback follows on the watcher's thread
+            // once TrackChangeWatcher::DefaultWindow has passed, and only if the metadata changed.
+            void emitMediaPropertiesChanged(MediaInfo media);
+            void emitPlaybackInfoChanged(PlaybackState playback);
+            void emitTimelinePropertiesChanged(TimelineState timeline);
+
+            [[nodiscard]] FakeVolumeEndpoint& volumeEndpoint() noexcept { return *m_volumeEndpoint; }
+            [[nodiscard]] uint64_t fetchCount() const noexcept { return m_fetches.load(std::memory_order_relaxed); }
+            [[nodiscard]] SessionStateCache::Stats cacheStats() const noexcept { return m_cache.stats(); }
+
+            std::expected<void, AudioError> initialize() noexcept override;
+            AsyncResult<void> initializeAsync() noexcept override;
+            std::expected<std::chrono::seconds, AudioError> getDuration() noexcept override;
+            std::expected<std::chrono::seconds, AudioError> getCurrentPosition() noexcept override;
+            std::expected<std::chrono::milliseconds, AudioError> getCurrentPositionPrecise() noexcept override;
+            std::expected<std::string, AudioError> getTitle() const noexcept override;
+            std::expected<std::string, AudioError> getArtist() const noexcept override;
+            std::expected<std::string, AudioError> getAlbum() const noexcept override;
+            std::expected<std::string_view, AudioError> getText(MediaText field, StringPool& pool) const noexcept override;
+            std::expected<std::span<const uint8_t>, AudioError> getThumbnailBytes() noexcept override;
+            std::expected<ThumbnailCache::Buffer, AudioError> getThumbnail() noexcept override;
+            std::expected<TrackSnapshot, AudioError> getTrackSnapshot() noexcept override;
+
+            std::expected<void, AudioError> play() noexcept override;
+            std::expected<void, AudioError> pause() noexcept override;
+            std::expected<void, AudioError> next() noexcept override;
+            std::expected<void, AudioError> previous() noexcept override;
+            std::expected<void, AudioError> seek(std::chrono::seconds position) noexcept override;
+            std::expected<void, AudioError> setVolume(double volume) noexcept override;
+            std::expected<double, AudioError> getVolume() noexcept override;
+
+            AsyncResult<void> playAsync() noexcept override;
+            AsyncResult<void> pauseAsync() noexcept override;
+            AsyncResult<void> nextAsync() noexcept override;
+            AsyncResult<void> previousAsync() noexcept override;
+            AsyncResult<void> seekAsync(std::chrono::seconds position) noexcept override;
+            AsyncResult<void> setVolumeAsync(double volume) noexcept override;
+            AsyncResult<double> getVolumeAsync() noexcept override;
+            AsyncResult<TrackSnapshot> getTrackSnapshotAsync() noexcept override;
+
+            void setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept override;
+            void setPlaybackEventCallback(PlaybackEventCallback callback) noexcept override;
+            void setTrackChangedCallback(TrackChangedCallback callback) noexcept override;
+            TrackChangeStats getTrackChangeStats() const noexcept override;
+            VolumeController::SubscriptionId subscribeVolumeChanged(VolumeChangedCallback callback) noexcept override;
+            void unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept override;
+        };
+
+    }
+}
@@ -0,0 +1,86 @@
+#include "ScriptedSessionSource.h"
+#include <algorithm>
+
+namespace audio {
+    namespace platform {
+
+        ScriptedSessionSource::ScriptedSessionSource(std::string id, std::shared_ptr<IAudioSession> session)
+            : m_currentId(id) {
+            m_sessions.emplace_back(std::move(id), std::move(session));
+        }
+
+        void ScriptedSessionSource::addSession(std::string id, std::shared_ptr<IAudioSession> session) {
+            {
+                std::scoped_lock lock(m_mutex);
+                m_sessions.emplace_back(std::move(id), std::move(session));
+            }
+            if (auto notify = handlers().sessionsChanged)
+                notify();
+        }
+
+        void ScriptedSessionSource::removeSession(std::string_view id) {
+            bool currentRemoved = false;
+            {
+                std::scoped_lock lock(m_mutex);
+                std::erase_if(m_sessions, [id](const auto& session) { return session.first == id; });
+                if (m_currentId == id) {
+                    m_currentId.clear();
+                    currentRemoved = true;
+                }
+            }
+            auto notify = handlers();
+            if (notify.sessionsChanged)
+                notify.sessionsChanged();
+            if (currentRemoved && notify.currentSessionChanged)
+                notify.currentSessionChanged();
+        }
+
+        void ScriptedSessionSource::setCurrentSession(std::string id) {
+            {
+                std::scoped_lock lock(m_mutex);
+                m_currentId = std::move(id);
+            }
+            if (auto notify = handlers().currentSessionChanged)
+                notify();
+        }
+
+        std::expected<void, AudioError> ScriptedSessionSource::open(Handlers handlers) noexcept {
+            std::scoped_lock lock(m_mutex);
+            m_handlers = std::move(handlers);
+            return {};
+        }
+
+        AsyncResult<void> ScriptedSessionSource::openAsync(Handlers handlers) noexcept {
+            co_return open(std::move(handlers));
+        }
+
+        std::expected<std::vector<std::string>, AudioError> ScriptedSessionSource::sessionIds() noexcept {
+            std::scoped_lock lock(m_mutex);
+            std::vector<std::string> ids;
+            ids.reserve(m_sessions.size());
+            for (const auto& session : m_sessions)
+                ids.push_back(session.first);
+            return ids;
+        }
+
+        std::expected<std::string, AudioError> ScriptedSessionSource::currentSessionId() noexcept {
+            std::scoped_lock lock(m_mutex);
+            return m_currentId;
+        }
+
+        std::expected<std::shared_ptr<IAudioSession>, AudioError> ScriptedSessionSource::createSession(std::string_view id) noexcept {
+            std::scoped_lock lock(m_mutex);
+            auto it = std::find_if(m_sessions.begin(), m_sessions.end(), [id](const auto& session) { return session.first == id; });
+            if (it == m_sessions.end())
+                return std::unexpected(AudioError(ErrorCategory::NotFound, "Create session"));
+            m_creates.fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+
+        ScriptedSessionSource::Handlers ScriptedSessionSource::handlers() const {
+            std::scoped_lock lock(m_mutex);
+            return m_handlers;
+        }
+
+    }
+}
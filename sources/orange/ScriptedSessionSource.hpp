@@ -0,0 +1,47 @@
+#pragma once
+#include "SessionRegistry.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+namespace audio {
+    namespace platform {
+
+        // Session source with no operating-system dependency. addSession/removeSession and
+        // setCurrentSession behave like apps starting, closing and taking focus, and fire the
+        // same notifications GSMTC's SessionsChanged and CurrentSessionChanged would.
+        class ScriptedSessionSource : public ISessionSource {
+        public:
+            ScriptedSessionSource() = default;
+            // A single session under id that is also the current one.
+            ScriptedSessionSource(std::string id, std::shared_ptr<IAudioSession> session);
+
+            void addSession(std::string id, std::shared_ptr<IAudioSession> session);
+            void removeSession(std::string_view id);
+            void setCurrentSession(std::string id);
+
+            [[nodiscard]] uint64_t createCount() const noexcept { return m_creates.load(std::memory_order_relaxed); }
+
+            std::expected<void, AudioError> open(Handlers handlers) noexcept override;
+            AsyncResult<void> openAsync(Handlers handlers) noexcept override;
+            std::expected<std::vector<std::string>, AudioError> sessionIds() noexcept override;
+            std::expected<std::string, AudioError> currentSessionId() noexcept override;
+            std::expected<std::shared_ptr<IAudioSession>, AudioError> createSession(std::string_view id) noexcept override;
+
+        private:
+            Handlers handlers() const;
+
+            mutable std::mutex m_mutex;
+            std::vector<std::pair<std::string, std::shared_ptr<IAudioSession>>> m_sessions;
+            std::string m_currentId;
+            Handlers m_handlers;
+            std::atomic<uint64_t> m_creates{ 0 };
+        };
+
+    }
+}
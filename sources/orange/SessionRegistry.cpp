@@ -0,0 +1,303 @@
+#include "SessionRegistry.h"
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+namespace audio {
+
+    SessionRegistry::SessionRegistry(std::unique_ptr<ISessionSource> source)
+        : m_source(std::move(source)) {
+    }
+
+    SessionRegistry::~SessionRegistry() {
+        // Stop the source first so no refresh can start while the entries are torn down.
+        m_source.reset();
+        EntryMap entries;
+        {
+            std::unique_lock lock(m_mutex);
+            entries.swap(m_entries);
+        }
+        // A session handed in by the caller outlives the registry, and the callbacks from
+        // wireCallbacks point back at it.
+        for (const auto& [id, entry] : entries) {
+            entry->session->setPlaybackChangedCallback(nullptr);
+            entry->session->setPlaybackEventCallback(nullptr);
+            entry->session->setTrackChangedCallback(nullptr);
+        }
+    }
+
+    ISessionSource::Handlers SessionRegistry::handlers() {
+        return {
+            [this] { refreshSessions(); },
+            [this] { refreshCurrent(); }
+        };
+    }
+
+    std::expected<void, AudioError> SessionRegistry::initialize() noexcept {
+        if (auto opened = m_source->open(handlers()); !opened)
+            return opened;
+        refreshSessions();
+        refreshCurrent();
+        return {};
+    }
+
+    // The source's handlers may already be refreshing, so each diff and insert holds
+    // m_refreshMutex as refreshSessions() does. It is released across every co_await: the
+    // coroutine may resume on another thread, and a refresh should not wait on a priming.
+    AsyncResult<void> SessionRegistry::initializeAsync() noexcept {
+        auto opened = co_await m_source->openAsync(handlers());
+        if (!opened)
+            co_return opened;
+
+        std::unique_lock refresh(m_refreshMutex);
+        auto ids = m_source->sessionIds();
+        if (!ids)
+            co_return std::unexpected(ids.error());
+        for (const auto& id : missingIds(*ids)) {
+            if (find(id))
+                continue;
+            auto session = m_source->createSession(id);
+            if (!session)
+                continue;
+            refresh.unlock();
+            auto initialized = co_await (*session)->initializeAsync();
+            refresh.lock();
+            // While it was primed, a refresh may have added the app or seen its session go.
+            if (!initialized || find(id))
+                continue;
+            auto current = m_source->sessionIds();
+            if (!current || std::find(current->begin(), current->end(), id) == current->end())
+                continue;
+            insert(std::make_shared<Entry>(id, std::move(*session)));
+        }
+        refresh.unlock();
+        refreshCurrent();
+        co_return {};
+    }
+
+    std::vector<std::string> SessionRegistry::sessionIds() const {
+        std::shared_lock lock(m_mutex);
+        std::vector<std::string> ids;
+        ids.reserve(m_entries.size());
+        for (const auto& [id, entry] : m_entries)
+            ids.push_back(id);
+        return ids;
+    }
+
+    std::shared_ptr<SessionRegistry::Entry> SessionRegistry::find(std::string_view id) const noexcept {
+        std::shared_lock lock(m_mutex);
+        auto it = m_entries.find(id);
+        return it == m_entries.end() ? nullptr : it->second;
+    }
+
+    std::shared_ptr<SessionRegistry::Entry> SessionRegistry::active() const noexcept {
+        std::shared_lock lock(m_mutex);
+        auto it = m_entries.find(activeIdLocked());
+        return it == m_entries.end() ? nullptr : it->second;
+    }
+
+    std::string SessionRegistry::activeId() const {
+        auto entry = active();
+        return entry ? entry->id : std::string();
+    }
+
+    SessionRegistry::Mode SessionRegistry::mode() const noexcept {
+        std::shared_lock lock(m_mutex);
+        return m_mode;
+    }
+
+    void SessionRegistry::pin(std::string_view id) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_mode = Mode::Pinned;
+            m_pinnedId = id;
+        }
+        notifyIfActiveChanged();
+    }
+
+    void SessionRegistry::followCurrent() {
+        {
+            std::unique_lock lock(m_mutex);
+            m_mode = Mode::FollowCurrent;
+            m_pinnedId.clear();
+        }
+        notifyIfActiveChanged();
+    }
+
+    void SessionRegistry::setPlaybackChangedCallback(IAudioEventNotifier::PlaybackChangedCallback callback) {
+        {
+            std::scoped_lock lock(m_callbackMutex);
+            m_playbackChanged = std::move(callback);
+        }
+        std::vector<std::shared_ptr<Entry>> entries;
+        {
+            std::shared_lock lock(m_mutex);
+            for (const auto& [id, entry] : m_entries)
+                entries.push_back(entry);
+        }
+        for (const auto& entry : entries)
+            wireCallbacks(entry);
+    }
+
+    void SessionRegistry::setPlaybackEventCallback(IAudioEventNotifier::PlaybackEventCallback callback) {
+        {
+            std::scoped_lock lock(m_callbackMutex);
+            m_playbackEvent = std::move(callback);
+        }
+        std::vector<std::shared_ptr<Entry>> entries;
+        {
+            std::shared_lock lock(m_mutex);
+            for (const auto& [id, entry] : m_entries)
+                entries.push_back(entry);
+        }
+        for (const auto& entry : entries)
+            wireCallbacks(entry);
+    }
+
+    void SessionRegistry::setTrackChangedCallback(IAudioEventNotifier::TrackChangedCallback callback) {
+        {
+            std::scoped_lock lock(m_callbackMutex);
+            m_trackChanged = std::move(callback);
+        }
+        std::vector<std::shared_ptr<Entry>> entries;
+        {
+            std::shared_lock lock(m_mutex);
+            for (const auto& [id, entry] : m_entries)
+                entries.push_back(entry);
+        }
+        for (const auto& entry : entries)
+            wireCallbacks(entry);
+    }
+
+    void SessionRegistry::setActiveSessionChangedCallback(ActiveSessionChangedCallback callback) {
+        std::scoped_lock lock(m_callbackMutex);
+        m_activeChanged = std::move(callback);
+    }
+
+    // SessionsChanged carries no delta, so the id list is diffed against the entries: sessions
+    // that are still there are left untouched, and only new apps pay for a session and its priming.
+    void SessionRegistry::refreshSessions() noexcept {
+        try {
+            std::scoped_lock refresh(m_refreshMutex);
+            auto ids = m_source->sessionIds();
+            if (!ids)
+                return;
+
+            std::vector<std::shared_ptr<Entry>> removed;
+            {
+                std::unordered_set<std::string_view> present(ids->begin(), ids->end());
+                std::unique_lock lock(m_mutex);
+                for (auto it = m_entries.begin(); it != m_entries.end();) {
+                    if (present.contains(it->first)) {
+                        ++it;
+                        continue;
+                    }
+                    removed.push_back(std::move(it->second));
+                    it = m_entries.erase(it);
+                }
+            }
+
+            for (const auto& id : missingIds(*ids)) {
+                auto session = m_source->createSession(id);
+                if (!session || !(*session)->initialize())
+                    continue;
+                insert(std::make_shared<Entry>(id, std::move(*session)));
+            }
+
+            // Outside the lock: tearing an entry down waits for its queued commands.
+            removed.clear();
+        }
+        catch (...) {
+        }
+        notifyIfActiveChanged();
+    }
+
+    void SessionRegistry::refreshCurrent() noexcept {
+        try {
+            auto id = m_source->currentSessionId();
+            if (!id)
+                return;
+            {
+                std::unique_lock lock(m_mutex);
+                m_currentId = *id;
+            }
+            // The current-session event can arrive before the list change that introduces it.
+            if (!id->empty() && !find(*id))
+                refreshSessions();
+        }
+        catch (...) {
+        }
+        notifyIfActiveChanged();
+    }
+
+    std::vector<std::string> SessionRegistry::missingIds(const std::vector<std::string>& ids) const {
+        std::vector<std::string> missing;
+        std::shared_lock lock(m_mutex);
+        for (const auto& id : ids) {
+            // An app can own several sessions; the registry follows the first one it reports.
+            if (!m_entries.contains(id) && std::find(missing.begin(), missing.end(), id) == missing.end())
+                missing.push_back(id);
+        }
+        return missing;
+    }
+
+    void SessionRegistry::insert(std::shared_ptr<Entry> entry) {
+        wireCallbacks(entry);
+        std::unique_lock lock(m_mutex);
+        m_entries.try_emplace(entry->id, std::move(entry));
+    }
+
+    void SessionRegistry::wireCallbacks(const std::shared_ptr<Entry>& entry) {
+        IAudioEventNotifier::PlaybackChangedCallback playbackChanged;
+        IAudioEventNotifier::PlaybackEventCallback playbackEvent;
+        IAudioEventNotifier::TrackChangedCallback trackChanged;
+        {
+            std::scoped_lock lock(m_callbackMutex);
+            playbackChanged = m_playbackChanged;
+            playbackEvent = m_playbackEvent;
+            trackChanged = m_trackChanged;
+        }
+        if (playbackChanged) {
+            entry->session->setPlaybackChangedCallback([this, id = entry->id, playbackChanged](std::string_view status) {
+                if (isActive(id))
+                    playbackChanged(status);
+                });
+        }
+        if (playbackEvent) {
+            entry->session->setPlaybackEventCallback([this, id = entry->id, playbackEvent](const PlaybackEvent& event) {
+                if (isActive(id))
+                    playbackEvent(event);
+                });
+        }
+        if (trackChanged) {
+            entry->session->setTrackChangedCallback([this, id = entry->id, trackChanged](std::string_view title, std::string_view artist) {
+                if (isActive(id))
+                    trackChanged(title, artist);
+                });
+        }
+    }
+
+    bool SessionRegistry::isActive(std::string_view id) const {
+        std::shared_lock lock(m_mutex);
+        return activeIdLocked() == id;
+    }
+
+    std::string SessionRegistry::activeIdLocked() const {
+        return m_mode == Mode::Pinned ? m_pinnedId : m_currentId;
+    }
+
+    void SessionRegistry::notifyIfActiveChanged() {
+        auto id = activeId();
+        ActiveSessionChangedCallback callback;
+        {
+            std::scoped_lock lock(m_callbackMutex);
+            if (id == m_lastActiveId)
+                return;
+            m_lastActiveId = id;
+            callback = m_activeChanged;
+        }
+        if (callback)
+            callback(id);
+    }
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include "IAudioSession.h"
+#include "CommandQueue.h"
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace audio {
+
+    // The operating-system side of session discovery. Sessions are identified by the id of the
+    // app that owns them (SourceAppUserModelId on Windows). The handlers given to open() only
+    // signal that something changed; the registry then asks again for the ids it needs.
+    class ISessionSource {
+    public:
+        struct Handlers {
+            std::function<void()> sessionsChanged;
+            std::function<void()> currentSessionChanged;
+        };
+
+        virtual ~ISessionSource() = default;
+
+        virtual std::expected<void, AudioError> open(Handlers handlers) noexcept = 0;
+        virtual AsyncResult<void> openAsync(Handlers handlers) noexcept = 0;
+        virtual std::expected<std::vector<std::string>, AudioError> sessionIds() noexcept = 0;
+        // Empty when the system has no current session.
+        virtual std::expected<std::string, AudioError> currentSessionId() noexcept = 0;
+        // Returns a session that has not been initialized yet.
+        virtual std::expected<std::shared_ptr<IAudioSession>, AudioError> createSession(std::string_view id) noexcept = 0;
+    };
+
+    // Tracks every session the source reports, keyed by app id. Each entry keeps its own session
+    // object (and with it its state cache and event subscriptions) and its own CommandQueue for as
+    // long as the app's session exists, so changing the active session only changes which entry
+    // callers are routed to. The active session is either the system's current one or a pinned id.
+    class SessionRegistry {
+    public:
+        enum class Mode {
+            FollowCurrent,
+            Pinned
+        };
+
+        struct Entry {
+            explicit Entry(std::string id, std::shared_ptr<IAudioSession> session)
+                : id(std::move(id)), session(std::move(session)), commands(this->session) {
+            }
+
+            const std::string id;
+            const std::shared_ptr<IAudioSession> session;
+            CommandQueue commands;
+        };
+
+        using ActiveSessionChangedCallback = std::function<void(std::string_view id)>;
+
+        explicit SessionRegistry(std::unique_ptr<ISessionSource> source);
+        ~SessionRegistry();
+        SessionRegistry(const SessionRegistry&) = delete;
+        SessionRegistry& operator=(const SessionRegistry&) = delete;
+
+        std::expected<void, AudioError> initialize() noexcept;
+        AsyncResult<void> initializeAsync() noexcept;
+
+        [[nodiscard]] std::vector<std::string> sessionIds() const;
+        [[nodiscard]] std::shared_ptr<Entry> find(std::string_view id) const noexcept;
+        // nullptr when the pinned session is gone or the system has no current session.
+        [[nodiscard]] std::shared_ptr<Entry> active() const noexcept;
+        [[nodiscard]] std::string activeId() const;
+        [[nodiscard]] Mode mode() const noexcept;
+
+        // Pinning an id that is not (yet) known is allowed; calls fail until that app shows up.
+        void pin(std::string_view id);
+        void followCurrent();
+
+        // Installed on every entry; events from sessions other than the active one are dropped.
+        void setPlaybackChangedCallback(IAudioEventNotifier::PlaybackChangedCallback callback);
+        void setPlaybackEventCallback(IAudioEventNotifier::PlaybackEventCallback callback);
+        void setTrackChangedCallback(IAudioEventNotifier::TrackChangedCallback callback);
+        void setActiveSessionChangedCallback(ActiveSessionChangedCallback callback);
+
+    private:
+        struct IdHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view id) const noexcept { return std::hash<std::string_view>{}(id); }
+        };
+
+        using EntryMap = std::unordered_map<std::string, std::shared_ptr<Entry>, IdHash, std::equal_to<>>;
+
+        ISessionSource::Handlers handlers();
+        void refreshSessions() noexcept;
+        void refreshCurrent() noexcept;
+        std::vector<std::string> missingIds(const std::vector<std::string>& ids) const;
+        void insert(std::shared_ptr<Entry> entry);
+        void wireCallbacks(const std::shared_ptr<Entry>& entry);
+        bool isActive(std::string_view id) const;
+        std::string activeIdLocked() const;
+        void notifyIfActiveChanged();
+
+        std::unique_ptr<ISessionSource> m_source;
+
+        mutable std::shared_mutex m_mutex;
+        EntryMap m_entries;
+        Mode m_mode{ Mode::FollowCurrent };
+        std::string m_currentId;
+        std::string m_pinnedId;
+
+        // Serializes refreshes so one app's session is never created twice.
+        std::mutex m_refreshMutex;
+
+        std::mutex m_callbackMutex;
+        IAudioEventNotifier::PlaybackChangedCallback m_playbackChanged;
+        IAudioEventNotifier::PlaybackEventCallback m_playbackEvent;
+        IAudioEventNotifier::TrackChangedCallback m_trackChanged;
+        ActiveSessionChangedCallback m_activeChanged;
+        std::string m_lastActiveId;
+    };
+
+}
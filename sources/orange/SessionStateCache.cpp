@@ -0,0 +1,62 @@
+#include "SessionStateCache.h"
+#include "PlaybackClock.h"
+#include "Tracer.h"
+
+namespace audio {
+
+    SessionStateCache::SessionStateCache()
+        : m_state(std::make_shared<const SessionState>()) {
+    }
+
+    std::shared_ptr<const SessionState> SessionStateCache::load() const noexcept {
+        return m_state.load(std::memory_order_acquire);
+    }
+
+    template <typename Mutator>
+    void SessionStateCache::update(Mutator&& mutate) {
+        std::scoped_lock lock(m_writeMutex);
+        auto next = std::make_shared<SessionState>(*m_state.load(std::memory_order_relaxed));
+        mutate(*next);
+        m_state.store(std::move(next), std::memory_order_release);
+        m_updates.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void SessionStateCache::publishMedia(MediaInfo media) {
+        TraceSpan trace("cache", "Publish media");
+        update([&](SessionState& state) { state.media = std::move(media); });
+    }
+
+    void SessionStateCache::publishPlayback(PlaybackState playback) {
+        TraceSpan trace("cache", "Publish playback");
+        update([&](SessionState& state) {
+            // Players do not always report a fresh timeline when they pause or change rate, so
+            // freeze the extrapolated position at the switch to keep the clock continuous.
+            if (state.timeline && (!state.playback || state.playback->status != playback.status || state.playback->rate != playback.rate)) {
+                auto now = PlaybackClock::Clock::now();
+                state.timeline->position = PlaybackClock::position(*state.timeline, state.playback, now);
+                state.timeline->anchoredAt = now;
+            }
+            state.playback = playback;
+            });
+    }
+
+    void SessionStateCache::publishTimeline(TimelineState timeline) {
+        TraceSpan trace("cache", "Publish timeline");
+        timeline.anchoredAt = PlaybackClock::anchorFor(timeline.lastUpdated);
+        update([&](SessionState& state) { state.timeline = timeline; });
+    }
+
+    void SessionStateCache::clear() noexcept {
+        std::scoped_lock lock(m_writeMutex);
+        m_state.store(std::make_shared<const SessionState>(), std::memory_order_release);
+    }
+
+    SessionStateCache::Stats SessionStateCache::stats() const noexcept {
+        return {
+            m_hits.load(std::memory_order_relaxed),
+            m_misses.load(std::memory_order_relaxed),
+            m_updates.load(std::memory_order_relaxed)
+        };
+    }
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "IAudioSession.h"
+#include "OperationStats.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <cstdint>
+#include <string>
+
+namespace audio {
+
+    struct MediaInfo {
+        std::string title;
+        std::string artist;
+        std::string album;
+        std::string albumArtist;
+        int32_t trackNumber{ 0 };
+        uint64_t thumbnailHandle{ 0 };
+        // The platform's own UTF-16, from backends that receive it (GSMTC); empty elsewhere.
+        std::u16string titleUtf16;
+        std::u16string artistUtf16;
+        std::u16string albumUtf16;
+
+        [[nodiscard]] const std::string& text(MediaText field) const noexcept {
+            return field == MediaText::Title ? title : field == MediaText::Artist ? artist : album;
+        }
+        [[nodiscard]] const std::u16string& textUtf16(MediaText field) const noexcept {
+            return field == MediaText::Title ? titleUtf16 : field == MediaText::Artist ? artistUtf16 : albumUtf16;
+        }
+        bool operator==(const MediaInfo&) const = default;
+    };
+
+    struct TimelineState {
+        std::chrono::milliseconds start{ 0 };
+        std::chrono::milliseconds end{ 0 };
+        std::chrono::milliseconds position{ 0 };
+        std::chrono::system_clock::time_point lastUpdated{};
+        // Steady-clock instant at which position was true; filled in by SessionStateCache on publish.
+        std::chrono::steady_clock::time_point anchoredAt{};
+    };
+
+    // Immutable once published. Each part stays empty until the backend has delivered it.
+    struct SessionState {
+        std::optional<MediaInfo> media;
+        std::optional<PlaybackState> playback;
+        std::optional<TimelineState> timeline;
+    };
+
+    // Holds the last state reported by a backend's change events. Readers take a reference to
+    // the current immutable SessionState without blocking; writers build a modified copy and
+    // publish it atomically.
+    class SessionStateCache {
+    public:
+        struct Stats {
+            uint64_t hits{ 0 };
+            uint64_t misses{ 0 };
+            uint64_t updates{ 0 };
+        };
+
+        SessionStateCache();
+
+        [[nodiscard]] std::shared_ptr<const SessionState> load() const noexcept;
+
+        void publishMedia(MediaInfo media);
+        void publishPlayback(PlaybackState playback);
+        void publishTimeline(TimelineState timeline);
+        void clear() noexcept;
+
+        // Also counted process-wide, in OperationStats::platform().
+        void recordHit() noexcept {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            OperationStats::platform().recordCacheHit();
+        }
+        void recordMiss() noexcept {
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            OperationStats::platform().recordCacheMiss();
+        }
+        [[nodiscard]] Stats stats() const noexcept;
+
+    private:
+        template <typename Mutator>
+        void update(Mutator&& mutate);
+
+        std::atomic<std::shared_ptr<const SessionState>> m_state;
+        std::mutex m_writeMutex;
+        std::atomic<uint64_t> m_hits{ 0 };
+        std::atomic<uint64_t> m_misses{ 0 };
+        std::atomic<uint64_t> m_updates{ 0 };
+    };
+
+}
@@ -0,0 +1,308 @@
+#include "SimulatedAudioSession.h"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace audio {
+    namespace platform {
+
+        namespace {
+
+            constexpr std::chrono::seconds TrackLength{ 240 };
+
+            MediaInfo trackInfo(int32_t track) {
+                MediaInfo media;
+                media.title = "Simulated Track " + std::to_string(track);
+                media.artist = "Simulated Artist";
+                media.album = "Simulated Album";
+                media.albumArtist = "Simulated Artist";
+                media.trackNumber = track;
+                media.thumbnailHandle = static_cast<uint64_t>(track);
+                return media;
+            }
+
+            TimelineState trackTimeline() {
+                TimelineState timeline;
+                timeline.end = TrackLength;
+                timeline.lastUpdated = std::chrono::system_clock::now();
+                return timeline;
+            }
+
+            // Sleeping is only accurate to tens of microseconds, so the last stretch is spun.
+            void waitUntil(std::chrono::steady_clock::time_point deadline) noexcept {
+                constexpr auto spinWindow = std::chrono::microseconds(200);
+                auto remaining = deadline - std::chrono::steady_clock::now();
+                if (remaining > spinWindow)
+                    std::this_thread::sleep_for(remaining - spinWindow);
+                while (std::chrono::steady_clock::now() < deadline) {
+                }
+            }
+
+        }
+
+        SimulatedAudioSession::SimulatedAudioSession(SimulationProfile profile)
+            : m_profile(std::move(profile)),
+            m_player(std::make_unique<ScriptedAudioSession>()) {
+            m_player->setMediaProperties(trackInfo(m_track));
+            PlaybackState playback;
+            playback.status = PlaybackStatus::Paused;
+            playback.controls = static_cast<uint32_t>(PlaybackControl::Play) | static_cast<uint32_t>(PlaybackControl::Pause)
+                | static_cast<uint32_t>(PlaybackControl::Next) | static_cast<uint32_t>(PlaybackControl::Previous)
+                | static_cast<uint32_t>(PlaybackControl::PlaybackPosition);
+            m_player->setPlaybackInfo(playback);
+            m_player->setTimeline(trackTimeline());
+            std::vector<uint8_t> thumbnail(m_profile.thumbnailBytes);
+            for (size_t i = 0; i < thumbnail.size(); ++i)
+                thumbnail[i] = static_cast<uint8_t>(i * 31u);
+            m_player->setThumbnail(std::move(thumbnail));
+            if (m_profile.eventRate > 0.0)
+                m_worker = std::thread([this] { run(); });
+        }
+
+        SimulatedAudioSession::~SimulatedAudioSession() noexcept {
+            {
+                std::scoped_lock lock(m_mutex);
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+            if (m_worker.joinable())
+                m_worker.join();
+        }
+
+        uint64_t SimulatedAudioSession::calls(SimulatedOperation operation) const noexcept {
+            return m_calls[static_cast<size_t>(operation)].load(std::memory_order_relaxed);
+        }
+
+        // Each calling thread draws its jitter from its own generator, so callers never contend
+        // on it; the profile's seed keeps runs repeatable for a given thread layout.
+        void SimulatedAudioSession::spend(SimulatedOperation operation) const noexcept {
+            m_calls[static_cast<size_t>(operation)].fetch_add(1, std::memory_order_relaxed);
+            const auto& latency = m_profile[operation];
+            auto cost = latency.base;
+            if (latency.jitter.count() > 0) {
+                thread_local std::mt19937_64 random(m_profile.seed ^ std::hash<std::thread::id>{}(std::this_thread::get_id()));
+                std::uniform_int_distribution<int64_t> offset(-latency.jitter.count(), latency.jitter.count());
+                cost += std::chrono::microseconds(offset(random));
+            }
+            if (cost.count() > 0)
+                waitUntil(std::chrono::steady_clock::now() + cost);
+        }
+
+        void SimulatedAudioSession::changeTrack(int32_t step) {
+            int32_t track = 0;
+            {
+                std::scoped_lock lock(m_trackMutex);
+                m_track = std::max(1, m_track + step);
+                track = m_track;
+            }
+            m_player->emitTimelinePropertiesChanged(trackTimeline());
+            m_player->emitMediaPropertiesChanged(trackInfo(track));
+        }
+
+        void SimulatedAudioSession::togglePlayback() {
+            auto state = m_player->getTrackSnapshot();
+            const bool playing = state && state->status == PlaybackStatus::Playing;
+            if (playing)
+                m_player->pause();
+            else
+                m_player->play();
+        }
+
+        void SimulatedAudioSession::run() {
+            const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / m_profile.eventRate));
+            auto due = std::chrono::steady_clock::now() + interval;
+            std::unique_lock lock(m_mutex);
+            for (uint64_t tick = 1;; ++tick) {
+                if (m_wake.wait_until(lock, due, [this] { return m_stopping; }))
+                    return;
+                lock.unlock();
+                // Until initialize() the player reports no session; those changes are simply not seen.
+                if (tick % 4 == 0)
+                    changeTrack(1);
+                else
+                    togglePlayback();
+                m_events.fetch_add(1, std::memory_order_relaxed);
+                lock.lock();
+                due += interval;
+            }
+        }
+
+        std::expected<void, AudioError> SimulatedAudioSession::initialize() noexcept {
+            spend(SimulatedOperation::Initialize);
+            return m_player->initialize();
+        }
+
+        std::expected<std::chrono::seconds, AudioError> SimulatedAudioSession::getDuration() noexcept {
+            spend(SimulatedOperation::Read);
+            return m_player->getDuration();
+        }
+
+        std::expected<std::chrono::seconds, AudioError> SimulatedAudioSession::getCurrentPosition() noexcept {
+            spend(SimulatedOperation::Read);
+            return m_player->getCurrentPosition();
+        }
+
+        std::expected<std::chrono::milliseconds, AudioError> SimulatedAudioSession::getCurrentPositionPrecise() noexcept {
+            spend(SimulatedOperation::Read);
+            return m_player->getCurrentPositionPrecise();
+        }
+
+        std::expected<std::string, AudioError> SimulatedAudioSession::getTitle() const noexcept {
+            spend(SimulatedOperation::Read);
+            return m_player->getTitle();
+        }
+
+        std::expected<std::string, AudioError> SimulatedAudioSession::getArtist() const noexcept {
+            spend(SimulatedOperation::Read);
+            return m_player->getArtist();
+        }
+
+        std::expected<std::string, AudioError> SimulatedAudioSession::getAlbum() const noexcept {
+            spend(SimulatedOperation::Read);
+            return m_player->getAlbum();
+        }
+
+        std::expected<std::string_view, AudioError> SimulatedAudioSession::getText(MediaText field, StringPool& pool) const noexcept {
+            spend(SimulatedOperation::Read);
+            return m_player->getText(field, pool);
+        }
+
+        std::expected<std::u16string, AudioError> SimulatedAudioSession::getTextUtf16(MediaText field) const noexcept {
+            spend(SimulatedOperation::Read);
+            return m_player->getTextUtf16(field);
+        }
+
+        std::expected<std::span<const uint8_t>, AudioError> SimulatedAudioSession::getThumbnailBytes() noexcept {
+            spend(SimulatedOperation::Thumbnail);
+            return m_player->getThumbnailBytes();
+        }
+
+        std::expected<ThumbnailCache::Buffer, AudioError> SimulatedAudioSession::getThumbnail() noexcept {
+            spend(SimulatedOperation::Thumbnail);
+            return m_player->getThumbnail();
+        }
+
+        std::expected<TrackSnapshot, AudioError> SimulatedAudioSession::getTrackSnapshot() noexcept {
+            spend(SimulatedOperation::Snapshot);
+            return m_player->getTrackSnapshot();
+        }
+
+        std::expected<void, AudioError> SimulatedAudioSession::play() noexcept {
+            spend(SimulatedOperation::Command);
+            return m_player->play();
+        }
+
+        std::expected<void, AudioError> SimulatedAudioSession::pause() noexcept {
+            spend(SimulatedOperation::Command);
+            return m_player->pause();
+        }
+
+        std::expected<void, AudioError> SimulatedAudioSession::next() noexcept {
+            spend(SimulatedOperation::Command);
+            if (auto result = m_player->next(); !result)
+                return result;
+            try {
+                changeTrack(1);
+                return {};
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Next track", ex));
+            }
+        }
+
+        std::expected<void, AudioError> SimulatedAudioSession::previous() noexcept {
+            spend(SimulatedOperation::Command);
+            if (auto result = m_player->previous(); !result)
+                return result;
+            try {
+                changeTrack(-1);
+                return {};
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Previous track", ex));
+            }
+        }
+
+        std::expected<void, AudioError> SimulatedAudioSession::seek(std::chrono::seconds position) noexcept {
+            spend(SimulatedOperation::Command);
+            return m_player->seek(position);
+        }
+
+        std::expected<void, AudioError> SimulatedAudioSession::setVolume(double volume) noexcept {
+            spend(SimulatedOperation::Volume);
+            return m_player->setVolume(volume);
+        }
+
+        std::expected<double, AudioError> SimulatedAudioSession::getVolume() noexcept {
+            spend(SimulatedOperation::Volume);
+            return m_player->getVolume();
+        }
+
+        // Like the scripted backend, the async forms do their work, simulated latency included,
+        // before the returned AsyncResult exists.
+        AsyncResult<void> SimulatedAudioSession::initializeAsync() noexcept {
+            co_return initialize();
+        }
+
+        AsyncResult<void> SimulatedAudioSession::playAsync() noexcept {
+            co_return play();
+        }
+
+        AsyncResult<void> SimulatedAudioSession::pauseAsync() noexcept {
+            co_return pause();
+        }
+
+        AsyncResult<void> SimulatedAudioSession::nextAsync() noexcept {
+            co_return next();
+        }
+
+        AsyncResult<void> SimulatedAudioSession::previousAsync() noexcept {
+            co_return previous();
+        }
+
+        AsyncResult<void> SimulatedAudioSession::seekAsync(std::chrono::seconds position) noexcept {
+            co_return seek(position);
+        }
+
+        AsyncResult<void> SimulatedAudioSession::setVolumeAsync(double volume) noexcept {
+            co_return setVolume(volume);
+        }
+
+        AsyncResult<double> SimulatedAudioSession::getVolumeAsync() noexcept {
+            co_return getVolume();
+        }
+
+        AsyncResult<TrackSnapshot> SimulatedAudioSession::getTrackSnapshotAsync() noexcept {
+            co_return getTrackSnapshot();
+        }
+
+        VolumeController::SubscriptionId SimulatedAudioSession::subscribeVolumeChanged(VolumeChangedCallback callback) noexcept {
+            return m_player->subscribeVolumeChanged(std::move(callback));
+        }
+
+        void SimulatedAudioSession::unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept {
+            m_player->unsubscribeVolumeChanged(id);
+        }
+
+        void SimulatedAudioSession::setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept {
+            m_player->setPlaybackChangedCallback(std::move(callback));
+        }
+
+        void SimulatedAudioSession::setPlaybackEventCallback(PlaybackEventCallback callback) noexcept {
+            m_player->setPlaybackEventCallback(std::move(callback));
+        }
+
+        void SimulatedAudioSession::setTrackChangedCallback(TrackChangedCallback callback) noexcept {
+            m_player->setTrackChangedCallback(std::move(callback));
+        }
+
+        TrackChangeStats SimulatedAudioSession::getTrackChangeStats() const noexcept {
+            return m_player->getTrackChangeStats();
+        }
+
+    }
+}
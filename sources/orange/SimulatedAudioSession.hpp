@@ -0,0 +1,130 @@
+#pragma once
+#include "IAudioSession.h"
+#include "ScriptedAudioSession.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <expected>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace audio {
+    namespace platform {
+
+        // The kinds of backend call a simulation can give a cost to.
+        enum class SimulatedOperation : uint32_t {
+            Initialize = 0,
+            // getTitle, getArtist, getAlbum, getDuration and the position getters.
+            Read = 1,
+            Snapshot = 2,
+            Thumbnail = 3,
+            // play, pause, next, previous, seek.
+            Command = 4,
+            Volume = 5
+        };
+
+        inline constexpr size_t SimulatedOperationCount = 6;
+
+        struct SimulatedLatency {
+            std::chrono::microseconds base{ 0 };
+            // Each call adds a uniformly distributed offset in [-jitter, +jitter], never going below zero.
+            std::chrono::microseconds jitter{ 0 };
+        };
+
+        struct SimulationProfile {
+            std::array<SimulatedLatency, SimulatedOperationCount> latency{};
+            // Player-side changes per second, made on the simulation's own thread: mostly play/pause
+            // toggles, every fourth one a track change. 0 keeps the player still.
+            double eventRate{ 0.0 };
+            size_t thumbnailBytes{ 64 * 1024 };
+            uint64_t seed{ 1 };
+
+            [[nodiscard]] SimulatedLatency& operator[](SimulatedOperation operation) noexcept {
+                return latency[static_cast<size_t>(operation)];
+            }
+            [[nodiscard]] const SimulatedLatency& operator[](SimulatedOperation operation) const noexcept {
+                return latency[static_cast<size_t>(operation)];
+            }
+        };
+
+        // Backend for measuring the layers above it off Windows. Every IAudioSession call first
+        // costs the latency its profile gives that kind of operation, spent on the calling thread
+        // as a real backend's would be, and is then served by a ScriptedAudioSession, so the state
+        // cache, change events and track-change coalescing behave as with a real player.
+        class SimulatedAudioSession final : public IAudioSession {
+        public:
+            explicit SimulatedAudioSession(SimulationProfile profile = {});
+            ~SimulatedAudioSession() noexcept override;
+            SimulatedAudioSession(const SimulatedAudioSession&) = delete;
+            SimulatedAudioSession& operator=(const SimulatedAudioSession&) = delete;
+
+            [[nodiscard]] const SimulationProfile& profile() const noexcept { return m_profile; }
+            [[nodiscard]] uint64_t calls(SimulatedOperation operation) const noexcept;
+            [[nodiscard]] uint64_t simulatedEvents() const noexcept { return m_events.load(std::memory_order_relaxed); }
+            [[nodiscard]] ScriptedAudioSession& player() noexcept { return *m_player; }
+
+            std::expected<void, AudioError> initialize() noexcept override;
+            AsyncResult<void> initializeAsync() noexcept override;
+            std::expected<std::chrono::seconds, AudioError> getDuration() noexcept override;
+            std::expected<std::chrono::seconds, AudioError> getCurrentPosition() noexcept override;
+            std::expected<std::chrono::milliseconds, AudioError> getCurrentPositionPrecise() noexcept override;
+            std::expected<std::string, AudioError> getTitle() const noexcept override;
+            std::expected<std::string, AudioError> getArtist() const noexcept override;
+            std::expected<std::string, AudioError> getAlbum() const noexcept override;
+            std::expected<std::string_view, AudioError> getText(MediaText field, StringPool& pool) const noexcept override;
+            std::expected<std::u16string, AudioError> getTextUtf16(MediaText field) const noexcept override;
+            std::expected<std::span<const uint8_t>, AudioError> getThumbnailBytes() noexcept override;
+            std::expected<ThumbnailCache::Buffer, AudioError> getThumbnail() noexcept override;
+            std::expected<TrackSnapshot, AudioError> getTrackSnapshot() noexcept override;
+
+            std::expected<void, AudioError> play() noexcept override;
+            std::expected<void, AudioError> pause() noexcept override;
+            std::expected<void, AudioError> next() noexcept override;
+            std::expected<void, AudioError> previous() noexcept override;
+            std::expected<void, AudioError> seek(std::chrono::seconds position) noexcept override;
+            std::expected<void, AudioError> setVolume(double volume) noexcept override;
+            std::expected<double, AudioError> getVolume() noexcept override;
+
+            AsyncResult<void> playAsync() noexcept override;
+            AsyncResult<void> pauseAsync() noexcept override;
+            AsyncResult<void> nextAsync() noexcept override;
+            AsyncResult<void> previousAsync() noexcept override;
+            AsyncResult<void> seekAsync(std::chrono::seconds position) noexcept override;
+            AsyncResult<void> setVolumeAsync(double volume) noexcept override;
+            AsyncResult<double> getVolumeAsync() noexcept override;
+            AsyncResult<TrackSnapshot> getTrackSnapshotAsync() noexcept override;
+
+            void setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept override;
+            void setPlaybackEventCallback(PlaybackEventCallback callback) noexcept override;
+            void setTrackChangedCallback(TrackChangedCallback callback) noexcept override;
+            TrackChangeStats getTrackChangeStats() const noexcept override;
+            VolumeController::SubscriptionId subscribeVolumeChanged(VolumeChangedCallback callback) noexcept override;
+            void unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept override;
+
+        private:
+            void spend(SimulatedOperation operation) const noexcept;
+            void changeTrack(int32_t step);
+            void togglePlayback();
+            void run();
+
+            const SimulationProfile m_profile;
+            std::unique_ptr<ScriptedAudioSession> m_player;
+            mutable std::array<std::atomic<uint64_t>, SimulatedOperationCount> m_calls{};
+
+            std::mutex m_trackMutex;
+            int32_t m_track{ 1 };
+
+            std::atomic<uint64_t> m_events{ 0 };
+            std::mutex m_mutex;
+            std::condition_variable m_wake;
+            bool m_stopping{ false };
+            std::thread m_worker;
+        };
+
+    }
+}
@@ -0,0 +1,154 @@
+#include "StateBlock.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+namespace audio {
+
+    namespace {
+
+        constexpr size_t TextWords = StateBlock::TextCapacity / sizeof(uint64_t);
+
+        template <typename T>
+        void store(T& field, T value) noexcept {
+            std::atomic_ref<T>(field).store(value, std::memory_order_relaxed);
+        }
+
+        template <typename T>
+        T load(const T& field) noexcept {
+            return std::atomic_ref<T>(const_cast<T&>(field)).load(std::memory_order_relaxed);
+        }
+
+        // The longest prefix of text that fits in capacity bytes without splitting a character.
+        std::string_view fit(std::string_view text, size_t capacity) noexcept {
+            if (text.size() <= capacity)
+                return text;
+            auto length = capacity;
+            while (length > 0 && (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80)
+                --length;
+            return text.substr(0, length);
+        }
+
+        size_t wordsFor(size_t bytes) noexcept {
+            return (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+        }
+
+    }
+
+    StateBlock::StateBlock() {
+        m_layout.magic = Magic;
+        m_layout.version = Version;
+        std::scoped_lock lock(m_writeMutex);
+        publish();
+    }
+
+    // The odd sequence and the release fence order it before every field store; the release
+    // store of the even sequence orders the fields before it. Text is stored only as far as
+    // the new strings reach, as the lengths keep readers from looking further.
+    void StateBlock::publish() noexcept {
+        uint64_t text[TextWords]{};
+        auto* bytes = reinterpret_cast<char*>(text);
+        size_t used = 0;
+        const auto place = [&](const std::string& value, uint32_t& offset, uint32_t& length) {
+            const auto fitted = fit(value, TextCapacity - used);
+            std::memcpy(bytes + used, fitted.data(), fitted.size());
+            offset = static_cast<uint32_t>(used);
+            length = static_cast<uint32_t>(fitted.size());
+            used += fitted.size();
+        };
+        uint32_t titleOffset = 0, titleLength = 0, artistOffset = 0, artistLength = 0, albumOffset = 0, albumLength = 0;
+        place(m_state.title, titleOffset, titleLength);
+        place(m_state.artist, artistOffset, artistLength);
+        place(m_state.album, albumOffset, albumLength);
+
+        uint32_t flags = 0;
+        if (m_state.hasSession)
+            flags |= HasSession;
+        if (m_state.muted)
+            flags |= Muted;
+
+        std::atomic_ref<uint64_t> sequence(m_layout.sequence);
+        const auto start = sequence.load(std::memory_order_relaxed);
+        sequence.store(start + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        store(m_layout.status, static_cast<int32_t>(m_state.status));
+        store(m_layout.flags, flags);
+        store(m_layout.positionMillis, static_cast<int64_t>(m_state.position.count()));
+        store(m_layout.anchorNanos, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(m_state.anchoredAt.time_since_epoch()).count()));
+        store(m_layout.durationMillis, static_cast<int64_t>(m_state.duration.count()));
+        store(m_layout.rate, m_state.rate);
+        store(m_layout.volume, m_state.volume);
+        store(m_layout.trackId, m_state.trackId);
+        store(m_layout.titleOffset, titleOffset);
+        store(m_layout.titleLength, titleLength);
+        store(m_layout.artistOffset, artistOffset);
+        store(m_layout.artistLength, artistLength);
+        store(m_layout.albumOffset, albumOffset);
+        store(m_layout.albumLength, albumLength);
+        for (size_t i = 0; i < wordsFor(used); ++i)
+            store(m_layout.text[i], text[i]);
+
+        sequence.store(start + 2, std::memory_order_release);
+    }
+
+    // Lengths read during a write can be anything, so they are clamped before they are used;
+    // the copy is thrown away afterwards anyway.
+    StateBlock::State StateBlock::read() const {
+        std::atomic_ref<uint64_t> sequence(const_cast<uint64_t&>(m_layout.sequence));
+        Layout copy;
+        while (true) {
+            const auto before = sequence.load(std::memory_order_acquire);
+            if (before % 2 == 0) {
+                copy.status = load(m_layout.status);
+                copy.flags = load(m_layout.flags);
+                copy.positionMillis = load(m_layout.positionMillis);
+                copy.anchorNanos = load(m_layout.anchorNanos);
+                copy.durationMillis = load(m_layout.durationMillis);
+                copy.rate = load(m_layout.rate);
+                copy.volume = load(m_layout.volume);
+                copy.trackId = load(m_layout.trackId);
+                copy.titleOffset = std::min<uint32_t>(load(m_layout.titleOffset), TextCapacity);
+                copy.titleLength = std::min<uint32_t>(load(m_layout.titleLength), TextCapacity - copy.titleOffset);
+                copy.artistOffset = std::min<uint32_t>(load(m_layout.artistOffset), TextCapacity);
+                copy.artistLength = std::min<uint32_t>(load(m_layout.artistLength), TextCapacity - copy.artistOffset);
+                copy.albumOffset = std::min<uint32_t>(load(m_layout.albumOffset), TextCapacity);
+                copy.albumLength = std::min<uint32_t>(load(m_layout.albumLength), TextCapacity - copy.albumOffset);
+                const auto used = std::max({ copy.titleOffset + copy.titleLength, copy.artistOffset + copy.artistLength, copy.albumOffset + copy.albumLength });
+                for (size_t i = 0; i < wordsFor(used); ++i)
+                    copy.text[i] = load(m_layout.text[i]);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before)
+                    break;
+            }
+            m_retries.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+        }
+
+        const auto* bytes = reinterpret_cast<const char*>(copy.text);
+        State state;
+        state.status = static_cast<PlaybackStatus>(copy.status);
+        state.hasSession = (copy.flags & HasSession) != 0;
+        state.muted = (copy.flags & Muted) != 0;
+        state.position = std::chrono::milliseconds(copy.positionMillis);
+        state.anchoredAt = Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(copy.anchorNanos)));
+        state.duration = std::chrono::milliseconds(copy.durationMillis);
+        state.rate = copy.rate;
+        state.volume = copy.volume;
+        state.trackId = copy.trackId;
+        state.title.assign(bytes + copy.titleOffset, copy.titleLength);
+        state.artist.assign(bytes + copy.artistOffset, copy.artistLength);
+        state.album.assign(bytes + copy.albumOffset, copy.albumLength);
+        return state;
+    }
+
+    StateBlock::Stats StateBlock::stats() const noexcept {
+        Stats stats;
+        // Every publish adds two; the one in the constructor is not counted.
+        stats.writes = std::atomic_ref<uint64_t>(const_cast<uint64_t&>(m_layout.sequence)).load(std::memory_order_relaxed) / 2 - 1;
+        stats.retries = m_retries.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include "SessionStateCache.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <type_traits>
+
+namespace audio {
+
+    // The active session's state in one fixed-layout block that readers map instead of calling
+    // in: AudioAPI.java views it as a MemorySegment. Writers take turns and publish whole
+    // states under a seqlock; a reader copies the block and keeps the copy only if the sequence
+    // was even and unchanged around it, so it never sees half of one state and half of another.
+    // Every field is written and read with word-sized atomic accesses.
+    class StateBlock {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr uint32_t Magic = 0x4F535442;
+        static constexpr uint32_t Version = 1;
+        static constexpr size_t TextCapacity = 1536;
+
+        enum Flags : uint32_t {
+            HasSession = 1u << 0,
+            Muted = 1u << 1,
+        };
+
+        // Shared with AudioAPI.java; the offsets below are part of the ABI. Fields are only
+        // ever added at the end, with Version bumped.
+        struct Layout {
+            uint32_t magic;
+            uint32_t version;
+            // Odd while a write is in progress.
+            uint64_t sequence;
+            // PlaybackStatus.
+            int32_t status;
+            uint32_t flags;
+            // The position was positionMillis at anchorNanos on the steady clock, the clock of
+            // System.nanoTime on the supported platforms; it advances at rate while playing.
+            int64_t positionMillis;
+            int64_t anchorNanos;
+            int64_t durationMillis;
+            double rate;
+            // Negative until the session's volume is known.
+            double volume;
+            // HistoryJournal::trackId of the current track, 0 without one.
+            uint64_t trackId;
+            // Byte ranges of text; the strings are UTF-8 and not terminated.
+            uint32_t titleOffset;
+            uint32_t titleLength;
+            uint32_t artistOffset;
+            uint32_t artistLength;
+            uint32_t albumOffset;
+            uint32_t albumLength;
+            // Held as words so it is published with the same atomic stores as the rest.
+            uint64_t text[TextCapacity / sizeof(uint64_t)];
+        };
+
+        static_assert(std::is_standard_layout_v<Layout> && std::is_trivially_copyable_v<Layout>);
+        static_assert(offsetof(Layout, sequence) == 8 && offsetof(Layout, status) == 16 && offsetof(Layout, positionMillis) == 24);
+        static_assert(offsetof(Layout, rate) == 48 && offsetof(Layout, trackId) == 64 && offsetof(Layout, titleOffset) == 72);
+        static_assert(offsetof(Layout, text) == 96 && sizeof(Layout) == 96 + TextCapacity);
+        static_assert(std::atomic_ref<uint64_t>::is_always_lock_free && std::atomic_ref<uint64_t>::required_alignment <= alignof(uint64_t));
+
+        // What the block holds, unpacked. Text longer than its share of TextCapacity is cut at a
+        // character boundary: the title first, then the artist, then the album.
+        struct State {
+            PlaybackStatus status{ PlaybackStatus::Closed };
+            bool hasSession{ false };
+            bool muted{ false };
+            std::chrono::milliseconds position{ 0 };
+            Clock::time_point anchoredAt{};
+            std::chrono::milliseconds duration{ 0 };
+            double rate{ 1.0 };
+            double volume{ -1.0 };
+            uint64_t trackId{ 0 };
+            std::string title;
+            std::string artist;
+            std::string album;
+        };
+
+        struct Stats {
+            uint64_t writes{ 0 };
+            // Reads through read() that found a write in progress and tried again.
+            uint64_t retries{ 0 };
+        };
+
+        StateBlock();
+        StateBlock(const StateBlock&) = delete;
+        StateBlock& operator=(const StateBlock&) = delete;
+
+        // Applies change to the last published state and publishes the result.
+        template <typename Change>
+        void update(Change&& change) {
+            std::scoped_lock lock(m_writeMutex);
+            change(m_state);
+            publish();
+        }
+
+        // A consistent copy, spinning while a write is in progress.
+        [[nodiscard]] State read() const;
+        // Stays valid, at the same address, for the lifetime of the block.
+        [[nodiscard]] const Layout* layout() const noexcept { return &m_layout; }
+        [[nodiscard]] Stats stats() const noexcept;
+
+    private:
+        // Called with m_writeMutex held.
+        void publish() noexcept;
+
+        alignas(64) Layout m_layout{};
+
+        std::mutex m_writeMutex;
+        State m_state;
+        mutable std::atomic<uint64_t> m_retries{ 0 };
+    };
+
+}
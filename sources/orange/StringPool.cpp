@@ -0,0 +1,46 @@
+#include "StringPool.h"
+
+namespace audio {
+
+    std::expected<std::string_view, AudioError> StringPool::intern(std::string_view text) noexcept {
+        std::scoped_lock lock(m_mutex);
+        if (auto found = m_entries.find(text); found != m_entries.end()) {
+            ++m_hits;
+            found->second = m_epoch;
+            return found->first;
+        }
+        try {
+            auto inserted = m_entries.emplace(std::string(text), m_epoch).first;
+            ++m_misses;
+            m_bytes += inserted->first.size();
+            return inserted->first;
+        }
+        catch (const std::exception& ex) {
+            return std::unexpected(AudioError::fromException("Intern text", ex));
+        }
+    }
+
+    // Entries interned during the epoch that is ending survive, so a caller that polls the same
+    // track and releases after every poll never frees and reallocates its text; only entries
+    // left alone for a whole epoch go.
+    void StringPool::advanceEpoch() noexcept {
+        std::scoped_lock lock(m_mutex);
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->second < m_epoch) {
+                m_bytes -= it->first.size();
+                ++m_reclaimed;
+                it = m_entries.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        ++m_epoch;
+    }
+
+    StringPool::Stats StringPool::stats() const noexcept {
+        std::scoped_lock lock(m_mutex);
+        return { m_entries.size(), m_bytes, m_hits, m_misses, m_reclaimed, m_epoch };
+    }
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "AudioError.h"
+#include <expected>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+
+namespace audio {
+
+    // Interning pool for metadata text. Equal strings share one copy, and interning a string the
+    // pool already holds neither allocates nor copies. The views it returns, which are always
+    // NUL-terminated, stay valid until the next advanceEpoch(); that call frees only what no one
+    // has interned since the call before it, so text that is being polled stays put.
+    class StringPool {
+    public:
+        struct Stats {
+            uint64_t strings{ 0 };
+            uint64_t bytes{ 0 };
+            uint64_t hits{ 0 };
+            uint64_t misses{ 0 };
+            uint64_t reclaimed{ 0 };
+            uint64_t epoch{ 0 };
+        };
+
+        StringPool() = default;
+        StringPool(const StringPool&) = delete;
+        StringPool& operator=(const StringPool&) = delete;
+
+        // Fails only if a new entry cannot be allocated.
+        [[nodiscard]] std::expected<std::string_view, AudioError> intern(std::string_view text) noexcept;
+        // Ends the current epoch: views handed out before this call may no longer be used.
+        void advanceEpoch() noexcept;
+
+        [[nodiscard]] Stats stats() const noexcept;
+
+    private:
+        struct Hash {
+            using is_transparent = void;
+            size_t operator()(std::string_view text) const noexcept { return std::hash<std::string_view>{}(text); }
+        };
+
+        // Node-based, so an entry's string never moves while it is in the map.
+        std::unordered_map<std::string, uint64_t, Hash, std::equal_to<>> m_entries;
+        mutable std::mutex m_mutex;
+        uint64_t m_epoch{ 0 };
+        uint64_t m_bytes{ 0 };
+        uint64_t m_hits{ 0 };
+        uint64_t m_misses{ 0 };
+        uint64_t m_reclaimed{ 0 };
+    };
+
+}
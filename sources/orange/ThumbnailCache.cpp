@@ -0,0 +1,110 @@
+#include "ThumbnailCache.h"
+#include "Tracer.h"
+#include <cstring>
+#include <utility>
+
+namespace audio {
+
+    ThumbnailCache::ThumbnailCache(size_t budgetBytes)
+        : m_budget(budgetBytes) {
+    }
+
+    ThumbnailCache::Buffer ThumbnailCache::find(const void* reference) {
+        std::scoped_lock lock(m_mutex);
+        auto it = m_byReference.find(reference);
+        if (it == m_byReference.end()) {
+            ++m_misses;
+            return nullptr;
+        }
+        ++m_hits;
+        touch(it->second.blob);
+        return it->second.blob->buffer;
+    }
+
+    ThumbnailCache::Buffer ThumbnailCache::insert(const void* reference, std::shared_ptr<const void> keepAlive, std::vector<uint8_t> bytes) {
+        TraceSpan trace("cache", "Thumbnail insert");
+        auto hash = contentHash(bytes);
+
+        std::scoped_lock lock(m_mutex);
+        if (auto known = m_byReference.find(reference); known != m_byReference.end()) {
+            touch(known->second.blob);
+            return known->second.blob->buffer;
+        }
+
+        if (auto same = m_byHash.find(hash); same != m_byHash.end()) {
+            auto blob = same->second;
+            // Equal hashes are only a hint; a collision gets a private buffer that is not cached.
+            if (*blob->buffer != bytes)
+                return std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+            ++m_deduplicated;
+            link(reference, std::move(keepAlive), blob);
+            touch(blob);
+            return blob->buffer;
+        }
+
+        auto buffer = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+        m_lru.push_front(Blob{ hash, buffer, {} });
+        m_byHash.emplace(hash, m_lru.begin());
+        m_bytes += buffer->size();
+        link(reference, std::move(keepAlive), m_lru.begin());
+        evictOverBudget();
+        return buffer;
+    }
+
+    void ThumbnailCache::setBudget(size_t budgetBytes) {
+        std::scoped_lock lock(m_mutex);
+        m_budget = budgetBytes;
+        evictOverBudget();
+    }
+
+    ThumbnailCache::Stats ThumbnailCache::stats() const {
+        std::scoped_lock lock(m_mutex);
+        return { m_hits, m_misses, m_deduplicated, m_evictions, m_lru.size(), m_bytes, m_budget };
+    }
+
+    // Word-at-a-time multiply/xorshift mix. Only used to find candidates, which are compared in
+    // full before being shared, so speed matters more than distribution quality.
+    uint64_t ThumbnailCache::contentHash(std::span<const uint8_t> bytes) noexcept {
+        constexpr uint64_t Multiplier = 0x9E3779B97F4A7C15ull;
+        uint64_t hash = static_cast<uint64_t>(bytes.size()) * Multiplier;
+        size_t offset = 0;
+        for (; offset + sizeof(uint64_t) <= bytes.size(); offset += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, bytes.data() + offset, sizeof(word));
+            hash = (hash ^ word) * Multiplier;
+            hash ^= hash >> 32;
+        }
+        if (offset < bytes.size()) {
+            uint64_t tail = 0;
+            std::memcpy(&tail, bytes.data() + offset, bytes.size() - offset);
+            hash = (hash ^ tail) * Multiplier;
+        }
+        return hash ^ (hash >> 29);
+    }
+
+    void ThumbnailCache::touch(std::list<Blob>::iterator blob) {
+        m_lru.splice(m_lru.begin(), m_lru, blob);
+    }
+
+    void ThumbnailCache::link(const void* reference, std::shared_ptr<const void> keepAlive, std::list<Blob>::iterator blob) {
+        if (blob->references.size() == MaxReferencesPerBlob) {
+            m_byReference.erase(blob->references.front());
+            blob->references.erase(blob->references.begin());
+        }
+        blob->references.push_back(reference);
+        m_byReference.insert_or_assign(reference, Reference{ std::move(keepAlive), blob });
+    }
+
+    void ThumbnailCache::evictOverBudget() {
+        while (m_bytes > m_budget && !m_lru.empty()) {
+            auto& blob = m_lru.back();
+            for (const void* reference : blob.references)
+                m_byReference.erase(reference);
+            m_byHash.erase(blob.hash);
+            m_bytes -= blob.buffer->size();
+            ++m_evictions;
+            m_lru.pop_back();
+        }
+    }
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace audio {
+
+    // Encoded artwork shared between sessions. Buffers are immutable and reference counted, so a
+    // caller that holds one keeps it valid even after the cache has evicted it. Lookups go through
+    // the identity of the backend's stream reference first; a miss is then matched by content, so
+    // the same cover reported under several references (one per track of an album) is stored once.
+    class ThumbnailCache {
+    public:
+        using Buffer = std::shared_ptr<const std::vector<uint8_t>>;
+
+        static constexpr size_t DefaultBudgetBytes = 16 * 1024 * 1024;
+        // Players may hand out a fresh reference object on every properties fetch; only the most
+        // recent ones are remembered, older ones fall back to the content match.
+        static constexpr size_t MaxReferencesPerBlob = 8;
+
+        struct Stats {
+            uint64_t hits{ 0 };
+            uint64_t misses{ 0 };
+            uint64_t deduplicated{ 0 };
+            uint64_t evictions{ 0 };
+            size_t entries{ 0 };
+            size_t bytes{ 0 };
+            size_t budgetBytes{ 0 };
+        };
+
+        explicit ThumbnailCache(size_t budgetBytes = DefaultBudgetBytes);
+        ThumbnailCache(const ThumbnailCache&) = delete;
+        ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+        // reference is only compared, never dereferenced; keepAlive must own whatever it points
+        // to so the address cannot be reused by another stream while the cache remembers it.
+        [[nodiscard]] Buffer find(const void* reference);
+        Buffer insert(const void* reference, std::shared_ptr<const void> keepAlive, std::vector<uint8_t> bytes);
+
+        // Shrinking the budget evicts least recently used artwork right away.
+        void setBudget(size_t budgetBytes);
+        [[nodiscard]] Stats stats() const;
+
+        [[nodiscard]] static uint64_t contentHash(std::span<const uint8_t> bytes) noexcept;
+
+    private:
+        struct Blob {
+            uint64_t hash;
+            Buffer buffer;
+            std::vector<const void*> references;
+        };
+
+        struct Reference {
+            std::shared_ptr<const void> keepAlive;
+            std::list<Blob>::iterator blob;
+        };
+
+        void touch(std::list<Blob>::iterator blob);
+        void link(const void* reference, std::shared_ptr<const void> keepAlive, std::list<Blob>::iterator blob);
+        void evictOverBudget();
+
+        mutable std::mutex m_mutex;
+        size_t m_budget;
+        size_t m_bytes{ 0 };
+        // Most recently used first.
+        std::list<Blob> m_lru;
+        std::unordered_map<uint64_t, std::list<Blob>::iterator> m_byHash;
+        std::unordered_map<const void*, Reference> m_byReference;
+
+        uint64_t m_hits{ 0 };
+        uint64_t m_misses{ 0 };
+        uint64_t m_deduplicated{ 0 };
+        uint64_t m_evictions{ 0 };
+    };
+
+}
@@ -0,0 +1,187 @@
+#include "ThumbnailProcessor.h"
+#include <algorithm>
+
+namespace audio {
+
+    namespace {
+
+        // Zero would mean "no limit" to the scaler, which is never a useful thumbnail.
+        std::vector<uint32_t> normalized(std::vector<uint32_t> sizes) {
+            std::erase(sizes, 0u);
+            std::sort(sizes.begin(), sizes.end());
+            sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+            return sizes;
+        }
+
+    }
+
+    ThumbnailProcessor::ThumbnailProcessor(std::unique_ptr<IImageDecoder> decoder, std::vector<uint32_t> sizes)
+        : m_decoder(std::move(decoder)),
+        m_sizes(normalized(std::move(sizes))),
+        m_worker([this] { run(); }) {
+    }
+
+    ThumbnailProcessor::~ThumbnailProcessor() {
+        stop();
+    }
+
+    void ThumbnailProcessor::stop() {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        if (m_worker.joinable())
+            m_worker.join();
+    }
+
+    void ThumbnailProcessor::refresh(Source source) {
+        m_requests.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::scoped_lock lock(m_mutex);
+            if (m_stopping)
+                return;
+            if (m_pending)
+                m_superseded.fetch_add(1, std::memory_order_relaxed);
+            m_lastSource = source;
+            m_pending = std::move(source);
+            ++m_generation;
+            m_current.reset();
+            m_currentError.reset();
+        }
+        m_wake.notify_one();
+    }
+
+    void ThumbnailProcessor::setSizes(std::vector<uint32_t> sizes) {
+        Source source;
+        {
+            std::scoped_lock lock(m_mutex);
+            m_sizes = normalized(std::move(sizes));
+            source = m_lastSource;
+        }
+        if (source)
+            refresh(std::move(source));
+    }
+
+    std::vector<uint32_t> ThumbnailProcessor::sizes() const {
+        std::scoped_lock lock(m_mutex);
+        return m_sizes;
+    }
+
+    std::expected<ThumbnailProcessor::Image, AudioError> ThumbnailProcessor::get(uint32_t size) const {
+        std::scoped_lock lock(m_mutex);
+        if (std::find(m_sizes.begin(), m_sizes.end(), size) == m_sizes.end())
+            return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Get scaled thumbnail"));
+        if (!m_current)
+            return std::unexpected(m_currentError.value_or(AudioError(ErrorCategory::NotReady, "Get scaled thumbnail")));
+        for (const auto& [variantSize, image] : m_current->variants) {
+            if (variantSize == size)
+                return image;
+        }
+        return std::unexpected(AudioError(ErrorCategory::NotReady, "Get scaled thumbnail"));
+    }
+
+    ThumbnailProcessor::Stats ThumbnailProcessor::stats() const noexcept {
+        Stats stats;
+        stats.requests = m_requests.load(std::memory_order_relaxed);
+        stats.superseded = m_superseded.load(std::memory_order_relaxed);
+        stats.decodes = m_decodes.load(std::memory_order_relaxed);
+        stats.reused = m_reused.load(std::memory_order_relaxed);
+        stats.failures = m_failures.load(std::memory_order_relaxed);
+        stats.lastDecodeTime = std::chrono::microseconds(m_lastDecodeMicros.load(std::memory_order_relaxed));
+        return stats;
+    }
+
+    void ThumbnailProcessor::run() {
+        m_decoder->attachThread();
+        for (;;) {
+            Source source;
+            std::vector<uint32_t> sizes;
+            uint64_t generation = 0;
+            {
+                std::unique_lock lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stopping || m_pending; });
+                if (m_stopping)
+                    return;
+                source = std::move(m_pending);
+                m_pending = nullptr;
+                sizes = m_sizes;
+                generation = m_generation;
+            }
+
+            auto result = process(source, sizes);
+            if (!result)
+                m_failures.fetch_add(1, std::memory_order_relaxed);
+
+            std::scoped_lock lock(m_mutex);
+            // A newer refresh owns the published state now; this result is only kept for reuse.
+            if (generation != m_generation)
+                continue;
+            if (result)
+                m_current = std::move(*result);
+            else
+                m_currentError = std::move(result.error());
+        }
+    }
+
+    std::expected<std::shared_ptr<const ThumbnailProcessor::Prepared>, AudioError> ThumbnailProcessor::process(const Source& source, const std::vector<uint32_t>& sizes) {
+        auto encoded = source();
+        if (!encoded)
+            return std::unexpected(encoded.error());
+        if (!*encoded || (*encoded)->empty())
+            return std::unexpected(AudioError(ErrorCategory::NotFound, "Get thumbnail"));
+
+        if (auto prepared = findPrepared(*encoded, sizes)) {
+            m_reused.fetch_add(1, std::memory_order_relaxed);
+            return prepared;
+        }
+
+        auto started = Clock::now();
+        auto decoded = m_decoder->decode(**encoded);
+        if (!decoded)
+            return std::unexpected(decoded.error());
+
+        auto prepared = std::make_shared<Prepared>();
+        prepared->encoded = *encoded;
+
+        // Largest first, each variant scaled from the previous one: only the first pass reads the
+        // full decoded image, the smaller ones start from an already reduced copy.
+        std::vector<uint32_t> descending = sizes;
+        std::sort(descending.begin(), descending.end(), std::greater<>());
+        const RgbaImage* from = &*decoded;
+        for (uint32_t size : descending) {
+            auto image = std::make_shared<const RgbaImage>(ImageScaler::fit(*from, size));
+            from = image.get();
+            prepared->variants.emplace_back(size, std::move(image));
+        }
+
+        m_lastDecodeMicros.store(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started).count(), std::memory_order_relaxed);
+        m_decodes.fetch_add(1, std::memory_order_relaxed);
+        remember(prepared);
+        return prepared;
+    }
+
+    std::shared_ptr<const ThumbnailProcessor::Prepared> ThumbnailProcessor::findPrepared(const ThumbnailCache::Buffer& encoded, const std::vector<uint32_t>& sizes) {
+        for (auto it = m_prepared.begin(); it != m_prepared.end(); ++it) {
+            const auto& prepared = *it;
+            if (prepared->encoded != encoded || prepared->variants.size() != sizes.size())
+                continue;
+            bool complete = std::all_of(sizes.begin(), sizes.end(), [&](uint32_t size) {
+                return std::any_of(prepared->variants.begin(), prepared->variants.end(),
+                    [size](const auto& variant) { return variant.first == size; });
+            });
+            if (!complete)
+                continue;
+            m_prepared.splice(m_prepared.begin(), m_prepared, it);
+            return m_prepared.front();
+        }
+        return nullptr;
+    }
+
+    void ThumbnailProcessor::remember(std::shared_ptr<const Prepared> prepared) {
+        m_prepared.push_front(std::move(prepared));
+        if (m_prepared.size() > MaxPreparedArtwork)
+            m_prepared.pop_back();
+    }
+
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "AudioError.h"
+#include "ImageScaler.h"
+#include "ThumbnailCache.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <expected>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+namespace audio {
+
+    // Turns encoded artwork into premultiplied RGBA. Implementations are called from the
+    // processor's worker thread only.
+    class IImageDecoder {
+    public:
+        virtual ~IImageDecoder() = default;
+        // Runs once on the worker before any artwork is fetched there, for per-thread setup such
+        // as joining a COM apartment.
+        virtual void attachThread() noexcept {}
+        virtual std::expected<RgbaImage, AudioError> decode(std::span<const uint8_t> encoded) noexcept = 0;
+    };
+
+    // Decodes the active track's artwork on a background thread and keeps it scaled to every
+    // registered size, so a UI can ask for a ready-made variant without touching a codec. Work is
+    // keyed by the shared artwork buffer, which the thumbnail cache already deduplicates by content,
+    // so tracks of one album and a return to a recent track are served without decoding again.
+    class ThumbnailProcessor {
+    public:
+        using Image = std::shared_ptr<const RgbaImage>;
+        // Runs on the worker; fetches whatever artwork is current at that moment.
+        using Source = std::function<std::expected<ThumbnailCache::Buffer, AudioError>()>;
+
+        static constexpr size_t MaxPreparedArtwork = 8;
+
+        struct Stats {
+            uint64_t requests{ 0 };
+            uint64_t superseded{ 0 };
+            uint64_t decodes{ 0 };
+            uint64_t reused{ 0 };
+            uint64_t failures{ 0 };
+            std::chrono::microseconds lastDecodeTime{ 0 };
+        };
+
+        ThumbnailProcessor(std::unique_ptr<IImageDecoder> decoder, std::vector<uint32_t> sizes = { 64, 128, 512 });
+        ~ThumbnailProcessor();
+        ThumbnailProcessor(const ThumbnailProcessor&) = delete;
+        ThumbnailProcessor& operator=(const ThumbnailProcessor&) = delete;
+
+        // Schedules the current artwork for processing. Until it is ready get() reports not ready
+        // rather than handing out the previous track's image; a refresh still waiting when a newer
+        // one arrives is dropped.
+        void refresh(Source source);
+        // Joins the worker; refreshes after this are ignored. Owners whose Source reaches into
+        // objects destroyed before the processor call it first.
+        void stop();
+        // Replaces the registered sizes and reprocesses the current artwork with them.
+        void setSizes(std::vector<uint32_t> sizes);
+        [[nodiscard]] std::vector<uint32_t> sizes() const;
+
+        // Never blocks on decoding. size must be one of the registered sizes.
+        [[nodiscard]] std::expected<Image, AudioError> get(uint32_t size) const;
+        [[nodiscard]] Stats stats() const noexcept;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Prepared {
+            ThumbnailCache::Buffer encoded;
+            std::vector<std::pair<uint32_t, Image>> variants;
+        };
+
+        void run();
+        std::expected<std::shared_ptr<const Prepared>, AudioError> process(const Source& source, const std::vector<uint32_t>& sizes);
+        std::shared_ptr<const Prepared> findPrepared(const ThumbnailCache::Buffer& encoded, const std::vector<uint32_t>& sizes);
+        void remember(std::shared_ptr<const Prepared> prepared);
+
+        std::unique_ptr<IImageDecoder> m_decoder;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::vector<uint32_t> m_sizes;
+        Source m_lastSource;
+        Source m_pending;
+        uint64_t m_generation{ 0 };
+        bool m_stopping{ false };
+        std::shared_ptr<const Prepared> m_current;
+        std::optional<AudioError> m_currentError;
+        // Worker only; most recently used first.
+        std::list<std::shared_ptr<const Prepared>> m_prepared;
+
+        std::atomic<uint64_t> m_requests{ 0 };
+        std::atomic<uint64_t> m_superseded{ 0 };
+        std::atomic<uint64_t> m_decodes{ 0 };
+        std::atomic<uint64_t> m_reused{ 0 };
+        std::atomic<uint64_t> m_failures{ 0 };
+        std::atomic<int64_t> m_lastDecodeMicros{ 0 };
+
+        std::thread m_worker;
+    };
+
+}
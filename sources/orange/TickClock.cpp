@@ -0,0 +1,39 @@
+#include "TickClock.h"
+
+namespace audio {
+
+    namespace {
+
+        struct Origin {
+            std::chrono::steady_clock::time_point time;
+            TickClock::Ticks ticks;
+        };
+
+        const Origin& origin() noexcept {
+            static const Origin start{ std::chrono::steady_clock::now(), TickClock::now() };
+            return start;
+        }
+
+    }
+
+    void TickClock::calibrate() noexcept {
+        origin();
+    }
+
+    double TickClock::nanosPerTick() noexcept {
+#ifdef AUDIO_HAS_TSC
+        const auto& start = origin();
+        const auto ticks = now() - start.ticks;
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start.time);
+        return ticks > 0 ? elapsed.count() / static_cast<double>(ticks) : 1.0;
+#else
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::duration(1)).count();
+#endif
+    }
+
+    std::chrono::nanoseconds TickClock::sinceOrigin(Ticks ticks, double nanosPerTick) noexcept {
+        const auto offset = static_cast<int64_t>(ticks - origin().ticks);
+        return std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(offset) * nanosPerTick));
+    }
+
+}
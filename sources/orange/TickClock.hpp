@@ -0,0 +1,38 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define AUDIO_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define AUDIO_HAS_TSC 1
+#endif
+
+namespace audio {
+
+    // Timestamps for instrumentation: the CPU's time-stamp counter on x86, which is invariant on
+    // every processor we run on and is what QueryPerformanceCounter reads anyway, at half the
+    // cost of a steady_clock read; steady_clock elsewhere. Ticks are only turned into time when
+    // they are reported.
+    class TickClock {
+    public:
+        using Ticks = uint64_t;
+
+        [[nodiscard]] static Ticks now() noexcept {
+#ifdef AUDIO_HAS_TSC
+            return __rdtsc();
+#else
+            return static_cast<Ticks>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+        // Measured against steady_clock since the origin was taken.
+        [[nodiscard]] static double nanosPerTick() noexcept;
+        // Time from the origin to ticks, for placing events on one timeline.
+        [[nodiscard]] static std::chrono::nanoseconds sinceOrigin(Ticks ticks, double nanosPerTick) noexcept;
+        // Takes the origin if nothing has yet; call it early so there is history to scale by.
+        static void calibrate() noexcept;
+    };
+
+}
@@ -0,0 +1,307 @@
+#include "Tracer.h"
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace audio {
+
+    namespace {
+
+        constexpr auto FlushInterval = std::chrono::milliseconds(20);
+
+        struct Span {
+            const char* category;
+            const char* name;
+            TickClock::Ticks started;
+            TickClock::Ticks finished;
+        };
+
+        // Single producer (the owning thread), single consumer (the flusher). The producer only
+        // writes head and the consumer only writes tail; both only ever grow.
+        struct ThreadBuffer {
+            static constexpr size_t Capacity = 16384;
+
+            explicit ThreadBuffer(uint32_t thread) noexcept : thread(thread) {}
+
+            alignas(64) std::atomic<uint64_t> head{ 0 };
+            std::atomic<uint64_t> dropped{ 0 };
+            alignas(64) std::atomic<uint64_t> tail{ 0 };
+            std::atomic<bool> retired{ false };
+            const uint32_t thread;
+            std::array<Span, Capacity> spans;
+        };
+
+        // Lets the flusher forget a buffer once its thread has exited and the buffer is drained.
+        struct BufferHandle {
+            std::shared_ptr<ThreadBuffer> buffer;
+
+            ~BufferHandle() {
+                if (buffer)
+                    buffer->retired.store(true, std::memory_order_release);
+            }
+        };
+
+        thread_local BufferHandle t_buffer;
+
+        int processId() noexcept {
+#ifdef _WIN32
+            return _getpid();
+#else
+            return static_cast<int>(getpid());
+#endif
+        }
+
+        void appendString(std::string& out, const char* text) {
+            out += '"';
+            for (const char* c = text; *c; ++c) {
+                if (*c == '"' || *c == '\\')
+                    out += '\\';
+                if (static_cast<unsigned char>(*c) >= 0x20)
+                    out += *c;
+            }
+            out += '"';
+        }
+
+        class TraceState {
+        public:
+            std::expected<void, AudioError> start(const std::string& path, std::atomic<bool>& enabled) {
+                if (path.empty())
+                    return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Start trace"));
+                std::scoped_lock control(m_controlMutex);
+                if (m_file)
+                    return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Start trace", 0, "a trace is already running"));
+                std::FILE* file = std::fopen(path.c_str(), "wb");
+                if (!file)
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Start trace", errno, path));
+                // Unbuffered, and each flush is a single write, so a process that exits while
+                // tracing leaves a file that ends after a complete span.
+                std::setvbuf(file, nullptr, _IONBF, 0);
+                std::fputs("[\n", file);
+                m_file = file;
+                m_first = true;
+                m_pid = processId();
+                TickClock::calibrate();
+                {
+                    std::scoped_lock lock(m_mutex);
+                    // Spans left over from an earlier trace belong to that one.
+                    for (auto& buffer : m_buffers)
+                        buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+                    m_stopping = false;
+                }
+                m_flusher = std::thread([this] { run(); });
+                enabled.store(true, std::memory_order_release);
+                return {};
+            }
+
+            void stop(std::atomic<bool>& enabled) noexcept {
+                std::scoped_lock control(m_controlMutex);
+                if (!m_file)
+                    return;
+                enabled.store(false, std::memory_order_release);
+                {
+                    std::scoped_lock lock(m_mutex);
+                    m_stopping = true;
+                }
+                m_wake.notify_all();
+                if (m_flusher.joinable())
+                    m_flusher.join();
+                std::fputs("\n]\n", m_file);
+                std::fclose(m_file);
+                m_file = nullptr;
+            }
+
+            void record(const Span& span) noexcept {
+                auto* buffer = t_buffer.buffer.get();
+                if (!buffer) {
+                    buffer = attach();
+                    if (!buffer)
+                        return;
+                }
+                const auto head = buffer->head.load(std::memory_order_relaxed);
+                if (head - buffer->tail.load(std::memory_order_acquire) >= ThreadBuffer::Capacity) {
+                    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                buffer->spans[head % ThreadBuffer::Capacity] = span;
+                buffer->head.store(head + 1, std::memory_order_release);
+            }
+
+            Tracer::Stats stats() {
+                Tracer::Stats stats;
+                {
+                    std::scoped_lock control(m_controlMutex);
+                    stats.running = m_file != nullptr;
+                }
+                std::scoped_lock lock(m_mutex);
+                stats.recorded = m_retiredRecorded;
+                stats.dropped = m_retiredDropped;
+                for (const auto& buffer : m_buffers) {
+                    stats.recorded += buffer->head.load(std::memory_order_relaxed);
+                    stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+                }
+                stats.written = m_written.load(std::memory_order_relaxed);
+                return stats;
+            }
+
+        private:
+            ThreadBuffer* attach() noexcept {
+                try {
+                    std::scoped_lock lock(m_mutex);
+                    t_buffer.buffer = std::make_shared<ThreadBuffer>(++m_nextThread);
+                    m_buffers.push_back(t_buffer.buffer);
+                    return t_buffer.buffer.get();
+                }
+                catch (...) {
+                    return nullptr;
+                }
+            }
+
+            void run() {
+                std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+                for (;;) {
+                    bool stopping;
+                    {
+                        std::unique_lock lock(m_mutex);
+                        m_wake.wait_for(lock, FlushInterval, [this] { return m_stopping; });
+                        stopping = m_stopping;
+                        buffers = m_buffers;
+                    }
+                    // Measured again on every pass: nanosPerTick() compares against steady_clock
+                    // over everything since the origin, which at start may be microseconds.
+                    m_scale = TickClock::nanosPerTick();
+                    for (const auto& buffer : buffers)
+                        drain(*buffer);
+                    if (!m_chunk.empty()) {
+                        std::fwrite(m_chunk.data(), 1, m_chunk.size(), m_file);
+                        m_chunk.clear();
+                    }
+                    forgetRetired();
+                    if (stopping)
+                        return;
+                }
+            }
+
+            // Appends the buffer's spans to m_chunk as complete events, times in microseconds.
+            void drain(ThreadBuffer& buffer) {
+                auto tail = buffer.tail.load(std::memory_order_relaxed);
+                const auto head = buffer.head.load(std::memory_order_acquire);
+                char fields[128];
+                for (; tail != head; ++tail) {
+                    const auto& span = buffer.spans[tail % ThreadBuffer::Capacity];
+                    const auto begin = TickClock::sinceOrigin(span.started, m_scale);
+                    const auto ticks = static_cast<int64_t>(span.finished - span.started);
+                    const double duration = ticks > 0 ? static_cast<double>(ticks) * m_scale / 1000.0 : 0.0;
+                    m_chunk += m_first ? "{\"name\":" : ",\n{\"name\":";
+                    m_first = false;
+                    appendString(m_chunk, span.name);
+                    m_chunk += ",\"cat\":";
+                    appendString(m_chunk, span.category);
+                    const int length = std::snprintf(fields, sizeof(fields), ",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                        m_pid, buffer.thread, static_cast<double>(begin.count()) / 1000.0, duration);
+                    if (length > 0)
+                        m_chunk.append(fields, std::min(static_cast<size_t>(length), sizeof(fields) - 1));
+                }
+                m_written.fetch_add(head - buffer.tail.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                buffer.tail.store(head, std::memory_order_release);
+            }
+
+            void forgetRetired() {
+                std::scoped_lock lock(m_mutex);
+                std::erase_if(m_buffers, [this](const std::shared_ptr<ThreadBuffer>& buffer) {
+                    if (!buffer->retired.load(std::memory_order_acquire)
+                        || buffer->tail.load(std::memory_order_relaxed) != buffer->head.load(std::memory_order_acquire))
+                        return false;
+                    m_retiredRecorded += buffer->head.load(std::memory_order_relaxed);
+                    m_retiredDropped += buffer->dropped.load(std::memory_order_relaxed);
+                    return true;
+                });
+            }
+
+            // Serialises start and stop; m_mutex guards the buffer list and the flusher's wake-up.
+            std::mutex m_controlMutex;
+            std::FILE* m_file{ nullptr };
+            std::thread m_flusher;
+            bool m_first{ true };
+            std::string m_chunk;
+            int m_pid{ 0 };
+            double m_scale{ 1.0 };
+
+            std::mutex m_mutex;
+            std::condition_variable m_wake;
+            bool m_stopping{ false };
+            std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+            uint32_t m_nextThread{ 0 };
+            uint64_t m_retiredRecorded{ 0 };
+            uint64_t m_retiredDropped{ 0 };
+            std::atomic<uint64_t> m_written{ 0 };
+        };
+
+        // Never destroyed: threads may still record while statics are torn down, and joining the
+        // flusher from a DLL's static destructors would deadlock on the loader lock.
+        TraceState& state() {
+            static auto* const instance = new TraceState;
+            return *instance;
+        }
+
+    }
+
+    std::expected<void, AudioError> Tracer::start(const std::string& path) {
+        try {
+            return state().start(path, s_enabled);
+        }
+        catch (const std::exception& ex) {
+            return std::unexpected(AudioError::fromException("Start trace", ex));
+        }
+    }
+
+    void Tracer::stop() noexcept {
+        state().stop(s_enabled);
+    }
+
+    void Tracer::startFromEnvironment() noexcept {
+        static std::once_flag once;
+        std::call_once(once, [] {
+#ifdef _MSC_VER
+            char* value = nullptr;
+            size_t length = 0;
+            if (_dupenv_s(&value, &length, EnvironmentVariable) != 0 || !value)
+                return;
+            std::unique_ptr<char, decltype(&std::free)> owned(value, &std::free);
+            const std::string path(value);
+#else
+            const char* value = std::getenv(EnvironmentVariable);
+            if (!value)
+                return;
+            const std::string path(value);
+#endif
+            if (!path.empty())
+                (void)start(path);
+        });
+    }
+
+    void Tracer::record(const char* category, const char* name, TickClock::Ticks started, TickClock::Ticks finished) noexcept {
+        state().record(Span{ category, name, started, finished });
+    }
+
+    Tracer::Stats Tracer::stats() noexcept {
+        try {
+            return state().stats();
+        }
+        catch (...) {
+            return {};
+        }
+    }
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "AudioError.h"
+#include "TickClock.h"
+#include <atomic>
+#include <expected>
+#include <string>
+#include <cstdint>
+
+namespace audio {
+
+    // Opt-in span tracer writing Chrome trace-event JSON, which chrome://tracing and Perfetto open
+    // directly. Each thread records into its own fixed ring without locking or allocating (the
+    // first span of a thread allocates its ring); a background thread drains the rings into the
+    // file every 20 ms. A span that finds its ring full is dropped and counted. While the tracer
+    // is stopped, recording is one relaxed load and a branch.
+    //
+    // Category and name are stored as pointers and read by the flusher later, so both must have
+    // static storage duration: string literals, __func__, or names from a constant table.
+    class Tracer {
+    public:
+        // When set, the first AudioSessionManager of the process starts tracing into that file.
+        static constexpr const char* EnvironmentVariable = "AUDIO_TRACE_FILE";
+
+        struct Stats {
+            bool running{ false };
+            uint64_t recorded{ 0 };
+            uint64_t dropped{ 0 };
+            uint64_t written{ 0 };
+        };
+
+        [[nodiscard]] static bool enabled() noexcept {
+            return s_enabled.load(std::memory_order_relaxed);
+        }
+
+        // Truncates path and starts writing to it. Fails if a trace is already running.
+        static std::expected<void, AudioError> start(const std::string& path);
+        // Writes what is still buffered, closes the JSON array and the file. A process that
+        // exits without stopping leaves the array open, which both viewers accept.
+        static void stop() noexcept;
+        // Starts a trace into $AUDIO_TRACE_FILE if it is set; only the first call looks.
+        static void startFromEnvironment() noexcept;
+
+        static void record(const char* category, const char* name, TickClock::Ticks started, TickClock::Ticks finished) noexcept;
+
+        [[nodiscard]] static Stats stats() noexcept;
+
+    private:
+        static inline std::atomic<bool> s_enabled{ false };
+    };
+
+    // Records the scope as one span if the tracer was running when it was entered.
+    class TraceSpan {
+    public:
+        TraceSpan(const char* category, const char* name) noexcept
+            : m_category(category), m_name(name), m_active(Tracer::enabled()) {
+            if (m_active)
+                m_started = TickClock::now();
+        }
+        ~TraceSpan() {
+            if (m_active)
+                Tracer::record(m_category, m_name, m_started, TickClock::now());
+        }
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+        const char* m_category;
+        const char* m_name;
+        const bool m_active;
+        TickClock::Ticks m_started{ 0 };
+    };
+
+}
@@ -0,0 +1,95 @@
+#include "TrackChangeWatcher.h"
+#include <utility>
+
+namespace audio {
+
+    TrackChangeWatcher::TrackChangeWatcher(Fetch fetch, Deliver deliver, std::chrono::milliseconds window)
+        : m_fetch(std::move(fetch)),
+        m_deliver(std::move(deliver)),
+        m_window(window),
+        m_worker([this] { run(); }) {
+    }
+
+    TrackChangeWatcher::~TrackChangeWatcher() {
+        stop();
+    }
+
+    void TrackChangeWatcher::stop() {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopping = true;
+            m_pending = false;
+        }
+        m_wake.notify_all();
+        if (m_worker.joinable())
+            m_worker.join();
+    }
+
+    void TrackChangeWatcher::notify() {
+        m_received.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::scoped_lock lock(m_mutex);
+            if (m_stopping || m_pending)
+                return;
+            m_pending = true;
+            m_due = Clock::now() + m_window;
+        }
+        m_wake.notify_one();
+    }
+
+    void TrackChangeWatcher::reset(std::optional<MediaInfo> baseline) {
+        std::scoped_lock lock(m_mutex);
+        m_last = std::move(baseline);
+    }
+
+    void TrackChangeWatcher::setWindow(std::chrono::milliseconds window) {
+        std::scoped_lock lock(m_mutex);
+        m_window = window;
+    }
+
+    TrackChangeStats TrackChangeWatcher::stats() const noexcept {
+        TrackChangeStats stats;
+        stats.received = m_received.load(std::memory_order_relaxed);
+        stats.fetches = m_fetches.load(std::memory_order_relaxed);
+        stats.delivered = m_delivered.load(std::memory_order_relaxed);
+        stats.unchanged = m_unchanged.load(std::memory_order_relaxed);
+        stats.failures = m_failures.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void TrackChangeWatcher::run() {
+        std::unique_lock lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [this] { return m_stopping || m_pending; });
+            while (!m_stopping && Clock::now() < m_due)
+                m_wake.wait_until(lock, m_due);
+            if (m_stopping)
+                return;
+            // Cleared before fetching, so anything that changes during the fetch is fetched again.
+            m_pending = false;
+            lock.unlock();
+
+            m_fetches.fetch_add(1, std::memory_order_relaxed);
+            std::expected<MediaInfo, AudioError> media = std::unexpected(AudioError(ErrorCategory::Internal, "Fetch media properties"));
+            if (m_fetch)
+                media = m_fetch();
+
+            lock.lock();
+            if (!media) {
+                m_failures.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (m_last == *media) {
+                m_unchanged.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            m_last = *media;
+            lock.unlock();
+            m_delivered.fetch_add(1, std::memory_order_relaxed);
+            if (m_deliver)
+                m_deliver(*media);
+            lock.lock();
+        }
+    }
+
+}
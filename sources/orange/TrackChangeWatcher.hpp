@@ -0,0 +1,71 @@
+#pragma once
+#include "AudioError.h"
+#include "IAudioSession.h"
+#include "SessionStateCache.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <expected>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace audio {
+
+    // Turns a player's MediaPropertiesChanged notifications into track changes. notify() only
+    // flags that the metadata is stale and returns, so the event thread never waits on a fetch.
+    // The worker fetches once the window after the first notification has passed, so the three to
+    // five changes a player sends per track (title first, artwork later) cost one fetch, and it
+    // delivers only when the fetched MediaInfo differs from the last one delivered. A notification
+    // that arrives while a fetch is running schedules another one.
+    class TrackChangeWatcher {
+    public:
+        // Both run on the watcher's thread.
+        using Fetch = std::function<std::expected<MediaInfo, AudioError>()>;
+        using Deliver = std::function<void(const MediaInfo&)>;
+
+        static constexpr std::chrono::milliseconds DefaultWindow{ 100 };
+
+        TrackChangeWatcher(Fetch fetch, Deliver deliver, std::chrono::milliseconds window = DefaultWindow);
+        ~TrackChangeWatcher();
+        TrackChangeWatcher(const TrackChangeWatcher&) = delete;
+        TrackChangeWatcher& operator=(const TrackChangeWatcher&) = delete;
+
+        void notify();
+        // Makes baseline the last delivered metadata without delivering it, e.g. when a session is
+        // primed; nullopt makes the next successful fetch count as a change.
+        void reset(std::optional<MediaInfo> baseline = std::nullopt);
+        void setWindow(std::chrono::milliseconds window);
+        // Joins the worker; a pending fetch is dropped and later notifications are ignored.
+        // Owners whose Fetch or Deliver reach into members destroyed first call it themselves.
+        void stop();
+
+        [[nodiscard]] TrackChangeStats stats() const noexcept;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        void run();
+
+        Fetch m_fetch;
+        Deliver m_deliver;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::chrono::milliseconds m_window;
+        bool m_pending{ false };
+        Clock::time_point m_due{};
+        bool m_stopping{ false };
+        std::optional<MediaInfo> m_last;
+
+        std::atomic<uint64_t> m_received{ 0 };
+        std::atomic<uint64_t> m_fetches{ 0 };
+        std::atomic<uint64_t> m_delivered{ 0 };
+        std::atomic<uint64_t> m_unchanged{ 0 };
+        std::atomic<uint64_t> m_failures{ 0 };
+
+        std::thread m_worker;
+    };
+
+}
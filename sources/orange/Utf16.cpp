@@ -0,0 +1,314 @@
+#include "Utf16.h"
+#include <bit>
+#include <cstdint>
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define AUDIO_HAS_SSE2 1
+// The NEON loops have not been built yet; AUDIO_UTF16_NEON opts in once an ARM64 toolchain is
+// there to check them. Without it ARM64 takes the scalar loops.
+#elif (defined(_M_ARM64) || defined(__aarch64__)) && defined(AUDIO_UTF16_NEON)
+#include <arm_neon.h>
+#define AUDIO_HAS_NEON 1
+#endif
+
+namespace audio {
+
+    namespace {
+
+        constexpr char32_t Replacement = 0xFFFD;
+
+        // Units or bytes the vector loops take per step.
+        [[maybe_unused]] constexpr size_t Block = 16;
+
+        struct Decoded {
+            char32_t code;
+            size_t consumed;
+        };
+
+        Decoded decodeUtf16(std::u16string_view text, size_t index) noexcept {
+            const char32_t unit = text[index];
+            if (unit < 0xD800 || unit > 0xDFFF)
+                return { unit, 1 };
+            if (unit <= 0xDBFF && index + 1 < text.size()) {
+                const char32_t low = text[index + 1];
+                if (low >= 0xDC00 && low <= 0xDFFF)
+                    return { 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00), 2 };
+            }
+            return { Replacement, 1 };
+        }
+
+        // An invalid sequence consumes its lead byte and the continuation bytes that were still
+        // acceptable at their position, so the next sequence starts at the first offending byte.
+        Decoded decodeUtf8(std::string_view text, size_t index) noexcept {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(text.data());
+            const unsigned char lead = bytes[index];
+            if (lead < 0x80)
+                return { lead, 1 };
+            size_t length = 0;
+            char32_t code = 0;
+            unsigned char low = 0x80;
+            unsigned char high = 0xBF;
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                length = 2;
+                code = lead & 0x1F;
+            }
+            else if (lead >= 0xE0 && lead <= 0xEF) {
+                length = 3;
+                code = lead & 0x0F;
+                if (lead == 0xE0)
+                    low = 0xA0;
+                else if (lead == 0xED)
+                    high = 0x9F;
+            }
+            else if (lead >= 0xF0 && lead <= 0xF4) {
+                length = 4;
+                code = lead & 0x07;
+                if (lead == 0xF0)
+                    low = 0x90;
+                else if (lead == 0xF4)
+                    high = 0x8F;
+            }
+            else {
+                return { Replacement, 1 };
+            }
+            for (size_t i = 1; i < length; ++i) {
+                if (index + i >= text.size() || bytes[index + i] < low || bytes[index + i] > high)
+                    return { Replacement, i };
+                code = (code << 6) | (bytes[index + i] & 0x3F);
+                low = 0x80;
+                high = 0xBF;
+            }
+            return { code, length };
+        }
+
+        // Converts the character at index if it fits, advancing index and written.
+        bool encodeUtf8(std::u16string_view text, size_t& index, char* out, size_t capacity, size_t& written) noexcept {
+            const auto [code, consumed] = decodeUtf16(text, index);
+            const size_t size = code < 0x80 ? 1 : code < 0x800 ? 2 : code < 0x10000 ? 3 : 4;
+            if (capacity - written < size)
+                return false;
+            auto* bytes = reinterpret_cast<unsigned char*>(out + written);
+            switch (size) {
+            case 1:
+                bytes[0] = static_cast<unsigned char>(code);
+                break;
+            case 2:
+                bytes[0] = static_cast<unsigned char>(0xC0 | (code >> 6));
+                bytes[1] = static_cast<unsigned char>(0x80 | (code & 0x3F));
+                break;
+            case 3:
+                bytes[0] = static_cast<unsigned char>(0xE0 | (code >> 12));
+                bytes[1] = static_cast<unsigned char>(0x80 | ((code >> 6) & 0x3F));
+                bytes[2] = static_cast<unsigned char>(0x80 | (code & 0x3F));
+                break;
+            default:
+                bytes[0] = static_cast<unsigned char>(0xF0 | (code >> 18));
+                bytes[1] = static_cast<unsigned char>(0x80 | ((code >> 12) & 0x3F));
+                bytes[2] = static_cast<unsigned char>(0x80 | ((code >> 6) & 0x3F));
+                bytes[3] = static_cast<unsigned char>(0x80 | (code & 0x3F));
+                break;
+            }
+            written += size;
+            index += consumed;
+            return true;
+        }
+
+        bool encodeUtf16(std::string_view text, size_t& index, char16_t* out, size_t capacity, size_t& written) noexcept {
+            const auto [code, consumed] = decodeUtf8(text, index);
+            if (code < 0x10000) {
+                if (capacity == written)
+                    return false;
+                out[written++] = static_cast<char16_t>(code);
+            }
+            else {
+                if (capacity - written < 2)
+                    return false;
+                out[written++] = static_cast<char16_t>(0xD800 + ((code - 0x10000) >> 10));
+                out[written++] = static_cast<char16_t>(0xDC00 + ((code - 0x10000) & 0x3FF));
+            }
+            index += consumed;
+            return true;
+        }
+
+#if defined(AUDIO_HAS_SSE2) || defined(AUDIO_HAS_NEON)
+        // The block loops below keep enough room for a whole block in the worst case, so these
+        // write without checking capacity. Only what the scalar path would need a second look
+        // at, a surrogate or an unusual lead byte, goes back to encodeUtf8 or encodeUtf16.
+        bool encodeUtf8Unchecked(std::u16string_view text, size_t& index, char* out, size_t capacity, size_t& written) noexcept {
+            const char32_t unit = text[index];
+            auto* bytes = reinterpret_cast<unsigned char*>(out + written);
+            if (unit < 0x80) {
+                bytes[0] = static_cast<unsigned char>(unit);
+                written += 1;
+            }
+            else if (unit < 0x800) {
+                bytes[0] = static_cast<unsigned char>(0xC0 | (unit >> 6));
+                bytes[1] = static_cast<unsigned char>(0x80 | (unit & 0x3F));
+                written += 2;
+            }
+            else if (unit < 0xD800 || unit > 0xDFFF) {
+                bytes[0] = static_cast<unsigned char>(0xE0 | (unit >> 12));
+                bytes[1] = static_cast<unsigned char>(0x80 | ((unit >> 6) & 0x3F));
+                bytes[2] = static_cast<unsigned char>(0x80 | (unit & 0x3F));
+                written += 3;
+            }
+            else {
+                return encodeUtf8(text, index, out, capacity, written);
+            }
+            ++index;
+            return true;
+        }
+
+        bool encodeUtf16Unchecked(std::string_view text, size_t& index, char16_t* out, size_t capacity, size_t& written) noexcept {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(text.data()) + index;
+            const unsigned char lead = bytes[0];
+            if (lead < 0x80) {
+                out[written++] = lead;
+                index += 1;
+                return true;
+            }
+            const auto continuation = [](unsigned char byte) { return (byte & 0xC0) == 0x80; };
+            const size_t left = text.size() - index;
+            if (lead >= 0xC2 && lead <= 0xDF && left >= 2 && continuation(bytes[1])) {
+                out[written++] = static_cast<char16_t>(((lead & 0x1F) << 6) | (bytes[1] & 0x3F));
+                index += 2;
+                return true;
+            }
+            // E0 and ED restrict their second byte; encodeUtf16 deals with those.
+            if (lead >= 0xE1 && lead <= 0xEF && lead != 0xED && left >= 3 && continuation(bytes[1]) && continuation(bytes[2])) {
+                out[written++] = static_cast<char16_t>(((lead & 0x0F) << 12) | ((bytes[1] & 0x3F) << 6) | (bytes[2] & 0x3F));
+                index += 3;
+                return true;
+            }
+            return encodeUtf16(text, index, out, capacity, written);
+        }
+#endif
+
+#if defined(AUDIO_HAS_SSE2)
+        // Both write a whole block, whatever it holds, and return how many leading units were
+        // ASCII; only those are kept, the caller overwrites the rest.
+        size_t narrowAscii(const char16_t* in, char* out) noexcept {
+            const auto first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            const auto second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(first, second));
+            const auto nonAscii = _mm_set1_epi16(static_cast<short>(0xFF80));
+            const auto zero = _mm_setzero_si128();
+            const auto ascii = _mm_packs_epi16(_mm_cmpeq_epi16(_mm_and_si128(first, nonAscii), zero),
+                _mm_cmpeq_epi16(_mm_and_si128(second, nonAscii), zero));
+            return static_cast<size_t>(std::countr_one(static_cast<uint32_t>(_mm_movemask_epi8(ascii))));
+        }
+
+        size_t widenAscii(const char* in, char16_t* out) noexcept {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            const auto zero = _mm_setzero_si128();
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(bytes, zero));
+            return static_cast<size_t>(std::countr_zero(static_cast<uint32_t>(_mm_movemask_epi8(bytes)) | 0x10000u));
+        }
+#elif defined(AUDIO_HAS_NEON)
+        // NEON has no movemask; narrowing shifts leave four bits per lane, which is enough to
+        // find the first lane that is set.
+        size_t firstSet(uint8x16_t lanes) noexcept {
+            const auto bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(lanes), 4)), 0);
+            return bits == 0 ? Block : static_cast<size_t>(std::countr_zero(bits)) / 4;
+        }
+
+        size_t narrowAscii(const char16_t* in, char* out) noexcept {
+            const auto first = vld1q_u16(reinterpret_cast<const uint16_t*>(in));
+            const auto second = vld1q_u16(reinterpret_cast<const uint16_t*>(in + 8));
+            vst1q_u8(reinterpret_cast<uint8_t*>(out), vcombine_u8(vmovn_u16(first), vmovn_u16(second)));
+            if (vmaxvq_u16(vorrq_u16(first, second)) < 0x80)
+                return Block;
+            const auto limit = vdupq_n_u16(0x7F);
+            return firstSet(vcombine_u8(vmovn_u16(vcgtq_u16(first, limit)), vmovn_u16(vcgtq_u16(second, limit))));
+        }
+
+        size_t widenAscii(const char* in, char16_t* out) noexcept {
+            const auto bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(in));
+            vst1q_u16(reinterpret_cast<uint16_t*>(out), vmovl_u8(vget_low_u8(bytes)));
+            vst1q_u16(reinterpret_cast<uint16_t*>(out + 8), vmovl_high_u8(bytes));
+            if (vmaxvq_u8(bytes) < 0x80)
+                return Block;
+            return firstSet(vcgeq_u8(bytes, vdupq_n_u8(0x80)));
+        }
+#endif
+
+    }
+
+    size_t Utf16::toUtf8Scalar(std::u16string_view text, char* out, size_t capacity) noexcept {
+        size_t index = 0;
+        size_t written = 0;
+        while (index < text.size() && encodeUtf8(text, index, out, capacity, written)) {
+        }
+        return written;
+    }
+
+    size_t Utf16::toUtf16Scalar(std::string_view text, char16_t* out, size_t capacity) noexcept {
+        size_t index = 0;
+        size_t written = 0;
+        while (index < text.size() && encodeUtf16(text, index, out, capacity, written)) {
+        }
+        return written;
+    }
+
+    // Takes the ASCII run at the head of each block in one step and converts the rest of the
+    // block a character at a time without capacity checks, room for the worst case having been
+    // made sure of once per block. Text with no ASCII to speak of, Cyrillic or CJK, pays one
+    // probe per block for it and is never slower than the scalar loop.
+    size_t Utf16::toUtf8(std::u16string_view text, char* out, size_t capacity) noexcept {
+        size_t index = 0;
+        size_t written = 0;
+#if defined(AUDIO_HAS_SSE2) || defined(AUDIO_HAS_NEON)
+        while (text.size() - index >= Block && capacity - written >= Block * MaxUtf8PerUnit) {
+            const auto end = index + Block;
+            const auto ascii = narrowAscii(text.data() + index, out + written);
+            index += ascii;
+            written += ascii;
+            while (index < end) {
+                if (!encodeUtf8Unchecked(text, index, out, capacity, written))
+                    return written;
+            }
+        }
+#endif
+        while (index < text.size() && encodeUtf8(text, index, out, capacity, written)) {
+        }
+        return written;
+    }
+
+    size_t Utf16::toUtf16(std::string_view text, char16_t* out, size_t capacity) noexcept {
+        size_t index = 0;
+        size_t written = 0;
+#if defined(AUDIO_HAS_SSE2) || defined(AUDIO_HAS_NEON)
+        while (text.size() - index >= Block && capacity - written >= Block + 1) {
+            const auto end = index + Block;
+            const auto ascii = widenAscii(text.data() + index, out + written);
+            index += ascii;
+            written += ascii;
+            while (index < end) {
+                if (!encodeUtf16Unchecked(text, index, out, capacity, written))
+                    return written;
+            }
+        }
+#endif
+        while (index < text.size() && encodeUtf16(text, index, out, capacity, written)) {
+        }
+        return written;
+    }
+
+    std::string Utf16::toUtf8(std::u16string_view text) {
+        std::string result;
+        result.resize_and_overwrite(text.size() * MaxUtf8PerUnit, [&](char* out, size_t capacity) {
+            return toUtf8(text, out, capacity);
+            });
+        return result;
+    }
+
+    std::u16string Utf16::toUtf16(std::string_view text) {
+        std::u16string result;
+        result.resize_and_overwrite(text.size() * MaxUtf16PerByte, [&](char16_t* out, size_t capacity) {
+            return toUtf16(text, out, capacity);
+            });
+        return result;
+    }
+
+}
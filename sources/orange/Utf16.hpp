@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace audio {
+
+    // UTF-16 <-> UTF-8 conversion for metadata text. GSMTC hands out UTF-16 and Java keeps it,
+    // so text only needs converting for callers that want UTF-8. Runs of ASCII, which is most
+    // of what players report, are converted 16 code units at a time with SSE2 (NEON where
+    // AUDIO_UTF16_NEON is defined); the rest goes one character at a time. Neither direction
+    // fails: a lone surrogate, or a UTF-8 sequence that is malformed, overlong, a surrogate or
+    // past U+10FFFF, becomes U+FFFD (for UTF-8, once per maximal invalid subsequence, as
+    // WHATWG and ICU do).
+    //
+    // The buffer forms write at most capacity units, never split a character and return the
+    // number written; they add no terminator.
+    class Utf16 {
+    public:
+        // Worst cases, for sizing a buffer without a length pass: a surrogate pair takes four
+        // bytes, and a four-byte sequence two units.
+        static constexpr size_t MaxUtf8PerUnit = 3;
+        static constexpr size_t MaxUtf16PerByte = 1;
+
+        static size_t toUtf8(std::u16string_view text, char* out, size_t capacity) noexcept;
+        [[nodiscard]] static std::string toUtf8(std::u16string_view text);
+
+        static size_t toUtf16(std::string_view text, char16_t* out, size_t capacity) noexcept;
+        [[nodiscard]] static std::u16string toUtf16(std::string_view text);
+
+        // The same conversions without the vector loops, which the benchmark checks them against.
+        static size_t toUtf8Scalar(std::u16string_view text, char* out, size_t capacity) noexcept;
+        static size_t toUtf16Scalar(std::string_view text, char16_t* out, size_t capacity) noexcept;
+    };
+
+}
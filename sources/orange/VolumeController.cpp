@@ -0,0 +1,128 @@
+#include "VolumeController.h"
+#include "OperationStats.h"
+#include <algorithm>
+#include <bit>
+
+namespace audio {
+
+    VolumeController::VolumeController(std::unique_ptr<IVolumeEndpoint> endpoint)
+        : m_endpoint(std::move(endpoint)) {
+    }
+
+    VolumeController::~VolumeController() {
+        // Drop the endpoint first so no change notification can arrive while listeners are torn down.
+        m_endpoint.reset();
+    }
+
+    std::expected<void, AudioError> VolumeController::ensureOpen() noexcept {
+        if (m_open.load(std::memory_order_acquire))
+            return {};
+
+        std::scoped_lock lock(m_openMutex);
+        if (m_open.load(std::memory_order_relaxed))
+            return {};
+        if (!m_endpoint)
+            return std::unexpected(AudioError(ErrorCategory::Unsupported, "Open volume control"));
+
+        auto& stats = OperationStats::platform();
+        auto opened = stats.measure(StatOperation::VolumeEndpoint, [&] {
+            return m_endpoint->open([this](float volume, bool muted) { apply(volume, muted); });
+        });
+        if (!opened)
+            return std::unexpected(opened.error());
+        auto volume = stats.measure(StatOperation::VolumeEndpoint, [&] { return m_endpoint->readVolume(); });
+        if (!volume)
+            return std::unexpected(volume.error());
+        auto muted = stats.measure(StatOperation::VolumeEndpoint, [&] { return m_endpoint->readMute(); });
+        if (!muted)
+            return std::unexpected(muted.error());
+
+        {
+            std::scoped_lock state(m_applyMutex);
+            m_state.store(pack(*volume, *muted), std::memory_order_release);
+        }
+        m_open.store(true, std::memory_order_release);
+        return {};
+    }
+
+    std::expected<double, AudioError> VolumeController::getVolume() noexcept {
+        if (auto opened = ensureOpen(); !opened)
+            return std::unexpected(opened.error());
+        return static_cast<double>(unpack(m_state.load(std::memory_order_acquire)).first);
+    }
+
+    std::expected<void, AudioError> VolumeController::setVolume(double volume) noexcept {
+        if (volume < 0.0 || volume > 1.0)
+            return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Set volume"));
+        if (auto opened = ensureOpen(); !opened)
+            return std::unexpected(opened.error());
+        auto written = OperationStats::platform().measure(StatOperation::VolumeEndpoint, [&] {
+            return m_endpoint->writeVolume(static_cast<float>(volume));
+        });
+        if (!written)
+            return written;
+        apply(static_cast<float>(volume), std::nullopt);
+        return {};
+    }
+
+    std::expected<bool, AudioError> VolumeController::isMuted() noexcept {
+        if (auto opened = ensureOpen(); !opened)
+            return std::unexpected(opened.error());
+        return unpack(m_state.load(std::memory_order_acquire)).second;
+    }
+
+    std::expected<void, AudioError> VolumeController::setMuted(bool muted) noexcept {
+        if (auto opened = ensureOpen(); !opened)
+            return std::unexpected(opened.error());
+        auto written = OperationStats::platform().measure(StatOperation::VolumeEndpoint, [&] { return m_endpoint->writeMute(muted); });
+        if (!written)
+            return written;
+        apply(std::nullopt, muted);
+        return {};
+    }
+
+    VolumeController::SubscriptionId VolumeController::subscribe(VolumeChangedCallback callback) {
+        std::scoped_lock lock(m_listenerMutex);
+        auto id = m_nextId++;
+        m_listeners.emplace_back(id, std::move(callback));
+        return id;
+    }
+
+    void VolumeController::unsubscribe(SubscriptionId id) noexcept {
+        std::scoped_lock lock(m_listenerMutex);
+        std::erase_if(m_listeners, [id](const auto& listener) { return listener.first == id; });
+    }
+
+    // Our own writes come back through the endpoint's change notification as well; only the
+    // first report of a given state reaches listeners. A write changes only its own half of the
+    // pair, and the comparison, the update and the delivery happen in one critical section, so
+    // two changes racing each other are neither merged wrongly nor announced out of order.
+    void VolumeController::apply(std::optional<float> volume, std::optional<bool> muted) {
+        std::scoped_lock lock(m_applyMutex);
+        const auto [previousVolume, previousMuted] = unpack(m_state.load(std::memory_order_relaxed));
+        const float nextVolume = volume.value_or(previousVolume);
+        const bool nextMuted = muted.value_or(previousMuted);
+        if (previousVolume == nextVolume && previousMuted == nextMuted)
+            return;
+        m_state.store(pack(nextVolume, nextMuted), std::memory_order_release);
+
+        std::vector<VolumeChangedCallback> listeners;
+        {
+            std::scoped_lock listenerLock(m_listenerMutex);
+            listeners.reserve(m_listeners.size());
+            for (const auto& listener : m_listeners)
+                listeners.push_back(listener.second);
+        }
+        for (const auto& listener : listeners)
+            listener(static_cast<double>(nextVolume), nextMuted);
+    }
+
+    uint64_t VolumeController::pack(float volume, bool muted) noexcept {
+        return static_cast<uint64_t>(std::bit_cast<uint32_t>(volume)) | (muted ? uint64_t{ 1 } << 32 : 0);
+    }
+
+    std::pair<float, bool> VolumeController::unpack(uint64_t state) noexcept {
+        return { std::bit_cast<float>(static_cast<uint32_t>(state)), (state >> 32) != 0 };
+    }
+
+}
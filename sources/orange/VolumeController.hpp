@@ -0,0 +1,72 @@
+#pragma once
+#include "AudioError.h"
+#include <atomic>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+namespace audio {
+
+    // The operating-system side of a volume control: it acquires its interfaces once in open()
+    // and reports changes made elsewhere (mixer, other apps) through the handler given there.
+    class IVolumeEndpoint {
+    public:
+        using ChangeHandler = std::function<void(float volume, bool muted)>;
+
+        virtual ~IVolumeEndpoint() = default;
+
+        virtual std::expected<void, AudioError> open(ChangeHandler onChanged) noexcept = 0;
+        virtual std::expected<float, AudioError> readVolume() noexcept = 0;
+        virtual std::expected<bool, AudioError> readMute() noexcept = 0;
+        virtual std::expected<void, AudioError> writeVolume(float volume) noexcept = 0;
+        virtual std::expected<void, AudioError> writeMute(bool muted) noexcept = 0;
+    };
+
+    // Keeps one endpoint open for the lifetime of a session, answers reads from the last known
+    // volume and mute state, and fans out every change to the subscribed listeners.
+    class VolumeController {
+    public:
+        using VolumeChangedCallback = std::function<void(double volume, bool muted)>;
+        using SubscriptionId = uint64_t;
+
+        explicit VolumeController(std::unique_ptr<IVolumeEndpoint> endpoint);
+        ~VolumeController();
+        VolumeController(const VolumeController&) = delete;
+        VolumeController& operator=(const VolumeController&) = delete;
+
+        std::expected<double, AudioError> getVolume() noexcept;
+        std::expected<void, AudioError> setVolume(double volume) noexcept;
+        std::expected<bool, AudioError> isMuted() noexcept;
+        std::expected<void, AudioError> setMuted(bool muted) noexcept;
+
+        SubscriptionId subscribe(VolumeChangedCallback callback);
+        void unsubscribe(SubscriptionId id) noexcept;
+
+    private:
+        std::expected<void, AudioError> ensureOpen() noexcept;
+        void apply(std::optional<float> volume, std::optional<bool> muted);
+        static uint64_t pack(float volume, bool muted) noexcept;
+        static std::pair<float, bool> unpack(uint64_t state) noexcept;
+
+        std::unique_ptr<IVolumeEndpoint> m_endpoint;
+
+        std::mutex m_openMutex;
+        std::atomic<bool> m_open{ false };
+        // Volume and mute packed into one word, so a reader never pairs one change's volume with
+        // another's mute. Written only under m_applyMutex, which also orders the notifications;
+        // it is recursive so a listener may set the volume again.
+        std::atomic<uint64_t> m_state{ 0 };
+        std::recursive_mutex m_applyMutex;
+
+        std::mutex m_listenerMutex;
+        std::vector<std::pair<SubscriptionId, VolumeChangedCallback>> m_listeners;
+        SubscriptionId m_nextId{ 1 };
+    };
+
+}
@@ -0,0 +1,129 @@
+#include "WasapiVolumeEndpoint.h"
+#include <utility>
+
+namespace audio {
+    namespace platform {
+
+        namespace {
+
+            struct SessionEvents : winrt::implements<SessionEvents, IAudioSessionEvents> {
+                IVolumeEndpoint::ChangeHandler onChanged;
+
+                explicit SessionEvents(IVolumeEndpoint::ChangeHandler handler) : onChanged(std::move(handler)) {}
+
+                HRESULT STDMETHODCALLTYPE OnSimpleVolumeChanged(float newVolume, BOOL newMute, LPCGUID) noexcept override {
+                    try {
+                        if (onChanged)
+                            onChanged(newVolume, newMute != FALSE);
+                    }
+                    catch (...) {
+                    }
+                    return S_OK;
+                }
+
+                HRESULT STDMETHODCALLTYPE OnDisplayNameChanged(LPCWSTR, LPCGUID) noexcept override { return S_OK; }
+                HRESULT STDMETHODCALLTYPE OnIconPathChanged(LPCWSTR, LPCGUID) noexcept override { return S_OK; }
+                HRESULT STDMETHODCALLTYPE OnChannelVolumeChanged(DWORD, float*, DWORD, LPCGUID) noexcept override { return S_OK; }
+                HRESULT STDMETHODCALLTYPE OnGroupingParamChanged(LPCGUID, LPCGUID) noexcept override { return S_OK; }
+                HRESULT STDMETHODCALLTYPE OnStateChanged(AudioSessionState) noexcept override { return S_OK; }
+                HRESULT STDMETHODCALLTYPE OnSessionDisconnected(AudioSessionDisconnectReason) noexcept override { return S_OK; }
+            };
+
+        }
+
+        WasapiVolumeEndpoint::~WasapiVolumeEndpoint() {
+            if (m_sessionControl && m_events)
+                m_sessionControl->UnregisterAudioSessionNotification(m_events.get());
+        }
+
+        std::expected<void, AudioError> WasapiVolumeEndpoint::open(ChangeHandler onChanged) noexcept {
+            try {
+                winrt::com_ptr<IMMDeviceEnumerator> enumerator;
+                HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
+                    __uuidof(IMMDeviceEnumerator), enumerator.put_void());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Create device enumerator", hr));
+                }
+
+                winrt::com_ptr<IMMDevice> device;
+                hr = enumerator->GetDefaultAudioEndpoint(eRender, eMultimedia, device.put());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Get default audio endpoint", hr));
+                }
+
+                winrt::com_ptr<IAudioSessionManager2> sessionManager;
+                hr = device->Activate(__uuidof(IAudioSessionManager2), CLSCTX_ALL, nullptr, sessionManager.put_void());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Create audio session manager", hr));
+                }
+
+                winrt::com_ptr<IAudioSessionControl> sessionControl;
+                hr = sessionManager->GetAudioSessionControl(nullptr, 0, sessionControl.put());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Get audio session control", hr));
+                }
+                winrt::com_ptr<ISimpleAudioVolume> volumeControl;
+                hr = sessionControl->QueryInterface(__uuidof(ISimpleAudioVolume), volumeControl.put_void());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Get volume control interface", hr));
+                }
+
+                auto events = winrt::make_self<SessionEvents>(std::move(onChanged));
+                hr = sessionControl->RegisterAudioSessionNotification(events.get());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Register volume notifications", hr));
+                }
+
+                m_sessionControl = std::move(sessionControl);
+                m_volume = std::move(volumeControl);
+                m_events = events.as<IAudioSessionEvents>();
+                return {};
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Open volume control", ex));
+            }
+            catch (const winrt::hresult_error& ex) {
+                return std::unexpected(AudioError(ErrorCategory::Platform, "Open volume control", ex.code(), winrt::to_string(ex.message())));
+            }
+        }
+
+        std::expected<float, AudioError> WasapiVolumeEndpoint::readVolume() noexcept {
+            if (!m_volume)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "Get volume"));
+            float volume = 0.0f;
+            if (HRESULT hr = m_volume->GetMasterVolume(&volume); FAILED(hr)) {
+                return std::unexpected(AudioError(ErrorCategory::Platform, "Get volume", hr));
+            }
+            return volume;
+        }
+
+        std::expected<bool, AudioError> WasapiVolumeEndpoint::readMute() noexcept {
+            if (!m_volume)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "Get mute state"));
+            BOOL muted = FALSE;
+            if (HRESULT hr = m_volume->GetMute(&muted); FAILED(hr)) {
+                return std::unexpected(AudioError(ErrorCategory::Platform, "Get mute state", hr));
+            }
+            return muted != FALSE;
+        }
+
+        std::expected<void, AudioError> WasapiVolumeEndpoint::writeVolume(float volume) noexcept {
+            if (!m_volume)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "Set volume"));
+            if (HRESULT hr = m_volume->SetMasterVolume(volume, nullptr); FAILED(hr)) {
+                return std::unexpected(AudioError(ErrorCategory::Platform, "Set volume", hr));
+            }
+            return {};
+        }
+
+        std::expected<void, AudioError> WasapiVolumeEndpoint::writeMute(bool muted) noexcept {
+            if (!m_volume)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "Set mute state"));
+            if (HRESULT hr = m_volume->SetMute(muted ? TRUE : FALSE, nullptr); FAILED(hr)) {
+                return std::unexpected(AudioError(ErrorCategory::Platform, "Set mute state", hr));
+            }
+            return {};
+        }
+
+    }
+}
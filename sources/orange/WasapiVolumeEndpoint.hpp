@@ -0,0 +1,32 @@
+#pragma once
+#include "VolumeController.h"
+#include <winrt/base.h>
+#include <mmdeviceapi.h>
+#include <audiopolicy.h>
+
+namespace audio {
+    namespace platform {
+
+        // Resolves the enumerator -> device -> session manager -> session control chain once and
+        // keeps ISimpleAudioVolume alive, with an IAudioSessionEvents sink for external changes.
+        class WasapiVolumeEndpoint : public IVolumeEndpoint {
+        public:
+            WasapiVolumeEndpoint() = default;
+            ~WasapiVolumeEndpoint() override;
+            WasapiVolumeEndpoint(const WasapiVolumeEndpoint&) = delete;
+            WasapiVolumeEndpoint& operator=(const WasapiVolumeEndpoint&) = delete;
+
+            std::expected<void, AudioError> open(ChangeHandler onChanged) noexcept override;
+            std::expected<float, AudioError> readVolume() noexcept override;
+            std::expected<bool, AudioError> readMute() noexcept override;
+            std::expected<void, AudioError> writeVolume(float volume) noexcept override;
+            std::expected<void, AudioError> writeMute(bool muted) noexcept override;
+
+        private:
+            winrt::com_ptr<IAudioSessionControl> m_sessionControl;
+            winrt::com_ptr<ISimpleAudioVolume> m_volume;
+            winrt::com_ptr<IAudioSessionEvents> m_events;
+        };
+
+    }
+}
@@ -0,0 +1,91 @@
+#include "WicImageDecoder.h"
+#include <winrt/base.h>
+#include <wincodec.h>
+
+namespace audio {
+    namespace platform {
+
+        namespace {
+
+            // The processor's worker is a plain std::thread. It joins the MTA so the session's WinRT
+            // calls and WIC both work there, and leaves again when the thread exits.
+            struct ComApartment {
+                bool joined{ false };
+                ComApartment() : joined(SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED))) {}
+                ~ComApartment() {
+                    if (joined)
+                        CoUninitialize();
+                }
+            };
+
+        }
+
+        void WicImageDecoder::attachThread() noexcept {
+            thread_local ComApartment apartment;
+        }
+
+        std::expected<RgbaImage, AudioError> WicImageDecoder::decode(std::span<const uint8_t> encoded) noexcept {
+            try {
+                if (encoded.empty() || encoded.size() > MAXDWORD)
+                    return std::unexpected(AudioError(ErrorCategory::InvalidArgument, "Decode thumbnail"));
+
+                winrt::com_ptr<IWICImagingFactory> factory;
+                HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER,
+                    __uuidof(IWICImagingFactory), factory.put_void());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Create imaging factory", hr));
+                }
+
+                winrt::com_ptr<IWICStream> stream;
+                hr = factory->CreateStream(stream.put());
+                if (SUCCEEDED(hr))
+                    hr = stream->InitializeFromMemory(const_cast<BYTE*>(encoded.data()), static_cast<DWORD>(encoded.size()));
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Wrap thumbnail data", hr));
+                }
+
+                winrt::com_ptr<IWICBitmapDecoder> decoder;
+                hr = factory->CreateDecoderFromStream(stream.get(), nullptr, WICDecodeMetadataCacheOnDemand, decoder.put());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Unsupported, "Decode thumbnail", hr));
+                }
+
+                winrt::com_ptr<IWICBitmapFrameDecode> frame;
+                hr = decoder->GetFrame(0, frame.put());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Read thumbnail frame", hr));
+                }
+
+                winrt::com_ptr<IWICBitmapSource> converted;
+                hr = WICConvertBitmapSource(GUID_WICPixelFormat32bppPRGBA, frame.get(), converted.put());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Convert thumbnail pixels", hr));
+                }
+
+                UINT width = 0;
+                UINT height = 0;
+                hr = converted->GetSize(&width, &height);
+                if (FAILED(hr) || width == 0 || height == 0) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Get thumbnail size", hr));
+                }
+
+                RgbaImage image;
+                image.width = width;
+                image.height = height;
+                image.pixels.resize(static_cast<size_t>(width) * height * 4);
+                hr = converted->CopyPixels(nullptr, width * 4, static_cast<UINT>(image.pixels.size()), image.pixels.data());
+                if (FAILED(hr)) {
+                    return std::unexpected(AudioError(ErrorCategory::Platform, "Copy thumbnail pixels", hr));
+                }
+                return image;
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Decode thumbnail", ex));
+            }
+            catch (const winrt::hresult_error& ex) {
+                return std::unexpected(AudioError(ErrorCategory::Platform, "Decode thumbnail", ex.code(), winrt::to_string(ex.message())));
+            }
+        }
+
+    }
+}
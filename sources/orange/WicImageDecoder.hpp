@@ -0,0 +1,16 @@
+#pragma once
+#include "ThumbnailProcessor.h"
+
+namespace audio {
+    namespace platform {
+
+        // Windows Imaging Component decoder; handles whatever codecs are installed (JPEG and PNG in
+        // practice) and converts straight to 32bpp premultiplied RGBA.
+        class WicImageDecoder : public IImageDecoder {
+        public:
+            void attachThread() noexcept override;
+            std::expected<RgbaImage, AudioError> decode(std::span<const uint8_t> encoded) noexcept override;
+        };
+
+    }
+}
@@ -1,4 +1,8 @@
 #include "WinRTAudioSession.h"
+#include "OperationStats.h"
+#include "PlaybackClock.h"
+#include "Utf16.h"
+#include "WasapiVolumeEndpoint.h"
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.Foundation.Collections.h>
 #include <winrt/Windows.Storage.Streams.h>
@@ -6,43 +10,126 @@
 #include <winrt/Windows.Media.Playback.h>
 #include <winrt/Windows.Media.Control.h>
 #include <winrt/base.h>
-#include <format>
 #include <vector>
 #include <algorithm>
-#include <mmdeviceapi.h>
-#include <audiopolicy.h>
+#include <utility>
 #include <winrt/Windows.Media.h>
-#include <Audioclient.h>
 namespace audio {
 	namespace platform {
 
-			WinRTAudioSession::~WinRTAudioSession() noexcept {
-			if (m_currentSession) {
-				if (m_playbackChangedToken)
-					m_currentSession.PlaybackInfoChanged(m_playbackChangedToken);
-				if (m_mediaPropertiesChangedToken)
-					m_currentSession.MediaPropertiesChanged(m_mediaPropertiesChangedToken);
+		namespace {
+
+			// Joins the MTA for the lifetime of the calling thread, and leaves again when it exits.
+			struct ComApartment {
+				bool joined{ false };
+				ComApartment() : joined(SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED))) {}
+				~ComApartment() {
+					if (joined)
+						CoUninitialize();
+				}
+			};
+
+			// hstring holds wchar_t, which is UTF-16 on Windows.
+			std::u16string_view utf16(winrt::hstring const& text) noexcept {
+				return std::u16string_view(reinterpret_cast<const char16_t*>(text.data()), text.size());
 			}
+
+		}
+
+		WinRTAudioSession::WinRTAudioSession()
+			: m_volume(std::make_shared<VolumeController>(std::make_unique<WasapiVolumeEndpoint>())),
+			m_thumbnails(std::make_shared<ThumbnailCache>()),
+			m_trackWatcher([this] { return fetchMediaForWatcher(); }, [this](const MediaInfo& media) { deliverTrackChanged(media); }) {
 		}
 
-		std::expected<void, std::string> WinRTAudioSession::initialize() noexcept {
+		WinRTAudioSession::WinRTAudioSession(winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession session,
+			std::shared_ptr<VolumeController> volume, std::shared_ptr<ThumbnailCache> thumbnails)
+			: m_currentSession(std::move(session)), m_volume(std::move(volume)), m_thumbnails(std::move(thumbnails)),
+			m_trackWatcher([this] { return fetchMediaForWatcher(); }, [this](const MediaInfo& media) { deliverTrackChanged(media); }) {
+		}
+
+		WinRTAudioSession::~WinRTAudioSession() noexcept {
+			unsubscribeCacheEvents();
+			m_trackWatcher.stop();
+		}
+
+		std::expected<void, AudioError> WinRTAudioSession::initialize() noexcept {
 			try {
-				auto asyncManager = winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionManager::RequestAsync();
-				m_sessionManager = asyncManager.get();
-				winrt::Windows::Foundation::Collections::IVectorView<winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession> sessions = m_sessionManager.GetSessions();
-				if (sessions.Size() > 0) {
-					m_currentSession = sessions.GetAt(0);
-				}
-				else {
-					return std::unexpected("No active audio session found.");
+				if (!currentSession()) {
+					auto asyncManager = winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionManager::RequestAsync();
+					auto manager = asyncManager.get();
+					auto session = manager.GetCurrentSession();
+					if (!session) {
+						winrt::Windows::Foundation::Collections::IVectorView<winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession> sessions = manager.GetSessions();
+						if (sessions.Size() > 0) {
+							session = sessions.GetAt(0);
+						}
+						else {
+							return std::unexpected(AudioError(ErrorCategory::NoSession, "Initialize"));
+						}
+					}
+					bind(std::move(manager), std::move(session));
 				}
+				subscribeCacheEvents();
+				primeCache();
 				return {};
 			}
 			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Initialization failed: {}", ex.what()));
+				return std::unexpected(AudioError::fromException("Initialize", ex));
+			}
+			catch (const winrt::hresult_error& ex) {
+				return std::unexpected(AudioError(ErrorCategory::Platform, "Initialize", ex.code(), winrt::to_string(ex.message())));
+			}
+		}
+
+		// The manager is requested on whichever thread-pool thread the await resumes on, so the
+		// session is built in locals and published by bind() only once it is complete.
+		AsyncResult<void> WinRTAudioSession::initializeAsync() noexcept {
+			auto self = shared_from_this();
+			try {
+				if (!currentSession()) {
+					auto manager = co_await winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionManager::RequestAsync();
+					auto session = manager.GetCurrentSession();
+					if (!session) {
+						auto sessions = manager.GetSessions();
+						if (sessions.Size() == 0)
+							co_return std::unexpected(AudioError(ErrorCategory::NoSession, "Initialize"));
+						session = sessions.GetAt(0);
+					}
+					bind(std::move(manager), std::move(session));
+				}
+				subscribeCacheEvents();
+
+				auto mediaProps = co_await currentSession().TryGetMediaPropertiesAsync();
+				m_trackWatcher.reset(publishMediaProperties(mediaProps));
+				m_playbackDiff.reset(refreshPlaybackInfo());
+				refreshTimeline();
+				co_return {};
+			}
+			catch (const std::exception& ex) {
+				co_return std::unexpected(AudioError::fromException("Initialize", ex));
+			}
+			catch (const winrt::hresult_error& ex) {
+				co_return std::unexpected(AudioError(ErrorCategory::Platform, "Initialize", ex.code(), winrt::to_string(ex.message())));
 			}
 		}
 
+		// A second initialize() racing the first keeps whichever session was bound first, so the
+		// change handlers and every reader stay on one session.
+		void WinRTAudioSession::bind(winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionManager manager,
+			winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession session) {
+			std::scoped_lock lock(m_sessionMutex);
+			if (m_currentSession)
+				return;
+			m_sessionManager = std::move(manager);
+			m_currentSession = std::move(session);
+		}
+
+		winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession WinRTAudioSession::currentSession() const {
+			std::scoped_lock lock(m_sessionMutex);
+			return m_currentSession;
+		}
+
 
 		auto getTimelineProperties(winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession const& session)
 			-> winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionTimelineProperties
@@ -51,297 +138,618 @@ namespace audio {
 		}
 
 
-		std::expected<std::chrono::seconds, std::string> WinRTAudioSession::getDuration() noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
-			try {
+		std::expected<std::chrono::seconds, AudioError> WinRTAudioSession::getDuration() noexcept {
+			auto state = timelineState();
+			if (!state)
+				return std::unexpected(state.error());
+			const auto& timeline = *(*state)->timeline;
+			return std::chrono::duration_cast<std::chrono::seconds>(timeline.end - timeline.start);
+		}
 
-				auto timeline = getTimelineProperties(m_currentSession);
-				auto duration = timeline.EndTime() - timeline.StartTime();
-				int64_t seconds = duration.count() / 10000000LL;
-				return std::chrono::seconds(seconds);
-			}
-			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Error getting duration: {}", ex.what()));
-			}
+		std::expected<std::chrono::seconds, AudioError> WinRTAudioSession::getCurrentPosition() noexcept {
+			auto position = getCurrentPositionPrecise();
+			if (!position)
+				return std::unexpected(position.error());
+			return std::chrono::duration_cast<std::chrono::seconds>(*position);
 		}
 
-		std::expected<std::chrono::seconds, std::string> WinRTAudioSession::getCurrentPosition() noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
-			try {
+		std::expected<std::chrono::milliseconds, AudioError> WinRTAudioSession::getCurrentPositionPrecise() noexcept {
+			if (auto timeline = timelineState(); !timeline)
+				return std::unexpected(timeline.error());
+			auto state = playbackState();
+			if (!state)
+				return std::unexpected(state.error());
+			if (!(*state)->timeline)
+				return std::unexpected(AudioError(ErrorCategory::Interrupted, "Get position"));
+			return PlaybackClock::position(*(*state)->timeline, (*state)->playback);
+		}
 
-				auto timeline = getTimelineProperties(m_currentSession);
-				int64_t seconds = timeline.Position().count() / 10000000LL;
-				return std::chrono::seconds(seconds);
+		std::expected<std::string, AudioError> WinRTAudioSession::getTitle() const noexcept {
+			auto state = mediaState();
+			if (!state)
+				return std::unexpected(state.error());
+			return (*state)->media->title;
+		}
 
-			}
-			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Error getting current position: {}", ex.what()));
-			}
+		std::expected<std::string, AudioError> WinRTAudioSession::getArtist() const noexcept {
+			auto state = mediaState();
+			if (!state)
+				return std::unexpected(state.error());
+			return (*state)->media->artist;
 		}
 
-		std::expected<std::string, std::string> WinRTAudioSession::getTitle() const noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
-			try {
-				auto mediaProps = m_currentSession.TryGetMediaPropertiesAsync().get();
-				return winrt::to_string(mediaProps.Title());
-			}
-			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Error getting title: {}", ex.what()));
-			}
+		std::expected<std::string, AudioError> WinRTAudioSession::getAlbum() const noexcept {
+			auto state = mediaState();
+			if (!state)
+				return std::unexpected(state.error());
+			return (*state)->media->album;
 		}
 
-		std::expected<std::string, std::string> WinRTAudioSession::getArtist() const noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
-			try {
-				auto mediaProps = m_currentSession.TryGetMediaPropertiesAsync().get();
-				return winrt::to_string(mediaProps.Artist());
-			}
-			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Error getting artist: {}", ex.what()));
-			}
+		std::expected<std::string_view, AudioError> WinRTAudioSession::getText(MediaText field, StringPool& pool) const noexcept {
+			auto state = mediaState();
+			if (!state)
+				return std::unexpected(state.error());
+			return pool.intern((*state)->media->text(field));
 		}
 
-		std::expected<std::string, std::string> WinRTAudioSession::getAlbum() const noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
-			try {
-				auto mediaProps = m_currentSession.TryGetMediaPropertiesAsync().get();
-				return winrt::to_string(mediaProps.AlbumTitle());
-			}
-			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Error getting album: {}", ex.what()));
-			}
+		std::expected<std::u16string, AudioError> WinRTAudioSession::getTextUtf16(MediaText field) const noexcept {
+			auto state = mediaState();
+			if (!state)
+				return std::unexpected(state.error());
+			return (*state)->media->textUtf16(field);
 		}
 
-		std::expected<std::span<const uint8_t>, std::string> WinRTAudioSession::getThumbnailBytes() noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
-			try {
-				auto mediaProps = m_currentSession.TryGetMediaPropertiesAsync().get();
-				auto thumbnail = mediaProps.Thumbnail();
-				if (!thumbnail)
-					return std::unexpected("No thumbnail available.");
+		std::expected<std::span<const uint8_t>, AudioError> WinRTAudioSession::getThumbnailBytes() noexcept {
+			auto thumbnail = getThumbnail();
+			if (!thumbnail)
+				return std::unexpected(thumbnail.error());
+			return std::span<const uint8_t>((*thumbnail)->data(), (*thumbnail)->size());
+		}
 
-				auto stream = thumbnail.OpenReadAsync().get();
-				uint64_t size = stream.Size();
-				winrt::Windows::Storage::Streams::Buffer bufferWinRT{ static_cast<uint32_t>(size) };
-				auto readOp = stream.ReadAsync(bufferWinRT, bufferWinRT.Capacity(), winrt::Windows::Storage::Streams::InputStreamOptions::None);
-				readOp.get();
+		// The stream is only read when neither the reference nor, after reading, the content is
+		// already known to the shared cache; m_cache.thumbnail keeps the current artwork alive. The
+		// reference is copied out and read unlocked, and the result is kept only if the artwork did
+		// not change meanwhile.
+		std::expected<ThumbnailCache::Buffer, AudioError> WinRTAudioSession::getThumbnail() noexcept {
+			auto state = mediaState();
+			if (!state)
+				return std::unexpected(state.error());
+			try {
+				std::optional<winrt::Windows::Storage::Streams::IRandomAccessStreamReference> current;
+				{
+					std::scoped_lock lock(m_cache.mutex);
+					if (!m_cache.thumbnailRef)
+						return std::unexpected(AudioError(ErrorCategory::NotFound, "Get thumbnail"));
+					if (m_cache.thumbnail)
+						return m_cache.thumbnail;
+					current = m_cache.thumbnailRef;
+				}
 
-				std::vector<uint8_t> buffer(bufferWinRT.Length());
-				std::copy_n(bufferWinRT.data(), bufferWinRT.Length(), buffer.begin());
+				const auto& reference = *current;
+				auto buffer = m_thumbnails->find(winrt::get_abi(reference));
+				if (!buffer) {
+					auto stream = reference.OpenReadAsync().get();
+					uint64_t size = stream.Size();
+					winrt::Windows::Storage::Streams::Buffer bufferWinRT{ static_cast<uint32_t>(size) };
+					auto readOp = stream.ReadAsync(bufferWinRT, bufferWinRT.Capacity(), winrt::Windows::Storage::Streams::InputStreamOptions::None);
+					readOp.get();
+
+					std::vector<uint8_t> bytes(bufferWinRT.data(), bufferWinRT.data() + bufferWinRT.Length());
+					buffer = m_thumbnails->insert(winrt::get_abi(reference),
+						std::make_shared<const winrt::Windows::Storage::Streams::IRandomAccessStreamReference>(reference), std::move(bytes));
+				}
 
-				m_cache.thumbnailBytes = std::move(buffer);
-				return std::span<const uint8_t>(m_cache.thumbnailBytes->data(), m_cache.thumbnailBytes->size());
+				std::scoped_lock lock(m_cache.mutex);
+				if (m_cache.thumbnailRef && *m_cache.thumbnailRef == reference)
+					m_cache.thumbnail = buffer;
+				return buffer;
 			}
 			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Error getting thumbnail: {}", ex.what()));
+				return std::unexpected(AudioError::fromException("Get thumbnail", ex));
+			}
+			catch (const winrt::hresult_error& ex) {
+				return std::unexpected(AudioError(ErrorCategory::Platform, "Get thumbnail", ex.code(), winrt::to_string(ex.message())));
 			}
 		}
 
-		std::expected<void, std::string> WinRTAudioSession::play() noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
+		std::expected<TrackSnapshot, AudioError> WinRTAudioSession::getTrackSnapshot() noexcept {
+			if (auto timeline = timelineState(); !timeline)
+				return std::unexpected(timeline.error());
+			if (auto playback = playbackState(); !playback)
+				return std::unexpected(playback.error());
+			auto state = mediaState();
+			if (!state)
+				return std::unexpected(state.error());
+			if (!(*state)->timeline || !(*state)->playback)
+				return std::unexpected(AudioError(ErrorCategory::Interrupted, "Get track snapshot"));
+
+			const SessionState& current = **state;
+			TrackSnapshot snapshot;
+			snapshot.title = current.media->title;
+			snapshot.artist = current.media->artist;
+			snapshot.album = current.media->album;
+			snapshot.albumArtist = current.media->albumArtist;
+			snapshot.trackNumber = current.media->trackNumber;
+			snapshot.duration = std::chrono::duration_cast<std::chrono::seconds>(current.timeline->end - current.timeline->start);
+			snapshot.position = std::chrono::duration_cast<std::chrono::seconds>(PlaybackClock::position(*current.timeline, current.playback));
+			snapshot.status = current.playback->status;
+			snapshot.thumbnailHandle = current.media->thumbnailHandle;
+			return snapshot;
+		}
+
+		std::expected<void, AudioError> WinRTAudioSession::play() noexcept {
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Play"));
 			try {
-				m_currentSession.TryPlayAsync().get();
+				session.TryPlayAsync().get();
 				return {};
 			}
 			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Play failed: {}", ex.what()));
+				return std::unexpected(AudioError::fromException("Play", ex));
 			}
 		}
 
-		std::expected<void, std::string> WinRTAudioSession::pause() noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
+		std::expected<void, AudioError> WinRTAudioSession::pause() noexcept {
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Pause"));
 			try {
-				m_currentSession.TryPauseAsync().get();
+				session.TryPauseAsync().get();
 				return {};
 			}
 			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Pause failed: {}", ex.what()));
+				return std::unexpected(AudioError::fromException("Pause", ex));
 			}
 		}
 
-		std::expected<void, std::string> WinRTAudioSession::next() noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
+		std::expected<void, AudioError> WinRTAudioSession::next() noexcept {
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Next track"));
 			try {
-				m_currentSession.TrySkipNextAsync().get();
+				session.TrySkipNextAsync().get();
 				return {};
 			}
 			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Next track failed: {}", ex.what()));
+				return std::unexpected(AudioError::fromException("Next track", ex));
 			}
 		}
 
-		std::expected<void, std::string> WinRTAudioSession::previous() noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
+		std::expected<void, AudioError> WinRTAudioSession::previous() noexcept {
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Previous track"));
 			try {
-				m_currentSession.TrySkipPreviousAsync().get();
+				session.TrySkipPreviousAsync().get();
 				return {};
 			}
 			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Previous track failed: {}", ex.what()));
+				return std::unexpected(AudioError::fromException("Previous track", ex));
 			}
 		}
 
-		std::expected<void, std::string> WinRTAudioSession::seek(std::chrono::seconds position) noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
+		std::expected<void, AudioError> WinRTAudioSession::seek(std::chrono::seconds position) noexcept {
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Seek"));
 			try {
 				int64_t hundred_nanos = position.count() * 10000000LL;
-				m_currentSession.TryChangePlaybackPositionAsync(hundred_nanos).get();
+				session.TryChangePlaybackPositionAsync(hundred_nanos).get();
 				return {};
 			}
 			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Seek operation failed: {}", ex.what()));
+				return std::unexpected(AudioError::fromException("Seek", ex));
 			}
 			catch (const winrt::hresult_error& ex) {
-				return std::unexpected(std::format("Seek operation failed with HRESULT error: {}", winrt::to_string(ex.message())));
+				return std::unexpected(AudioError(ErrorCategory::Platform, "Seek", ex.code(), winrt::to_string(ex.message())));
 			}
 		}
 
-		std::expected<void, std::string> WinRTAudioSession::setVolume(double volume) noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
+		std::expected<void, AudioError> WinRTAudioSession::setVolume(double volume) noexcept {
+			if (!currentSession())
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Set volume"));
+			return m_volume->setVolume(volume);
+		}
+
+		std::expected<double, AudioError> WinRTAudioSession::getVolume() noexcept {
+			if (!currentSession())
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Get volume"));
+			return m_volume->getVolume();
+		}
+
+		template <typename Request>
+		AsyncResult<void> runTransportAsync(winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession session,
+			Request request, const char* operation) {
+			if (!session)
+				co_return std::unexpected(AudioError(ErrorCategory::NoSession, operation));
 			try {
+				co_await request(session);
+				co_return {};
+			}
+			catch (const std::exception& ex) {
+				co_return std::unexpected(AudioError::fromException(operation, ex));
+			}
+			catch (const winrt::hresult_error& ex) {
+				co_return std::unexpected(AudioError(ErrorCategory::Platform, operation, ex.code(), winrt::to_string(ex.message())));
+			}
+		}
 
-				if (volume < 0.0 || volume > 1.0) {
-					return std::unexpected("Volume must be between 0.0 and 1.0");
-				}
+		AsyncResult<void> WinRTAudioSession::playAsync() noexcept {
+			return runTransportAsync(currentSession(), [](auto const& session) { return session.TryPlayAsync(); }, "Play");
+		}
 
-				auto playbackInfo = m_currentSession.GetPlaybackInfo();
-				auto controlsInfo = playbackInfo.Controls();
-				winrt::com_ptr<IAudioSessionManager2> sessionManager;
-				HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
-					__uuidof(IMMDeviceEnumerator), sessionManager.put_void());
-				if (FAILED(hr)) {
-					return std::unexpected("Failed to create audio session manager");
-				}
+		AsyncResult<void> WinRTAudioSession::pauseAsync() noexcept {
+			return runTransportAsync(currentSession(), [](auto const& session) { return session.TryPauseAsync(); }, "Pause");
+		}
+
+		AsyncResult<void> WinRTAudioSession::nextAsync() noexcept {
+			return runTransportAsync(currentSession(), [](auto const& session) { return session.TrySkipNextAsync(); }, "Next track");
+		}
+
+		AsyncResult<void> WinRTAudioSession::previousAsync() noexcept {
+			return runTransportAsync(currentSession(), [](auto const& session) { return session.TrySkipPreviousAsync(); }, "Previous track");
+		}
 
-				winrt::com_ptr<IAudioSessionControl> sessionControl;
-				hr = sessionManager->GetAudioSessionControl(nullptr, 0, sessionControl.put());
-				if (FAILED(hr)) {
-					return std::unexpected("Failed to get audio session control");
+		AsyncResult<void> WinRTAudioSession::seekAsync(std::chrono::seconds position) noexcept {
+			int64_t hundred_nanos = position.count() * 10000000LL;
+			return runTransportAsync(currentSession(), [hundred_nanos](auto const& session) {
+				return session.TryChangePlaybackPositionAsync(hundred_nanos);
+				}, "Seek");
+		}
+
+		// The COM volume interfaces have no asynchronous form, so these hop to the thread pool.
+		AsyncResult<void> WinRTAudioSession::setVolumeAsync(double volume) noexcept {
+			auto self = shared_from_this();
+			co_await winrt::resume_background();
+			co_return setVolume(volume);
+		}
+
+		AsyncResult<double> WinRTAudioSession::getVolumeAsync() noexcept {
+			auto self = shared_from_this();
+			co_await winrt::resume_background();
+			co_return getVolume();
+		}
+
+		AsyncResult<TrackSnapshot> WinRTAudioSession::getTrackSnapshotAsync() noexcept {
+			auto self = shared_from_this();
+			auto session = currentSession();
+			if (!session)
+				co_return std::unexpected(AudioError(ErrorCategory::NoSession, "Get track snapshot"));
+			if (!m_cache.state.load()->media) {
+				try {
+					auto mediaProps = co_await session.TryGetMediaPropertiesAsync();
+					publishMediaProperties(mediaProps);
 				}
-				winrt::com_ptr<ISimpleAudioVolume> volumeControl;
-				hr = sessionControl->QueryInterface(__uuidof(ISimpleAudioVolume), volumeControl.put_void());
-				if (FAILED(hr)) {
-					return std::unexpected("Failed to get volume control interface");
+				catch (const std::exception& ex) {
+					co_return std::unexpected(AudioError::fromException("Get track snapshot", ex));
 				}
-				hr = volumeControl->SetMasterVolume(static_cast<float>(volume), nullptr);
-				if (FAILED(hr)) {
-					return std::unexpected("Failed to set volume");
+				catch (const winrt::hresult_error& ex) {
+					co_return std::unexpected(AudioError(ErrorCategory::Platform, "Get track snapshot", ex.code(), winrt::to_string(ex.message())));
 				}
+			}
+			// Playback info and timeline are local reads on the session object, so the rest is cheap.
+			co_return getTrackSnapshot();
+		}
 
-				return {};
+		VolumeController::SubscriptionId WinRTAudioSession::subscribeVolumeChanged(VolumeChangedCallback callback) noexcept {
+			try {
+				return m_volume->subscribe(std::move(callback));
 			}
-			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Set volume failed: {}", ex.what()));
+			catch (...) {
+				return 0;
 			}
-			catch (const winrt::hresult_error& ex) {
-				return std::unexpected(std::format("Set volume failed with HRESULT error: {}", winrt::to_string(ex.message())));
+		}
+
+		void WinRTAudioSession::unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept {
+			m_volume->unsubscribe(id);
+		}
+
+		// Both are raised from the cache's PlaybackInfoChanged handler once the new state has been
+		// diffed, so a player re-sending identical info wakes nobody.
+		void WinRTAudioSession::setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept {
+			std::scoped_lock lock(m_callbackMutex);
+			m_playbackChanged = std::move(callback);
+		}
+
+		void WinRTAudioSession::setPlaybackEventCallback(PlaybackEventCallback callback) noexcept {
+			std::scoped_lock lock(m_callbackMutex);
+			m_playbackEvent = std::move(callback);
+		}
+
+		void WinRTAudioSession::setTrackChangedCallback(TrackChangedCallback callback) noexcept {
+			std::scoped_lock lock(m_callbackMutex);
+			m_trackChanged = std::move(callback);
+		}
+
+		TrackChangeStats WinRTAudioSession::getTrackChangeStats() const noexcept {
+			return m_trackWatcher.stats();
+		}
+
+		std::expected<winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionPlaybackInfo, AudioError>
+			WinRTAudioSession::getPlaybackInfo() const noexcept {
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Get playback info"));
+			try {
+				OperationStats::Scope timing(OperationStats::platform(), StatOperation::FetchPlaybackInfo);
+				auto playbackInfo = session.GetPlaybackInfo();
+				return playbackInfo;
+			}
+			catch (const std::exception& ex) {
+				return std::unexpected(AudioError::fromException("Get playback info", ex));
 			}
 		}
 
-		std::expected<double, std::string> WinRTAudioSession::getVolume() noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
+		std::expected<winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionMediaProperties, AudioError>
+			WinRTAudioSession::getMediaProperties() const noexcept {
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Get media properties"));
 			try {
-				auto playbackInfo = m_currentSession.GetPlaybackInfo();
-				auto controlsInfo = playbackInfo.Controls();
-				winrt::com_ptr<IAudioSessionManager2> sessionManager;
-				HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
-					__uuidof(IMMDeviceEnumerator), sessionManager.put_void());
-				if (FAILED(hr)) {
-					return std::unexpected("Failed to create audio session manager");
-				}
+				OperationStats::Scope timing(OperationStats::platform(), StatOperation::FetchMediaProperties);
+				return session.TryGetMediaPropertiesAsync().get();
+			}
+			catch (const std::exception& ex) {
+				return std::unexpected(AudioError::fromException("Get media properties", ex));
+			}
+		}
+
+		void WinRTAudioSession::clearCache() noexcept {
+			m_cache.state.clear();
+			std::scoped_lock lock(m_cache.mutex);
+			m_cache.thumbnail.reset();
+			m_cache.thumbnailRef.reset();
+		}
 
-				winrt::com_ptr<IAudioSessionControl> sessionControl;
-				hr = sessionManager->GetAudioSessionControl(nullptr, 0, sessionControl.put());
-				if (FAILED(hr)) {
-					return std::unexpected("Failed to get audio session control");
+		void WinRTAudioSession::subscribeCacheEvents() {
+			auto session = currentSession();
+			unsubscribeCacheEvents();
+			clearCache();
+			// Only flags the metadata as stale; the watcher fetches it on its own thread.
+			m_cacheMediaToken = session.MediaPropertiesChanged([this](auto const&, auto const&) {
+				try {
+					m_trackWatcher.notify();
+				}
+				catch (...) {
 				}
-				winrt::com_ptr<ISimpleAudioVolume> volumeControl;
-				hr = sessionControl->QueryInterface(__uuidof(ISimpleAudioVolume), volumeControl.put_void());
-				if (FAILED(hr)) {
-					return std::unexpected("Failed to get volume control interface");
+				});
+			m_cachePlaybackToken = session.PlaybackInfoChanged([this](auto const&, auto const&) {
+				try {
+					if (auto event = m_playbackDiff.update(refreshPlaybackInfo()))
+						raisePlaybackEvent(*event);
 				}
-				float volume;
-				hr = volumeControl->GetMasterVolume(&volume);
-				if (FAILED(hr)) {
-					return std::unexpected("Failed to get volume");
+				catch (...) {
 				}
+				});
+			m_cacheTimelineToken = session.TimelinePropertiesChanged([this](auto const&, auto const&) {
+				try {
+					refreshTimeline();
+				}
+				catch (...) {
+				}
+				});
+		}
+
+		// Fetches everything up front so the first poll is already served from memory.
+		void WinRTAudioSession::primeCache() const {
+			m_trackWatcher.reset(refreshMediaProperties());
+			m_playbackDiff.reset(refreshPlaybackInfo());
+			refreshTimeline();
+		}
 
-				return static_cast<double>(volume);
+		void WinRTAudioSession::unsubscribeCacheEvents() noexcept {
+			auto session = currentSession();
+			if (!session)
+				return;
+			if (m_cacheMediaToken)
+				session.MediaPropertiesChanged(std::exchange(m_cacheMediaToken, {}));
+			if (m_cachePlaybackToken)
+				session.PlaybackInfoChanged(std::exchange(m_cachePlaybackToken, {}));
+			if (m_cacheTimelineToken)
+				session.TimelinePropertiesChanged(std::exchange(m_cacheTimelineToken, {}));
+		}
+
+		MediaInfo WinRTAudioSession::refreshMediaProperties() const {
+			auto session = currentSession();
+			auto mediaProps = [&] {
+				OperationStats::Scope timing(OperationStats::platform(), StatOperation::FetchMediaProperties);
+				return session.TryGetMediaPropertiesAsync().get();
+			}();
+			return publishMediaProperties(mediaProps);
+		}
+
+		MediaInfo WinRTAudioSession::publishMediaProperties(winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionMediaProperties const& mediaProps) const {
+			MediaInfo media;
+			media.titleUtf16 = utf16(mediaProps.Title());
+			media.artistUtf16 = utf16(mediaProps.Artist());
+			media.albumUtf16 = utf16(mediaProps.AlbumTitle());
+			media.title = Utf16::toUtf8(media.titleUtf16);
+			media.artist = Utf16::toUtf8(media.artistUtf16);
+			media.album = Utf16::toUtf8(media.albumUtf16);
+			media.albumArtist = Utf16::toUtf8(utf16(mediaProps.AlbumArtist()));
+			media.trackNumber = mediaProps.TrackNumber();
+			media.thumbnailHandle = rememberThumbnail(mediaProps.Thumbnail());
+			m_cache.state.publishMedia(media);
+			return media;
+		}
+
+		// Runs on the watcher's thread, which is a plain std::thread and so has to join the MTA
+		// before making WinRT calls.
+		std::expected<MediaInfo, AudioError> WinRTAudioSession::fetchMediaForWatcher() const {
+			thread_local ComApartment apartment;
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Fetch media properties"));
+			try {
+				return refreshMediaProperties();
 			}
 			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Get volume failed: {}", ex.what()));
+				return std::unexpected(AudioError::fromException("Fetch media properties", ex));
 			}
 			catch (const winrt::hresult_error& ex) {
-				return std::unexpected(std::format("Get volume failed with HRESULT error: {}", winrt::to_string(ex.message())));
+				return std::unexpected(AudioError(ErrorCategory::Platform, "Fetch media properties", ex.code(), winrt::to_string(ex.message())));
 			}
 		}
 
-		void WinRTAudioSession::setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept {
-			if (!m_currentSession)
-				return;
-			m_playbackChangedToken = m_currentSession.PlaybackInfoChanged([callback](auto const&, auto const&) {
-				callback("Playback info updated");
-				});
+		void WinRTAudioSession::deliverTrackChanged(const MediaInfo& media) {
+			TrackChangedCallback callback;
+			{
+				std::scoped_lock lock(m_callbackMutex);
+				callback = m_trackChanged;
+			}
+			if (callback)
+				callback(media.title, media.artist);
 		}
 
-		void WinRTAudioSession::setTrackChangedCallback(TrackChangedCallback callback) noexcept {
-			if (!m_currentSession)
-				return;
-			m_mediaPropertiesChangedToken = m_currentSession.MediaPropertiesChanged([this, callback](auto const&, auto const&) {
-				try {
-					auto mediaProps = m_currentSession.TryGetMediaPropertiesAsync().get();
-					callback(winrt::to_string(mediaProps.Title()),
-						winrt::to_string(mediaProps.Artist()));
-				}
-				catch (...) {
-					callback("Unknown", "Unknown");
-				}
-				});
+		PlaybackState WinRTAudioSession::refreshPlaybackInfo() const {
+			auto session = currentSession();
+			auto playbackInfo = [&] {
+				OperationStats::Scope timing(OperationStats::platform(), StatOperation::FetchPlaybackInfo);
+				return session.GetPlaybackInfo();
+			}();
+			PlaybackState playback;
+			playback.status = static_cast<PlaybackStatus>(playbackInfo.PlaybackStatus());
+			if (auto rate = playbackInfo.PlaybackRate())
+				playback.rate = rate.Value();
+			if (auto shuffle = playbackInfo.IsShuffleActive())
+				playback.shuffle = shuffle.Value();
+			if (auto repeat = playbackInfo.AutoRepeatMode())
+				playback.repeat = static_cast<RepeatMode>(repeat.Value());
+			playback.controls = controlBits(playbackInfo.Controls());
+			m_cache.state.publishPlayback(playback);
+			return playback;
 		}
 
-		std::expected<winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionPlaybackInfo, std::string>
-			WinRTAudioSession::getPlaybackInfo() const noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
+		uint32_t WinRTAudioSession::controlBits(winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionPlaybackControls const& controls) noexcept {
+			const std::pair<bool, PlaybackControl> flags[] = {
+				{ controls.IsPlayEnabled(), PlaybackControl::Play },
+				{ controls.IsPauseEnabled(), PlaybackControl::Pause },
+				{ controls.IsStopEnabled(), PlaybackControl::Stop },
+				{ controls.IsNextEnabled(), PlaybackControl::Next },
+				{ controls.IsPreviousEnabled(), PlaybackControl::Previous },
+				{ controls.IsPlayPauseToggleEnabled(), PlaybackControl::PlayPauseToggle },
+				{ controls.IsShuffleEnabled(), PlaybackControl::Shuffle },
+				{ controls.IsRepeatEnabled(), PlaybackControl::Repeat },
+				{ controls.IsPlaybackRateEnabled(), PlaybackControl::PlaybackRate },
+				{ controls.IsPlaybackPositionEnabled(), PlaybackControl::PlaybackPosition },
+				{ controls.IsFastForwardEnabled(), PlaybackControl::FastForward },
+				{ controls.IsRewindEnabled(), PlaybackControl::Rewind }
+			};
+			uint32_t bits = 0;
+			for (const auto& [enabled, control] : flags) {
+				if (enabled)
+					bits |= static_cast<uint32_t>(control);
+			}
+			return bits;
+		}
+
+		void WinRTAudioSession::raisePlaybackEvent(const PlaybackEvent& event) {
+			PlaybackChangedCallback changed;
+			PlaybackEventCallback typed;
+			{
+				std::scoped_lock lock(m_callbackMutex);
+				changed = m_playbackChanged;
+				typed = m_playbackEvent;
+			}
+			if (typed)
+				typed(event);
+			if (changed)
+				changed("Playback info updated");
+		}
+
+		void WinRTAudioSession::refreshTimeline() const {
+			auto session = currentSession();
+			auto timelineProps = [&] {
+				OperationStats::Scope timing(OperationStats::platform(), StatOperation::FetchTimeline);
+				return getTimelineProperties(session);
+			}();
+			TimelineState timeline;
+			timeline.start = std::chrono::duration_cast<std::chrono::milliseconds>(timelineProps.StartTime());
+			timeline.end = std::chrono::duration_cast<std::chrono::milliseconds>(timelineProps.EndTime());
+			timeline.position = std::chrono::duration_cast<std::chrono::milliseconds>(timelineProps.Position());
+			timeline.lastUpdated = winrt::clock::to_sys(timelineProps.LastUpdatedTime());
+			m_cache.state.publishTimeline(timeline);
+		}
+
+		std::expected<std::shared_ptr<const SessionState>, AudioError> WinRTAudioSession::mediaState() const noexcept {
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Get media properties"));
+			auto state = m_cache.state.load();
+			if (state->media) {
+				m_cache.state.recordHit();
+				return state;
+			}
+			m_cache.state.recordMiss();
 			try {
-				auto playbackInfo = m_currentSession.GetPlaybackInfo();
-				return playbackInfo;
+				refreshMediaProperties();
+				return m_cache.state.load();
 			}
 			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Error getting playback info: {}", ex.what()));
+				return std::unexpected(AudioError::fromException("Get media properties", ex));
+			}
+			catch (const winrt::hresult_error& ex) {
+				return std::unexpected(AudioError(ErrorCategory::Platform, "Get media properties", ex.code(), winrt::to_string(ex.message())));
 			}
 		}
 
-		std::expected<winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionMediaProperties, std::string>
-			WinRTAudioSession::getMediaProperties() const noexcept {
-			if (!m_currentSession)
-				return std::unexpected("No active session.");
+		std::expected<std::shared_ptr<const SessionState>, AudioError> WinRTAudioSession::playbackState() const noexcept {
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Get playback info"));
+			auto state = m_cache.state.load();
+			if (state->playback) {
+				m_cache.state.recordHit();
+				return state;
+			}
+			m_cache.state.recordMiss();
 			try {
-				return m_currentSession.TryGetMediaPropertiesAsync().get();
+				refreshPlaybackInfo();
+				return m_cache.state.load();
 			}
 			catch (const std::exception& ex) {
-				return std::unexpected(std::format("Error getting media properties: {}", ex.what()));
+				return std::unexpected(AudioError::fromException("Get playback info", ex));
+			}
+			catch (const winrt::hresult_error& ex) {
+				return std::unexpected(AudioError(ErrorCategory::Platform, "Get playback info", ex.code(), winrt::to_string(ex.message())));
 			}
 		}
 
-		void WinRTAudioSession::clearCache() noexcept {
+		std::expected<std::shared_ptr<const SessionState>, AudioError> WinRTAudioSession::timelineState() const noexcept {
+			auto session = currentSession();
+			if (!session)
+				return std::unexpected(AudioError(ErrorCategory::NoSession, "Get timeline"));
+			auto state = m_cache.state.load();
+			if (state->timeline) {
+				m_cache.state.recordHit();
+				return state;
+			}
+			m_cache.state.recordMiss();
+			try {
+				refreshTimeline();
+				return m_cache.state.load();
+			}
+			catch (const std::exception& ex) {
+				return std::unexpected(AudioError::fromException("Get timeline", ex));
+			}
+			catch (const winrt::hresult_error& ex) {
+				return std::unexpected(AudioError(ErrorCategory::Platform, "Get timeline", ex.code(), winrt::to_string(ex.message())));
+			}
+		}
+
+		uint64_t WinRTAudioSession::rememberThumbnail(winrt::Windows::Storage::Streams::IRandomAccessStreamReference const& thumbnail) const noexcept {
 			std::scoped_lock lock(m_cache.mutex);
-			m_cache.thumbnailBytes.reset();
-			m_cache.thumbnailRef.reset();
-			m_cache.duration.reset();
+			if (!thumbnail) {
+				m_cache.thumbnailRef.reset();
+				return 0;
+			}
+			if (!m_cache.thumbnailRef || *m_cache.thumbnailRef != thumbnail) {
+				m_cache.thumbnailRef = thumbnail;
+				m_cache.thumbnail.reset();
+				++m_cache.thumbnailHandle;
+			}
+			return m_cache.thumbnailHandle;
 		}
 
 	} 
@@ -1,7 +1,12 @@
 #pragma once
 #include "IAudioSession.h"
+#include "PlaybackEvents.h"
+#include "SessionStateCache.h"
+#include "TrackChangeWatcher.h"
+#include "VolumeController.h"
 #include <winrt/Windows.Media.Control.h>
 #include <winrt/Windows.Media.Playback.h>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <vector>
@@ -14,56 +19,113 @@
 namespace audio {
     namespace platform {
 
-        class WinRTAudioSession : public IAudioSession {
+        class WinRTAudioSession final : public IAudioSession, public std::enable_shared_from_this<WinRTAudioSession> {
         private:
+            // Bound at most once, possibly on a thread-pool thread while callers are already
+            // reading; readers take a copy through currentSession() and use only that.
+            mutable std::mutex m_sessionMutex;
             winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionManager m_sessionManager{ nullptr };
             winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession m_currentSession{ nullptr };
 
+            // state is refreshed from the session's change events; mutex only guards the thumbnail fields.
             struct Cache {
+                SessionStateCache state;
                 std::mutex mutex;
                 std::optional<winrt::Windows::Storage::Streams::IRandomAccessStreamReference> thumbnailRef;
-                std::optional<std::vector<uint8_t>> thumbnailBytes;
-                std::optional<std::chrono::seconds> duration;
+                ThumbnailCache::Buffer thumbnail;
+                uint64_t thumbnailHandle{ 0 };
             };
 
-            Cache m_cache;
-            winrt::event_token m_playbackChangedToken{};
-            winrt::event_token m_mediaPropertiesChangedToken{};
+            mutable Cache m_cache;
+            std::shared_ptr<VolumeController> m_volume;
+            std::shared_ptr<ThumbnailCache> m_thumbnails;
+            winrt::event_token m_cacheMediaToken{};
+            winrt::event_token m_cachePlaybackToken{};
+            winrt::event_token m_cacheTimelineToken{};
 
-            std::expected<winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionPlaybackInfo, std::string>
+            // Last playback state handed out, so PlaybackInfoChanged only raises real changes.
+            mutable PlaybackDiffer m_playbackDiff;
+            std::mutex m_callbackMutex;
+            PlaybackChangedCallback m_playbackChanged;
+            PlaybackEventCallback m_playbackEvent;
+            TrackChangedCallback m_trackChanged;
+            // Last, so its worker is joined before anything it reads goes away.
+            mutable TrackChangeWatcher m_trackWatcher;
+
+            std::expected<winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionPlaybackInfo, AudioError>
                 getPlaybackInfo() const noexcept;
 
-            std::expected<winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionMediaProperties, std::string>
+            std::expected<winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionMediaProperties, AudioError>
                 getMediaProperties() const noexcept;
 
+            void bind(winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionManager manager,
+                winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession session);
+            winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession currentSession() const;
             void clearCache() noexcept;
+            void subscribeCacheEvents();
+            void unsubscribeCacheEvents() noexcept;
+            void primeCache() const;
+            MediaInfo refreshMediaProperties() const;
+            MediaInfo publishMediaProperties(winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionMediaProperties const& mediaProps) const;
+            std::expected<MediaInfo, AudioError> fetchMediaForWatcher() const;
+            void deliverTrackChanged(const MediaInfo& media);
+            PlaybackState refreshPlaybackInfo() const;
+            static uint32_t controlBits(winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionPlaybackControls const& controls) noexcept;
+            void raisePlaybackEvent(const PlaybackEvent& event);
+            void refreshTimeline() const;
+            std::expected<std::shared_ptr<const SessionState>, AudioError> mediaState() const noexcept;
+            std::expected<std::shared_ptr<const SessionState>, AudioError> playbackState() const noexcept;
+            std::expected<std::shared_ptr<const SessionState>, AudioError> timelineState() const noexcept;
+            uint64_t rememberThumbnail(winrt::Windows::Storage::Streams::IRandomAccessStreamReference const& thumbnail) const noexcept;
 
         public:
-            WinRTAudioSession() = default;
+            WinRTAudioSession();
+            // Binds to session up front; initialize() then only subscribes and primes the cache.
+            WinRTAudioSession(winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSession session,
+                std::shared_ptr<VolumeController> volume, std::shared_ptr<ThumbnailCache> thumbnails);
             ~WinRTAudioSession() noexcept override;
             WinRTAudioSession(const WinRTAudioSession&) = delete;
             WinRTAudioSession& operator=(const WinRTAudioSession&) = delete;
-            WinRTAudioSession(WinRTAudioSession&&) noexcept = default;
-            WinRTAudioSession& operator=(WinRTAudioSession&&) noexcept = default;
+            WinRTAudioSession(WinRTAudioSession&&) = delete;
+            WinRTAudioSession& operator=(WinRTAudioSession&&) = delete;
+
+            std::expected<void, AudioError> initialize() noexcept override;
+            AsyncResult<void> initializeAsync() noexcept override;
+            std::expected<std::chrono::seconds, AudioError> getDuration() noexcept override;
+            std::expected<std::chrono::seconds, AudioError> getCurrentPosition() noexcept override;
+            std::expected<std::chrono::milliseconds, AudioError> getCurrentPositionPrecise() noexcept override;
+            std::expected<std::string, AudioError> getTitle() const noexcept override;
+            std::expected<std::string, AudioError> getArtist() const noexcept override;
+            std::expected<std::string, AudioError> getAlbum() const noexcept override;
+            std::expected<std::string_view, AudioError> getText(MediaText field, StringPool& pool) const noexcept override;
+            std::expected<std::u16string, AudioError> getTextUtf16(MediaText field) const noexcept override;
+            std::expected<std::span<const uint8_t>, AudioError> getThumbnailBytes() noexcept override;
+            std::expected<ThumbnailCache::Buffer, AudioError> getThumbnail() noexcept override;
+            std::expected<TrackSnapshot, AudioError> getTrackSnapshot() noexcept override;
 
-            std::expected<void, std::string> initialize() noexcept override;
-            std::expected<std::chrono::seconds, std::string> getDuration() noexcept override;
-            std::expected<std::chrono::seconds, std::string> getCurrentPosition() noexcept override;
-            std::expected<std::string, std::string> getTitle() const noexcept override;
-            std::expected<std::string, std::string> getArtist() const noexcept override;
-            std::expected<std::string, std::string> getAlbum() const noexcept override;
-            std::expected<std::span<const uint8_t>, std::string> getThumbnailBytes() noexcept override;
+            std::expected<void, AudioError> play() noexcept override;
+            std::expected<void, AudioError> pause() noexcept override;
+            std::expected<void, AudioError> next() noexcept override;
+            std::expected<void, AudioError> previous() noexcept override;
+            std::expected<void, AudioError> seek(std::chrono::seconds position) noexcept override;
+            std::expected<void, AudioError> setVolume(double volume) noexcept override;
+            std::expected<double, AudioError> getVolume() noexcept override;
 
-            std::expected<void, std::string> play() noexcept override;
-            std::expected<void, std::string> pause() noexcept override;
-            std::expected<void, std::string> next() noexcept override;
-            std::expected<void, std::string> previous() noexcept override;
-            std::expected<void, std::string> seek(std::chrono::seconds position) noexcept override;
-            std::expected<void, std::string> setVolume(double volume) noexcept override;
-            std::expected<double, std::string> getVolume() noexcept override;
+            AsyncResult<void> playAsync() noexcept override;
+            AsyncResult<void> pauseAsync() noexcept override;
+            AsyncResult<void> nextAsync() noexcept override;
+            AsyncResult<void> previousAsync() noexcept override;
+            AsyncResult<void> seekAsync(std::chrono::seconds position) noexcept override;
+            AsyncResult<void> setVolumeAsync(double volume) noexcept override;
+            AsyncResult<double> getVolumeAsync() noexcept override;
+            AsyncResult<TrackSnapshot> getTrackSnapshotAsync() noexcept override;
 
             void setPlaybackChangedCallback(PlaybackChangedCallback callback) noexcept override;
+            void setPlaybackEventCallback(PlaybackEventCallback callback) noexcept override;
             void setTrackChangedCallback(TrackChangedCallback callback) noexcept override;
+            TrackChangeStats getTrackChangeStats() const noexcept override;
+            VolumeController::SubscriptionId subscribeVolumeChanged(VolumeChangedCallback callback) noexcept override;
+            void unsubscribeVolumeChanged(VolumeController::SubscriptionId id) noexcept override;
         };
 
     } 
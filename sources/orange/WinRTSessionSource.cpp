@@ -0,0 +1,126 @@
+#include "WinRTSessionSource.h"
+#include "WinRTAudioSession.h"
+#include "WasapiVolumeEndpoint.h"
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.Foundation.Collections.h>
+#include <winrt/base.h>
+#include <utility>
+
+namespace audio {
+    namespace platform {
+
+        WinRTSessionSource::WinRTSessionSource(std::shared_ptr<ThumbnailCache> thumbnails)
+            : m_volume(std::make_shared<VolumeController>(std::make_unique<WasapiVolumeEndpoint>())),
+            m_thumbnails(std::move(thumbnails)) {
+        }
+
+        WinRTSessionSource::~WinRTSessionSource() noexcept {
+            unsubscribe();
+        }
+
+        std::expected<void, AudioError> WinRTSessionSource::open(Handlers handlers) noexcept {
+            try {
+                m_sessionManager = winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionManager::RequestAsync().get();
+                subscribe(std::move(handlers));
+                return {};
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Open session manager", ex));
+            }
+            catch (const winrt::hresult_error& ex) {
+                return std::unexpected(AudioError(ErrorCategory::Platform, "Open session manager", ex.code(), winrt::to_string(ex.message())));
+            }
+        }
+
+        AsyncResult<void> WinRTSessionSource::openAsync(Handlers handlers) noexcept {
+            try {
+                m_sessionManager = co_await winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionManager::RequestAsync();
+                subscribe(std::move(handlers));
+                co_return {};
+            }
+            catch (const std::exception& ex) {
+                co_return std::unexpected(AudioError::fromException("Open session manager", ex));
+            }
+            catch (const winrt::hresult_error& ex) {
+                co_return std::unexpected(AudioError(ErrorCategory::Platform, "Open session manager", ex.code(), winrt::to_string(ex.message())));
+            }
+        }
+
+        std::expected<std::vector<std::string>, AudioError> WinRTSessionSource::sessionIds() noexcept {
+            if (!m_sessionManager)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "List sessions"));
+            try {
+                auto sessions = m_sessionManager.GetSessions();
+                std::vector<std::string> ids;
+                ids.reserve(sessions.Size());
+                for (auto const& session : sessions)
+                    ids.push_back(winrt::to_string(session.SourceAppUserModelId()));
+                return ids;
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("List sessions", ex));
+            }
+            catch (const winrt::hresult_error& ex) {
+                return std::unexpected(AudioError(ErrorCategory::Platform, "List sessions", ex.code(), winrt::to_string(ex.message())));
+            }
+        }
+
+        std::expected<std::string, AudioError> WinRTSessionSource::currentSessionId() noexcept {
+            if (!m_sessionManager)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "Get current session"));
+            try {
+                auto session = m_sessionManager.GetCurrentSession();
+                if (!session)
+                    return std::string();
+                return winrt::to_string(session.SourceAppUserModelId());
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Get current session", ex));
+            }
+            catch (const winrt::hresult_error& ex) {
+                return std::unexpected(AudioError(ErrorCategory::Platform, "Get current session", ex.code(), winrt::to_string(ex.message())));
+            }
+        }
+
+        std::expected<std::shared_ptr<IAudioSession>, AudioError> WinRTSessionSource::createSession(std::string_view id) noexcept {
+            if (!m_sessionManager)
+                return std::unexpected(AudioError(ErrorCategory::NotReady, "Create session"));
+            try {
+                auto wideId = winrt::to_hstring(id);
+                for (auto const& session : m_sessionManager.GetSessions()) {
+                    if (session.SourceAppUserModelId() == wideId)
+                        return std::make_shared<WinRTAudioSession>(session, m_volume, m_thumbnails);
+                }
+                return std::unexpected(AudioError(ErrorCategory::NotFound, "Create session"));
+            }
+            catch (const std::exception& ex) {
+                return std::unexpected(AudioError::fromException("Create session", ex));
+            }
+            catch (const winrt::hresult_error& ex) {
+                return std::unexpected(AudioError(ErrorCategory::Platform, "Create session", ex.code(), winrt::to_string(ex.message())));
+            }
+        }
+
+        void WinRTSessionSource::subscribe(Handlers handlers) {
+            unsubscribe();
+            m_sessionsChangedToken = m_sessionManager.SessionsChanged([handler = handlers.sessionsChanged](auto const&, auto const&) {
+                if (handler)
+                    handler();
+                });
+            m_currentSessionChangedToken = m_sessionManager.CurrentSessionChanged([handler = handlers.currentSessionChanged](auto const&, auto const&) {
+                if (handler)
+                    handler();
+                });
+        }
+
+        void WinRTSessionSource::unsubscribe() noexcept {
+            if (!m_sessionManager)
+                return;
+            if (m_sessionsChangedToken)
+                m_sessionManager.SessionsChanged(std::exchange(m_sessionsChangedToken, {}));
+            if (m_currentSessionChangedToken)
+                m_sessionManager.CurrentSessionChanged(std::exchange(m_currentSessionChangedToken, {}));
+        }
+
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "SessionRegistry.h"
+#include "VolumeController.h"
+#include "ThumbnailCache.h"
+#include <winrt/Windows.Media.Control.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace audio {
+    namespace platform {
+
+        // Feeds SessionRegistry from GlobalSystemMediaTransportControlsSessionManager. Sessions are
+        // keyed by SourceAppUserModelId. The volume controller is shared by every session it
+        // creates, since they all steer the same audio session of this process, and so is the
+        // thumbnail cache, since players often report the same artwork.
+        class WinRTSessionSource : public ISessionSource {
+        public:
+            explicit WinRTSessionSource(std::shared_ptr<ThumbnailCache> thumbnails);
+            ~WinRTSessionSource() noexcept override;
+            WinRTSessionSource(const WinRTSessionSource&) = delete;
+            WinRTSessionSource& operator=(const WinRTSessionSource&) = delete;
+
+            std::expected<void, AudioError> open(Handlers handlers) noexcept override;
+            AsyncResult<void> openAsync(Handlers handlers) noexcept override;
+            std::expected<std::vector<std::string>, AudioError> sessionIds() noexcept override;
+            std::expected<std::string, AudioError> currentSessionId() noexcept override;
+            std::expected<std::shared_ptr<IAudioSession>, AudioError> createSession(std::string_view id) noexcept override;
+
+        private:
+            void subscribe(Handlers handlers);
+            void unsubscribe() noexcept;
+
+            winrt::Windows::Media::Control::GlobalSystemMediaTransportControlsSessionManager m_sessionManager{ nullptr };
+            winrt::event_token m_sessionsChangedToken{};
+            winrt::event_token m_currentSessionChangedToken{};
+            std::shared_ptr<VolumeController> m_volume;
+            std::shared_ptr<ThumbnailCache> m_thumbnails;
+        };
+
+    }
+}
@@ -1,10 +1,20 @@
 #include <memory>
 #include <chrono>
 #include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <cstring>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
 #include "AudioAPI.h"
 #include "AudioSessionManager.h"
+#ifdef AUDIO_ENABLE_SIMULATION
+#include "SimulatedAudioSession.h"
+#endif
+#include "Tracer.h"
+#include "Utf16.h"
 
 #if defined(_WIN32) || defined(_WIN64)
 #define API_EXPORT __declspec(dllexport)
@@ -40,17 +50,478 @@ ExpectedResult makeError(const std::string& error) {
 
 using PlaybackCallback = void (*)(const char*);
 using TrackChangedCallback = void (*)(const char*, const char*);
+using ActiveSessionCallback = void (*)(const char*);
+
+constexpr size_t SNAPSHOT_TEXT_CAPACITY = 512;
+
+// Filled in place by getSnapshot; text fields are truncated to fit and always NUL-terminated.
+struct AudioTrackSnapshot {
+    char title[SNAPSHOT_TEXT_CAPACITY];
+    char artist[SNAPSHOT_TEXT_CAPACITY];
+    char album[SNAPSHOT_TEXT_CAPACITY];
+    char albumArtist[SNAPSHOT_TEXT_CAPACITY];
+    int32_t trackNumber;
+    int32_t playbackStatus;
+    int64_t durationSeconds;
+    int64_t positionSeconds;
+    uint64_t thumbnailHandle;
+};
+
+// AudioTrackSnapshot with its text in UTF-16 code units, for callers that keep text that way.
+// Each field is NUL-terminated and its length, in units without the NUL, is given alongside.
+struct AudioTrackSnapshotUtf16 {
+    char16_t title[SNAPSHOT_TEXT_CAPACITY];
+    char16_t artist[SNAPSHOT_TEXT_CAPACITY];
+    char16_t album[SNAPSHOT_TEXT_CAPACITY];
+    char16_t albumArtist[SNAPSHOT_TEXT_CAPACITY];
+    uint32_t titleLength;
+    uint32_t artistLength;
+    uint32_t albumLength;
+    uint32_t albumArtistLength;
+    int32_t trackNumber;
+    int32_t playbackStatus;
+    int64_t durationSeconds;
+    int64_t positionSeconds;
+    uint64_t thumbnailHandle;
+};
+
+struct AudioCommandStats {
+    uint64_t submitted;
+    uint64_t executed;
+    uint64_t coalesced;
+    int64_t totalWaitMicros;
+    int64_t maxWaitMicros;
+};
+
+struct AudioThumbnailCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t deduplicated;
+    uint64_t evictions;
+    uint64_t entries;
+    uint64_t bytes;
+    uint64_t budgetBytes;
+};
+
+// Premultiplied RGBA8, rows of width * 4 bytes with no padding.
+struct AudioRgbaImage {
+    const uint8_t* pixels;
+    uint32_t width;
+    uint32_t height;
+};
+
+// kind is audio::SessionEvent::Kind; timestampMicros is system time since the Unix epoch.
+struct AudioEvent {
+    int32_t kind;
+    uint32_t reserved;
+    uint64_t sequence;
+    int64_t timestampMicros;
+};
+
+struct AudioEventQueueStats {
+    uint64_t pushed;
+    uint64_t delivered;
+    uint64_t overflows;
+    uint64_t dropped;
+    uint64_t capacity;
+};
+
+// status is audio::PlaybackStatus, repeat audio::RepeatMode and controls a set of
+// audio::PlaybackControl bits.
+struct AudioPlaybackState {
+    int32_t status;
+    int32_t repeat;
+    double rate;
+    uint32_t shuffle;
+    uint32_t controls;
+};
+
+// changed is a set of audio::PlaybackEvent::Field bits.
+struct AudioPlaybackEvent {
+    AudioPlaybackState previous;
+    AudioPlaybackState current;
+    uint32_t changed;
+    uint32_t reserved;
+};
+
+struct AudioPlaybackEventStats {
+    uint64_t received;
+    uint64_t delivered;
+    uint64_t collapsed;
+    uint64_t cancelled;
+};
+
+struct AudioTrackChangeStats {
+    uint64_t received;
+    uint64_t fetches;
+    uint64_t delivered;
+    uint64_t unchanged;
+    uint64_t failures;
+};
+
+constexpr size_t STAT_OPERATION_COUNT = audio::StatOperationCount;
+
+// Percentiles are read off a histogram with four buckets per power of two, so they may be up
+// to 25% above the true value; none exceeds maxNanos.
+struct AudioOperationStats {
+    uint64_t calls;
+    uint64_t errors;
+    int64_t totalNanos;
+    int64_t maxNanos;
+    int64_t p50Nanos;
+    int64_t p90Nanos;
+    int64_t p99Nanos;
+    int64_t p999Nanos;
+};
+
+// operations is indexed by audio::StatOperation and events by audio::SessionEvent::Kind.
+struct AudioStats {
+    AudioOperationStats operations[STAT_OPERATION_COUNT];
+    uint64_t cacheHits;
+    uint64_t cacheMisses;
+    uint64_t events[4];
+    int64_t elapsedNanos;
+};
+
+// Text owned by the manager's string pool: UTF-8, NUL-terminated, length in bytes without the
+// NUL. Valid until releaseStringsV2 is next called on the same manager.
+struct AudioBorrowedText {
+    const char* text;
+    uint64_t length;
+};
+
+struct AudioStringPoolStats {
+    uint64_t strings;
+    uint64_t bytes;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t reclaimed;
+    uint64_t epoch;
+};
+
+struct AudioHistoryStats {
+    uint64_t appended;
+    uint64_t committed;
+    uint64_t commits;
+    uint64_t failures;
+    uint64_t recovered;
+    uint64_t truncatedBytes;
+};
+
+// outcome is audio::PlayOutcome: 1 skipped, 2 completed.
+struct AudioHistoryRecord {
+    int64_t startedMicros;
+    uint64_t trackId;
+    uint32_t playedMillis;
+    uint32_t durationSeconds;
+    int32_t outcome;
+    int32_t reserved;
+};
+
+struct AudioPlayCount {
+    uint64_t plays;
+    uint64_t completed;
+    int64_t playedMillis;
+};
+
+// status is audio::PlaybackStatus; durationMillis is zero when the session reports none.
+struct AudioPositionTick {
+    int64_t positionMillis;
+    int64_t durationMillis;
+    int32_t status;
+    int32_t reserved;
+};
+
+struct AudioPositionTickerStats {
+    uint64_t sources;
+    uint64_t subscribers;
+    uint64_t parked;
+    uint64_t ticks;
+    uint64_t samples;
+    uint64_t sampleFailures;
+    uint64_t turns;
+};
+
+#ifdef AUDIO_ENABLE_SIMULATION
+// Both arrays are indexed by audio::platform::SimulatedOperation: initialize, reads, snapshot,
+// thumbnail, commands, volume.
+struct AudioSimulationProfile {
+    int64_t latencyMicros[6];
+    int64_t jitterMicros[6];
+    double eventRate;
+    uint64_t thumbnailBytes;
+    uint64_t seed;
+};
+#endif
+
+// Runs on a system or debouncer thread; event is only valid for the duration of the call.
+using PlaybackEventCallbackV2 = void (*)(void* userData, const AudioPlaybackEvent* event);
+
+// Passed to subscribeV2 callbacks. kind is audio::SessionEvent::Kind and selects the filled
+// fields: playback for PlaybackChanged, title and artist for TrackChanged, sessionId for
+// ActiveSessionChanged. The others are null. Everything is valid for the duration of the call.
+struct AudioNotification {
+    int32_t kind;
+    uint32_t reserved;
+    const AudioPlaybackEvent* playback;
+    const char* title;
+    const char* artist;
+    const char* sessionId;
+};
+
+using NotificationCallbackV2 = void (*)(void* userData, const AudioNotification* notification);
+
+// Runs on the position ticker's thread; tick is only valid for the duration of the call.
+using PositionCallbackV2 = void (*)(void* userData, const AudioPositionTick* tick);
+
+// Completion callbacks for the *Async exports. They run on the thread that finished the
+// operation; error and snapshot pointers are only valid for the duration of the call.
+using AsyncCompletionCallback = void (*)(void* userData, bool success, const char* error);
+using AsyncVolumeCallback = void (*)(void* userData, bool success, double volume, const char* error);
+using AsyncSnapshotCallback = void (*)(void* userData, const AudioTrackSnapshot* snapshot, const char* error);
+
+void fillPlaybackState(const audio::PlaybackState& state, AudioPlaybackState* out) {
+    out->status = static_cast<int32_t>(state.status);
+    out->repeat = static_cast<int32_t>(state.repeat);
+    out->rate = state.rate;
+    out->shuffle = state.shuffle ? 1 : 0;
+    out->controls = state.controls;
+}
+
+void deliverNotification(NotificationCallbackV2 callback, void* userData, const audio::SessionNotification& notification) {
+    AudioNotification out{};
+    out.kind = static_cast<int32_t>(notification.kind);
+    AudioPlaybackEvent playback{};
+    std::string first;
+    std::string second;
+    switch (notification.kind) {
+    case audio::SessionEvent::Kind::PlaybackChanged:
+        if (notification.playback) {
+            fillPlaybackState(notification.playback->previous, &playback.previous);
+            fillPlaybackState(notification.playback->current, &playback.current);
+            playback.changed = notification.playback->changed;
+            out.playback = &playback;
+        }
+        break;
+    case audio::SessionEvent::Kind::TrackChanged:
+        first = notification.title;
+        second = notification.artist;
+        out.title = first.c_str();
+        out.artist = second.c_str();
+        break;
+    case audio::SessionEvent::Kind::ActiveSessionChanged:
+        first = notification.sessionId;
+        out.sessionId = first.c_str();
+        break;
+    }
+    callback(userData, &out);
+}
+
 void safeCopyString(char* dest, size_t destSize, const char* src) {
 #ifdef _MSC_VER
-    strcpy_s(dest, destSize, src);
+    strncpy_s(dest, destSize, src, _TRUNCATE);
 #else
     strncpy(dest, src, destSize - 1);
     dest[destSize - 1] = '\0'; 
 #endif
 }
 
+void fillSnapshot(const audio::TrackSnapshot& snapshot, AudioTrackSnapshot* outSnapshot) {
+    safeCopyString(outSnapshot->title, SNAPSHOT_TEXT_CAPACITY, snapshot.title.c_str());
+    safeCopyString(outSnapshot->artist, SNAPSHOT_TEXT_CAPACITY, snapshot.artist.c_str());
+    safeCopyString(outSnapshot->album, SNAPSHOT_TEXT_CAPACITY, snapshot.album.c_str());
+    safeCopyString(outSnapshot->albumArtist, SNAPSHOT_TEXT_CAPACITY, snapshot.albumArtist.c_str());
+    outSnapshot->trackNumber = snapshot.trackNumber;
+    outSnapshot->playbackStatus = static_cast<int32_t>(snapshot.status);
+    outSnapshot->durationSeconds = snapshot.duration.count();
+    outSnapshot->positionSeconds = snapshot.position.count();
+    outSnapshot->thumbnailHandle = snapshot.thumbnailHandle;
+}
+
+// Truncates like safeCopyString, but never inside a character.
+uint32_t copyUtf16(std::string_view text, char16_t* dest) {
+    const auto length = audio::Utf16::toUtf16(text, dest, SNAPSHOT_TEXT_CAPACITY - 1);
+    dest[length] = u'\0';
+    return static_cast<uint32_t>(length);
+}
+
+void fillSnapshotUtf16(const audio::TrackSnapshot& snapshot, AudioTrackSnapshotUtf16* outSnapshot) {
+    outSnapshot->titleLength = copyUtf16(snapshot.title, outSnapshot->title);
+    outSnapshot->artistLength = copyUtf16(snapshot.artist, outSnapshot->artist);
+    outSnapshot->albumLength = copyUtf16(snapshot.album, outSnapshot->album);
+    outSnapshot->albumArtistLength = copyUtf16(snapshot.albumArtist, outSnapshot->albumArtist);
+    outSnapshot->trackNumber = snapshot.trackNumber;
+    outSnapshot->playbackStatus = static_cast<int32_t>(snapshot.status);
+    outSnapshot->durationSeconds = snapshot.duration.count();
+    outSnapshot->positionSeconds = snapshot.position.count();
+    outSnapshot->thumbnailHandle = snapshot.thumbnailHandle;
+}
+
+void completeAsync(audio::AsyncResult<void> operation, AsyncCompletionCallback callback, void* userData) {
+    operation.then([callback, userData](const std::expected<void, audio::AudioError>& result) {
+        if (result)
+            callback(userData, true, nullptr);
+        else
+            callback(userData, false, result.error().message().c_str());
+        });
+}
+
+// Result convention of the V2 exports. Nothing is heap-allocated on either side: scalars come back
+// inline, strings and byte arrays are written into caller buffers, and a failure is a status code
+// whose details can be fetched with getLastErrorInfoV2 or getLastErrorMessageV2 on the same thread
+// when they are wanted.
+enum AudioStatus : int32_t {
+    AUDIO_OK = 0,
+    AUDIO_ERROR_INVALID_ARGUMENT = 1,
+    AUDIO_ERROR_NO_SESSION = 2,
+    AUDIO_ERROR_NOT_READY = 3,
+    // value.size holds the length the buffer needs, excluding the terminating NUL for strings.
+    AUDIO_ERROR_BUFFER_TOO_SMALL = 4,
+    // Reserved for ABI stability.
+    AUDIO_ERROR_OPERATION_FAILED = 5,
+    AUDIO_ERROR_NOT_FOUND = 6,
+    AUDIO_ERROR_UNSUPPORTED = 7,
+    AUDIO_ERROR_INTERRUPTED = 8,
+    AUDIO_ERROR_PLATFORM = 9,
+    AUDIO_ERROR_INTERNAL = 10
+};
+
+enum AudioValueKind : int32_t {
+    AUDIO_VALUE_NONE = 0,
+    AUDIO_VALUE_INT64 = 1,
+    AUDIO_VALUE_DOUBLE = 2,
+    AUDIO_VALUE_SIZE = 3
+};
+
+struct AudioResult {
+    int32_t status;
+    int32_t kind;
+    union {
+        int64_t i64;
+        double f64;
+        uint64_t size;
+    } value;
+};
+
+// category is the audio::ErrorCategory value; operation is a static string owned by the library.
+struct AudioErrorInfo {
+    int32_t category;
+    int32_t hresult;
+    const char* operation;
+};
+
+namespace {
+
+    // Holds the error itself rather than its text, so recording a failure never allocates; the
+    // message is only formatted if the caller asks for it.
+    thread_local std::optional<audio::AudioError> lastError;
+
+    AudioStatus statusFor(audio::ErrorCategory category) {
+        switch (category) {
+        case audio::ErrorCategory::NoSession: return AUDIO_ERROR_NO_SESSION;
+        case audio::ErrorCategory::NotReady: return AUDIO_ERROR_NOT_READY;
+        case audio::ErrorCategory::NotFound: return AUDIO_ERROR_NOT_FOUND;
+        case audio::ErrorCategory::InvalidArgument: return AUDIO_ERROR_INVALID_ARGUMENT;
+        case audio::ErrorCategory::Unsupported: return AUDIO_ERROR_UNSUPPORTED;
+        case audio::ErrorCategory::Interrupted: return AUDIO_ERROR_INTERRUPTED;
+        case audio::ErrorCategory::Platform: return AUDIO_ERROR_PLATFORM;
+        case audio::ErrorCategory::Internal: return AUDIO_ERROR_INTERNAL;
+        }
+        return AUDIO_ERROR_INTERNAL;
+    }
+
+    AudioResult statusResult(AudioStatus status) {
+        AudioResult result{ status, AUDIO_VALUE_NONE, {} };
+        result.value.i64 = 0;
+        return result;
+    }
+
+    AudioResult failure(const audio::AudioError& error) {
+        lastError = error;
+        return statusResult(statusFor(error.category()));
+    }
+
+    AudioResult invalidArgument(const char* operation) {
+        return failure(audio::AudioError(audio::ErrorCategory::InvalidArgument, operation));
+    }
+
+    // Paths cross the ABI as UTF-8.
+    std::filesystem::path utf8Path(const char* path) {
+        return std::filesystem::path(std::u8string_view(reinterpret_cast<const char8_t*>(path)));
+    }
+
+    AudioResult borrowedText(const std::expected<std::string_view, audio::AudioError>& text, AudioBorrowedText* out) {
+        if (!text) return failure(text.error());
+        out->text = text->data();
+        out->length = text->size();
+        AudioResult result{ AUDIO_OK, AUDIO_VALUE_SIZE, {} };
+        result.value.size = text->size();
+        return result;
+    }
+
+    AudioResult int64Result(int64_t value) {
+        AudioResult result{ AUDIO_OK, AUDIO_VALUE_INT64, {} };
+        result.value.i64 = value;
+        return result;
+    }
+
+    AudioResult doubleResult(double value) {
+        AudioResult result{ AUDIO_OK, AUDIO_VALUE_DOUBLE, {} };
+        result.value.f64 = value;
+        return result;
+    }
+
+    // A null buffer or zero capacity is a pure length query.
+    AudioResult writeBytes(const void* data, size_t size, void* buffer, uint64_t capacity, bool terminate) {
+        AudioResult result{ AUDIO_OK, AUDIO_VALUE_SIZE, {} };
+        result.value.size = size;
+        if (!buffer || capacity < size + (terminate ? 1 : 0)) {
+            result.status = AUDIO_ERROR_BUFFER_TOO_SMALL;
+            return result;
+        }
+        if (size != 0)
+            std::memcpy(buffer, data, size);
+        if (terminate)
+            static_cast<char*>(buffer)[size] = '\0';
+        return result;
+    }
+
+    AudioResult writeText(std::string_view text, char* buffer, uint64_t capacity) {
+        return writeBytes(text.data(), text.size(), buffer, capacity, true);
+    }
+
+    AudioResult fromVoid(const std::expected<void, audio::AudioError>& result) {
+        return result ? statusResult(AUDIO_OK) : failure(result.error());
+    }
+
+    template <typename Rep, typename Period>
+    AudioResult fromDuration(const std::expected<std::chrono::duration<Rep, Period>, audio::AudioError>& result) {
+        return result ? int64Result(static_cast<int64_t>(result->count())) : failure(result.error());
+    }
+
+    AudioResult fromText(const std::expected<std::string, audio::AudioError>& result, char* buffer, uint64_t capacity) {
+        return result ? writeText(*result, buffer, capacity) : failure(result.error());
+    }
+
+    // As writeText, with capacity and value.size counted in UTF-16 code units.
+    AudioResult fromUtf16(const std::expected<std::u16string, audio::AudioError>& result, char16_t* buffer, uint64_t capacity) {
+        if (!result) return failure(result.error());
+        AudioResult written{ AUDIO_OK, AUDIO_VALUE_SIZE, {} };
+        written.value.size = result->size();
+        if (!buffer || capacity < result->size() + 1) {
+            written.status = AUDIO_ERROR_BUFFER_TOO_SMALL;
+            return written;
+        }
+        std::copy(result->begin(), result->end(), buffer);
+        buffer[result->size()] = u'\0';
+        return written;
+    }
+
+}
+
 extern "C" {
     API_EXPORT void* createAudioManager() {
+        audio::TraceSpan trace("ffi", __func__);
         try {
             return new audio::AudioTrackManager();
         }
@@ -60,6 +531,7 @@ extern "C" {
     }
 
     API_EXPORT void destroyAudioManager(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (managerPtr) {
             auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
             delete manager;
@@ -67,6 +539,7 @@ extern "C" {
     }
 
     API_EXPORT ExpectedResult initialize(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -77,11 +550,12 @@ extern "C" {
             return makeVoidSuccess();
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
 
     API_EXPORT ExpectedResult getDuration(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -92,11 +566,12 @@ extern "C" {
             return { true, seconds };
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
 
     API_EXPORT ExpectedResult getCurrentPosition(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -107,11 +582,28 @@ extern "C" {
             return { true, seconds };
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
+        }
+    }
+
+    API_EXPORT ExpectedResult getCurrentPositionPrecise(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return makeError("Invalid manager pointer");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        auto result = manager->getCurrentPositionPrecise();
+
+        if (result) {
+            auto* millis = new int64_t(result.value().count());
+            return { true, millis };
+        }
+        else {
+            return makeError(result.error().message());
         }
     }
 
     API_EXPORT ExpectedResult getTitle(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -124,11 +616,12 @@ extern "C" {
             return { true, title_str };
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
 
     API_EXPORT ExpectedResult getArtist(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -141,11 +634,12 @@ extern "C" {
             return { true, artist_str };
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
 
     API_EXPORT ExpectedResult getAlbum(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -158,11 +652,28 @@ extern "C" {
             return { true, album_str };
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
+        }
+    }
+
+    API_EXPORT ExpectedResult getSnapshot(void* managerPtr, AudioTrackSnapshot* outSnapshot) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outSnapshot) return makeError("Invalid pointers");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        auto result = manager->getTrackSnapshot();
+
+        if (result) {
+            fillSnapshot(result.value(), outSnapshot);
+            return makeVoidSuccess();
+        }
+        else {
+            return makeError(result.error().message());
         }
     }
 
     API_EXPORT ExpectedResult play(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -172,11 +683,15 @@ extern "C" {
             return makeVoidSuccess();
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
 
+#ifdef _WIN32
+    // Elsewhere a C symbol named pause would collide with, and interpose, pause(2) from libc;
+    // callers there use pauseV2.
     API_EXPORT ExpectedResult pause(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -186,11 +701,13 @@ extern "C" {
             return makeVoidSuccess();
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
+#endif
 
     API_EXPORT ExpectedResult next(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -200,11 +717,12 @@ extern "C" {
             return makeVoidSuccess();
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
 
     API_EXPORT ExpectedResult previous(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -214,11 +732,12 @@ extern "C" {
             return makeVoidSuccess();
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
 
     API_EXPORT ExpectedResult seek(void* managerPtr, int64_t seconds) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -231,10 +750,11 @@ extern "C" {
             return makeVoidSuccess();
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
     API_EXPORT ExpectedResult setVolume(void* managerPtr, double volume) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -244,11 +764,12 @@ extern "C" {
             return makeVoidSuccess();
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
 
     API_EXPORT ExpectedResult getVolume(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr) return makeError("Invalid manager pointer");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -259,34 +780,353 @@ extern "C" {
             return { true, volume };
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
         }
     }
 
     API_EXPORT ExpectedResult getThumbnailBytes(void* managerPtr, uint8_t** outBuffer, size_t* outSize) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr || !outBuffer || !outSize) return makeError("Invalid pointers");
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
 
  
-        auto result = manager->getThumbnailBytes();
+        auto result = manager->getThumbnail();
 
         if (result) {
-            auto span = result.value();
-            size_t size = span.size();
+            const auto& bytes = *result.value();
+            size_t size = bytes.size();
             *outSize = size;
             uint8_t* buffer = new uint8_t[size];
-            std::memcpy(buffer, span.data(), size);
+            std::memcpy(buffer, bytes.data(), size);
             *outBuffer = buffer;
 
             return makeVoidSuccess();
         }
         else {
-            return makeError(result.error());
+            return makeError(result.error().message());
+        }
+    }
+
+    // Lends the cached artwork without copying. outData stays valid until the handle written to
+    // outHandle is passed to releaseThumbnail, regardless of later track changes or eviction.
+    API_EXPORT ExpectedResult acquireThumbnail(void* managerPtr, const uint8_t** outData, uint64_t* outSize, void** outHandle) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outData || !outSize || !outHandle) return makeError("Invalid pointers");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        auto result = manager->getThumbnail();
+
+        if (result) {
+            try {
+                auto* handle = new audio::ThumbnailCache::Buffer(std::move(result.value()));
+                *outData = (*handle)->data();
+                *outSize = (*handle)->size();
+                *outHandle = handle;
+                return makeVoidSuccess();
+            }
+            catch (const std::exception& ex) {
+                return makeError(ex.what());
+            }
+        }
+        else {
+            return makeError(result.error().message());
+        }
+    }
+
+    API_EXPORT void releaseThumbnail(void* handle) {
+        audio::TraceSpan trace("ffi", __func__);
+        delete static_cast<audio::ThumbnailCache::Buffer*>(handle);
+    }
+
+    API_EXPORT ExpectedResult setThumbnailCacheBudget(void* managerPtr, uint64_t budgetBytes) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return makeError("Invalid manager pointer");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        manager->setThumbnailCacheBudget(static_cast<size_t>(budgetBytes));
+        return makeVoidSuccess();
+    }
+
+    API_EXPORT ExpectedResult getThumbnailCacheStats(void* managerPtr, AudioThumbnailCacheStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outStats) return makeError("Invalid pointers");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        auto stats = manager->getThumbnailCacheStats();
+        outStats->hits = stats.hits;
+        outStats->misses = stats.misses;
+        outStats->deduplicated = stats.deduplicated;
+        outStats->evictions = stats.evictions;
+        outStats->entries = stats.entries;
+        outStats->bytes = stats.bytes;
+        outStats->budgetBytes = stats.budgetBytes;
+        return makeVoidSuccess();
+    }
+
+    API_EXPORT ExpectedResult setThumbnailSizes(void* managerPtr, const uint32_t* sizes, uint64_t count) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || (!sizes && count != 0)) return makeError("Invalid pointers");
+
+        try {
+            auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+            manager->setThumbnailSizes(std::vector<uint32_t>(sizes, sizes + count));
+            return makeVoidSuccess();
+        }
+        catch (const std::exception& ex) {
+            return makeError(ex.what());
+        }
+    }
+
+    // Never waits for decoding; fails with "Thumbnail is not ready." until the variant exists.
+    // outImage->pixels stays valid until outHandle is passed to releaseThumbnailRgba.
+    API_EXPORT ExpectedResult acquireThumbnailRgba(void* managerPtr, uint32_t size, AudioRgbaImage* outImage, void** outHandle) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outImage || !outHandle) return makeError("Invalid pointers");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        auto result = manager->getThumbnailRgba(size);
+
+        if (result) {
+            try {
+                auto* handle = new audio::ThumbnailProcessor::Image(std::move(result.value()));
+                outImage->pixels = (*handle)->pixels.data();
+                outImage->width = (*handle)->width;
+                outImage->height = (*handle)->height;
+                *outHandle = handle;
+                return makeVoidSuccess();
+            }
+            catch (const std::exception& ex) {
+                return makeError(ex.what());
+            }
+        }
+        else {
+            return makeError(result.error().message());
+        }
+    }
+
+    API_EXPORT void releaseThumbnailRgba(void* handle) {
+        audio::TraceSpan trace("ffi", __func__);
+        delete static_cast<audio::ThumbnailProcessor::Image*>(handle);
+    }
+
+    API_EXPORT void initializeAsync(void* managerPtr, AsyncCompletionCallback callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!callback) return;
+        if (!managerPtr) {
+            callback(userData, false, "Invalid manager pointer");
+            return;
+        }
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        completeAsync(manager->initializeAsync(), callback, userData);
+    }
+
+    API_EXPORT void playAsync(void* managerPtr, AsyncCompletionCallback callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!callback) return;
+        if (!managerPtr) {
+            callback(userData, false, "Invalid manager pointer");
+            return;
+        }
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        completeAsync(manager->playAsync(), callback, userData);
+    }
+
+    API_EXPORT void pauseAsync(void* managerPtr, AsyncCompletionCallback callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!callback) return;
+        if (!managerPtr) {
+            callback(userData, false, "Invalid manager pointer");
+            return;
+        }
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        completeAsync(manager->pauseAsync(), callback, userData);
+    }
+
+    API_EXPORT void nextAsync(void* managerPtr, AsyncCompletionCallback callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!callback) return;
+        if (!managerPtr) {
+            callback(userData, false, "Invalid manager pointer");
+            return;
+        }
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        completeAsync(manager->nextAsync(), callback, userData);
+    }
+
+    API_EXPORT void previousAsync(void* managerPtr, AsyncCompletionCallback callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!callback) return;
+        if (!managerPtr) {
+            callback(userData, false, "Invalid manager pointer");
+            return;
+        }
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        completeAsync(manager->previousAsync(), callback, userData);
+    }
+
+    API_EXPORT void seekAsync(void* managerPtr, int64_t seconds, AsyncCompletionCallback callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!callback) return;
+        if (!managerPtr) {
+            callback(userData, false, "Invalid manager pointer");
+            return;
+        }
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        completeAsync(manager->seekAsync(std::chrono::seconds(seconds)), callback, userData);
+    }
+
+    API_EXPORT void setVolumeAsync(void* managerPtr, double volume, AsyncCompletionCallback callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!callback) return;
+        if (!managerPtr) {
+            callback(userData, false, "Invalid manager pointer");
+            return;
+        }
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        completeAsync(manager->setVolumeAsync(volume), callback, userData);
+    }
+
+    API_EXPORT void getVolumeAsync(void* managerPtr, AsyncVolumeCallback callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!callback) return;
+        if (!managerPtr) {
+            callback(userData, false, 0.0, "Invalid manager pointer");
+            return;
+        }
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        manager->getVolumeAsync().then([callback, userData](const std::expected<double, audio::AudioError>& result) {
+            if (result)
+                callback(userData, true, result.value(), nullptr);
+            else
+                callback(userData, false, 0.0, result.error().message().c_str());
+            });
+    }
+
+    API_EXPORT void getSnapshotAsync(void* managerPtr, AsyncSnapshotCallback callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!callback) return;
+        if (!managerPtr) {
+            callback(userData, nullptr, "Invalid manager pointer");
+            return;
+        }
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        manager->getTrackSnapshotAsync().then([callback, userData](const std::expected<audio::TrackSnapshot, audio::AudioError>& result) {
+            if (result) {
+                AudioTrackSnapshot snapshot{};
+                fillSnapshot(result.value(), &snapshot);
+                callback(userData, &snapshot, nullptr);
+            }
+            else {
+                callback(userData, nullptr, result.error().message().c_str());
+            }
+            });
+    }
+
+    API_EXPORT ExpectedResult getCommandStats(void* managerPtr, AudioCommandStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outStats) return makeError("Invalid pointers");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        auto stats = manager->getCommandStats();
+        outStats->submitted = stats.submitted;
+        outStats->executed = stats.executed;
+        outStats->coalesced = stats.coalesced;
+        outStats->totalWaitMicros = stats.totalWait.count();
+        outStats->maxWaitMicros = stats.maxWait.count();
+        return makeVoidSuccess();
+    }
+
+    // Ids are joined with '\n'; app user model ids never contain one.
+    API_EXPORT ExpectedResult getSessionIds(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return makeError("Invalid manager pointer");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        try {
+            std::string joined;
+            for (const auto& id : manager->getSessionIds()) {
+                if (!joined.empty())
+                    joined += '\n';
+                joined += id;
+            }
+            char* ids_str = new char[joined.length() + 1];
+            safeCopyString(ids_str, joined.length() + 1, joined.c_str());
+            return { true, ids_str };
+        }
+        catch (const std::exception& ex) {
+            return makeError(ex.what());
+        }
+    }
+
+    // Succeeds with an empty string when no session is active.
+    API_EXPORT ExpectedResult getActiveSessionId(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return makeError("Invalid manager pointer");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        try {
+            const std::string id = manager->getActiveSessionId();
+            char* id_str = new char[id.length() + 1];
+            safeCopyString(id_str, id.length() + 1, id.c_str());
+            return { true, id_str };
+        }
+        catch (const std::exception& ex) {
+            return makeError(ex.what());
+        }
+    }
+
+    API_EXPORT ExpectedResult selectSession(void* managerPtr, const char* id) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !id) return makeError("Invalid pointers");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        try {
+            manager->selectSession(id);
+            return makeVoidSuccess();
+        }
+        catch (const std::exception& ex) {
+            return makeError(ex.what());
+        }
+    }
+
+    API_EXPORT ExpectedResult followCurrentSession(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return makeError("Invalid manager pointer");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        try {
+            manager->followCurrentSession();
+            return makeVoidSuccess();
+        }
+        catch (const std::exception& ex) {
+            return makeError(ex.what());
         }
     }
 
+    API_EXPORT void setActiveSessionCallback(void* managerPtr, ActiveSessionCallback callback) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !callback) return;
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+
+        manager->onActiveSessionChanged([callback](std::string_view id) {
+            std::string id_copy(id);
+            callback(id_copy.c_str());
+            });
+    }
+
     API_EXPORT void setPlaybackCallback(void* managerPtr, PlaybackCallback callback) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr || !callback) return;
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -298,6 +1138,7 @@ extern "C" {
     }
 
     API_EXPORT void setTrackCallback(void* managerPtr, TrackChangedCallback callback) {
+        audio::TraceSpan trace("ffi", __func__);
         if (!managerPtr || !callback) return;
 
         auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
@@ -310,19 +1151,760 @@ extern "C" {
     }
 
     API_EXPORT void freeString(char* str) {
+        audio::TraceSpan trace("ffi", __func__);
         delete[] str;
     }
 
     API_EXPORT void freeInt64(int64_t* ptr) {
+        audio::TraceSpan trace("ffi", __func__);
         delete ptr;
     }
 
     API_EXPORT void freeDouble(double* ptr) {
+        audio::TraceSpan trace("ffi", __func__);
         delete ptr;
     }
 
     API_EXPORT void freeThumbnailData(uint8_t* buffer) {
+        audio::TraceSpan trace("ffi", __func__);
         delete[] buffer;
     }
 
+    // ---- V2 exports: see AudioResult. The exports above stay for existing callers. ----
+
+    // Empty when this thread has not failed a V2 call yet.
+    API_EXPORT AudioResult getLastErrorMessageV2(char* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!lastError)
+            return writeText({}, buffer, capacity);
+        try {
+            return writeText(lastError->message(), buffer, capacity);
+        }
+        catch (const std::exception&) {
+            return writeText(lastError->operation(), buffer, capacity);
+        }
+    }
+
+    // Structured form of the same error; needs no buffer and never allocates.
+    API_EXPORT AudioResult getLastErrorInfoV2(AudioErrorInfo* outInfo) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!outInfo) return statusResult(AUDIO_ERROR_INVALID_ARGUMENT);
+        if (!lastError)
+            return statusResult(AUDIO_ERROR_NOT_FOUND);
+        outInfo->category = static_cast<int32_t>(lastError->category());
+        outInfo->hresult = lastError->hresult();
+        outInfo->operation = lastError->operation();
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult initializeV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromVoid(static_cast<audio::AudioTrackManager*>(managerPtr)->initialize());
+    }
+
+    API_EXPORT AudioResult getDurationV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromDuration(static_cast<audio::AudioTrackManager*>(managerPtr)->getDuration());
+    }
+
+    API_EXPORT AudioResult getCurrentPositionV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromDuration(static_cast<audio::AudioTrackManager*>(managerPtr)->getCurrentPosition());
+    }
+
+    API_EXPORT AudioResult getCurrentPositionPreciseV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromDuration(static_cast<audio::AudioTrackManager*>(managerPtr)->getCurrentPositionPrecise());
+    }
+
+    API_EXPORT AudioResult getTitleV2(void* managerPtr, char* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromText(static_cast<audio::AudioTrackManager*>(managerPtr)->getTitle(), buffer, capacity);
+    }
+
+    API_EXPORT AudioResult getArtistV2(void* managerPtr, char* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromText(static_cast<audio::AudioTrackManager*>(managerPtr)->getArtist(), buffer, capacity);
+    }
+
+    API_EXPORT AudioResult getAlbumV2(void* managerPtr, char* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromText(static_cast<audio::AudioTrackManager*>(managerPtr)->getAlbum(), buffer, capacity);
+    }
+
+    // UTF-16 counterparts of the three above, for callers that keep text as UTF-16: on Windows
+    // the player's text is handed over as received, with no conversion either way.
+    API_EXPORT AudioResult getTitleUtf16V2(void* managerPtr, char16_t* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromUtf16(static_cast<audio::AudioTrackManager*>(managerPtr)->getTextUtf16(audio::MediaText::Title), buffer, capacity);
+    }
+
+    API_EXPORT AudioResult getArtistUtf16V2(void* managerPtr, char16_t* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromUtf16(static_cast<audio::AudioTrackManager*>(managerPtr)->getTextUtf16(audio::MediaText::Artist), buffer, capacity);
+    }
+
+    API_EXPORT AudioResult getAlbumUtf16V2(void* managerPtr, char16_t* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromUtf16(static_cast<audio::AudioTrackManager*>(managerPtr)->getTextUtf16(audio::MediaText::Album), buffer, capacity);
+    }
+
+    // Borrowed text: nothing to free and, once the text is pooled, nothing allocated or copied.
+    // Call releaseStringsV2 now and then (e.g. after each refresh) to let go of old tracks' text.
+    API_EXPORT AudioResult borrowTitleV2(void* managerPtr, AudioBorrowedText* outText) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outText) return invalidArgument("Check arguments");
+        return borrowedText(static_cast<audio::AudioTrackManager*>(managerPtr)->getTitleView(), outText);
+    }
+
+    API_EXPORT AudioResult borrowArtistV2(void* managerPtr, AudioBorrowedText* outText) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outText) return invalidArgument("Check arguments");
+        return borrowedText(static_cast<audio::AudioTrackManager*>(managerPtr)->getArtistView(), outText);
+    }
+
+    API_EXPORT AudioResult borrowAlbumV2(void* managerPtr, AudioBorrowedText* outText) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outText) return invalidArgument("Check arguments");
+        return borrowedText(static_cast<audio::AudioTrackManager*>(managerPtr)->getAlbumView(), outText);
+    }
+
+    API_EXPORT AudioResult releaseStringsV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        static_cast<audio::AudioTrackManager*>(managerPtr)->releaseStrings();
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult getStringPoolStatsV2(void* managerPtr, AudioStringPoolStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outStats) return invalidArgument("Check arguments");
+
+        const auto stats = static_cast<audio::AudioTrackManager*>(managerPtr)->getStringPoolStats();
+        outStats->strings = stats.strings;
+        outStats->bytes = stats.bytes;
+        outStats->hits = stats.hits;
+        outStats->misses = stats.misses;
+        outStats->reclaimed = stats.reclaimed;
+        outStats->epoch = stats.epoch;
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult getSnapshotV2(void* managerPtr, AudioTrackSnapshot* outSnapshot) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outSnapshot) return invalidArgument("Check arguments");
+
+        auto result = static_cast<audio::AudioTrackManager*>(managerPtr)->getTrackSnapshot();
+        if (!result)
+            return failure(result.error());
+        fillSnapshot(*result, outSnapshot);
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult getSnapshotUtf16V2(void* managerPtr, AudioTrackSnapshotUtf16* outSnapshot) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outSnapshot) return invalidArgument("Check arguments");
+
+        auto result = static_cast<audio::AudioTrackManager*>(managerPtr)->getTrackSnapshot();
+        if (!result)
+            return failure(result.error());
+        fillSnapshotUtf16(*result, outSnapshot);
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult playV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromVoid(static_cast<audio::AudioTrackManager*>(managerPtr)->play());
+    }
+
+    API_EXPORT AudioResult pauseV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromVoid(static_cast<audio::AudioTrackManager*>(managerPtr)->pause());
+    }
+
+    API_EXPORT AudioResult nextV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromVoid(static_cast<audio::AudioTrackManager*>(managerPtr)->next());
+    }
+
+    API_EXPORT AudioResult previousV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromVoid(static_cast<audio::AudioTrackManager*>(managerPtr)->previous());
+    }
+
+    API_EXPORT AudioResult seekV2(void* managerPtr, int64_t seconds) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromVoid(static_cast<audio::AudioTrackManager*>(managerPtr)->seek(std::chrono::seconds(seconds)));
+    }
+
+    API_EXPORT AudioResult setVolumeV2(void* managerPtr, double volume) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        return fromVoid(static_cast<audio::AudioTrackManager*>(managerPtr)->setVolume(volume));
+    }
+
+    API_EXPORT AudioResult getVolumeV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        auto result = static_cast<audio::AudioTrackManager*>(managerPtr)->getVolume();
+        return result ? doubleResult(*result) : failure(result.error());
+    }
+
+    // Copies the encoded artwork; acquireThumbnailV2 lends it without a copy.
+    API_EXPORT AudioResult getThumbnailBytesV2(void* managerPtr, uint8_t* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        auto result = static_cast<audio::AudioTrackManager*>(managerPtr)->getThumbnail();
+        if (!result)
+            return failure(result.error());
+        const auto& bytes = **result;
+        return writeBytes(bytes.data(), bytes.size(), buffer, capacity, false);
+    }
+
+    API_EXPORT AudioResult acquireThumbnailV2(void* managerPtr, const uint8_t** outData, uint64_t* outSize, void** outHandle) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outData || !outSize || !outHandle) return invalidArgument("Check arguments");
+
+        auto result = static_cast<audio::AudioTrackManager*>(managerPtr)->getThumbnail();
+        if (!result)
+            return failure(result.error());
+        try {
+            auto* handle = new audio::ThumbnailCache::Buffer(std::move(*result));
+            *outData = (*handle)->data();
+            *outSize = (*handle)->size();
+            *outHandle = handle;
+            return statusResult(AUDIO_OK);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Acquire thumbnail", ex));
+        }
+    }
+
+    API_EXPORT AudioResult setThumbnailCacheBudgetV2(void* managerPtr, uint64_t budgetBytes) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+        static_cast<audio::AudioTrackManager*>(managerPtr)->setThumbnailCacheBudget(static_cast<size_t>(budgetBytes));
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult getThumbnailCacheStatsV2(void* managerPtr, AudioThumbnailCacheStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outStats) return invalidArgument("Check arguments");
+
+        auto stats = static_cast<audio::AudioTrackManager*>(managerPtr)->getThumbnailCacheStats();
+        outStats->hits = stats.hits;
+        outStats->misses = stats.misses;
+        outStats->deduplicated = stats.deduplicated;
+        outStats->evictions = stats.evictions;
+        outStats->entries = stats.entries;
+        outStats->bytes = stats.bytes;
+        outStats->budgetBytes = stats.budgetBytes;
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult setThumbnailSizesV2(void* managerPtr, const uint32_t* sizes, uint64_t count) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || (!sizes && count != 0)) return invalidArgument("Check arguments");
+
+        try {
+            static_cast<audio::AudioTrackManager*>(managerPtr)->setThumbnailSizes(std::vector<uint32_t>(sizes, sizes + count));
+            return statusResult(AUDIO_OK);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Set thumbnail sizes", ex));
+        }
+    }
+
+    API_EXPORT AudioResult acquireThumbnailRgbaV2(void* managerPtr, uint32_t size, AudioRgbaImage* outImage, void** outHandle) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outImage || !outHandle) return invalidArgument("Check arguments");
+
+        auto result = static_cast<audio::AudioTrackManager*>(managerPtr)->getThumbnailRgba(size);
+        if (!result)
+            return failure(result.error());
+        try {
+            auto* handle = new audio::ThumbnailProcessor::Image(std::move(*result));
+            outImage->pixels = (*handle)->pixels.data();
+            outImage->width = (*handle)->width;
+            outImage->height = (*handle)->height;
+            *outHandle = handle;
+            return statusResult(AUDIO_OK);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Acquire scaled thumbnail", ex));
+        }
+    }
+
+    API_EXPORT AudioResult getCommandStatsV2(void* managerPtr, AudioCommandStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outStats) return invalidArgument("Check arguments");
+
+        auto stats = static_cast<audio::AudioTrackManager*>(managerPtr)->getCommandStats();
+        outStats->submitted = stats.submitted;
+        outStats->executed = stats.executed;
+        outStats->coalesced = stats.coalesced;
+        outStats->totalWaitMicros = stats.totalWait.count();
+        outStats->maxWaitMicros = stats.maxWait.count();
+        return statusResult(AUDIO_OK);
+    }
+
+    // Ids are joined with '\n', as in getSessionIds.
+    API_EXPORT AudioResult getSessionIdsV2(void* managerPtr, char* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        try {
+            std::string joined;
+            for (const auto& id : static_cast<audio::AudioTrackManager*>(managerPtr)->getSessionIds()) {
+                if (!joined.empty())
+                    joined += '\n';
+                joined += id;
+            }
+            return writeText(joined, buffer, capacity);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("List sessions", ex));
+        }
+    }
+
+    // Succeeds with an empty string when no session is active.
+    API_EXPORT AudioResult getActiveSessionIdV2(void* managerPtr, char* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        try {
+            return writeText(static_cast<audio::AudioTrackManager*>(managerPtr)->getActiveSessionId(), buffer, capacity);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Get active session", ex));
+        }
+    }
+
+    API_EXPORT AudioResult selectSessionV2(void* managerPtr, const char* id) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !id) return invalidArgument("Check arguments");
+
+        try {
+            static_cast<audio::AudioTrackManager*>(managerPtr)->selectSession(id);
+            return statusResult(AUDIO_OK);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Select session", ex));
+        }
+    }
+
+    API_EXPORT AudioResult followCurrentSessionV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        try {
+            static_cast<audio::AudioTrackManager*>(managerPtr)->followCurrentSession();
+            return statusResult(AUDIO_OK);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Follow current session", ex));
+        }
+    }
+
+    // Copies up to capacity queued events into buffer; value.size is the number written.
+    API_EXPORT AudioResult pollEventsV2(void* managerPtr, AudioEvent* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || (!buffer && capacity != 0)) return invalidArgument("Check arguments");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        audio::SessionEvent batch[64];
+        uint64_t written = 0;
+        while (written < capacity) {
+            const auto wanted = static_cast<size_t>(std::min<uint64_t>(capacity - written, std::size(batch)));
+            const size_t count = manager->pollEvents(std::span(batch, wanted));
+            for (size_t i = 0; i < count; ++i) {
+                AudioEvent& out = buffer[written + i];
+                out.kind = static_cast<int32_t>(batch[i].kind);
+                out.reserved = 0;
+                out.sequence = batch[i].sequence;
+                out.timestampMicros = batch[i].timestampMicros;
+            }
+            written += count;
+            if (count < wanted)
+                break;
+        }
+        AudioResult result{ AUDIO_OK, AUDIO_VALUE_SIZE, {} };
+        result.value.size = written;
+        return result;
+    }
+
+    // value.i64 is 1 when events are queued, 0 when the timeout passed first.
+    API_EXPORT AudioResult waitForEventsV2(void* managerPtr, int64_t timeoutMillis) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || timeoutMillis < 0) return invalidArgument("Check arguments");
+
+        try {
+            const bool ready = static_cast<audio::AudioTrackManager*>(managerPtr)->waitForEvents(std::chrono::milliseconds(timeoutMillis));
+            return int64Result(ready ? 1 : 0);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Wait for events", ex));
+        }
+    }
+
+    API_EXPORT AudioResult getEventQueueStatsV2(void* managerPtr, AudioEventQueueStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outStats) return invalidArgument("Check arguments");
+
+        auto stats = static_cast<audio::AudioTrackManager*>(managerPtr)->getEventQueueStats();
+        outStats->pushed = stats.pushed;
+        outStats->delivered = stats.delivered;
+        outStats->overflows = stats.overflows;
+        outStats->dropped = stats.dropped;
+        outStats->capacity = stats.capacity;
+        return statusResult(AUDIO_OK);
+    }
+
+
+    // A null callback removes the current one.
+    API_EXPORT AudioResult setPlaybackEventCallbackV2(void* managerPtr, PlaybackEventCallbackV2 callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        auto* manager = static_cast<audio::AudioTrackManager*>(managerPtr);
+        if (!callback) {
+            manager->onPlaybackChanged(nullptr);
+            return statusResult(AUDIO_OK);
+        }
+        manager->onPlaybackChangedT([callback, userData](const audio::PlaybackEvent& event) {
+            AudioPlaybackEvent out{};
+            fillPlaybackState(event.previous, &out.previous);
+            fillPlaybackState(event.current, &out.current);
+            out.changed = event.changed;
+            callback(userData, &out);
+            });
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult setPlaybackDebounceV2(void* managerPtr, int64_t windowMillis) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || windowMillis < 0) return invalidArgument("Check arguments");
+        static_cast<audio::AudioTrackManager*>(managerPtr)->setPlaybackDebounce(std::chrono::milliseconds(windowMillis));
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult getPlaybackEventStatsV2(void* managerPtr, AudioPlaybackEventStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outStats) return invalidArgument("Check arguments");
+
+        auto stats = static_cast<audio::AudioTrackManager*>(managerPtr)->getPlaybackEventStats();
+        outStats->received = stats.received;
+        outStats->delivered = stats.delivered;
+        outStats->collapsed = stats.collapsed;
+        outStats->cancelled = stats.cancelled;
+        return statusResult(AUDIO_OK);
+    }
+
+
+    API_EXPORT AudioResult getTrackChangeStatsV2(void* managerPtr, AudioTrackChangeStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outStats) return invalidArgument("Check arguments");
+
+        auto stats = static_cast<audio::AudioTrackManager*>(managerPtr)->getTrackChangeStats();
+        outStats->received = stats.received;
+        outStats->fetches = stats.fetches;
+        outStats->delivered = stats.delivered;
+        outStats->unchanged = stats.unchanged;
+        outStats->failures = stats.failures;
+        return statusResult(AUDIO_OK);
+    }
+
+
+    // value.i64 is the subscription id to pass to unsubscribeV2. Subscribers are independent of the
+    // single callbacks set with setPlaybackCallback and friends.
+    API_EXPORT AudioResult subscribeV2(void* managerPtr, int32_t kind, NotificationCallbackV2 callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !callback) return invalidArgument("Check arguments");
+
+        try {
+            auto id = static_cast<audio::AudioTrackManager*>(managerPtr)->subscribe(static_cast<audio::SessionEvent::Kind>(kind),
+                [callback, userData](const audio::SessionNotification& notification) {
+                    deliverNotification(callback, userData, notification);
+                });
+            if (id == 0)
+                return invalidArgument("Check event kind");
+            return int64Result(static_cast<int64_t>(id));
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Subscribe", ex));
+        }
+    }
+
+    // Once it succeeds the callback is not running and will not run again, so userData may be
+    // freed; called from inside that callback, it cannot wait for itself and returns at once.
+    API_EXPORT AudioResult unsubscribeV2(void* managerPtr, uint64_t subscriptionId) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        try {
+            if (!static_cast<audio::AudioTrackManager*>(managerPtr)->unsubscribe(subscriptionId))
+                return failure(audio::AudioError(audio::ErrorCategory::NotFound, "Unsubscribe"));
+            return statusResult(AUDIO_OK);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Unsubscribe", ex));
+        }
+    }
+
+    // value.i64 is the subscription id to pass to unsubscribePositionV2. The first tick comes
+    // at once; later ones every intervalMillis of playback, and none while paused or stopped.
+    API_EXPORT AudioResult subscribePositionV2(void* managerPtr, int64_t intervalMillis, PositionCallbackV2 callback, void* userData) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !callback) return invalidArgument("Check arguments");
+
+        try {
+            auto id = static_cast<audio::AudioTrackManager*>(managerPtr)->subscribePosition(std::chrono::milliseconds(intervalMillis),
+                [callback, userData](const audio::PositionTicker::Tick& tick) {
+                    AudioPositionTick out{};
+                    out.positionMillis = tick.position.count();
+                    out.durationMillis = tick.duration.count();
+                    out.status = static_cast<int32_t>(tick.status);
+                    callback(userData, &out);
+                });
+            if (id == 0)
+                return invalidArgument("Check interval");
+            return int64Result(static_cast<int64_t>(id));
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Subscribe position", ex));
+        }
+    }
+
+    // NotFound for an id another manager handed out. Once it succeeds no tick is under way or
+    // still to come, so userData may be freed, unless it is called from the position callback.
+    API_EXPORT AudioResult unsubscribePositionV2(void* managerPtr, uint64_t subscriptionId) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        if (!static_cast<audio::AudioTrackManager*>(managerPtr)->unsubscribePosition(subscriptionId))
+            return failure(audio::AudioError(audio::ErrorCategory::NotFound, "Unsubscribe position"));
+        return statusResult(AUDIO_OK);
+    }
+
+    // Process-wide: every manager's position subscribers share the one ticker.
+    API_EXPORT AudioResult getPositionTickerStatsV2(AudioPositionTickerStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!outStats) return invalidArgument("Check arguments");
+
+        const auto stats = audio::PositionTicker::shared().stats();
+        outStats->sources = stats.sources;
+        outStats->subscribers = stats.subscribers;
+        outStats->parked = stats.parked;
+        outStats->ticks = stats.ticks;
+        outStats->samples = stats.samples;
+        outStats->sampleFailures = stats.sampleFailures;
+        outStats->turns = stats.turns;
+        return statusResult(AUDIO_OK);
+    }
+
+    // Stores the address of the manager's audio::StateBlock::Layout in outBlock; value.size is
+    // its size. The block stays at that address until destroyAudioManager and is only ever
+    // read: copy it, and keep the copy if sequence was even and the same before and after.
+    API_EXPORT AudioResult getStateBlockV2(void* managerPtr, const void** outBlock) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outBlock) return invalidArgument("Check arguments");
+
+        *outBlock = static_cast<audio::AudioTrackManager*>(managerPtr)->getStateBlock().layout();
+        AudioResult result{ AUDIO_OK, AUDIO_VALUE_SIZE, {} };
+        result.value.size = sizeof(audio::StateBlock::Layout);
+        return result;
+    }
+
+
+#ifdef AUDIO_ENABLE_SIMULATION
+    // A manager backed by SimulatedAudioSession instead of the platform, for benchmarks and for
+    // running without a media player. A null profile costs nothing per call and raises no events.
+    // Release it with destroyAudioManager. Only exported from builds that define
+    // AUDIO_ENABLE_SIMULATION; release builds leave it out.
+    API_EXPORT AudioResult createSimulatedAudioManagerV2(const AudioSimulationProfile* profile, void** outManager) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!outManager) return invalidArgument("Check arguments");
+        *outManager = nullptr;
+
+        audio::platform::SimulationProfile simulation;
+        if (profile) {
+            if (profile->eventRate < 0.0) return invalidArgument("Check arguments");
+            for (size_t i = 0; i < audio::platform::SimulatedOperationCount; ++i) {
+                if (profile->latencyMicros[i] < 0 || profile->jitterMicros[i] < 0) return invalidArgument("Check arguments");
+                simulation.latency[i].base = std::chrono::microseconds(profile->latencyMicros[i]);
+                simulation.latency[i].jitter = std::chrono::microseconds(profile->jitterMicros[i]);
+            }
+            simulation.eventRate = profile->eventRate;
+            simulation.thumbnailBytes = static_cast<size_t>(profile->thumbnailBytes);
+            simulation.seed = profile->seed;
+        }
+        try {
+            *outManager = new audio::AudioTrackManager(std::make_shared<audio::platform::SimulatedAudioSession>(simulation));
+            return statusResult(AUDIO_OK);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Create simulated manager", ex));
+        }
+    }
+#endif
+
+    API_EXPORT AudioResult getStatsV2(void* managerPtr, AudioStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outStats) return invalidArgument("Check arguments");
+
+        auto stats = static_cast<audio::AudioTrackManager*>(managerPtr)->getStats();
+        for (size_t i = 0; i < STAT_OPERATION_COUNT; ++i) {
+            const auto& operation = stats.operations[i];
+            auto& out = outStats->operations[i];
+            out.calls = operation.calls;
+            out.errors = operation.errors;
+            out.totalNanos = operation.total.count();
+            out.maxNanos = operation.max.count();
+            out.p50Nanos = operation.percentile(0.50).count();
+            out.p90Nanos = operation.percentile(0.90).count();
+            out.p99Nanos = operation.percentile(0.99).count();
+            out.p999Nanos = operation.percentile(0.999).count();
+        }
+        outStats->cacheHits = stats.cacheHits;
+        outStats->cacheMisses = stats.cacheMisses;
+        for (size_t kind = 0; kind < stats.events.size(); ++kind)
+            outStats->events[kind] = stats.events[kind];
+        outStats->elapsedNanos = stats.elapsed.count();
+        return statusResult(AUDIO_OK);
+    }
+
+    // Span tracing, see audio::Tracer. Process-wide, so neither takes a manager.
+    API_EXPORT AudioResult startTraceV2(const char* path) {
+        if (!path) return invalidArgument("Check arguments");
+
+        auto started = audio::Tracer::start(path);
+        if (!started) return failure(started.error());
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult stopTraceV2() {
+        audio::Tracer::stop();
+        return statusResult(AUDIO_OK);
+    }
+
+    // Playback history, see audio::HistoryJournal. The queries read the journal file directly,
+    // so they work with or without a manager, and while one is writing to it.
+    API_EXPORT AudioResult enableHistoryV2(void* managerPtr, const char* path) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !path) return invalidArgument("Check arguments");
+
+        try {
+            auto enabled = static_cast<audio::AudioTrackManager*>(managerPtr)->enableHistory(utf8Path(path));
+            if (!enabled) return failure(enabled.error());
+            return statusResult(AUDIO_OK);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Enable history", ex));
+        }
+    }
+
+    API_EXPORT AudioResult disableHistoryV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        static_cast<audio::AudioTrackManager*>(managerPtr)->disableHistory();
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult flushHistoryV2(void* managerPtr) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr) return invalidArgument("Check manager pointer");
+
+        auto flushed = static_cast<audio::AudioTrackManager*>(managerPtr)->flushHistory();
+        if (!flushed) return failure(flushed.error());
+        return statusResult(AUDIO_OK);
+    }
+
+    API_EXPORT AudioResult getHistoryStatsV2(void* managerPtr, AudioHistoryStats* outStats) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!managerPtr || !outStats) return invalidArgument("Check arguments");
+
+        const auto stats = static_cast<audio::AudioTrackManager*>(managerPtr)->getHistoryStats();
+        outStats->appended = stats.appended;
+        outStats->committed = stats.committed;
+        outStats->commits = stats.commits;
+        outStats->failures = stats.failures;
+        outStats->recovered = stats.recovered;
+        outStats->truncatedBytes = stats.truncatedBytes;
+        return statusResult(AUDIO_OK);
+    }
+
+    // Fills buffer with up to capacity plays, newest first; value.size is the number written.
+    API_EXPORT AudioResult getRecentlyPlayedV2(const char* path, AudioHistoryRecord* buffer, uint64_t capacity) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!path || (!buffer && capacity != 0)) return invalidArgument("Check arguments");
+
+        try {
+            auto reader = audio::HistoryReader::open(utf8Path(path));
+            if (!reader) return failure(reader.error());
+            const auto records = reader->records();
+            const auto count = std::min<uint64_t>(capacity, records.size());
+            for (uint64_t i = 0; i < count; ++i) {
+                const auto& record = records[records.size() - 1 - i];
+                AudioHistoryRecord& out = buffer[i];
+                out.startedMicros = record.startedMicros;
+                out.trackId = record.trackId;
+                out.playedMillis = record.playedMillis;
+                out.durationSeconds = record.durationSeconds;
+                out.outcome = static_cast<int32_t>(record.outcome);
+                out.reserved = 0;
+            }
+            AudioResult result{ AUDIO_OK, AUDIO_VALUE_SIZE, {} };
+            result.value.size = count;
+            return result;
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Read history", ex));
+        }
+    }
+
+    API_EXPORT AudioResult getPlayCountV2(const char* path, uint64_t trackId, AudioPlayCount* outCount) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!path || !outCount) return invalidArgument("Check arguments");
+
+        try {
+            auto reader = audio::HistoryReader::open(utf8Path(path));
+            if (!reader) return failure(reader.error());
+            const auto count = reader->playCount(trackId);
+            outCount->plays = count.plays;
+            outCount->completed = count.completed;
+            outCount->playedMillis = count.played.count();
+            return statusResult(AUDIO_OK);
+        }
+        catch (const std::exception& ex) {
+            return failure(audio::AudioError::fromException("Read history", ex));
+        }
+    }
+
+    // The id the journal records for a track, to look up its play count. Strings are UTF-8.
+    API_EXPORT AudioResult getTrackIdV2(const char* title, const char* artist, const char* album, int64_t durationSeconds) {
+        audio::TraceSpan trace("ffi", __func__);
+        if (!title || !artist || !album) return invalidArgument("Check arguments");
+
+        const auto id = audio::HistoryJournal::trackId(title, artist, album, std::chrono::seconds(durationSeconds));
+        return int64Result(static_cast<int64_t>(id));
+    }
 }
\ No newline at end of file
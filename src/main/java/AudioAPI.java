@@ -1,7 +1,18 @@
 
 import java.lang.foreign.*;
 import java.lang.invoke.*;
+import java.nio.charset.StandardCharsets;
 import java.time.Duration;
+import java.time.Instant;
+import java.util.ArrayList;
+import java.util.EnumMap;
+import java.util.EnumSet;
+import java.util.List;
+import java.util.Optional;
+import java.util.Set;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.atomic.AtomicLong;
 import java.util.function.BiConsumer;
 import java.util.function.Consumer;
 
@@ -14,6 +25,7 @@ public class AudioAPI {
     private static final MethodHandle INITIALIZE;
     private static final MethodHandle GET_DURATION;
     private static final MethodHandle GET_CURRENT_POSITION;
+    private static final MethodHandle GET_CURRENT_POSITION_PRECISE;
     private static final MethodHandle GET_TITLE;
     private static final MethodHandle GET_ARTIST;
     private static final MethodHandle GET_ALBUM;
@@ -26,12 +38,265 @@ public class AudioAPI {
     private static final MethodHandle GET_VOLUME;
     private static final MethodHandle SET_PLAYBACK_CALLBACK;
     private static final MethodHandle SET_TRACK_CALLBACK;
-    private static final MethodHandle GET_THUMBNAIL_BYTES;
+    private static final MethodHandle SET_PLAYBACK_EVENT_CALLBACK;
+    private static final MethodHandle SET_PLAYBACK_DEBOUNCE;
+    private static final MethodHandle GET_PLAYBACK_EVENT_STATS;
+    private static final MethodHandle GET_TRACK_CHANGE_STATS;
+    private static final MethodHandle SUBSCRIBE;
+    private static final MethodHandle UNSUBSCRIBE;
+    private static final MethodHandle SUBSCRIBE_POSITION;
+    private static final MethodHandle UNSUBSCRIBE_POSITION;
+    private static final MethodHandle GET_POSITION_TICKER_STATS;
+    private static final MethodHandle GET_STATE_BLOCK;
+    private static final MethodHandle ACQUIRE_THUMBNAIL;
+    private static final MethodHandle RELEASE_THUMBNAIL;
+    private static final MethodHandle SET_THUMBNAIL_CACHE_BUDGET;
+    private static final MethodHandle GET_THUMBNAIL_CACHE_STATS;
+    private static final MethodHandle SET_THUMBNAIL_SIZES;
+    private static final MethodHandle ACQUIRE_THUMBNAIL_RGBA;
+    private static final MethodHandle RELEASE_THUMBNAIL_RGBA;
+    private static final MethodHandle GET_SNAPSHOT;
+    private static final MethodHandle INITIALIZE_ASYNC;
+    private static final MethodHandle PLAY_ASYNC;
+    private static final MethodHandle PAUSE_ASYNC;
+    private static final MethodHandle NEXT_ASYNC;
+    private static final MethodHandle PREVIOUS_ASYNC;
+    private static final MethodHandle SEEK_ASYNC;
+    private static final MethodHandle SET_VOLUME_ASYNC;
+    private static final MethodHandle GET_VOLUME_ASYNC;
+    private static final MethodHandle GET_SNAPSHOT_ASYNC;
+    private static final MethodHandle GET_COMMAND_STATS;
+    private static final MethodHandle GET_SESSION_IDS;
+    private static final MethodHandle GET_ACTIVE_SESSION_ID;
+    private static final MethodHandle SELECT_SESSION;
+    private static final MethodHandle FOLLOW_CURRENT_SESSION;
+    private static final MethodHandle SET_ACTIVE_SESSION_CALLBACK;
+    private static final MethodHandle GET_LAST_ERROR_MESSAGE;
+    private static final MethodHandle GET_LAST_ERROR_INFO;
+    private static final MethodHandle POLL_EVENTS;
+    private static final MethodHandle WAIT_FOR_EVENTS;
+    private static final MethodHandle GET_EVENT_QUEUE_STATS;
+    private static final MethodHandle GET_STATS;
+    private static final MethodHandle START_TRACE;
+    private static final MethodHandle STOP_TRACE;
+    private static final MethodHandle ENABLE_HISTORY;
+    private static final MethodHandle DISABLE_HISTORY;
+    private static final MethodHandle FLUSH_HISTORY;
+    private static final MethodHandle GET_HISTORY_STATS;
+    private static final MethodHandle GET_RECENTLY_PLAYED;
+    private static final MethodHandle GET_PLAY_COUNT;
+    private static final MethodHandle GET_TRACK_ID;
+
+    private static final long SNAPSHOT_TEXT_CAPACITY = 512;
+
+    // Strings start in a buffer of this size and are fetched again only when they do not fit.
+    private static final long INITIAL_TEXT_CAPACITY = 256;
+
+    private static final int STATUS_OK = 0;
+    private static final int STATUS_BUFFER_TOO_SMALL = 4;
+
+    /**
+     * Returned by value from every V2 export: a status code, the kind of the inline value and the
+     * value itself (int64, double, or a byte length).
+     */
+    private static final MemoryLayout AUDIO_RESULT_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_INT.withName("status"),
+            ValueLayout.JAVA_INT.withName("kind"),
+            ValueLayout.JAVA_LONG.withName("value")
+    );
+
+    /**
+     * Structured form of the last V2 failure on the calling thread; operation points at a static
+     * native string.
+     */
+    private static final MemoryLayout ERROR_INFO_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_INT.withName("category"),
+            ValueLayout.JAVA_INT.withName("hresult"),
+            ValueLayout.ADDRESS.withName("operation")
+    );
+
+    private static final MemoryLayout TRACK_SNAPSHOT_LAYOUT = MemoryLayout.structLayout(
+            MemoryLayout.sequenceLayout(SNAPSHOT_TEXT_CAPACITY, ValueLayout.JAVA_BYTE).withName("title"),
+            MemoryLayout.sequenceLayout(SNAPSHOT_TEXT_CAPACITY, ValueLayout.JAVA_BYTE).withName("artist"),
+            MemoryLayout.sequenceLayout(SNAPSHOT_TEXT_CAPACITY, ValueLayout.JAVA_BYTE).withName("album"),
+            MemoryLayout.sequenceLayout(SNAPSHOT_TEXT_CAPACITY, ValueLayout.JAVA_BYTE).withName("albumArtist"),
+            ValueLayout.JAVA_INT.withName("trackNumber"),
+            ValueLayout.JAVA_INT.withName("playbackStatus"),
+            ValueLayout.JAVA_LONG.withName("durationSeconds"),
+            ValueLayout.JAVA_LONG.withName("positionSeconds"),
+            ValueLayout.JAVA_LONG.withName("thumbnailHandle")
+    );
+
+    // The text comes as UTF-16 code units with their lengths, so Java strings are built from it
+    // without decoding.
+    private static final MemoryLayout TRACK_SNAPSHOT_UTF16_LAYOUT = MemoryLayout.structLayout(
+            MemoryLayout.sequenceLayout(SNAPSHOT_TEXT_CAPACITY, ValueLayout.JAVA_CHAR).withName("title"),
+            MemoryLayout.sequenceLayout(SNAPSHOT_TEXT_CAPACITY, ValueLayout.JAVA_CHAR).withName("artist"),
+            MemoryLayout.sequenceLayout(SNAPSHOT_TEXT_CAPACITY, ValueLayout.JAVA_CHAR).withName("album"),
+            MemoryLayout.sequenceLayout(SNAPSHOT_TEXT_CAPACITY, ValueLayout.JAVA_CHAR).withName("albumArtist"),
+            ValueLayout.JAVA_INT.withName("titleLength"),
+            ValueLayout.JAVA_INT.withName("artistLength"),
+            ValueLayout.JAVA_INT.withName("albumLength"),
+            ValueLayout.JAVA_INT.withName("albumArtistLength"),
+            ValueLayout.JAVA_INT.withName("trackNumber"),
+            ValueLayout.JAVA_INT.withName("playbackStatus"),
+            ValueLayout.JAVA_LONG.withName("durationSeconds"),
+            ValueLayout.JAVA_LONG.withName("positionSeconds"),
+            ValueLayout.JAVA_LONG.withName("thumbnailHandle")
+    );
+
+    private static final MemoryLayout THUMBNAIL_CACHE_STATS_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("hits"),
+            ValueLayout.JAVA_LONG.withName("misses"),
+            ValueLayout.JAVA_LONG.withName("deduplicated"),
+            ValueLayout.JAVA_LONG.withName("evictions"),
+            ValueLayout.JAVA_LONG.withName("entries"),
+            ValueLayout.JAVA_LONG.withName("bytes"),
+            ValueLayout.JAVA_LONG.withName("budgetBytes")
+    );
+
+    private static final MemoryLayout RGBA_IMAGE_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.ADDRESS.withName("pixels"),
+            ValueLayout.JAVA_INT.withName("width"),
+            ValueLayout.JAVA_INT.withName("height")
+    );
+
+    private static final MemoryLayout COMMAND_STATS_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("submitted"),
+            ValueLayout.JAVA_LONG.withName("executed"),
+            ValueLayout.JAVA_LONG.withName("coalesced"),
+            ValueLayout.JAVA_LONG.withName("totalWaitMicros"),
+            ValueLayout.JAVA_LONG.withName("maxWaitMicros")
+    );
+
+    private static final MemoryLayout EVENT_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_INT.withName("kind"),
+            ValueLayout.JAVA_INT.withName("reserved"),
+            ValueLayout.JAVA_LONG.withName("sequence"),
+            ValueLayout.JAVA_LONG.withName("timestampMicros")
+    );
+
+    private static final MemoryLayout EVENT_QUEUE_STATS_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("pushed"),
+            ValueLayout.JAVA_LONG.withName("delivered"),
+            ValueLayout.JAVA_LONG.withName("overflows"),
+            ValueLayout.JAVA_LONG.withName("dropped"),
+            ValueLayout.JAVA_LONG.withName("capacity")
+    );
+
+    private static final MemoryLayout OPERATION_STATS_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("calls"),
+            ValueLayout.JAVA_LONG.withName("errors"),
+            ValueLayout.JAVA_LONG.withName("totalNanos"),
+            ValueLayout.JAVA_LONG.withName("maxNanos"),
+            ValueLayout.JAVA_LONG.withName("p50Nanos"),
+            ValueLayout.JAVA_LONG.withName("p90Nanos"),
+            ValueLayout.JAVA_LONG.withName("p99Nanos"),
+            ValueLayout.JAVA_LONG.withName("p999Nanos")
+    );
+
+    /**
+     * operations follows the order of {@link Operation}; events is indexed by native event kind,
+     * slot 0 unused.
+     */
+    private static final MemoryLayout STATS_LAYOUT = MemoryLayout.structLayout(
+            MemoryLayout.sequenceLayout(Operation.values().length, OPERATION_STATS_LAYOUT).withName("operations"),
+            ValueLayout.JAVA_LONG.withName("cacheHits"),
+            ValueLayout.JAVA_LONG.withName("cacheMisses"),
+            MemoryLayout.sequenceLayout(4, ValueLayout.JAVA_LONG).withName("events"),
+            ValueLayout.JAVA_LONG.withName("elapsedNanos")
+    );
+
+    private static final MemoryLayout HISTORY_STATS_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("appended"),
+            ValueLayout.JAVA_LONG.withName("committed"),
+            ValueLayout.JAVA_LONG.withName("commits"),
+            ValueLayout.JAVA_LONG.withName("failures"),
+            ValueLayout.JAVA_LONG.withName("recovered"),
+            ValueLayout.JAVA_LONG.withName("truncatedBytes")
+    );
+
+    private static final MemoryLayout HISTORY_RECORD_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("startedMicros"),
+            ValueLayout.JAVA_LONG.withName("trackId"),
+            ValueLayout.JAVA_INT.withName("playedMillis"),
+            ValueLayout.JAVA_INT.withName("durationSeconds"),
+            ValueLayout.JAVA_INT.withName("outcome"),
+            ValueLayout.JAVA_INT.withName("reserved")
+    );
+
+    private static final MemoryLayout PLAY_COUNT_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("plays"),
+            ValueLayout.JAVA_LONG.withName("completed"),
+            ValueLayout.JAVA_LONG.withName("playedMillis")
+    );
+
+    private static final MemoryLayout PLAYBACK_STATE_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_INT.withName("status"),
+            ValueLayout.JAVA_INT.withName("repeat"),
+            ValueLayout.JAVA_DOUBLE.withName("rate"),
+            ValueLayout.JAVA_INT.withName("shuffle"),
+            ValueLayout.JAVA_INT.withName("controls")
+    );
+
+    private static final MemoryLayout PLAYBACK_EVENT_LAYOUT = MemoryLayout.structLayout(
+            PLAYBACK_STATE_LAYOUT.withName("previous"),
+            PLAYBACK_STATE_LAYOUT.withName("current"),
+            ValueLayout.JAVA_INT.withName("changed"),
+            ValueLayout.JAVA_INT.withName("reserved")
+    );
+
+    private static final MemoryLayout PLAYBACK_EVENT_STATS_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("received"),
+            ValueLayout.JAVA_LONG.withName("delivered"),
+            ValueLayout.JAVA_LONG.withName("collapsed"),
+            ValueLayout.JAVA_LONG.withName("cancelled")
+    );
+
+    private static final MemoryLayout TRACK_CHANGE_STATS_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("received"),
+            ValueLayout.JAVA_LONG.withName("fetches"),
+            ValueLayout.JAVA_LONG.withName("delivered"),
+            ValueLayout.JAVA_LONG.withName("unchanged"),
+            ValueLayout.JAVA_LONG.withName("failures")
+    );
+
+    private static final MemoryLayout NOTIFICATION_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_INT.withName("kind"),
+            ValueLayout.JAVA_INT.withName("reserved"),
+            ValueLayout.ADDRESS.withName("playback"),
+            ValueLayout.ADDRESS.withName("title"),
+            ValueLayout.ADDRESS.withName("artist"),
+            ValueLayout.ADDRESS.withName("sessionId")
+    );
+
+    private static final MemoryLayout POSITION_TICK_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("positionMillis"),
+            ValueLayout.JAVA_LONG.withName("durationMillis"),
+            ValueLayout.JAVA_INT.withName("status"),
+            ValueLayout.JAVA_INT.withName("reserved")
+    );
 
-    private static final MemoryLayout EXPECTED_RESULT_LAYOUT = MemoryLayout.structLayout(
-            ValueLayout.JAVA_BOOLEAN.withName("has_value"),
-            MemoryLayout.paddingLayout(7),
-            ValueLayout.ADDRESS.withName("value_or_error")
+    // Offsets into the native StateBlock::Layout; see StateBlock.hpp.
+    private static final int STATE_MAGIC = 0x4F535442;
+    private static final long STATE_VERSION_OFFSET = 4;
+    private static final long STATE_SEQUENCE_OFFSET = 8;
+    private static final long STATE_TEXT_RANGES_OFFSET = 72;
+    private static final long STATE_TEXT_OFFSET = 96;
+    private static final long STATE_TEXT_CAPACITY = 1536;
+    private static final int STATE_HAS_SESSION = 1;
+    private static final int STATE_MUTED = 2;
+    // Takes the block and a byte offset.
+    private static final VarHandle STATE_LONG = ValueLayout.JAVA_LONG.varHandle();
+
+    private static final MemoryLayout POSITION_TICKER_STATS_LAYOUT = MemoryLayout.structLayout(
+            ValueLayout.JAVA_LONG.withName("sources"),
+            ValueLayout.JAVA_LONG.withName("subscribers"),
+            ValueLayout.JAVA_LONG.withName("parked"),
+            ValueLayout.JAVA_LONG.withName("ticks"),
+            ValueLayout.JAVA_LONG.withName("samples"),
+            ValueLayout.JAVA_LONG.withName("sampleFailures"),
+            ValueLayout.JAVA_LONG.withName("turns")
     );
 
     static {
@@ -46,58 +311,196 @@ public class AudioAPI {
         DESTROY_AUDIO_MANAGER = linkerFunction("destroyAudioManager",
                 FunctionDescriptor.ofVoid(ValueLayout.ADDRESS));
 
-        INITIALIZE = linkerFunction("initialize",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        INITIALIZE = linkerFunction("initializeV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
+
+        GET_DURATION = linkerFunction("getDurationV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
 
-        GET_DURATION = linkerFunction("getDuration",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        GET_CURRENT_POSITION = linkerFunction("getCurrentPositionV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
 
-        GET_CURRENT_POSITION = linkerFunction("getCurrentPosition",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        GET_CURRENT_POSITION_PRECISE = linkerFunction("getCurrentPositionPreciseV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
 
-        GET_TITLE = linkerFunction("getTitle",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        GET_TITLE = linkerFunction("getTitleUtf16V2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
 
-        GET_ARTIST = linkerFunction("getArtist",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        GET_ARTIST = linkerFunction("getArtistUtf16V2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
 
-        GET_ALBUM = linkerFunction("getAlbum",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        GET_ALBUM = linkerFunction("getAlbumUtf16V2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
 
-        PLAY = linkerFunction("play",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        PLAY = linkerFunction("playV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
 
-        PAUSE = linkerFunction("pause",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        PAUSE = linkerFunction("pauseV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
 
-        NEXT = linkerFunction("next",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        NEXT = linkerFunction("nextV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
 
-        PREVIOUS = linkerFunction("previous",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        PREVIOUS = linkerFunction("previousV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
 
-        SEEK = linkerFunction("seek",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+        SEEK = linkerFunction("seekV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
 
-        SET_VOLUME = linkerFunction("setVolume",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_DOUBLE));
+        SET_VOLUME = linkerFunction("setVolumeV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_DOUBLE));
 
-        GET_VOLUME = linkerFunction("getVolume",
-                FunctionDescriptor.of(EXPECTED_RESULT_LAYOUT, ValueLayout.ADDRESS));
+        GET_VOLUME = linkerFunction("getVolumeV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
 
         SET_PLAYBACK_CALLBACK = linkerFunction("setPlaybackCallback",
                 FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.ADDRESS));
 
         SET_TRACK_CALLBACK = linkerFunction("setTrackCallback",
                 FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.ADDRESS));
-        GET_THUMBNAIL_BYTES = linkerFunction("getThumbnailBytes",
+        ACQUIRE_THUMBNAIL = linkerFunction("acquireThumbnailV2",
+                FunctionDescriptor.of(
+                        AUDIO_RESULT_LAYOUT,
+                        ValueLayout.ADDRESS,
+                        ValueLayout.ADDRESS,
+                        ValueLayout.ADDRESS,
+                        ValueLayout.ADDRESS
+                ));
+
+        RELEASE_THUMBNAIL = linkerFunction("releaseThumbnail",
+                FunctionDescriptor.ofVoid(ValueLayout.ADDRESS));
+
+        SET_THUMBNAIL_CACHE_BUDGET = linkerFunction("setThumbnailCacheBudgetV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        GET_THUMBNAIL_CACHE_STATS = linkerFunction("getThumbnailCacheStatsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        SET_THUMBNAIL_SIZES = linkerFunction("setThumbnailSizesV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        ACQUIRE_THUMBNAIL_RGBA = linkerFunction("acquireThumbnailRgbaV2",
                 FunctionDescriptor.of(
-                        EXPECTED_RESULT_LAYOUT,
+                        AUDIO_RESULT_LAYOUT,
                         ValueLayout.ADDRESS,
+                        ValueLayout.JAVA_INT,
                         ValueLayout.ADDRESS,
                         ValueLayout.ADDRESS
                 ));
 
+        RELEASE_THUMBNAIL_RGBA = linkerFunction("releaseThumbnailRgba",
+                FunctionDescriptor.ofVoid(ValueLayout.ADDRESS));
+
+        GET_SNAPSHOT = linkerFunction("getSnapshotUtf16V2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        final var asyncDescriptor = FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.ADDRESS);
+        INITIALIZE_ASYNC = linkerFunction("initializeAsync", asyncDescriptor);
+        PLAY_ASYNC = linkerFunction("playAsync", asyncDescriptor);
+        PAUSE_ASYNC = linkerFunction("pauseAsync", asyncDescriptor);
+        NEXT_ASYNC = linkerFunction("nextAsync", asyncDescriptor);
+        PREVIOUS_ASYNC = linkerFunction("previousAsync", asyncDescriptor);
+        GET_VOLUME_ASYNC = linkerFunction("getVolumeAsync", asyncDescriptor);
+        GET_SNAPSHOT_ASYNC = linkerFunction("getSnapshotAsync", asyncDescriptor);
+
+        GET_COMMAND_STATS = linkerFunction("getCommandStatsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        GET_SESSION_IDS = linkerFunction("getSessionIdsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        GET_ACTIVE_SESSION_ID = linkerFunction("getActiveSessionIdV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        SELECT_SESSION = linkerFunction("selectSessionV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        FOLLOW_CURRENT_SESSION = linkerFunction("followCurrentSessionV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
+
+        SET_ACTIVE_SESSION_CALLBACK = linkerFunction("setActiveSessionCallback",
+                FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        GET_LAST_ERROR_MESSAGE = linkerFunction("getLastErrorMessageV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        GET_LAST_ERROR_INFO = linkerFunction("getLastErrorInfoV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
+
+        POLL_EVENTS = linkerFunction("pollEventsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        WAIT_FOR_EVENTS = linkerFunction("waitForEventsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        GET_EVENT_QUEUE_STATS = linkerFunction("getEventQueueStatsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        GET_STATS = linkerFunction("getStatsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        START_TRACE = linkerFunction("startTraceV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
+
+        STOP_TRACE = linkerFunction("stopTraceV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT));
+
+        ENABLE_HISTORY = linkerFunction("enableHistoryV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        DISABLE_HISTORY = linkerFunction("disableHistoryV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
+
+        FLUSH_HISTORY = linkerFunction("flushHistoryV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
+
+        GET_HISTORY_STATS = linkerFunction("getHistoryStatsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        GET_RECENTLY_PLAYED = linkerFunction("getRecentlyPlayedV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        GET_PLAY_COUNT = linkerFunction("getPlayCountV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG, ValueLayout.ADDRESS));
+
+        GET_TRACK_ID = linkerFunction("getTrackIdV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        SET_PLAYBACK_EVENT_CALLBACK = linkerFunction("setPlaybackEventCallbackV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        SET_PLAYBACK_DEBOUNCE = linkerFunction("setPlaybackDebounceV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        GET_PLAYBACK_EVENT_STATS = linkerFunction("getPlaybackEventStatsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        GET_TRACK_CHANGE_STATS = linkerFunction("getTrackChangeStatsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        SUBSCRIBE = linkerFunction("subscribeV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_INT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        UNSUBSCRIBE = linkerFunction("unsubscribeV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        SUBSCRIBE_POSITION = linkerFunction("subscribePositionV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        UNSUBSCRIBE_POSITION = linkerFunction("unsubscribePositionV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.JAVA_LONG));
+
+        GET_POSITION_TICKER_STATS = linkerFunction("getPositionTickerStatsV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS));
+
+        GET_STATE_BLOCK = linkerFunction("getStateBlockV2",
+                FunctionDescriptor.of(AUDIO_RESULT_LAYOUT, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        SEEK_ASYNC = linkerFunction("seekAsync",
+                FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.JAVA_LONG, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        SET_VOLUME_ASYNC = linkerFunction("setVolumeAsync",
+                FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.JAVA_DOUBLE, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
     }
 
     private static MethodHandle linkerFunction(String name, FunctionDescriptor descriptor) {
@@ -106,6 +509,128 @@ public class AudioAPI {
                 descriptor);
     }
 
+    /**
+     * Starts writing a Chrome trace-event file of every native call, event dispatch and cache
+     * fill, for chrome://tracing or Perfetto. Tracing is process-wide; it can also be started by
+     * setting AUDIO_TRACE_FILE before the first manager is created.
+     */
+    public static void startTrace(String path) throws AudioException {
+        try (final var arena = Arena.ofConfined()) {
+            final var nativePath = arena.allocateFrom(path);
+            final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+            final var result = (MemorySegment) START_TRACE.invokeExact(allocator, nativePath);
+            AudioManager.check(result);
+        } catch (AudioException e) {
+            throw e;
+        } catch (Throwable e) {
+            throw new RuntimeException("Failed to start trace", e);
+        }
+    }
+
+    /**
+     * Flushes and closes the trace file; does nothing if no trace is running.
+     */
+    public static void stopTrace() {
+        try (final var arena = Arena.ofConfined()) {
+            final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+            final var result = (MemorySegment) STOP_TRACE.invokeExact(allocator);
+        } catch (Throwable e) {
+            throw new RuntimeException("Failed to stop trace", e);
+        }
+    }
+
+    /**
+     * Up to maxPlays plays from the history journal at path, newest first. Reads the file
+     * directly, so it works while a manager is still writing to it.
+     */
+    public static List<HistoryEntry> recentlyPlayed(String path, int maxPlays) throws AudioException {
+        if (maxPlays <= 0) {
+            return List.of();
+        }
+        try (final var arena = Arena.ofConfined()) {
+            final var nativePath = arena.allocateFrom(path);
+            final var buffer = arena.allocate(HISTORY_RECORD_LAYOUT, maxPlays);
+            final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+            final var result = (MemorySegment) GET_RECENTLY_PLAYED.invokeExact(allocator, nativePath, buffer, (long) maxPlays);
+            final var count = (int) AudioManager.longValue(result);
+            final var entries = new ArrayList<HistoryEntry>(count);
+            for (int i = 0; i < count; i++) {
+                final var offset = i * HISTORY_RECORD_LAYOUT.byteSize();
+                final var micros = buffer.get(ValueLayout.JAVA_LONG, offset);
+                entries.add(new HistoryEntry(
+                        Instant.ofEpochSecond(Math.floorDiv(micros, 1_000_000L), Math.floorMod(micros, 1_000_000L) * 1000),
+                        buffer.get(ValueLayout.JAVA_LONG, offset + 8),
+                        Duration.ofMillis(Integer.toUnsignedLong(buffer.get(ValueLayout.JAVA_INT, offset + 16))),
+                        Duration.ofSeconds(Integer.toUnsignedLong(buffer.get(ValueLayout.JAVA_INT, offset + 20))),
+                        buffer.get(ValueLayout.JAVA_INT, offset + 24) == 2));
+            }
+            return entries;
+        } catch (AudioException e) {
+            throw e;
+        } catch (Throwable e) {
+            throw new RuntimeException("Failed to read history", e);
+        }
+    }
+
+    public static PlayCount playCount(String path, long trackId) throws AudioException {
+        try (final var arena = Arena.ofConfined()) {
+            final var nativePath = arena.allocateFrom(path);
+            final var count = arena.allocate(PLAY_COUNT_LAYOUT);
+            final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+            final var result = (MemorySegment) GET_PLAY_COUNT.invokeExact(allocator, nativePath, trackId, count);
+            AudioManager.check(result);
+            return new PlayCount(
+                    count.get(ValueLayout.JAVA_LONG, 0),
+                    count.get(ValueLayout.JAVA_LONG, 8),
+                    Duration.ofMillis(count.get(ValueLayout.JAVA_LONG, 16)));
+        } catch (AudioException e) {
+            throw e;
+        } catch (Throwable e) {
+            throw new RuntimeException("Failed to read history", e);
+        }
+    }
+
+    /**
+     * The id the history journal records for a track, as used by {@link #playCount}.
+     */
+    public static long trackId(String title, String artist, String album, Duration duration) throws AudioException {
+        try (final var arena = Arena.ofConfined()) {
+            final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+            final var result = (MemorySegment) GET_TRACK_ID.invokeExact(allocator,
+                    arena.allocateFrom(title), arena.allocateFrom(artist), arena.allocateFrom(album), duration.toSeconds());
+            return AudioManager.longValue(result);
+        } catch (AudioException e) {
+            throw e;
+        } catch (Throwable e) {
+            throw new RuntimeException("Failed to compute track id", e);
+        }
+    }
+
+    /**
+     * The one ticker behind every manager's position subscriptions. turns counts wake-ups of its
+     * thread; it does not grow while nothing is playing.
+     */
+    public static PositionTickerStats positionTickerStats() throws AudioException {
+        try (final var arena = Arena.ofConfined()) {
+            final var stats = arena.allocate(POSITION_TICKER_STATS_LAYOUT);
+            final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+            final var result = (MemorySegment) GET_POSITION_TICKER_STATS.invokeExact(allocator, stats);
+            AudioManager.check(result);
+            return new PositionTickerStats(
+                    stats.get(ValueLayout.JAVA_LONG, 0),
+                    stats.get(ValueLayout.JAVA_LONG, 8),
+                    stats.get(ValueLayout.JAVA_LONG, 16),
+                    stats.get(ValueLayout.JAVA_LONG, 24),
+                    stats.get(ValueLayout.JAVA_LONG, 32),
+                    stats.get(ValueLayout.JAVA_LONG, 40),
+                    stats.get(ValueLayout.JAVA_LONG, 48));
+        } catch (AudioException e) {
+            throw e;
+        } catch (Throwable e) {
+            throw new RuntimeException("Failed to get position ticker stats", e);
+        }
+    }
+
     public static class AudioManager implements AutoCloseable {
 
         private final MemorySegment nativeHandle;
@@ -113,22 +638,100 @@ public class AudioAPI {
 
         private final PlaybackCallbackStub playbackCallbackStub;
         private final TrackChangedCallbackStub trackChangedCallbackStub;
+        private final PlaybackCallbackStub activeSessionCallbackStub;
+        private final PlaybackEventCallbackStub playbackEventCallbackStub;
+        // Native subscription id to the key its listener is registered under in Subscriptions.
+        private final ConcurrentHashMap<Long, Long> subscriptions = new ConcurrentHashMap<>();
+        // Likewise for subscribePosition, whose ids are numbered separately.
+        private final ConcurrentHashMap<Long, Long> positionSubscriptions = new ConcurrentHashMap<>();
+        // The native state block, mapped once; closing the arena makes late reads fail instead
+        // of touching freed memory.
+        private final Arena stateArena = Arena.ofShared();
+        private final MemorySegment stateBlock;
 
         public AudioManager() {
             try {
                 this.nativeHandle = (MemorySegment) CREATE_AUDIO_MANAGER.invokeExact();
                 this.playbackCallbackStub = new PlaybackCallbackStub();
                 this.trackChangedCallbackStub = new TrackChangedCallbackStub();
+                this.activeSessionCallbackStub = new PlaybackCallbackStub();
+                this.playbackEventCallbackStub = new PlaybackEventCallbackStub();
+                this.stateBlock = mapStateBlock(nativeHandle, stateArena);
             } catch (Throwable e) {
                 throw new RuntimeException("Failed to create AudioManager", e);
             }
         }
 
+        private static MemorySegment mapStateBlock(MemorySegment handle, Arena owner) throws Throwable {
+            try (final var arena = Arena.ofConfined()) {
+                final var address = arena.allocate(ValueLayout.ADDRESS);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) GET_STATE_BLOCK.invokeExact(allocator, handle, address);
+                final var block = address.get(ValueLayout.ADDRESS, 0).reinterpret(longValue(result), owner, null);
+                if (block.get(ValueLayout.JAVA_INT, 0) != STATE_MAGIC || block.get(ValueLayout.JAVA_INT, STATE_VERSION_OFFSET) < 1) {
+                    throw new IllegalStateException("Unexpected state block layout");
+                }
+                return block;
+            }
+        }
+
+        /**
+         * The active session's state as of its last event, read from the native state block
+         * without calling into native code. A read that overlaps a write is retried, so the
+         * result is always one whole state. Safe to call from any thread.
+         */
+        public PlayerState state() {
+            checkClosed();
+            final var block = stateBlock;
+            final var ranges = new long[6];
+            final var text = new byte[(int) STATE_TEXT_CAPACITY];
+            while (true) {
+                final var before = (long) STATE_LONG.getAcquire(block, STATE_SEQUENCE_OFFSET);
+                if ((before & 1) == 0) {
+                    final var status = block.get(ValueLayout.JAVA_INT, 16);
+                    final var flags = block.get(ValueLayout.JAVA_INT, 20);
+                    final var position = block.get(ValueLayout.JAVA_LONG, 24);
+                    final var anchorNanos = block.get(ValueLayout.JAVA_LONG, 32);
+                    final var duration = block.get(ValueLayout.JAVA_LONG, 40);
+                    final var rate = block.get(ValueLayout.JAVA_DOUBLE, 48);
+                    final var volume = block.get(ValueLayout.JAVA_DOUBLE, 56);
+                    final var trackId = block.get(ValueLayout.JAVA_LONG, 64);
+                    // Offset and length pairs; values read during a write can be anything.
+                    long used = 0;
+                    for (int i = 0; i < ranges.length; i += 2) {
+                        ranges[i] = Math.min(Integer.toUnsignedLong(block.get(ValueLayout.JAVA_INT, STATE_TEXT_RANGES_OFFSET + 4L * i)), STATE_TEXT_CAPACITY);
+                        ranges[i + 1] = Math.min(Integer.toUnsignedLong(block.get(ValueLayout.JAVA_INT, STATE_TEXT_RANGES_OFFSET + 4L * i + 4)),
+                                STATE_TEXT_CAPACITY - ranges[i]);
+                        used = Math.max(used, ranges[i] + ranges[i + 1]);
+                    }
+                    MemorySegment.copy(block, ValueLayout.JAVA_BYTE, STATE_TEXT_OFFSET, text, 0, (int) used);
+                    VarHandle.loadLoadFence();
+                    if ((long) STATE_LONG.getOpaque(block, STATE_SEQUENCE_OFFSET) == before) {
+                        return new PlayerState(
+                                (flags & STATE_HAS_SESSION) != 0,
+                                PlaybackStatus.fromNative(status),
+                                Duration.ofMillis(position),
+                                anchorNanos,
+                                Duration.ofMillis(duration),
+                                rate,
+                                volume,
+                                (flags & STATE_MUTED) != 0,
+                                trackId,
+                                new String(text, (int) ranges[0], (int) ranges[1], StandardCharsets.UTF_8),
+                                new String(text, (int) ranges[2], (int) ranges[3], StandardCharsets.UTF_8),
+                                new String(text, (int) ranges[4], (int) ranges[5], StandardCharsets.UTF_8));
+                    }
+                }
+                Thread.onSpinWait();
+            }
+        }
+
         public void initialize() throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var result = (MemorySegment) INITIALIZE.invokeExact(SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT)), nativeHandle);
-                checkResult(result);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) INITIALIZE.invokeExact(allocator, nativeHandle);
+                check(result);
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -139,9 +742,9 @@ public class AudioAPI {
         public Duration getDuration() throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
                 final var result = (MemorySegment) GET_DURATION.invokeExact(allocator, nativeHandle);
-                final var seconds = getValueAsLong(result);
+                final var seconds = longValue(result);
                 return Duration.ofSeconds(seconds);
             } catch (AudioException e) {
                 throw e;
@@ -153,9 +756,9 @@ public class AudioAPI {
         public Duration getCurrentPosition() throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
            final var result = (MemorySegment) GET_CURRENT_POSITION.invokeExact(allocator, nativeHandle);
-                final var seconds = getValueAsLong(result);
+                final var seconds = longValue(result);
                 return Duration.ofSeconds(seconds);
             } catch (AudioException e) {
                 throw e;
@@ -164,12 +767,25 @@ public class AudioAPI {
             }
         }
 
-        public String getTitle() throws AudioException {
+        public Duration getCurrentPositionPrecise() throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
-                final var result = (MemorySegment) GET_TITLE.invokeExact(allocator, nativeHandle);
-                return getValueAsString(result);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) GET_CURRENT_POSITION_PRECISE.invokeExact(allocator, nativeHandle);
+                final var millis = longValue(result);
+                return Duration.ofMillis(millis);
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get precise position", e);
+            }
+        }
+
+        public String getTitle() throws AudioException {
+            checkClosed();
+            try {
+                return readUtf16((allocator, buffer, capacity) ->
+                        (MemorySegment) GET_TITLE.invokeExact(allocator, nativeHandle, buffer, capacity));
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -179,10 +795,9 @@ public class AudioAPI {
 
         public String getArtist() throws AudioException {
             checkClosed();
-            try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
-                final var result = (MemorySegment) GET_ARTIST.invokeExact(allocator, nativeHandle);
-                return getValueAsString(result);
+            try {
+                return readUtf16((allocator, buffer, capacity) ->
+                        (MemorySegment) GET_ARTIST.invokeExact(allocator, nativeHandle, buffer, capacity));
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -191,38 +806,139 @@ public class AudioAPI {
         }
 
         public byte[] getThumbnailBytes() throws AudioException {
+            try (final var thumbnail = borrowThumbnail()) {
+                return thumbnail.data().toArray(ValueLayout.JAVA_BYTE);
+            }
+        }
+
+        /**
+         * Lends the cached encoded artwork without copying it. The segment is read-only and
+         * stays valid until the returned Thumbnail is closed.
+         */
+        public Thumbnail borrowThumbnail() throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var outBufferPtr = arena.allocate(ValueLayout.ADDRESS);
-                final var outSizePtr = arena.allocate(ValueLayout.ADDRESS);
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
-                final var result = (MemorySegment) GET_THUMBNAIL_BYTES.invokeExact(allocator,
+                final var outData = arena.allocate(ValueLayout.ADDRESS);
+                final var outSize = arena.allocate(ValueLayout.JAVA_LONG);
+                final var outHandle = arena.allocate(ValueLayout.ADDRESS);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) ACQUIRE_THUMBNAIL.invokeExact(allocator,
                         nativeHandle,
-                        outBufferPtr,
-                        outSizePtr
+                        outData,
+                        outSize,
+                        outHandle
                 );
-                checkResult(result);
-                final var bufferPtr = MemorySegment.ofAddress(outBufferPtr.get(ValueLayout.ADDRESS, 0).address());
-                final var size = outSizePtr.get(ValueLayout.JAVA_LONG, 0);
-                final var bytes = new byte[(int) size];
-                final var dataSegment = bufferPtr.reinterpret(size);
-                for (var i = 0; i < size; i++) {
-                    bytes[i] = dataSegment.get(ValueLayout.JAVA_BYTE, i);
+                check(result);
+                final var size = outSize.get(ValueLayout.JAVA_LONG, 0);
+                final var data = outData.get(ValueLayout.ADDRESS, 0).reinterpret(size).asReadOnly();
+                return new Thumbnail(data, outHandle.get(ValueLayout.ADDRESS, 0));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to borrow thumbnail", e);
+            }
+        }
+
+        /**
+         * Caps the memory used by cached artwork of the sessions this manager discovers.
+         */
+        public void setThumbnailCacheBudget(long budgetBytes) throws AudioException {
+            checkClosed();
+            if (budgetBytes < 0) {
+                throw new IllegalArgumentException("Budget must not be negative");
+            }
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) SET_THUMBNAIL_CACHE_BUDGET.invokeExact(allocator, nativeHandle, budgetBytes);
+                check(result);
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to set thumbnail cache budget", e);
+            }
+        }
+
+        public ThumbnailCacheStats getThumbnailCacheStats() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var stats = arena.allocate(THUMBNAIL_CACHE_STATS_LAYOUT);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) GET_THUMBNAIL_CACHE_STATS.invokeExact(allocator, nativeHandle, stats);
+                check(result);
+                return new ThumbnailCacheStats(
+                        stats.get(ValueLayout.JAVA_LONG, 0),
+                        stats.get(ValueLayout.JAVA_LONG, 8),
+                        stats.get(ValueLayout.JAVA_LONG, 16),
+                        stats.get(ValueLayout.JAVA_LONG, 24),
+                        stats.get(ValueLayout.JAVA_LONG, 32),
+                        stats.get(ValueLayout.JAVA_LONG, 40),
+                        stats.get(ValueLayout.JAVA_LONG, 48));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get thumbnail cache stats", e);
+            }
+        }
+
+        /**
+         * Registers the edge lengths, in pixels, that decoded artwork is prepared at.
+         */
+        public void setThumbnailSizes(int... sizes) throws AudioException {
+            checkClosed();
+            for (final var size : sizes) {
+                if (size <= 0) {
+                    throw new IllegalArgumentException("Thumbnail sizes must be positive");
                 }
-                return bytes;
+            }
+            try (final var arena = Arena.ofConfined()) {
+                final var nativeSizes = arena.allocateFrom(ValueLayout.JAVA_INT, sizes);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) SET_THUMBNAIL_SIZES.invokeExact(allocator,
+                        nativeHandle,
+                        nativeSizes,
+                        (long) sizes.length
+                );
+                check(result);
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
-                throw new RuntimeException("Failed to get thumbnail bytes", e);
+                throw new RuntimeException("Failed to set thumbnail sizes", e);
             }
         }
 
-        public String getAlbum() throws AudioException {
+        /**
+         * Lends the decoded artwork scaled to fit a registered size, as premultiplied RGBA. Never
+         * waits for decoding: throws "Thumbnail is not ready." until the variant exists.
+         */
+        public RgbaThumbnail borrowThumbnailRgba(int size) throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
-                final var result = (MemorySegment) GET_ALBUM.invokeExact(allocator, nativeHandle);
-                return getValueAsString(result);
+                final var image = arena.allocate(RGBA_IMAGE_LAYOUT);
+                final var outHandle = arena.allocate(ValueLayout.ADDRESS);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) ACQUIRE_THUMBNAIL_RGBA.invokeExact(allocator,
+                        nativeHandle,
+                        size,
+                        image,
+                        outHandle
+                );
+                check(result);
+                final var width = image.get(ValueLayout.JAVA_INT, 8);
+                final var height = image.get(ValueLayout.JAVA_INT, 12);
+                final var pixels = image.get(ValueLayout.ADDRESS, 0).reinterpret((long) width * height * 4).asReadOnly();
+                return new RgbaThumbnail(width, height, pixels, outHandle.get(ValueLayout.ADDRESS, 0));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to borrow scaled thumbnail", e);
+            }
+        }
+
+        public String getAlbum() throws AudioException {
+            checkClosed();
+            try {
+                return readUtf16((allocator, buffer, capacity) ->
+                        (MemorySegment) GET_ALBUM.invokeExact(allocator, nativeHandle, buffer, capacity));
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -230,12 +946,27 @@ public class AudioAPI {
             }
         }
 
+        public TrackSnapshot getSnapshot() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var snapshot = arena.allocate(TRACK_SNAPSHOT_UTF16_LAYOUT);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) GET_SNAPSHOT.invokeExact(allocator, nativeHandle, snapshot);
+                check(result);
+                return TrackSnapshot.readUtf16(snapshot);
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get track snapshot", e);
+            }
+        }
+
         public void play() throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
                 final var result = (MemorySegment) PLAY.invokeExact(allocator, nativeHandle);
-                checkResult(result);
+                check(result);
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -246,9 +977,9 @@ public class AudioAPI {
         public void pause() throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
                 final var result = (MemorySegment) PAUSE.invokeExact(allocator, nativeHandle);
-                checkResult(result);
+                check(result);
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -259,9 +990,9 @@ public class AudioAPI {
         public void next() throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
                 final var result = (MemorySegment) NEXT.invokeExact(allocator, nativeHandle);
-                checkResult(result);
+                check(result);
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -272,9 +1003,9 @@ public class AudioAPI {
         public void previous() throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
                 final var result = (MemorySegment) PREVIOUS.invokeExact(allocator, nativeHandle);
-                checkResult(result);
+                check(result);
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -285,9 +1016,9 @@ public class AudioAPI {
         public void seek(Duration position) throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
                 final var result = (MemorySegment) SEEK.invokeExact(allocator, nativeHandle,position.getSeconds());
-                checkResult(result);
+                check(result);
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -301,9 +1032,9 @@ public class AudioAPI {
                 throw new IllegalArgumentException("Volume must be between 0.0 and 1.0");
             }
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
                 final var result = (MemorySegment) SET_VOLUME.invokeExact(allocator, nativeHandle, volume);
-                checkResult(result);
+                check(result);
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -314,9 +1045,9 @@ public class AudioAPI {
         public double getVolume() throws AudioException {
             checkClosed();
             try (final var arena = Arena.ofConfined()) {
-                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(EXPECTED_RESULT_LAYOUT));
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
                 final var result = (MemorySegment) GET_VOLUME.invokeExact(allocator, nativeHandle);
-                return getValueAsDouble(result);
+                return doubleValue(result);
             } catch (AudioException e) {
                 throw e;
             } catch (Throwable e) {
@@ -324,114 +1055,1246 @@ public class AudioAPI {
             }
         }
 
-        public void setPlaybackChangedCallback(Consumer<String> callback) {
+        public CompletableFuture<Void> initializeAsync() {
+            return startVoidAsync(INITIALIZE_ASYNC, "Failed to initialize AudioManager");
+        }
+
+        public CompletableFuture<Void> playAsync() {
+            return startVoidAsync(PLAY_ASYNC, "Failed to play");
+        }
+
+        public CompletableFuture<Void> pauseAsync() {
+            return startVoidAsync(PAUSE_ASYNC, "Failed to pause");
+        }
+
+        public CompletableFuture<Void> nextAsync() {
+            return startVoidAsync(NEXT_ASYNC, "Failed to skip to next track");
+        }
+
+        public CompletableFuture<Void> previousAsync() {
+            return startVoidAsync(PREVIOUS_ASYNC, "Failed to go to previous track");
+        }
+
+        public CompletableFuture<Void> seekAsync(Duration position) {
             checkClosed();
+            final var pending = AsyncCallbacks.<Void>register();
             try {
-                playbackCallbackStub.setCallback(callback);
-                SET_PLAYBACK_CALLBACK.invokeExact(nativeHandle, playbackCallbackStub.segment);
+                SEEK_ASYNC.invokeExact(nativeHandle, position.getSeconds(), AsyncCallbacks.VOID_STUB, pending.userData());
             } catch (Throwable e) {
-                throw new RuntimeException("Failed to set playback callback", e);
+                AsyncCallbacks.fail(pending, new RuntimeException("Failed to seek", e));
             }
+            return pending.future();
         }
 
-        public void setTrackChangedCallback(BiConsumer<String, String> callback) {
+        public CompletableFuture<Void> setVolumeAsync(double volume) {
             checkClosed();
+            if (volume < 0.0 || volume > 1.0) {
+                throw new IllegalArgumentException("Volume must be between 0.0 and 1.0");
+            }
+            final var pending = AsyncCallbacks.<Void>register();
             try {
-                trackChangedCallbackStub.setCallback(callback);
-                SET_TRACK_CALLBACK.invokeExact(nativeHandle, trackChangedCallbackStub.segment);
+                SET_VOLUME_ASYNC.invokeExact(nativeHandle, volume, AsyncCallbacks.VOID_STUB, pending.userData());
             } catch (Throwable e) {
-                throw new RuntimeException("Failed to set track changed callback", e);
+                AsyncCallbacks.fail(pending, new RuntimeException("Failed to set volume", e));
             }
+            return pending.future();
         }
 
-        @Override
-        public void close() {
-            if (!closed) {
-                try {
-                    try (trackChangedCallbackStub; playbackCallbackStub) {
-                        DESTROY_AUDIO_MANAGER.invokeExact(nativeHandle);
-                    }
-                    closed = true;
-                } catch (Throwable e) {
-                    throw new RuntimeException("Failed to close AudioManager", e);
-                }
+        public CompletableFuture<Double> getVolumeAsync() {
+            checkClosed();
+            final var pending = AsyncCallbacks.<Double>register();
+            try {
+                GET_VOLUME_ASYNC.invokeExact(nativeHandle, AsyncCallbacks.VOLUME_STUB, pending.userData());
+            } catch (Throwable e) {
+                AsyncCallbacks.fail(pending, new RuntimeException("Failed to get volume", e));
             }
+            return pending.future();
         }
 
-        private void checkClosed() {
-            if (closed) {
-                throw new IllegalStateException("AudioManager is closed");
+        public CompletableFuture<TrackSnapshot> getSnapshotAsync() {
+            checkClosed();
+            final var pending = AsyncCallbacks.<TrackSnapshot>register();
+            try {
+                GET_SNAPSHOT_ASYNC.invokeExact(nativeHandle, AsyncCallbacks.SNAPSHOT_STUB, pending.userData());
+            } catch (Throwable e) {
+                AsyncCallbacks.fail(pending, new RuntimeException("Failed to get track snapshot", e));
             }
+            return pending.future();
         }
 
-        private void checkResult(MemorySegment result) throws AudioException {
-            final var hasValue = result.get(ValueLayout.JAVA_BOOLEAN, 0);
-            if (!hasValue) {
-                MemorySegment errorMsg = result.get(ValueLayout.ADDRESS, 8);
-                throw new AudioException(errorToString(errorMsg));
+        public CommandStats getCommandStats() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var stats = arena.allocate(COMMAND_STATS_LAYOUT);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) GET_COMMAND_STATS.invokeExact(allocator, nativeHandle, stats);
+                check(result);
+                return new CommandStats(
+                        stats.get(ValueLayout.JAVA_LONG, 0),
+                        stats.get(ValueLayout.JAVA_LONG, 8),
+                        stats.get(ValueLayout.JAVA_LONG, 16),
+                        Duration.ofNanos(stats.get(ValueLayout.JAVA_LONG, 24) * 1000),
+                        Duration.ofNanos(stats.get(ValueLayout.JAVA_LONG, 32) * 1000));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get command stats", e);
             }
         }
 
-        private String getValueAsString(MemorySegment result) throws AudioException {
-            final var hasValue = result.get(ValueLayout.JAVA_BOOLEAN, 0);
-            MemorySegment valuePtr = result.get(ValueLayout.ADDRESS, 8);
-
-            if (!hasValue) {
-                throw new AudioException(errorToString(valuePtr));
-            }
+        /**
+         * Source app ids of every media session the system currently reports.
+         */
+        public List<String> getSessionIds() throws AudioException {
+            checkClosed();
             try {
-                final var stringSegment = MemorySegment.ofAddress(valuePtr.address()).reinterpret(Long.MAX_VALUE);
-                return stringSegment.getString(0);
-            } catch (Exception e) {
-                throw new RuntimeException("Failed to read string value", e);
+                final var joined = readText((allocator, buffer, capacity) ->
+                        (MemorySegment) GET_SESSION_IDS.invokeExact(allocator, nativeHandle, buffer, capacity));
+                return joined.isEmpty() ? List.of() : List.of(joined.split("\n"));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get session ids", e);
             }
         }
 
-        private long getValueAsLong(MemorySegment result) throws AudioException {
-            final var hasValue = result.get(ValueLayout.JAVA_BOOLEAN, 0);
-            final var valuePtr = result.get(ValueLayout.ADDRESS, 8);
-
-            if (!hasValue) {
-                throw new AudioException(errorToString(valuePtr));
-            }
+        /**
+         * Id of the session calls are routed to, or empty when there is none.
+         */
+        public Optional<String> getActiveSessionId() throws AudioException {
+            checkClosed();
             try {
-                final var valueSegment = MemorySegment.ofAddress(valuePtr.address()).reinterpret(8);
-                return valueSegment.get(ValueLayout.JAVA_LONG, 0);
-            } catch (Exception e) {
-                throw new RuntimeException("Failed to read long value", e);
+                final var id = readText((allocator, buffer, capacity) ->
+                        (MemorySegment) GET_ACTIVE_SESSION_ID.invokeExact(allocator, nativeHandle, buffer, capacity));
+                return id.isEmpty() ? Optional.empty() : Optional.of(id);
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get active session id", e);
             }
         }
 
-        private double getValueAsDouble(MemorySegment result) throws AudioException {
-            final var hasValue = result.get(ValueLayout.JAVA_BOOLEAN, 0);
-            final var valuePtr = result.get(ValueLayout.ADDRESS, 8);
-
-            if (!hasValue) {
-                throw new AudioException(errorToString(valuePtr));
+        /**
+         * Routes every call to the session of the given app, even when another one becomes current.
+         */
+        public void selectSession(String id) throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var nativeId = arena.allocateFrom(id);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) SELECT_SESSION.invokeExact(allocator, nativeHandle, nativeId);
+                check(result);
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to select session", e);
             }
+        }
 
-            try {
-                final var valueSegment = MemorySegment.ofAddress(valuePtr.address()).reinterpret(8);
-                return valueSegment.get(ValueLayout.JAVA_DOUBLE, 0);
-            } catch (Exception e) {
-                throw new RuntimeException("Failed to read double value", e);
+        public void followCurrentSession() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) FOLLOW_CURRENT_SESSION.invokeExact(allocator, nativeHandle);
+                check(result);
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to follow current session", e);
             }
         }
 
-        private String errorToString(MemorySegment error) {
-            try {
-                final var stringSegment = MemorySegment.ofAddress(error.address()).reinterpret(Long.MAX_VALUE);
-                return stringSegment.getString(0);
-            } catch (Exception e) {
-                return "Unknown error (could not read error message)";
+        /**
+         * Takes up to maxEvents of the oldest queued events in one native call. Playback, track
+         * and active-session changes are queued whether or not callbacks are registered, so a
+         * consumer can poll this from its own thread instead of handling upcalls.
+         */
+        public List<Event> drainEvents(int maxEvents) throws AudioException {
+            checkClosed();
+            if (maxEvents <= 0) {
+                return List.of();
+            }
+            try (final var arena = Arena.ofConfined()) {
+                final var buffer = arena.allocate(EVENT_LAYOUT, maxEvents);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) POLL_EVENTS.invokeExact(allocator, nativeHandle, buffer, (long) maxEvents);
+                final var count = (int) longValue(result);
+                final var events = new ArrayList<Event>(count);
+                for (int i = 0; i < count; i++) {
+                    final var offset = i * EVENT_LAYOUT.byteSize();
+                    final var micros = buffer.get(ValueLayout.JAVA_LONG, offset + 16);
+                    events.add(new Event(
+                            EventKind.fromNative(buffer.get(ValueLayout.JAVA_INT, offset)),
+                            buffer.get(ValueLayout.JAVA_LONG, offset + 8),
+                            Instant.ofEpochSecond(Math.floorDiv(micros, 1_000_000L), Math.floorMod(micros, 1_000_000L) * 1000)));
+                }
+                return events;
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to drain events", e);
+            }
+        }
+
+        /**
+         * Blocks the calling thread until an event is queued or the timeout passes; true if
+         * events are waiting.
+         */
+        public boolean awaitEvents(Duration timeout) throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) WAIT_FOR_EVENTS.invokeExact(allocator, nativeHandle, timeout.toMillis());
+                return longValue(result) != 0;
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to wait for events", e);
+            }
+        }
+
+        public EventQueueStats getEventQueueStats() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var stats = arena.allocate(EVENT_QUEUE_STATS_LAYOUT);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) GET_EVENT_QUEUE_STATS.invokeExact(allocator, nativeHandle, stats);
+                check(result);
+                return new EventQueueStats(
+                        stats.get(ValueLayout.JAVA_LONG, 0),
+                        stats.get(ValueLayout.JAVA_LONG, 8),
+                        stats.get(ValueLayout.JAVA_LONG, 16),
+                        stats.get(ValueLayout.JAVA_LONG, 24),
+                        stats.get(ValueLayout.JAVA_LONG, 32));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get event queue stats", e);
+            }
+        }
+
+        /**
+         * Native-side latency and error counts per operation, from the C export inward. Time spent
+         * crossing into native code is the difference between what a caller measures around a
+         * method here and the matching operation's figures.
+         */
+        public Stats getStats() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var stats = arena.allocate(STATS_LAYOUT);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) GET_STATS.invokeExact(allocator, nativeHandle, stats);
+                check(result);
+                final var operations = new EnumMap<Operation, OperationStats>(Operation.class);
+                for (final var operation : Operation.values()) {
+                    final var offset = operation.ordinal() * OPERATION_STATS_LAYOUT.byteSize();
+                    operations.put(operation, new OperationStats(
+                            stats.get(ValueLayout.JAVA_LONG, offset),
+                            stats.get(ValueLayout.JAVA_LONG, offset + 8),
+                            Duration.ofNanos(stats.get(ValueLayout.JAVA_LONG, offset + 16)),
+                            Duration.ofNanos(stats.get(ValueLayout.JAVA_LONG, offset + 24)),
+                            Duration.ofNanos(stats.get(ValueLayout.JAVA_LONG, offset + 32)),
+                            Duration.ofNanos(stats.get(ValueLayout.JAVA_LONG, offset + 40)),
+                            Duration.ofNanos(stats.get(ValueLayout.JAVA_LONG, offset + 48)),
+                            Duration.ofNanos(stats.get(ValueLayout.JAVA_LONG, offset + 56))));
+                }
+                final var tail = Operation.values().length * OPERATION_STATS_LAYOUT.byteSize();
+                return new Stats(
+                        operations,
+                        stats.get(ValueLayout.JAVA_LONG, tail),
+                        stats.get(ValueLayout.JAVA_LONG, tail + 8),
+                        stats.get(ValueLayout.JAVA_LONG, tail + 24),
+                        stats.get(ValueLayout.JAVA_LONG, tail + 32),
+                        stats.get(ValueLayout.JAVA_LONG, tail + 40),
+                        Duration.ofNanos(stats.get(ValueLayout.JAVA_LONG, tail + 48)));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get stats", e);
+            }
+        }
+
+        /**
+         * Records every finished play to an append-only journal at path, written in batches on a
+         * native thread. Query it with {@link AudioAPI#recentlyPlayed} and {@link AudioAPI#playCount}.
+         */
+        public void enableHistory(String path) throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var nativePath = arena.allocateFrom(path);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) ENABLE_HISTORY.invokeExact(allocator, nativeHandle, nativePath);
+                check(result);
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to enable history", e);
+            }
+        }
+
+        public void disableHistory() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) DISABLE_HISTORY.invokeExact(allocator, nativeHandle);
+                check(result);
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to disable history", e);
+            }
+        }
+
+        /**
+         * Blocks until every finished play is on disk.
+         */
+        public void flushHistory() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) FLUSH_HISTORY.invokeExact(allocator, nativeHandle);
+                check(result);
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to flush history", e);
+            }
+        }
+
+        public HistoryStats getHistoryStats() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var stats = arena.allocate(HISTORY_STATS_LAYOUT);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) GET_HISTORY_STATS.invokeExact(allocator, nativeHandle, stats);
+                check(result);
+                return new HistoryStats(
+                        stats.get(ValueLayout.JAVA_LONG, 0),
+                        stats.get(ValueLayout.JAVA_LONG, 8),
+                        stats.get(ValueLayout.JAVA_LONG, 16),
+                        stats.get(ValueLayout.JAVA_LONG, 24),
+                        stats.get(ValueLayout.JAVA_LONG, 32),
+                        stats.get(ValueLayout.JAVA_LONG, 40));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get history stats", e);
+            }
+        }
+
+        /**
+         * Called with the new active session id, or an empty string when no session is active.
+         */
+        public void setActiveSessionChangedCallback(Consumer<String> callback) {
+            checkClosed();
+            try {
+                activeSessionCallbackStub.setCallback(callback);
+                SET_ACTIVE_SESSION_CALLBACK.invokeExact(nativeHandle, activeSessionCallbackStub.segment);
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to set active session callback", e);
+            }
+        }
+
+        private CompletableFuture<Void> startVoidAsync(MethodHandle handle, String failure) {
+            checkClosed();
+            final var pending = AsyncCallbacks.<Void>register();
+            try {
+                handle.invokeExact(nativeHandle, AsyncCallbacks.VOID_STUB, pending.userData());
+            } catch (Throwable e) {
+                AsyncCallbacks.fail(pending, new RuntimeException(failure, e));
+            }
+            return pending.future();
+        }
+
+        public void setPlaybackChangedCallback(Consumer<String> callback) {
+            checkClosed();
+            try {
+                playbackCallbackStub.setCallback(callback);
+                SET_PLAYBACK_CALLBACK.invokeExact(nativeHandle, playbackCallbackStub.segment);
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to set playback callback", e);
+            }
+        }
+
+        /**
+         * Called with the playback state before and after each change, and only when status, rate,
+         * shuffle, repeat mode or the available controls actually changed. Runs on a system
+         * thread, or on the debouncer's thread when a debounce window is set. Null removes it.
+         */
+        public void setPlaybackEventCallback(Consumer<PlaybackEvent> callback) throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                playbackEventCallbackStub.setCallback(callback);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var stub = callback != null ? playbackEventCallbackStub.segment : MemorySegment.NULL;
+                check((MemorySegment) SET_PLAYBACK_EVENT_CALLBACK.invokeExact(allocator, nativeHandle, stub, MemorySegment.NULL));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to set playback event callback", e);
+            }
+        }
+
+        /**
+         * Folds each burst of playback changes within window into a single event from the state
+         * before the burst to the state after it. Duration.ZERO, the default, reports every change.
+         */
+        public void setPlaybackDebounce(Duration window) throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                check((MemorySegment) SET_PLAYBACK_DEBOUNCE.invokeExact(allocator, nativeHandle, window.toMillis()));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to set playback debounce", e);
+            }
+        }
+
+        public PlaybackEventStats getPlaybackEventStats() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var stats = arena.allocate(PLAYBACK_EVENT_STATS_LAYOUT);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) GET_PLAYBACK_EVENT_STATS.invokeExact(allocator, nativeHandle, stats);
+                check(result);
+                return new PlaybackEventStats(
+                        stats.get(ValueLayout.JAVA_LONG, 0),
+                        stats.get(ValueLayout.JAVA_LONG, 8),
+                        stats.get(ValueLayout.JAVA_LONG, 16),
+                        stats.get(ValueLayout.JAVA_LONG, 24));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get playback event stats", e);
+            }
+        }
+
+        public void setTrackChangedCallback(BiConsumer<String, String> callback) {
+            checkClosed();
+            try {
+                trackChangedCallbackStub.setCallback(callback);
+                SET_TRACK_CALLBACK.invokeExact(nativeHandle, trackChangedCallbackStub.segment);
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to set track changed callback", e);
+            }
+        }
+
+        /**
+         * Adds a listener for one kind of event and returns its id for unsubscribe. Any number of
+         * listeners can be registered per kind, independently of the single set*Callback slots.
+         * Listeners run on native threads and must not block.
+         */
+        public long subscribe(EventKind kind, Consumer<Notification> listener) throws AudioException {
+            checkClosed();
+            if (kind == EventKind.UNKNOWN) {
+                throw new IllegalArgumentException("Cannot subscribe to UNKNOWN events");
+            }
+            final var key = Subscriptions.register(listener);
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) SUBSCRIBE.invokeExact(allocator, nativeHandle, kind.ordinal(),
+                        Subscriptions.STUB, MemorySegment.ofAddress(key));
+                final var id = longValue(result);
+                subscriptions.put(id, key);
+                return id;
+            } catch (AudioException e) {
+                Subscriptions.remove(key);
+                throw e;
+            } catch (Throwable e) {
+                Subscriptions.remove(key);
+                throw new RuntimeException("Failed to subscribe", e);
+            }
+        }
+
+        /**
+         * False if id is not subscribed on this manager, e.g. because it was already removed.
+         */
+        public boolean unsubscribe(long id) throws AudioException {
+            checkClosed();
+            final var key = subscriptions.remove(id);
+            if (key == null) {
+                return false;
+            }
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) UNSUBSCRIBE.invokeExact(allocator, nativeHandle, id);
+                check(result);
+                return true;
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to unsubscribe", e);
+            } finally {
+                Subscriptions.remove(key);
+            }
+        }
+
+        /**
+         * Calls listener with the active session's position at once and then every interval of
+         * playback, and returns an id for unsubscribePosition. Nothing is delivered while it is
+         * paused or stopped; ticks resume with playback. Every manager's listeners share one
+         * native thread and must not block.
+         */
+        public long subscribePosition(Duration interval, Consumer<PositionTick> listener) throws AudioException {
+            checkClosed();
+            final var key = Subscriptions.registerPosition(listener);
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) SUBSCRIBE_POSITION.invokeExact(allocator, nativeHandle, interval.toMillis(),
+                        Subscriptions.STUB, MemorySegment.ofAddress(key));
+                final var id = longValue(result);
+                positionSubscriptions.put(id, key);
+                return id;
+            } catch (AudioException e) {
+                Subscriptions.remove(key);
+                throw e;
+            } catch (Throwable e) {
+                Subscriptions.remove(key);
+                throw new RuntimeException("Failed to subscribe to position", e);
+            }
+        }
+
+        /**
+         * False if id is not a position subscription of this manager.
+         */
+        public boolean unsubscribePosition(long id) throws AudioException {
+            checkClosed();
+            final var key = positionSubscriptions.remove(id);
+            if (key == null) {
+                return false;
+            }
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) UNSUBSCRIBE_POSITION.invokeExact(allocator, nativeHandle, id);
+                check(result);
+                return true;
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to unsubscribe from position", e);
+            } finally {
+                Subscriptions.remove(key);
+            }
+        }
+
+        /**
+         * How the active session's property-change notifications turned into track-changed
+         * callbacks: bursts are fetched once, and unchanged metadata is not reported again.
+         */
+        public TrackChangeStats getTrackChangeStats() throws AudioException {
+            checkClosed();
+            try (final var arena = Arena.ofConfined()) {
+                final var stats = arena.allocate(TRACK_CHANGE_STATS_LAYOUT);
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var result = (MemorySegment) GET_TRACK_CHANGE_STATS.invokeExact(allocator, nativeHandle, stats);
+                check(result);
+                return new TrackChangeStats(
+                        stats.get(ValueLayout.JAVA_LONG, 0),
+                        stats.get(ValueLayout.JAVA_LONG, 8),
+                        stats.get(ValueLayout.JAVA_LONG, 16),
+                        stats.get(ValueLayout.JAVA_LONG, 24),
+                        stats.get(ValueLayout.JAVA_LONG, 32));
+            } catch (AudioException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new RuntimeException("Failed to get track change stats", e);
+            }
+        }
+
+        @Override
+        public void close() {
+            if (!closed) {
+                try {
+                    stateArena.close();
+                    try (playbackEventCallbackStub; activeSessionCallbackStub; trackChangedCallbackStub; playbackCallbackStub) {
+                        DESTROY_AUDIO_MANAGER.invokeExact(nativeHandle);
+                    }
+                    subscriptions.values().forEach(Subscriptions::remove);
+                    subscriptions.clear();
+                    positionSubscriptions.values().forEach(Subscriptions::remove);
+                    positionSubscriptions.clear();
+                    closed = true;
+                } catch (Throwable e) {
+                    throw new RuntimeException("Failed to close AudioManager", e);
+                }
+            }
+        }
+
+        private void checkClosed() {
+            if (closed) {
+                throw new IllegalStateException("AudioManager is closed");
+            }
+        }
+
+        private static void check(MemorySegment result) throws AudioException {
+            final var status = result.get(ValueLayout.JAVA_INT, 0);
+            if (status != STATUS_OK) {
+                throw lastError(status);
+            }
+        }
+
+        private static long longValue(MemorySegment result) throws AudioException {
+            check(result);
+            return result.get(ValueLayout.JAVA_LONG, 8);
+        }
+
+        private static double doubleValue(MemorySegment result) throws AudioException {
+            check(result);
+            return result.get(ValueLayout.JAVA_DOUBLE, 8);
+        }
+
+        @FunctionalInterface
+        private interface TextCall {
+            MemorySegment invoke(SegmentAllocator allocator, MemorySegment buffer, long capacity) throws Throwable;
+        }
+
+        /**
+         * Runs a V2 string export against a caller-owned buffer, growing it once to the length
+         * the native side reports when the first attempt does not fit.
+         */
+        private static String readText(TextCall call) throws Throwable {
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.prefixAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                var capacity = INITIAL_TEXT_CAPACITY;
+                while (true) {
+                    final var buffer = arena.allocate(capacity);
+                    final var result = call.invoke(allocator, buffer, capacity);
+                    if (result.get(ValueLayout.JAVA_INT, 0) == STATUS_BUFFER_TOO_SMALL) {
+                        capacity = result.get(ValueLayout.JAVA_LONG, 8) + 1;
+                        continue;
+                    }
+                    check(result);
+                    return buffer.getString(0);
+                }
+            }
+        }
+
+        /**
+         * As readText, for the UTF-16 exports: capacity and the reported length count chars, and
+         * the string is built from them as they are.
+         */
+        private static String readUtf16(TextCall call) throws Throwable {
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.prefixAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                var capacity = INITIAL_TEXT_CAPACITY;
+                while (true) {
+                    final var buffer = arena.allocate(ValueLayout.JAVA_CHAR, capacity);
+                    final var result = call.invoke(allocator, buffer, capacity);
+                    if (result.get(ValueLayout.JAVA_INT, 0) == STATUS_BUFFER_TOO_SMALL) {
+                        capacity = result.get(ValueLayout.JAVA_LONG, 8) + 1;
+                        continue;
+                    }
+                    check(result);
+                    final var length = result.get(ValueLayout.JAVA_LONG, 8);
+                    return new String(buffer.asSlice(0, length * Character.BYTES).toArray(ValueLayout.JAVA_CHAR));
+                }
+            }
+        }
+
+        /**
+         * The error is kept per native thread, so it has to be read right after the failing call
+         * on the thread that made it.
+         */
+        private static AudioException lastError(int status) {
+            var category = AudioException.Category.UNKNOWN;
+            var hresult = 0;
+            String operation = null;
+            try (final var arena = Arena.ofConfined()) {
+                final var allocator = SegmentAllocator.slicingAllocator(arena.allocate(AUDIO_RESULT_LAYOUT));
+                final var info = arena.allocate(ERROR_INFO_LAYOUT);
+                final var result = (MemorySegment) GET_LAST_ERROR_INFO.invokeExact(allocator, info);
+                if (result.get(ValueLayout.JAVA_INT, 0) == STATUS_OK) {
+                    category = AudioException.Category.fromNative(info.get(ValueLayout.JAVA_INT, 0));
+                    hresult = info.get(ValueLayout.JAVA_INT, 4);
+                    operation = info.get(ValueLayout.ADDRESS, 8).reinterpret(Long.MAX_VALUE).getString(0);
+                }
+            } catch (Throwable ignored) {
+                // Fall through with what is known; the status alone still classifies the failure.
+            }
+            try {
+                final var message = readText((allocator, buffer, capacity) ->
+                        (MemorySegment) GET_LAST_ERROR_MESSAGE.invokeExact(allocator, buffer, capacity));
+                return new AudioException(status, category, hresult, operation, message);
+            } catch (Throwable e) {
+                return new AudioException(status, category, hresult, operation,
+                        "Unknown error (could not read error message)");
+            }
+        }
+    }
+
+    public enum PlaybackStatus {
+        CLOSED, OPENED, CHANGING, STOPPED, PLAYING, PAUSED;
+
+        static PlaybackStatus fromNative(int value) {
+            final var values = values();
+            return value >= 0 && value < values.length ? values[value] : CLOSED;
+        }
+    }
+
+    public record TrackSnapshot(String title, String artist, String album, String albumArtist,
+                                int trackNumber, PlaybackStatus status, Duration duration,
+                                Duration position, long thumbnailHandle) {
+
+        static TrackSnapshot read(MemorySegment snapshot) {
+            return new TrackSnapshot(
+                    snapshot.getString(0),
+                    snapshot.getString(SNAPSHOT_TEXT_CAPACITY),
+                    snapshot.getString(SNAPSHOT_TEXT_CAPACITY * 2),
+                    snapshot.getString(SNAPSHOT_TEXT_CAPACITY * 3),
+                    snapshot.get(ValueLayout.JAVA_INT, SNAPSHOT_TEXT_CAPACITY * 4),
+                    PlaybackStatus.fromNative(snapshot.get(ValueLayout.JAVA_INT, SNAPSHOT_TEXT_CAPACITY * 4 + 4)),
+                    Duration.ofSeconds(snapshot.get(ValueLayout.JAVA_LONG, SNAPSHOT_TEXT_CAPACITY * 4 + 8)),
+                    Duration.ofSeconds(snapshot.get(ValueLayout.JAVA_LONG, SNAPSHOT_TEXT_CAPACITY * 4 + 16)),
+                    snapshot.get(ValueLayout.JAVA_LONG, SNAPSHOT_TEXT_CAPACITY * 4 + 24));
+        }
+
+        static TrackSnapshot readUtf16(MemorySegment snapshot) {
+            final var fields = SNAPSHOT_TEXT_CAPACITY * Character.BYTES * 4;
+            return new TrackSnapshot(
+                    utf16(snapshot, 0),
+                    utf16(snapshot, 1),
+                    utf16(snapshot, 2),
+                    utf16(snapshot, 3),
+                    snapshot.get(ValueLayout.JAVA_INT, fields + 16),
+                    PlaybackStatus.fromNative(snapshot.get(ValueLayout.JAVA_INT, fields + 20)),
+                    Duration.ofSeconds(snapshot.get(ValueLayout.JAVA_LONG, fields + 24)),
+                    Duration.ofSeconds(snapshot.get(ValueLayout.JAVA_LONG, fields + 32)),
+                    snapshot.get(ValueLayout.JAVA_LONG, fields + 40));
+        }
+
+        private static String utf16(MemorySegment snapshot, int field) {
+            final var length = snapshot.get(ValueLayout.JAVA_INT, SNAPSHOT_TEXT_CAPACITY * Character.BYTES * 4 + field * 4L);
+            final var text = snapshot.asSlice(SNAPSHOT_TEXT_CAPACITY * Character.BYTES * field, length * (long) Character.BYTES);
+            return new String(text.toArray(ValueLayout.JAVA_CHAR));
+        }
+    }
+
+    /**
+     * Borrowed view of native artwork. Closing it returns the buffer; the segment must not be
+     * used afterwards.
+     */
+    public static final class Thumbnail implements AutoCloseable {
+
+        private final MemorySegment data;
+        private final MemorySegment handle;
+        private boolean released = false;
+
+        private Thumbnail(MemorySegment data, MemorySegment handle) {
+            this.data = data;
+            this.handle = handle;
+        }
+
+        public MemorySegment data() {
+            if (released) {
+                throw new IllegalStateException("Thumbnail has been released");
+            }
+            return data;
+        }
+
+        @Override
+        public void close() {
+            if (!released) {
+                released = true;
+                try {
+                    RELEASE_THUMBNAIL.invokeExact(handle);
+                } catch (Throwable e) {
+                    throw new RuntimeException("Failed to release thumbnail", e);
+                }
             }
         }
     }
 
+    /**
+     * Borrowed view of a decoded, scaled artwork variant: premultiplied RGBA, width * 4 bytes per
+     * row. Closing it returns the image; the segment must not be used afterwards.
+     */
+    public static final class RgbaThumbnail implements AutoCloseable {
+
+        private final int width;
+        private final int height;
+        private final MemorySegment pixels;
+        private final MemorySegment handle;
+        private boolean released = false;
+
+        private RgbaThumbnail(int width, int height, MemorySegment pixels, MemorySegment handle) {
+            this.width = width;
+            this.height = height;
+            this.pixels = pixels;
+            this.handle = handle;
+        }
+
+        public int width() {
+            return width;
+        }
+
+        public int height() {
+            return height;
+        }
+
+        public MemorySegment pixels() {
+            if (released) {
+                throw new IllegalStateException("Thumbnail has been released");
+            }
+            return pixels;
+        }
+
+        @Override
+        public void close() {
+            if (!released) {
+                released = true;
+                try {
+                    RELEASE_THUMBNAIL_RGBA.invokeExact(handle);
+                } catch (Throwable e) {
+                    throw new RuntimeException("Failed to release thumbnail", e);
+                }
+            }
+        }
+    }
+
+    /**
+     * Mirrors audio::RepeatMode.
+     */
+    public enum RepeatMode {
+        NONE, TRACK, LIST;
+
+        static RepeatMode fromNative(int value) {
+            final var values = values();
+            return value >= 0 && value < values.length ? values[value] : NONE;
+        }
+    }
+
+    /**
+     * Transport actions a player can accept, in the bit order of audio::PlaybackControl.
+     */
+    public enum PlaybackControl {
+        PLAY, PAUSE, STOP, NEXT, PREVIOUS, PLAY_PAUSE_TOGGLE, SHUFFLE, REPEAT,
+        PLAYBACK_RATE, PLAYBACK_POSITION, FAST_FORWARD, REWIND
+    }
+
+    /**
+     * Fields of PlaybackState, in the bit order of audio::PlaybackEvent::Field.
+     */
+    public enum PlaybackField {
+        STATUS, RATE, SHUFFLE, REPEAT, CONTROLS
+    }
+
+    private static <E extends Enum<E>> Set<E> fromBits(Class<E> type, int bits) {
+        final var set = EnumSet.noneOf(type);
+        for (final var value : type.getEnumConstants()) {
+            if ((bits & (1 << value.ordinal())) != 0) {
+                set.add(value);
+            }
+        }
+        return set;
+    }
+
+    public record PlaybackState(PlaybackStatus status, double rate, boolean shuffle, RepeatMode repeat,
+                                Set<PlaybackControl> controls) {
+
+        static PlaybackState read(MemorySegment segment, long offset) {
+            return new PlaybackState(
+                    PlaybackStatus.fromNative(segment.get(ValueLayout.JAVA_INT, offset)),
+                    segment.get(ValueLayout.JAVA_DOUBLE, offset + 8),
+                    segment.get(ValueLayout.JAVA_INT, offset + 16) != 0,
+                    RepeatMode.fromNative(segment.get(ValueLayout.JAVA_INT, offset + 4)),
+                    fromBits(PlaybackControl.class, segment.get(ValueLayout.JAVA_INT, offset + 20)));
+        }
+    }
+
+    public record PlaybackEvent(PlaybackState previous, PlaybackState current, Set<PlaybackField> changed) {
+
+        static PlaybackEvent read(MemorySegment eventPtr) {
+            final var event = eventPtr.reinterpret(PLAYBACK_EVENT_LAYOUT.byteSize());
+            final var stateSize = PLAYBACK_STATE_LAYOUT.byteSize();
+            return new PlaybackEvent(
+                    PlaybackState.read(event, 0),
+                    PlaybackState.read(event, stateSize),
+                    fromBits(PlaybackField.class, event.get(ValueLayout.JAVA_INT, 2 * stateSize)));
+        }
+    }
+
+    /**
+     * One event as seen by a subscriber. Only the fields of its kind are set: playback for
+     * PLAYBACK_CHANGED, title and artist for TRACK_CHANGED, sessionId for ACTIVE_SESSION_CHANGED.
+     */
+    public record Notification(EventKind kind, PlaybackEvent playback, String title, String artist, String sessionId) {
+
+        static Notification read(MemorySegment notificationPtr) {
+            final var notification = notificationPtr.reinterpret(NOTIFICATION_LAYOUT.byteSize());
+            final var playback = notification.get(ValueLayout.ADDRESS, 8);
+            return new Notification(
+                    EventKind.fromNative(notification.get(ValueLayout.JAVA_INT, 0)),
+                    playback.equals(MemorySegment.NULL) ? null : PlaybackEvent.read(playback),
+                    readOptional(notification.get(ValueLayout.ADDRESS, 16)),
+                    readOptional(notification.get(ValueLayout.ADDRESS, 24)),
+                    readOptional(notification.get(ValueLayout.ADDRESS, 32)));
+        }
+
+        private static String readOptional(MemorySegment text) {
+            return text.equals(MemorySegment.NULL) ? null : text.reinterpret(Long.MAX_VALUE).getString(0);
+        }
+    }
+
+    /**
+     * collapsed counts events folded into another one by the debounce window; cancelled counts
+     * bursts that ended in the state they started from and were not reported at all.
+     */
+    public record PlaybackEventStats(long received, long delivered, long collapsed, long cancelled) {
+    }
+
+    public record TrackChangeStats(long received, long fetches, long delivered, long unchanged, long failures) {
+    }
+
+    public record ThumbnailCacheStats(long hits, long misses, long deduplicated, long evictions,
+                                      long entries, long bytes, long budgetBytes) {
+    }
+
+    public record CommandStats(long submitted, long executed, long coalesced, Duration totalWait, Duration maxWait) {
+    }
+
+    public enum EventKind {
+        UNKNOWN, PLAYBACK_CHANGED, TRACK_CHANGED, ACTIVE_SESSION_CHANGED;
+
+        static EventKind fromNative(int value) {
+            final var values = values();
+            return value >= 0 && value < values.length ? values[value] : UNKNOWN;
+        }
+    }
+
+    /**
+     * A gap in sequence numbers means events were dropped on overflow or drained by another consumer.
+     */
+    public record Event(EventKind kind, long sequence, Instant timestamp) {
+    }
+
+    public record EventQueueStats(long pushed, long delivered, long overflows, long dropped, long capacity) {
+    }
+
+    /**
+     * Mirrors audio::StatOperation, in native order. The FETCH_ and VOLUME_ENDPOINT entries time
+     * the platform calls made by every session in the process.
+     */
+    public enum Operation {
+        INITIALIZE, GET_DURATION, GET_POSITION, GET_TITLE, GET_ARTIST, GET_ALBUM, GET_THUMBNAIL,
+        GET_TRACK_SNAPSHOT, PLAY, PAUSE, NEXT, PREVIOUS, SEEK, SET_VOLUME, GET_VOLUME,
+        FETCH_MEDIA_PROPERTIES, FETCH_PLAYBACK_INFO, FETCH_TIMELINE, VOLUME_ENDPOINT
+    }
+
+    /**
+     * Percentiles come from a histogram and may read up to 25% high; none exceeds max.
+     */
+    public record OperationStats(long calls, long errors, Duration total, Duration max,
+                                 Duration p50, Duration p90, Duration p99, Duration p999) {
+    }
+
+    /**
+     * elapsed is the time the counters have been running, for turning counts into rates.
+     */
+    public record Stats(EnumMap<Operation, OperationStats> operations, long cacheHits, long cacheMisses,
+                        long playbackEvents, long trackEvents, long activeSessionEvents, Duration elapsed) {
+    }
+
+    /**
+     * One finished play. played excludes pauses; completed means at least 90% of the duration
+     * was played, or the duration was unknown.
+     */
+    public record HistoryEntry(Instant started, long trackId, Duration played, Duration duration, boolean completed) {
+    }
+
+    public record PlayCount(long plays, long completed, Duration played) {
+    }
+
+    /**
+     * recovered and truncatedBytes describe the journal as it was opened: records kept, and torn
+     * tail cut off after a crash.
+     */
+    public record HistoryStats(long appended, long committed, long commits, long failures,
+                               long recovered, long truncatedBytes) {
+    }
+
+    /**
+     * duration is zero when the session does not report one.
+     */
+    public record PositionTick(Duration position, Duration duration, PlaybackStatus status) {
+
+        static PositionTick read(MemorySegment tickPtr) {
+            final var tick = tickPtr.reinterpret(POSITION_TICK_LAYOUT.byteSize());
+            return new PositionTick(
+                    Duration.ofMillis(tick.get(ValueLayout.JAVA_LONG, 0)),
+                    Duration.ofMillis(tick.get(ValueLayout.JAVA_LONG, 8)),
+                    PlaybackStatus.fromNative(tick.get(ValueLayout.JAVA_INT, 16)));
+        }
+    }
+
+    /**
+     * parked counts subscribers waiting for playback to resume.
+     */
+    /**
+     * The native state block as of one write. position held at anchorNanos, a System.nanoTime
+     * value, and advances at rate while playing. volume is negative until the session has
+     * reported one; trackId is the history journal's id, 0 without a track.
+     */
+    public record PlayerState(boolean hasSession, PlaybackStatus status, Duration position, long anchorNanos,
+                              Duration duration, double rate, double volume, boolean muted, long trackId,
+                              String title, String artist, String album) {
+
+        public Duration positionAt(long nanoTime) {
+            if (status != PlaybackStatus.PLAYING || nanoTime <= anchorNanos) {
+                return position;
+            }
+            final var advanced = position.plusNanos((long) ((nanoTime - anchorNanos) * rate));
+            return duration.isZero() || advanced.compareTo(duration) < 0 ? advanced : duration;
+        }
+
+        public Duration currentPosition() {
+            return positionAt(System.nanoTime());
+        }
+    }
+
+    public record PositionTickerStats(long sources, long subscribers, long parked, long ticks,
+                                      long samples, long sampleFailures, long turns) {
+    }
+
     public static class AudioException extends Exception {
 
+        public static final int INVALID_ARGUMENT = 1;
+        public static final int NO_SESSION = 2;
+        public static final int NOT_READY = 3;
+        public static final int OPERATION_FAILED = 5;
+        public static final int NOT_FOUND = 6;
+        public static final int UNSUPPORTED = 7;
+        public static final int INTERRUPTED = 8;
+        public static final int PLATFORM = 9;
+        public static final int INTERNAL = 10;
+
+        /**
+         * Mirrors audio::ErrorCategory; the first eight constants are in native order. UNKNOWN is
+         * used when only a message is available, as with the async callbacks.
+         */
+        public enum Category {
+            NO_SESSION, NOT_READY, NOT_FOUND, INVALID_ARGUMENT, UNSUPPORTED, INTERRUPTED, PLATFORM, INTERNAL, UNKNOWN;
+
+            private static final Category[] VALUES = values();
+
+            static Category fromNative(int value) {
+                return value >= 0 && value < UNKNOWN.ordinal() ? VALUES[value] : UNKNOWN;
+            }
+        }
+
+        private final int status;
+        private final Category category;
+        private final int hresult;
+        private final String operation;
+
         public AudioException(String message) {
+            this(OPERATION_FAILED, message);
+        }
+
+        public AudioException(int status, String message) {
+            this(status, Category.UNKNOWN, 0, null, message);
+        }
+
+        public AudioException(int status, Category category, int hresult, String operation, String message) {
             super(message);
+            this.status = status;
+            this.category = category;
+            this.hresult = hresult;
+            this.operation = operation;
+        }
+
+        /**
+         * Native status code; NO_SESSION and NOT_READY are expected while polling.
+         */
+        public int status() {
+            return status;
+        }
+
+        public Category category() {
+            return category;
+        }
+
+        /**
+         * The failing operating-system call's HRESULT, or 0 when the failure did not come from one.
+         */
+        public int hresult() {
+            return hresult;
+        }
+
+        /**
+         * Short name of the native operation that failed, such as "Seek", or null if unknown.
+         */
+        public String operation() {
+            return operation;
+        }
+    }
+
+    /**
+     * Routes native completion callbacks back to the CompletableFuture that started them. The
+     * userData pointer passed to native code is just an id into the pending map, so the three
+     * upcall stubs are shared by every manager and every in-flight call.
+     */
+    private static final class AsyncCallbacks {
+
+        record Pending<T>(long id, CompletableFuture<T> future) {
+            MemorySegment userData() {
+                return MemorySegment.ofAddress(id);
+            }
+        }
+
+        private static final Arena CALLBACK_ARENA = Arena.global();
+        private static final AtomicLong NEXT_ID = new AtomicLong(1);
+        private static final ConcurrentHashMap<Long, CompletableFuture<?>> PENDING = new ConcurrentHashMap<>();
+
+        static final MemorySegment VOID_STUB = upcall("completeVoid",
+                MethodType.methodType(void.class, MemorySegment.class, boolean.class, MemorySegment.class),
+                FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.JAVA_BOOLEAN, ValueLayout.ADDRESS));
+
+        static final MemorySegment VOLUME_STUB = upcall("completeVolume",
+                MethodType.methodType(void.class, MemorySegment.class, boolean.class, double.class, MemorySegment.class),
+                FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.JAVA_BOOLEAN, ValueLayout.JAVA_DOUBLE, ValueLayout.ADDRESS));
+
+        static final MemorySegment SNAPSHOT_STUB = upcall("completeSnapshot",
+                MethodType.methodType(void.class, MemorySegment.class, MemorySegment.class, MemorySegment.class),
+                FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.ADDRESS, ValueLayout.ADDRESS));
+
+        private AsyncCallbacks() {
+        }
+
+        static <T> Pending<T> register() {
+            final var pending = new Pending<T>(NEXT_ID.getAndIncrement(), new CompletableFuture<>());
+            PENDING.put(pending.id(), pending.future());
+            return pending;
+        }
+
+        static void fail(Pending<?> pending, Throwable error) {
+            PENDING.remove(pending.id());
+            pending.future().completeExceptionally(error);
+        }
+
+        @SuppressWarnings("unchecked")
+        private static <T> CompletableFuture<T> take(MemorySegment userData) {
+            return (CompletableFuture<T>) PENDING.remove(userData.address());
+        }
+
+        private static MemorySegment upcall(String name, MethodType type, FunctionDescriptor descriptor) {
+            try {
+                final var target = MethodHandles.lookup().findStatic(AsyncCallbacks.class, name, type);
+                return LINKER.upcallStub(target, descriptor, CALLBACK_ARENA);
+            } catch (IllegalAccessException | NoSuchMethodException e) {
+                throw new RuntimeException(e);
+            }
+        }
+
+        private static String readError(MemorySegment error) {
+            if (error.equals(MemorySegment.NULL)) {
+                return "Unknown error";
+            }
+            return error.reinterpret(Long.MAX_VALUE).getString(0);
+        }
+
+        private static void completeVoid(MemorySegment userData, boolean success, MemorySegment error) {
+            try {
+                final CompletableFuture<Void> future = take(userData);
+                if (future == null) {
+                    return;
+                }
+                if (success) {
+                    future.complete(null);
+                } else {
+                    future.completeExceptionally(new AudioException(readError(error)));
+                }
+            } catch (Throwable ignored) {
+                // An exception escaping an upcall would bring down the JVM.
+            }
+        }
+
+        private static void completeVolume(MemorySegment userData, boolean success, double volume, MemorySegment error) {
+            try {
+                final CompletableFuture<Double> future = take(userData);
+                if (future == null) {
+                    return;
+                }
+                if (success) {
+                    future.complete(volume);
+                } else {
+                    future.completeExceptionally(new AudioException(readError(error)));
+                }
+            } catch (Throwable ignored) {
+                // An exception escaping an upcall would bring down the JVM.
+            }
+        }
+
+        private static void completeSnapshot(MemorySegment userData, MemorySegment snapshot, MemorySegment error) {
+            try {
+                final CompletableFuture<TrackSnapshot> future = take(userData);
+                if (future == null) {
+                    return;
+                }
+                if (!snapshot.equals(MemorySegment.NULL)) {
+                    future.complete(TrackSnapshot.read(snapshot.reinterpret(TRACK_SNAPSHOT_LAYOUT.byteSize())));
+                } else {
+                    future.completeExceptionally(new AudioException(readError(error)));
+                }
+            } catch (Throwable ignored) {
+                // An exception escaping an upcall would bring down the JVM.
+            }
+        }
+    }
+
+    /**
+     * Listeners registered through subscribe. The native side only holds the key of each one as
+     * its user data, and a single upcall stub serves every manager and every subscription.
+     */
+    private static final class Subscriptions {
+
+        private static final Arena CALLBACK_ARENA = Arena.global();
+        private static final AtomicLong NEXT_KEY = new AtomicLong(1);
+        // Each listener reads its own struct from the pointer; event and position listeners share the stub.
+        private static final ConcurrentHashMap<Long, Consumer<MemorySegment>> LISTENERS = new ConcurrentHashMap<>();
+
+        static final MemorySegment STUB;
+
+        static {
+            try {
+                final var target = MethodHandles.lookup().findStatic(Subscriptions.class, "dispatch",
+                        MethodType.methodType(void.class, MemorySegment.class, MemorySegment.class));
+                STUB = LINKER.upcallStub(target, FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.ADDRESS), CALLBACK_ARENA);
+            } catch (IllegalAccessException | NoSuchMethodException e) {
+                throw new RuntimeException(e);
+            }
+        }
+
+        private Subscriptions() {
+        }
+
+        static long register(Consumer<Notification> listener) {
+            return add(notification -> listener.accept(Notification.read(notification)));
+        }
+
+        static long registerPosition(Consumer<PositionTick> listener) {
+            return add(tick -> listener.accept(PositionTick.read(tick)));
+        }
+
+        private static long add(Consumer<MemorySegment> listener) {
+            final var key = NEXT_KEY.getAndIncrement();
+            LISTENERS.put(key, listener);
+            return key;
+        }
+
+        static void remove(long key) {
+            LISTENERS.remove(key);
+        }
+
+        private static void dispatch(MemorySegment userData, MemorySegment payload) {
+            try {
+                final var listener = LISTENERS.get(userData.address());
+                if (listener != null) {
+                    listener.accept(payload);
+                }
+            } catch (Throwable ignored) {
+                // An exception escaping an upcall would bring down the JVM.
+            }
         }
     }
 
@@ -442,7 +2305,6 @@ public class AudioAPI {
         final MemorySegment segment;
 
         PlaybackCallbackStub() {
-            segment = CALLBACK_ARENA.allocate(ValueLayout.ADDRESS);
             MethodHandle upCall;
             try {
                 upCall = MethodHandles.lookup().findVirtual(
@@ -453,16 +2315,15 @@ public class AudioAPI {
                 throw new RuntimeException(e);
             }
             final var boundUpCall = upCall.bindTo(this);
-            final var upcallStub = LINKER.upcallStub(
+            segment = LINKER.upcallStub(
                     boundUpCall,
                     FunctionDescriptor.ofVoid(ValueLayout.ADDRESS),
                     CALLBACK_ARENA);
-            segment.set(ValueLayout.ADDRESS, 0, upcallStub);
         }
 
         public void invoke(MemorySegment messagePtr) {
             if (callback != null) {
-                String message = messagePtr.getString(0);
+                String message = messagePtr.reinterpret(Long.MAX_VALUE).getString(0);
                 callback.accept(message);
             }
         }
@@ -483,7 +2344,6 @@ public class AudioAPI {
         final MemorySegment segment;
 
         TrackChangedCallbackStub() {
-            segment = CALLBACK_ARENA.allocate(ValueLayout.ADDRESS);
             MethodHandle upCall;
             try {
                 upCall = MethodHandles.lookup().findVirtual(
@@ -494,17 +2354,16 @@ public class AudioAPI {
                 throw new RuntimeException(e);
             }
             final var boundUpCall = upCall.bindTo(this);
-            final var upcallStub = LINKER.upcallStub(
+            segment = LINKER.upcallStub(
                     boundUpCall,
                     FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.ADDRESS),
                     CALLBACK_ARENA);
-            segment.set(ValueLayout.ADDRESS, 0, upcallStub);
         }
 
         public void invoke(MemorySegment titlePtr, MemorySegment artistPtr) {
             if (callback != null) {
-                String title = titlePtr.getString(0);
-                String artist = artistPtr.getString(0);
+                String title = titlePtr.reinterpret(Long.MAX_VALUE).getString(0);
+                String artist = artistPtr.reinterpret(Long.MAX_VALUE).getString(0);
                 callback.accept(title, artist);
             }
         }
@@ -517,4 +2376,43 @@ public class AudioAPI {
         public void close() {
         }
     }
+
+    private static class PlaybackEventCallbackStub implements AutoCloseable {
+
+        private static final Arena CALLBACK_ARENA = Arena.global();
+        private Consumer<PlaybackEvent> callback;
+        final MemorySegment segment;
+
+        PlaybackEventCallbackStub() {
+            MethodHandle upCall;
+            try {
+                upCall = MethodHandles.lookup().findVirtual(
+                        PlaybackEventCallbackStub.class,
+                        "invoke",
+                        MethodType.methodType(void.class, MemorySegment.class, MemorySegment.class));
+            } catch (IllegalAccessException | NoSuchMethodException e) {
+                throw new RuntimeException(e);
+            }
+            final var boundUpCall = upCall.bindTo(this);
+            segment = LINKER.upcallStub(
+                    boundUpCall,
+                    FunctionDescriptor.ofVoid(ValueLayout.ADDRESS, ValueLayout.ADDRESS),
+                    CALLBACK_ARENA);
+        }
+
+        public void invoke(MemorySegment userData, MemorySegment eventPtr) {
+            final var current = callback;
+            if (current != null) {
+                current.accept(PlaybackEvent.read(eventPtr));
+            }
+        }
+
+        public void setCallback(Consumer<PlaybackEvent> callback) {
+            this.callback = callback;
+        }
+
+        @Override
+        public void close() {
+        }
+    }
 }